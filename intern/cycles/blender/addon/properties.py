@@ -341,6 +341,33 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_adaptive_sampling: BoolProperty(
+        name="Use Adaptive Sampling",
+        description="Automatically stop sampling pixels and tiles once their noise is below the threshold "
+        "(CPU final renders without progressive refine only)",
+        default=False,
+    )
+    adaptive_threshold: FloatProperty(
+        name="Adaptive Sampling Threshold",
+        description="Noise level at which a pixel is considered converged, lower values give less noise",
+        min=0.0, max=1.0,
+        default=0.01,
+        precision=4,
+    )
+    adaptive_min_samples: IntProperty(
+        name="Adaptive Min Samples",
+        description="Minimum number of samples before a pixel can be considered converged, "
+        "zero for automatic setting based on the number of samples",
+        min=0, max=4096,
+        default=0,
+    )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights by their estimated contribution to each shading point, "
+        "using a hierarchy of lights. Reduces noise in scenes with many lights, but "
+        "is not used when sampling all lights",
+        default=False,
+    )
 
     min_light_bounces: IntProperty(
             name="Min Light Bounces",
@@ -717,6 +744,20 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="For final renders, read image textures tile by tile from disk as needed instead of loading "
+        "them fully into memory (CPU only, converting images to tiled and mipmapped .tx files makes this faster)",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Texture Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=4096,
+        min=128, max=1048576,
+        subtype='UNSIGNED',
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
@@ -1285,6 +1326,12 @@ class CyclesRenderLayerSettings(bpy.types.PropertyGroup):
         default=False,
         update=update_render_passes,
     )
+    pass_debug_sample_count: BoolProperty(
+        name="Debug Sample Count",
+        description="Number of samples taken for each pixel, to inspect adaptive sampling",
+        default=False,
+        update=update_render_passes,
+    )
 
     use_pass_volume_direct: BoolProperty(
         name="Volume Direct",
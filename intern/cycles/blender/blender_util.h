@@ -76,12 +76,13 @@ static inline BL::Mesh object_to_mesh(BL::BlendData & /*data*/,
     if (mesh.is_editmode() ||
         (mesh.use_auto_smooth() && subdivision_type == Mesh::SUBDIVISION_NONE)) {
       BL::Depsgraph depsgraph(PointerRNA_NULL);
-      mesh = object.to_mesh(false, depsgraph);
+      /* Instances of the mesh are synced as duplis, like for the evaluated mesh above. */
+      mesh = object.to_mesh(false, depsgraph, false);
     }
   }
   else {
     BL::Depsgraph depsgraph(PointerRNA_NULL);
-    mesh = object.to_mesh(false, depsgraph);
+    mesh = object.to_mesh(false, depsgraph, false);
   }
 
 #if 0
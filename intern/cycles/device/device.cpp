@@ -594,6 +594,7 @@ DeviceInfo Device::get_multi_device(const vector<DeviceInfo> &subdevices,
   info.has_half_images = true;
   info.has_volume_decoupled = true;
   info.has_osl = true;
+  info.has_adaptive_sampling = true;
   info.has_profiling = true;
 
   foreach (const DeviceInfo &device, subdevices) {
@@ -628,6 +629,7 @@ DeviceInfo Device::get_multi_device(const vector<DeviceInfo> &subdevices,
     info.has_half_images &= device.has_half_images;
     info.has_volume_decoupled &= device.has_volume_decoupled;
     info.has_osl &= device.has_osl;
+    info.has_adaptive_sampling &= device.has_adaptive_sampling;
     info.has_profiling &= device.has_profiling;
   }
 
@@ -75,12 +75,13 @@ class DeviceInfo {
   string description;
   string id; /* used for user preferences, should stay fixed with changing hardware config */
   int num;
-  bool display_device;       /* GPU is used as a display device. */
-  bool has_half_images;      /* Support half-float textures. */
-  bool has_volume_decoupled; /* Decoupled volume shading. */
-  bool has_osl;              /* Support Open Shading Language. */
-  bool use_split_kernel;     /* Use split or mega kernel. */
-  bool has_profiling;        /* Supports runtime collection of profiling info. */
+  bool display_device;        /* GPU is used as a display device. */
+  bool has_half_images;       /* Support half-float textures. */
+  bool has_volume_decoupled;  /* Decoupled volume shading. */
+  bool has_osl;               /* Support Open Shading Language. */
+  bool has_adaptive_sampling; /* Supports adaptive sampling. */
+  bool use_split_kernel;      /* Use split or mega kernel. */
+  bool has_profiling;         /* Supports runtime collection of profiling info. */
   int cpu_threads;
   vector<DeviceInfo> multi_devices;
 
@@ -94,6 +95,7 @@ class DeviceInfo {
     has_half_images = false;
     has_volume_decoupled = false;
     has_osl = false;
+    has_adaptive_sampling = false;
     use_split_kernel = false;
     has_profiling = false;
   }
@@ -179,6 +179,14 @@ class CPUDevice : public Device {
   DeviceRequestedFeatures requested_features;
 
   KernelFunctions<void (*)(KernelGlobals *, float *, int, int, int, int, int)> path_trace_kernel;
+  KernelFunctions<void (*)(KernelGlobals *, float *, int, int, int, int, int)>
+      adaptive_stopping_kernel;
+  KernelFunctions<bool (*)(KernelGlobals *, float *, int, int, int, int, int)>
+      adaptive_filter_x_kernel;
+  KernelFunctions<bool (*)(KernelGlobals *, float *, int, int, int, int, int)>
+      adaptive_filter_y_kernel;
+  KernelFunctions<void (*)(KernelGlobals *, float *, int, int, int, int, int)>
+      adaptive_adjust_samples_kernel;
   KernelFunctions<void (*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)>
       convert_to_half_float_kernel;
   KernelFunctions<void (*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)>
@@ -264,6 +272,10 @@ class CPUDevice : public Device {
         texture_info(this, "__texture_info", MEM_TEXTURE),
 #define REGISTER_KERNEL(name) name##_kernel(KERNEL_FUNCTIONS(name))
         REGISTER_KERNEL(path_trace),
+        REGISTER_KERNEL(adaptive_stopping),
+        REGISTER_KERNEL(adaptive_filter_x),
+        REGISTER_KERNEL(adaptive_filter_y),
+        REGISTER_KERNEL(adaptive_adjust_samples),
         REGISTER_KERNEL(convert_to_half_float),
         REGISTER_KERNEL(convert_to_byte),
         REGISTER_KERNEL(shader),
@@ -471,7 +483,14 @@ class CPUDevice : public Device {
       }
 
       TextureInfo &info = texture_info[flat_slot];
-      info.data = (uint64_t)mem.host_pointer;
+      if (mem.texture_cache_handle) {
+        info.data = (uint64_t)mem.texture_cache_handle;
+        info.use_texture_cache = 1;
+      }
+      else {
+        info.data = (uint64_t)mem.host_pointer;
+        info.use_texture_cache = 0;
+      }
       info.cl_buffer = 0;
       info.interpolation = mem.interpolation;
       info.extension = mem.extension;
@@ -819,9 +838,58 @@ class CPUDevice : public Device {
     return true;
   }
 
+  /* Mark converged pixels of the tile and grow the unconverged regions.
+   * Returns true if all pixels converged. */
+  bool adaptive_sampling_filter(KernelGlobals *kg, RenderTile &tile, int sample)
+  {
+    float *render_buffer = (float *)tile.buffer;
+
+    for (int y = tile.y; y < tile.y + tile.h; y++) {
+      for (int x = tile.x; x < tile.x + tile.w; x++) {
+        adaptive_stopping_kernel()(kg, render_buffer, sample, x, y, tile.offset, tile.stride);
+      }
+    }
+
+    bool any = false;
+    for (int y = tile.y; y < tile.y + tile.h; y++) {
+      any |= adaptive_filter_x_kernel()(
+          kg, render_buffer, y, tile.x, tile.w, tile.offset, tile.stride);
+    }
+    for (int x = tile.x; x < tile.x + tile.w; x++) {
+      any |= adaptive_filter_y_kernel()(
+          kg, render_buffer, x, tile.y, tile.h, tile.offset, tile.stride);
+    }
+
+    return !any;
+  }
+
+  /* Scale pixels that stopped early to the sample count of the tile, and
+   * count the pixel samples that were skipped. */
+  void adaptive_sampling_post(KernelGlobals *kg, RenderTile &tile)
+  {
+    float *render_buffer = (float *)tile.buffer;
+    const int pass_stride = kernel_data.film.pass_stride;
+    const int pass_sample_count = kernel_data.film.pass_sample_count;
+    const int num_samples = tile.sample - tile.start_sample;
+
+    for (int y = tile.y; y < tile.y + tile.h; y++) {
+      for (int x = tile.x; x < tile.x + tile.w; x++) {
+        const float *pixel = render_buffer + (tile.offset + x + y * tile.stride) * pass_stride;
+        tile.skipped_pixel_samples += max(num_samples - (int)pixel[pass_sample_count], 0);
+
+        adaptive_adjust_samples_kernel()(
+            kg, render_buffer, num_samples, x, y, tile.offset, tile.stride);
+      }
+    }
+  }
+
   void path_trace(DeviceTask &task, RenderTile &tile, KernelGlobals *kg)
   {
     const bool use_coverage = kernel_data.film.cryptomatte_passes & CRYPT_ACCURATE;
+    const bool use_adaptive_sampling = task.adaptive_sampling &&
+                                       kernel_data.integrator.use_adaptive_sampling &&
+                                       kernel_data.film.pass_adaptive_aux_buffer &&
+                                       kernel_data.film.pass_sample_count;
 
     scoped_timer timer(&tile.buffers->render_time);
 
@@ -854,11 +922,28 @@ class CPUDevice : public Device {
 
       tile.sample = sample + 1;
 
+      if (use_adaptive_sampling && tile.sample < end_sample) {
+        const int num_samples = tile.sample - start_sample;
+        if (num_samples >= kernel_data.integrator.adaptive_min_samples &&
+            num_samples % kernel_data.integrator.adaptive_step == 0 &&
+            adaptive_sampling_filter(kg, tile, num_samples)) {
+          /* Retire the tile, so the thread moves on to tiles that are still noisy. Remaining
+           * samples are reported as done to keep the progress consistent. */
+          tile.sample = end_sample;
+          tile.converged = true;
+          task.update_progress(&tile, tile.w * tile.h * (end_sample - sample));
+          break;
+        }
+      }
+
       task.update_progress(&tile, tile.w * tile.h);
     }
     if (use_coverage) {
       coverage.finalize();
     }
+    if (use_adaptive_sampling) {
+      adaptive_sampling_post(kg, tile);
+    }
   }
 
   void denoise(DenoisingTask &denoising, RenderTile &tile)
@@ -1225,6 +1310,7 @@ void device_cpu_info(vector<DeviceInfo> &devices)
   info.num = 0;
   info.has_volume_decoupled = true;
   info.has_osl = true;
+  info.has_adaptive_sampling = true;
   info.has_half_images = true;
   info.has_profiling = true;
 
@@ -1285,6 +1285,7 @@ class CUDADevice : public Device {
     info.width = mem.data_width;
     info.height = mem.data_height;
     info.depth = mem.data_depth;
+    info.use_texture_cache = 0;
     need_texture_info = true;
   }
 
@@ -33,6 +33,7 @@ device_memory::device_memory(Device *device, const char *name, MemoryType type)
       name(name),
       interpolation(INTERPOLATION_NONE),
       extension(EXTENSION_REPEAT),
+      texture_cache_handle(NULL),
       device(device),
       device_pointer(0),
       host_pointer(0),
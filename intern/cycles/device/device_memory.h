@@ -210,6 +210,8 @@ class device_memory {
   const char *name;
   InterpolationType interpolation;
   ExtensionType extension;
+  /* Image texture read through the texture cache instead of from host memory, CPU only. */
+  void *texture_cache_handle;
 
   /* Pointers. */
   Device *device;
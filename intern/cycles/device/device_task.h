@@ -114,6 +114,7 @@ class DeviceTask : public Task {
 
   bool need_finish_queue;
   bool integrator_branched;
+  bool adaptive_sampling;
   int2 requested_tile_size;
 
  protected:
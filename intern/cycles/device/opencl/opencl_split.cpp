@@ -1293,6 +1293,7 @@ void OpenCLDevice::flush_texture_buffers()
       info.width = mem->data_width;
       info.height = mem->data_height;
       info.depth = mem->data_depth;
+      info.use_texture_cache = 0;
 
       info.interpolation = mem->interpolation;
       info.extension = mem->extension;
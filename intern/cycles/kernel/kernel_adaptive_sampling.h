@@ -0,0 +1,262 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Adaptive Sampling
+ *
+ * Every odd sample is accumulated a second time into an auxiliary buffer with
+ * twice the weight, so that it holds an estimate of the pixel from half of the
+ * samples. The difference to the full estimate is the error of the pixel,
+ * relative to the square root of its intensity so that the noise threshold is
+ * perceptually similar for dark and bright pixels. Converged pixels are marked
+ * in the fourth component of the auxiliary buffer and skipped by the path
+ * tracing kernel.
+ *
+ * Based on "A Hierarchical Automatic Stopping Condition for Monte Carlo Global
+ * Illumination", Dammertz et al., 2010. */
+
+ccl_device_inline ccl_global float *kernel_adaptive_pixel_buffer(
+    KernelGlobals *kg, ccl_global float *buffer, int x, int y, int offset, int stride)
+{
+  return buffer + (offset + x + y * stride) * kernel_data.film.pass_stride;
+}
+
+ccl_device_inline bool kernel_adaptive_pixel_converged(KernelGlobals *kg,
+                                                       ccl_global float *buffer)
+{
+  return buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] > 0.0f;
+}
+
+ccl_device_inline void kernel_adaptive_pixel_set_converged(KernelGlobals *kg,
+                                                           ccl_global float *buffer,
+                                                           bool converged)
+{
+  buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] = (converged) ? 1.0f : 0.0f;
+}
+
+/* Mark the pixel as converged if the error estimate after the given number
+ * of samples is below the threshold. */
+ccl_device void kernel_adaptive_stopping(
+    KernelGlobals *kg, ccl_global float *buffer, int sample, int x, int y, int offset, int stride)
+{
+  buffer = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride);
+
+  if (kernel_adaptive_pixel_converged(kg, buffer)) {
+    return;
+  }
+
+  const ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux_buffer;
+  const float inv_sample = 1.0f / (float)sample;
+  const float3 I = make_float3(buffer[0], buffer[1], buffer[2]) * inv_sample;
+  const float3 A = make_float3(aux[0], aux[1], aux[2]) * inv_sample;
+
+  const float error = (fabsf(I.x - A.x) + fabsf(I.y - A.y) + fabsf(I.z - A.z)) /
+                      (sqrtf(max(I.x + I.y + I.z, 0.0f)) + 1e-4f);
+
+  kernel_adaptive_pixel_set_converged(
+      kg, buffer, error < kernel_data.integrator.adaptive_threshold);
+}
+
+/* Grow the unconverged pixels of a row by one pixel on either side, so that
+ * noise along the edges of noisy regions keeps being sampled. Returns true if
+ * any pixel in the row is not converged. */
+ccl_device bool kernel_adaptive_filter_x(KernelGlobals *kg,
+                                         ccl_global float *buffer,
+                                         int y,
+                                         int start_x,
+                                         int width,
+                                         int offset,
+                                         int stride)
+{
+  bool any = false;
+  bool prev = false;
+
+  for (int x = start_x; x < start_x + width; x++) {
+    ccl_global float *pixel = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride);
+
+    if (!kernel_adaptive_pixel_converged(kg, pixel)) {
+      any = true;
+      if (x > start_x && !prev) {
+        kernel_adaptive_pixel_set_converged(
+            kg, kernel_adaptive_pixel_buffer(kg, buffer, x - 1, y, offset, stride), false);
+      }
+      prev = true;
+    }
+    else {
+      if (prev) {
+        kernel_adaptive_pixel_set_converged(kg, pixel, false);
+      }
+      prev = false;
+    }
+  }
+
+  return any;
+}
+
+/* Same as above, for a column. */
+ccl_device bool kernel_adaptive_filter_y(KernelGlobals *kg,
+                                         ccl_global float *buffer,
+                                         int x,
+                                         int start_y,
+                                         int height,
+                                         int offset,
+                                         int stride)
+{
+  bool any = false;
+  bool prev = false;
+
+  for (int y = start_y; y < start_y + height; y++) {
+    ccl_global float *pixel = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride);
+
+    if (!kernel_adaptive_pixel_converged(kg, pixel)) {
+      any = true;
+      if (y > start_y && !prev) {
+        kernel_adaptive_pixel_set_converged(
+            kg, kernel_adaptive_pixel_buffer(kg, buffer, x, y - 1, offset, stride), false);
+      }
+      prev = true;
+    }
+    else {
+      if (prev) {
+        kernel_adaptive_pixel_set_converged(kg, pixel, false);
+      }
+      prev = false;
+    }
+  }
+
+  return any;
+}
+
+ccl_device_inline void kernel_adaptive_scale_pass(ccl_global float *buffer,
+                                                  int num_components,
+                                                  float scale)
+{
+  for (int i = 0; i < num_components; i++) {
+    buffer[i] *= scale;
+  }
+}
+
+/* Scale passes of pixels that stopped early as if they had been rendered
+ * with the given number of samples, so that the render buffer can be read
+ * and denoised like any other. Passes written only once are left as they
+ * are. */
+ccl_device void kernel_adaptive_adjust_samples(
+    KernelGlobals *kg, ccl_global float *buffer, int sample, int x, int y, int offset, int stride)
+{
+  buffer = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride);
+
+  const float num_samples = buffer[kernel_data.film.pass_sample_count];
+  if (num_samples == 0.0f || num_samples >= (float)sample) {
+    return;
+  }
+
+  const float scale = (float)sample / num_samples;
+
+  kernel_adaptive_scale_pass(buffer, 4, scale);
+  kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_adaptive_aux_buffer, 3, scale);
+
+#ifdef __PASSES__
+  const int flag = kernel_data.film.pass_flag;
+
+  if (flag & PASSMASK(NORMAL))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_normal, 4, scale);
+  if (flag & PASSMASK(UV))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_uv, 4, scale);
+  if (flag & PASSMASK(MOTION)) {
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_motion, 4, scale);
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_motion_weight, 1, scale);
+  }
+
+  const int light_flag = kernel_data.film.light_pass_flag;
+
+  if (light_flag & PASSMASK(MIST))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_mist, 1, scale);
+  if (light_flag & PASSMASK(EMISSION))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_emission, 4, scale);
+  if (light_flag & PASSMASK(BACKGROUND))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_background, 4, scale);
+  if (light_flag & PASSMASK(AO))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_ao, 4, scale);
+  if (light_flag & PASSMASK(SHADOW))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_shadow, 4, scale);
+
+  if (light_flag & PASSMASK(DIFFUSE_COLOR))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_diffuse_color, 4, scale);
+  if (light_flag & PASSMASK(GLOSSY_COLOR))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_glossy_color, 4, scale);
+  if (light_flag & PASSMASK(TRANSMISSION_COLOR))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_transmission_color, 4, scale);
+  if (light_flag & PASSMASK(SUBSURFACE_COLOR))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_subsurface_color, 4, scale);
+
+  if (light_flag & PASSMASK(DIFFUSE_DIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_diffuse_direct, 4, scale);
+  if (light_flag & PASSMASK(GLOSSY_DIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_glossy_direct, 4, scale);
+  if (light_flag & PASSMASK(TRANSMISSION_DIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_transmission_direct, 4, scale);
+  if (light_flag & PASSMASK(SUBSURFACE_DIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_subsurface_direct, 4, scale);
+  if (light_flag & PASSMASK(VOLUME_DIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_volume_direct, 4, scale);
+
+  if (light_flag & PASSMASK(DIFFUSE_INDIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_diffuse_indirect, 4, scale);
+  if (light_flag & PASSMASK(GLOSSY_INDIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_glossy_indirect, 4, scale);
+  if (light_flag & PASSMASK(TRANSMISSION_INDIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_transmission_indirect, 4, scale);
+  if (light_flag & PASSMASK(SUBSURFACE_INDIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_subsurface_indirect, 4, scale);
+  if (light_flag & PASSMASK(VOLUME_INDIRECT))
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_volume_indirect, 4, scale);
+
+  /* AOVs of each type are stored next to each other, see svm_node_aov_*. */
+  for (int i = 0; i < kernel_data.film.num_aov_color; i++)
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_aov_color + 4 * i, 4, scale);
+  for (int i = 0; i < kernel_data.film.num_aov_value; i++)
+    kernel_adaptive_scale_pass(buffer + kernel_data.film.pass_aov_value + i, 1, scale);
+
+  /* Only the weights of cryptomatte ID/weight pairs are accumulated. */
+  if (kernel_data.film.cryptomatte_passes) {
+    int num_types = 0;
+    num_types += (kernel_data.film.cryptomatte_passes & CRYPT_OBJECT) ? 1 : 0;
+    num_types += (kernel_data.film.cryptomatte_passes & CRYPT_MATERIAL) ? 1 : 0;
+    num_types += (kernel_data.film.cryptomatte_passes & CRYPT_ASSET) ? 1 : 0;
+
+    const int num_slots = num_types * 2 * kernel_data.film.cryptomatte_depth;
+    ccl_global float *cryptomatte_buffer = buffer + kernel_data.film.pass_cryptomatte;
+    for (int i = 0; i < num_slots; i++) {
+      cryptomatte_buffer[i * 2 + 1] *= scale;
+    }
+  }
+#endif /* __PASSES__ */
+
+#ifdef __DENOISING_FEATURES__
+  /* Denoising features and their variances are plain sums as well. */
+  if (kernel_data.film.pass_denoising_data) {
+    kernel_adaptive_scale_pass(
+        buffer + kernel_data.film.pass_denoising_data, DENOISING_PASS_SIZE_BASE, scale);
+    if (kernel_data.film.pass_denoising_clean) {
+      kernel_adaptive_scale_pass(
+          buffer + kernel_data.film.pass_denoising_clean, DENOISING_PASS_SIZE_CLEAN, scale);
+    }
+  }
+#endif /* __DENOISING_FEATURES__ */
+}
+
+CCL_NAMESPACE_END
@@ -178,6 +178,18 @@ ccl_device float lamp_light_pdf(KernelGlobals *kg, const float3 Ng, const float3
   return t * t / cos_pi;
 }
 
+/* Probability of picking a lamp at the shading point. */
+
+ccl_device_inline float lamp_light_select_pdf(KernelGlobals *kg, int lamp, float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    const int num_triangles = kernel_data.integrator.num_distribution -
+                              kernel_data.integrator.num_all_lights;
+    return light_tree_pdf(kg, P, num_triangles + lamp);
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
 /* Background Light */
 
 #ifdef __BACKGROUND_MIS__
@@ -496,6 +508,16 @@ background_light_sample(KernelGlobals *kg, float3 P, float randu, float randv, f
   return D;
 }
 
+/* All background lights are picked with the same probability, regardless of
+ * the shading point. */
+ccl_device_inline float background_light_select_pdf(KernelGlobals *kg)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    return kernel_data.integrator.light_tree_infinite_pdf;
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
 ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direction)
 {
   /* Probability of sampling portals instead of the map. */
@@ -511,7 +533,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
        * If map sampling is possible, it would be used instead,
        * otherwise fallback sampling is used. */
       if (portal_sampling_pdf == 1.0f) {
-        return kernel_data.integrator.pdf_lights / M_4PI_F;
+        return background_light_select_pdf(kg) / M_4PI_F;
       }
       else {
         /* Force map sampling. */
@@ -523,7 +545,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
     /* Evaluate PDF of sampling this direction by map sampling. */
     map_pdf = background_map_pdf(kg, direction) * (1.0f - portal_sampling_pdf);
   }
-  return (portal_pdf + map_pdf) * kernel_data.integrator.pdf_lights;
+  return (portal_pdf + map_pdf) * background_light_select_pdf(kg);
 }
 #endif
 
@@ -645,7 +667,7 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= lamp_light_select_pdf(kg, lamp, P);
 
   return (ls->pdf > 0.0f);
 }
@@ -783,7 +805,7 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= lamp_light_select_pdf(kg, lamp, P);
 
   return true;
 }
@@ -822,12 +844,39 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
+/* Probability per area of picking the triangle at the shading point, over the
+ * area of the triangle at the center of the shutter. */
+ccl_device_inline float triangle_light_select_pdf(
+    KernelGlobals *kg, int object, int prim, const float3 P, const float3 V[3], bool has_motion)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    const int index = light_tree_triangle_index(kg, object, prim);
+    if (index == -1) {
+      return 0.0f;
+    }
+
+    float area;
+    if (has_motion) {
+      float3 V_center[3];
+      triangle_world_space_vertices(kg, object, prim, -1.0f, V_center);
+      area = triangle_area(V_center[0], V_center[1], V_center[2]);
+    }
+    else {
+      area = triangle_area(V[0], V[1], V[2]);
+    }
+
+    return (area > 0.0f) ? light_tree_pdf(kg, P, index) / area : 0.0f;
+  }
+
+  return kernel_data.integrator.pdf_triangles;
+}
+
 ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
                                                 const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float pdf)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -852,10 +901,13 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+  const float pdf_triangles = triangle_light_select_pdf(
+      kg, sd->object, sd->prim, Px, V, has_motion);
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -883,12 +935,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       else {
         area = 0.5f * len(N);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_triangles;
       return pdf / solid_angle;
     }
   }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t, pdf_triangles);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -944,6 +996,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
   ls->type = LIGHT_TRIANGLE;
 
   float distance_to_plane = fabsf(dot(N0, V[0] - P) / dot(N0, N0));
+  const float pdf_triangles = triangle_light_select_pdf(kg, object, prim, P, V, has_motion);
 
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
     /* see James Arvo, "Stratified Sampling of Spherical Triangles"
@@ -1036,7 +1089,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
         triangle_world_space_vertices(kg, object, prim, -1.0f, V);
         area = triangle_area(V[0], V[1], V[2]);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_triangles;
       ls->pdf = pdf / solid_angle;
     }
   }
@@ -1050,7 +1103,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
+    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t, pdf_triangles);
     if (has_motion && area != 0.0f) {
       /* scale the PDF.
        * area = the area the sample was taken from
@@ -1120,7 +1173,16 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 {
   if (lamp < 0) {
     /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+    int index;
+    if (kernel_data.integrator.use_light_tree) {
+      index = light_tree_sample(kg, P, &randu);
+      if (index == -1) {
+        return false;
+      }
+    }
+    else {
+      index = light_distribution_sample(kg, &randu);
+    }
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
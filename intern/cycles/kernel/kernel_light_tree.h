@@ -0,0 +1,180 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Picks a light from the distribution by traversing a hierarchy of emitters,
+ * choosing at each node the child with the larger estimated contribution to
+ * the shading point. The probability of picking an emitter depends only on
+ * the shading position, so that it can be evaluated again for MIS when the
+ * emitter is hit by a BSDF ray. Lights at infinity are picked uniformly,
+ * separately from the tree.
+ *
+ * Based on "Importance Sampling of Many Lights with Adaptive Tree Splitting",
+ * Conty Estevez and Kulla, 2018. */
+
+ccl_device float light_tree_node_importance(const ccl_global KernelLightTreeNode *knode,
+                                            const float3 P)
+{
+  if (knode->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]);
+  const float3 bbox_max = make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_squared = 0.25f * len_squared(bbox_max - bbox_min);
+
+  float distance;
+  const float3 D = normalize_len(P - centroid, &distance);
+  const float distance_squared = distance * distance;
+
+  /* Bound the angle between the emission directions and the direction to
+   * the shading point, unless it is inside the bounds. */
+  float orientation = 1.0f;
+  if (knode->theta_o < M_PI_F && distance_squared > radius_squared) {
+    const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+    const float theta = fast_acosf(clamp(dot(axis, D), -1.0f, 1.0f));
+    const float theta_u = fast_asinf(sqrtf(radius_squared / distance_squared));
+    const float theta_p = max(theta - knode->theta_o - theta_u, 0.0f);
+
+    if (theta_p >= knode->theta_e) {
+      return 0.0f;
+    }
+    orientation = fast_cosf(theta_p);
+  }
+
+  /* Distance says little about the contribution of emitters close to the
+   * shading point, clamp it to the size of the bounds. */
+  const float falloff = max(max(distance_squared, radius_squared), 1e-12f);
+
+  return knode->energy * orientation / falloff;
+}
+
+/* Probability of choosing the left child of a node. */
+ccl_device float light_tree_left_probability(KernelGlobals *kg, int node, const float3 P)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node);
+  const float left = light_tree_node_importance(
+      &kernel_tex_fetch(__light_tree_nodes, node + 1), P);
+  const float right = light_tree_node_importance(
+      &kernel_tex_fetch(__light_tree_nodes, knode->child_index), P);
+  const float total = left + right;
+
+  return (total > 0.0f) ? left / total : 0.5f;
+}
+
+/* Pick an emitter for the shading point, returning its index in the light
+ * distribution. The random number is rescaled for reuse. */
+ccl_device int light_tree_sample(KernelGlobals *kg, const float3 P, float *randu)
+{
+  float r = *randu;
+
+  /* Lights at infinity. */
+  const float infinite_probability = kernel_data.integrator.light_tree_infinite_probability;
+  if (r < infinite_probability) {
+    const int num_infinite = kernel_data.integrator.light_tree_num_infinite;
+    r = r / infinite_probability * num_infinite;
+    const int i = min((int)r, num_infinite - 1);
+    *randu = min(r - i, 1.0f - FLT_EPSILON);
+    const int offset = kernel_data.integrator.light_tree_infinite_offset;
+    return kernel_tex_fetch(__light_tree_prims, offset + i);
+  }
+  r = (r - infinite_probability) / (1.0f - infinite_probability);
+
+  /* Traverse down to a leaf. */
+  int node = 0;
+  while (kernel_tex_fetch(__light_tree_nodes, node).num_prims == 0) {
+    const float left_probability = light_tree_left_probability(kg, node, P);
+
+    if (r < left_probability || left_probability == 1.0f) {
+      r = r / left_probability;
+      node = node + 1;
+    }
+    else {
+      r = (r - left_probability) / (1.0f - left_probability);
+      node = kernel_tex_fetch(__light_tree_nodes, node).child_index;
+    }
+  }
+
+  /* Pick emitter in the leaf by energy. */
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node);
+  float energy = r * knode->energy;
+
+  for (int i = 0; i < knode->num_prims; i++) {
+    const int index = kernel_tex_fetch(__light_tree_prims, knode->child_index + i);
+    const float prim_energy = kernel_tex_fetch(__light_tree_emitters, index).energy;
+
+    if (energy < prim_energy || i == knode->num_prims - 1) {
+      *randu = clamp(energy / prim_energy, 0.0f, 1.0f - FLT_EPSILON);
+      return index;
+    }
+    energy -= prim_energy;
+  }
+
+  return -1;
+}
+
+/* Probability of picking the emitter with the given index in the light
+ * distribution at the shading point, matching light_tree_sample. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, const float3 P, int index)
+{
+  const KernelLightTreeEmitter emitter = kernel_tex_fetch(__light_tree_emitters, index);
+
+  if (emitter.node == LIGHT_TREE_NODE_INFINITE) {
+    return kernel_data.integrator.light_tree_infinite_pdf;
+  }
+  else if (emitter.node == LIGHT_TREE_NODE_NONE) {
+    return 0.0f;
+  }
+
+  const ccl_global KernelLightTreeNode *kleaf = &kernel_tex_fetch(__light_tree_nodes,
+                                                                   emitter.node);
+  float pdf = (1.0f - kernel_data.integrator.light_tree_infinite_probability) * emitter.energy /
+              kleaf->energy;
+
+  /* Traverse up to the root. */
+  int node = emitter.node;
+  int parent = kleaf->parent;
+
+  while (parent != -1) {
+    const float left_probability = light_tree_left_probability(kg, parent, P);
+    pdf *= (node == parent + 1) ? left_probability : 1.0f - left_probability;
+
+    node = parent;
+    parent = kernel_tex_fetch(__light_tree_nodes, node).parent;
+  }
+
+  return pdf;
+}
+
+/* Index in the light distribution of a triangle hit by a ray, or -1 if it is
+ * not part of the distribution. */
+ccl_device_inline int light_tree_triangle_index(KernelGlobals *kg, int object, int prim)
+{
+  /* Each object has the offset of its triangles in the table, zero if it has
+   * none, followed by the index of its first triangle. */
+  const int offset = kernel_tex_fetch(__light_tree_triangles, object * 2);
+  if (offset == 0) {
+    return -1;
+  }
+  const int prim_offset = kernel_tex_fetch(__light_tree_triangles, object * 2 + 1);
+  return kernel_tex_fetch(__light_tree_triangles, offset + prim - prim_offset);
+}
+
+CCL_NAMESPACE_END
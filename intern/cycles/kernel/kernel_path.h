@@ -30,6 +30,7 @@
 #include "kernel/kernel_write_passes.h"
 #include "kernel/kernel_accumulate.h"
 #include "kernel/kernel_shader.h"
+#include "kernel/kernel_light_tree.h"
 #include "kernel/kernel_light.h"
 #include "kernel/kernel_passes.h"
 
@@ -656,6 +657,15 @@ ccl_device void kernel_path_trace(
 
   buffer += index * pass_stride;
 
+  if (kernel_data.film.pass_adaptive_aux_buffer) {
+    if (buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] > 0.0f) {
+      return;
+    }
+  }
+  if (kernel_data.film.pass_sample_count) {
+    kernel_write_pass_float(buffer + kernel_data.film.pass_sample_count, 1.0f);
+  }
+
   /* Initialize random numbers and sample ray. */
   uint rng_hash;
   Ray ray;
@@ -523,6 +523,15 @@ ccl_device void kernel_branched_path_trace(
 
   buffer += index * pass_stride;
 
+  if (kernel_data.film.pass_adaptive_aux_buffer) {
+    if (buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] > 0.0f) {
+      return;
+    }
+  }
+  if (kernel_data.film.pass_sample_count) {
+    kernel_write_pass_float(buffer + kernel_data.film.pass_sample_count, 1.0f);
+  }
+
   /* initialize random numbers and ray */
   uint rng_hash;
   Ray ray;
@@ -375,6 +375,8 @@ typedef enum PassType {
   PASS_CRYPTOMATTE,
   PASS_AOV_COLOR,
   PASS_AOV_VALUE,
+  PASS_ADAPTIVE_AUX_BUFFER,
+  PASS_SAMPLE_COUNT,
   PASS_CATEGORY_MAIN_END = 31,
 
   PASS_MIST = 32,
@@ -1250,8 +1252,12 @@ typedef struct KernelFilm {
 
   int pass_aov_color;
   int pass_aov_value;
-  int pad1;
-  int pad2;
+  int pass_adaptive_aux_buffer;
+  int pass_sample_count;
+
+  int num_aov_color;
+  int num_aov_value;
+  int pad1, pad2;
 
   /* XYZ to rendering color space transform. float4 instead of float3 to
    * ensure consistent padding/alignment across devices. */
@@ -1365,7 +1371,18 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
-  int pad1;
+  /* light tree */
+  int use_light_tree;
+  int light_tree_num_infinite;
+  int light_tree_infinite_offset;
+  float light_tree_infinite_probability;
+  float light_tree_infinite_pdf;
+
+  /* adaptive sampling */
+  int use_adaptive_sampling;
+  int adaptive_min_samples;
+  int adaptive_step;
+  float adaptive_threshold;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1534,6 +1551,43 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Node of the light tree, a bounding volume hierarchy over the emitters in the
+ * light distribution used to pick lights by their estimated contribution to
+ * the shading point. */
+typedef struct KernelLightTreeNode {
+  /* Bounds of the emitters and their total energy. */
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  /* Bounds of the emission directions: normals are within theta_o of the
+   * axis, and each emits within theta_e of its normal. */
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* For inner nodes the index of the right child, the left child directly
+   * follows its parent. For leaves the first emitter in __light_tree_prims. */
+  int child_index;
+  /* Number of emitters in leaves, zero for inner nodes. */
+  int num_prims;
+  int parent;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+#define LIGHT_TREE_NODE_NONE -1
+#define LIGHT_TREE_NODE_INFINITE -2
+
+/* Light tree data for each primitive in the light distribution. */
+typedef struct KernelLightTreeEmitter {
+  float energy;
+  /* Leaf containing the emitter, LIGHT_TREE_NODE_INFINITE for distant and
+   * background lights which are picked outside of the tree, or
+   * LIGHT_TREE_NODE_NONE for emitters without energy. */
+  int node;
+  int pad1, pad2;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -19,6 +19,18 @@
 void KERNEL_FUNCTION_FULL_NAME(path_trace)(
     KernelGlobals *kg, float *buffer, int sample, int x, int y, int offset, int stride);
 
+void KERNEL_FUNCTION_FULL_NAME(adaptive_stopping)(
+    KernelGlobals *kg, float *buffer, int sample, int x, int y, int offset, int stride);
+
+bool KERNEL_FUNCTION_FULL_NAME(adaptive_filter_x)(
+    KernelGlobals *kg, float *buffer, int y, int start_x, int width, int offset, int stride);
+
+bool KERNEL_FUNCTION_FULL_NAME(adaptive_filter_y)(
+    KernelGlobals *kg, float *buffer, int x, int start_y, int height, int offset, int stride);
+
+void KERNEL_FUNCTION_FULL_NAME(adaptive_adjust_samples)(
+    KernelGlobals *kg, float *buffer, int sample, int x, int y, int offset, int stride);
+
 void KERNEL_FUNCTION_FULL_NAME(convert_to_byte)(KernelGlobals *kg,
                                                 uchar4 *rgba,
                                                 float *buffer,
@@ -17,6 +17,8 @@
 #ifndef __KERNEL_CPU_IMAGE_H__
 #define __KERNEL_CPU_IMAGE_H__
 
+#include "util/util_texture_cache.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -470,10 +472,43 @@ template<typename T> struct TextureInterpolator {
 #undef SET_CUBIC_SPLINE_WEIGHTS
 };
 
+/* Lookup through the texture cache, with the footprint given by derivatives of the
+ * coordinates for mipmap selection. */
+ccl_device float4 kernel_tex_image_interp_cache(
+    const TextureInfo &info, float x, float y, float2 dx, float2 dy)
+{
+  float result[4];
+
+  if (!texture_cache_lookup(
+          (const TextureCacheHandle *)info.data, x, y, dx.x, dx.y, dy.x, dy.y, result)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return make_float4(result[0], result[1], result[2], result[3]);
+}
+
+ccl_device_inline bool kernel_tex_image_use_cache(KernelGlobals *kg, int id)
+{
+  return kernel_tex_fetch(__texture_info, id).use_texture_cache;
+}
+
+ccl_device float4
+kernel_tex_image_interp_footprint(KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+  return kernel_tex_image_interp_cache(info, x, y, dx, dy);
+}
+
 ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, float y)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
 
+  if (info.use_texture_cache) {
+    return kernel_tex_image_interp_cache(
+        info, x, y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f));
+  }
+
   switch (kernel_tex_type(id)) {
     case IMAGE_DATA_TYPE_HALF:
       return TextureInterpolator<half>::interp(info, x, y);
@@ -18,14 +18,26 @@ CCL_NAMESPACE_BEGIN
 
 #ifdef __TEXTURES__
 
-ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+/* Derivatives of the texture coordinate are used as footprint to select the mipmap level,
+ * for images read through the texture cache. Zero uses the full resolution. */
+ccl_device float4 svm_image_texture_footprint(
+    KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy, uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
+  float4 r;
+#  ifdef __KERNEL_CPU__
+  if (kernel_tex_image_use_cache(kg, id)) {
+    r = kernel_tex_image_interp_footprint(kg, id, x, y, dx, dy);
+  }
+  else
+#  endif
+  {
+    r = kernel_tex_image_interp(kg, id, x, y);
+  }
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -44,6 +56,33 @@ ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y,
   return r;
 }
 
+ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+{
+  return svm_image_texture_footprint(
+      kg, id, x, y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f), flags);
+}
+
+#  ifdef __KERNEL_CPU__
+/* Screen space derivatives of the default UV map, as footprint for images read through the
+ * texture cache. The texture coordinate may come from another UV map or be transformed, so
+ * this is only an estimate for the common case. */
+ccl_device_inline void svm_image_uv_differentials(KernelGlobals *kg,
+                                                  ShaderData *sd,
+                                                  float2 *dx,
+                                                  float2 *dy)
+{
+  *dx = make_float2(0.0f, 0.0f);
+  *dy = make_float2(0.0f, 0.0f);
+
+#    ifdef __RAY_DIFFERENTIALS__
+  const AttributeDescriptor desc = find_attribute(kg, sd, ATTR_STD_UV);
+  if (desc.offset != ATTR_STD_NOT_FOUND) {
+    primitive_surface_attribute_float2(kg, sd, desc, dx, dy);
+  }
+#    endif
+}
+#  endif
+
 /* Remap coordnate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
@@ -114,7 +153,14 @@ ccl_device void svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float2 dx = make_float2(0.0f, 0.0f), dy = make_float2(0.0f, 0.0f);
+#  ifdef __KERNEL_CPU__
+  if (id != -1 && node.w == NODE_IMAGE_PROJ_FLAT && kernel_tex_image_use_cache(kg, id)) {
+    svm_image_uv_differentials(kg, sd, &dx, &dy);
+  }
+#  endif
+
+  float4 f = svm_image_texture_footprint(kg, id, tex_co.x, tex_co.y, dx, dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
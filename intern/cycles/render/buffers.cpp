@@ -122,6 +122,9 @@ RenderTile::RenderTile()
   offset = 0;
   stride = 0;
 
+  skipped_pixel_samples = 0;
+  converged = false;
+
   buffer = 0;
 
   buffers = NULL;
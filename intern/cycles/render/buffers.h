@@ -142,6 +142,11 @@ class RenderTile {
   int stride;
   int tile_index;
 
+  /* Adaptive sampling: pixel samples skipped for converged pixels, and
+   * whether the whole tile converged before its last sample. */
+  uint64_t skipped_pixel_samples;
+  bool converged;
+
   device_ptr buffer;
   int device_size;
 
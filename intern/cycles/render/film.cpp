@@ -196,6 +196,13 @@ void Pass::add(PassType type, vector<Pass> &passes, const char *name)
     case PASS_AOV_VALUE:
       pass.components = 1;
       break;
+    case PASS_ADAPTIVE_AUX_BUFFER:
+      pass.components = 4;
+      break;
+    case PASS_SAMPLE_COUNT:
+      pass.components = 1;
+      pass.filter = false;
+      break;
     default:
       assert(false);
       break;
@@ -361,6 +368,11 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
   kfilm->pass_stride = 0;
   kfilm->use_light_pass = use_light_visibility;
 
+  kfilm->pass_adaptive_aux_buffer = 0;
+  kfilm->pass_sample_count = 0;
+  kfilm->num_aov_color = 0;
+  kfilm->num_aov_value = 0;
+
   bool have_cryptomatte = false, have_aov_color = false, have_aov_value = false;
 
   for (size_t i = 0; i < passes.size(); i++) {
@@ -503,12 +515,20 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
           kfilm->pass_aov_color = kfilm->pass_stride;
           have_aov_color = true;
         }
+        kfilm->num_aov_color++;
         break;
       case PASS_AOV_VALUE:
         if (!have_aov_value) {
           kfilm->pass_aov_value = kfilm->pass_stride;
           have_aov_value = true;
         }
+        kfilm->num_aov_value++;
+        break;
+      case PASS_ADAPTIVE_AUX_BUFFER:
+        kfilm->pass_adaptive_aux_buffer = kfilm->pass_stride;
+        break;
+      case PASS_SAMPLE_COUNT:
+        kfilm->pass_sample_count = kfilm->pass_stride;
         break;
       default:
         assert(false);
@@ -104,6 +104,8 @@ ImageManager::ImageManager(const DeviceInfo &info)
   max_num_images = TEX_NUM_MAX;
   has_half_images = info.has_half_images;
 
+  texture_cache_supported = (info.type == DEVICE_CPU);
+
   for (size_t type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
     tex_num_images[type] = 0;
   }
@@ -502,6 +504,39 @@ static bool image_associate_alpha(ImageManager::Image *img)
            img->alpha_type == IMAGE_ALPHA_IGNORE || img->alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
 }
 
+static bool image_use_texture_cache(ImageManager::Image *img)
+{
+  /* Only images which need no processing other than what the texture cache and kernel
+   * do, since the texture cache reads the file as is. */
+  return !img->builtin_data && img->metadata.depth <= 1 &&
+         (img->metadata.colorspace == u_colorspace_raw ||
+          img->metadata.colorspace == u_colorspace_srgb) &&
+         image_associate_alpha(img) && img->metadata.channels >= 1 &&
+         img->metadata.channels <= 4;
+}
+
+template<typename DeviceType>
+bool ImageManager::texture_cache_load_image(Image *img, device_vector<DeviceType> &tex_img)
+{
+  if (!texture_cache || !image_use_texture_cache(img)) {
+    return false;
+  }
+
+  TextureCacheHandle *handle = texture_cache->get_handle(
+      img->filename, img->interpolation, img->extension);
+  if (!handle) {
+    return false;
+  }
+
+  /* Pixels are looked up through the cache, only allocate a placeholder. */
+  thread_scoped_lock device_lock(device_mutex);
+  DeviceType *pixels = tex_img.alloc(1, 1);
+  memset(pixels, 0, sizeof(DeviceType));
+  tex_img.texture_cache_handle = handle;
+
+  return true;
+}
+
 bool ImageManager::file_load_image_generic(Image *img, unique_ptr<ImageInput> *in)
 {
   if (img->filename == "")
@@ -796,6 +831,11 @@ void ImageManager::device_load_image(
 
   /* Free previous texture in slot. */
   if (img->mem) {
+    if (img->mem->texture_cache_handle) {
+      /* File may have changed on disk. */
+      texture_cache->invalidate(img->filename);
+    }
+
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
     img->mem = NULL;
@@ -806,7 +846,8 @@ void ImageManager::device_load_image(
     device_vector<float4> *tex_img = new device_vector<float4>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::FLOAT, float>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::FLOAT, float>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       float *pixels = (float *)tex_img->alloc(1, 1);
@@ -828,7 +869,8 @@ void ImageManager::device_load_image(
     device_vector<float> *tex_img = new device_vector<float>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::FLOAT, float>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::FLOAT, float>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       float *pixels = (float *)tex_img->alloc(1, 1);
@@ -847,7 +889,8 @@ void ImageManager::device_load_image(
     device_vector<uchar4> *tex_img = new device_vector<uchar4>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::UINT8, uchar>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::UINT8, uchar>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       uchar *pixels = (uchar *)tex_img->alloc(1, 1);
@@ -869,7 +912,8 @@ void ImageManager::device_load_image(
     device_vector<uchar> *tex_img = new device_vector<uchar>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::UINT8, uchar>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::UINT8, uchar>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       uchar *pixels = (uchar *)tex_img->alloc(1, 1);
@@ -888,7 +932,8 @@ void ImageManager::device_load_image(
     device_vector<half4> *tex_img = new device_vector<half4>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::HALF, half>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::HALF, half>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       half *pixels = (half *)tex_img->alloc(1, 1);
@@ -910,7 +955,8 @@ void ImageManager::device_load_image(
     device_vector<uint16_t> *tex_img = new device_vector<uint16_t>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::USHORT, uint16_t>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::USHORT, uint16_t>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       uint16_t *pixels = (uint16_t *)tex_img->alloc(1, 1);
@@ -929,7 +975,8 @@ void ImageManager::device_load_image(
     device_vector<ushort4> *tex_img = new device_vector<ushort4>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::USHORT, uint16_t>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::USHORT, uint16_t>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       uint16_t *pixels = (uint16_t *)tex_img->alloc(1, 1);
@@ -951,7 +998,8 @@ void ImageManager::device_load_image(
     device_vector<half> *tex_img = new device_vector<half>(
         device, img->mem_name.c_str(), MEM_TEXTURE);
 
-    if (!file_load_image<TypeDesc::HALF, half>(img, type, texture_limit, *tex_img)) {
+    if (!texture_cache_load_image(img, *tex_img) &&
+        !file_load_image<TypeDesc::HALF, half>(img, type, texture_limit, *tex_img)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       half *pixels = (half *)tex_img->alloc(1, 1);
@@ -982,6 +1030,10 @@ void ImageManager::device_free_image(Device *, ImageDataType type, int slot)
     }
 
     if (img->mem) {
+      if (img->mem->texture_cache_handle) {
+        texture_cache->invalidate(img->filename);
+      }
+
       thread_scoped_lock device_lock(device_mutex);
       delete img->mem;
     }
@@ -992,12 +1044,26 @@ void ImageManager::device_free_image(Device *, ImageDataType type, int slot)
   }
 }
 
+void ImageManager::texture_cache_init(Scene *scene)
+{
+  /* OSL has its own texture system for image files. */
+  if (texture_cache || !texture_cache_supported || osl_texture_system ||
+      scene->params.texture_cache_size <= 0) {
+    return;
+  }
+
+  VLOG(1) << "Using texture cache with " << scene->params.texture_cache_size << "MB budget.";
+  texture_cache.reset(new TextureCache((size_t)scene->params.texture_cache_size * 1024 * 1024));
+}
+
 void ImageManager::device_update(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update) {
     return;
   }
 
+  texture_cache_init(scene);
+
   TaskPool pool;
   for (int type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
     for (size_t slot = 0; slot < images[type].size(); slot++) {
@@ -1036,6 +1102,8 @@ void ImageManager::device_update_slot(Device *device,
   Image *image = images[type][slot];
   assert(image != NULL);
 
+  texture_cache_init(scene);
+
   if (image->users == 0) {
     device_free_image(device, type, slot);
   }
@@ -1094,6 +1162,8 @@ void ImageManager::device_free(Device *device)
     }
     images[type].clear();
   }
+
+  texture_cache.reset();
 }
 
 void ImageManager::collect_statistics(RenderStats *stats)
@@ -1102,8 +1172,23 @@ void ImageManager::collect_statistics(RenderStats *stats)
     foreach (const Image *image, images[type]) {
       stats->image.textures.add_entry(
           NamedSizeEntry(path_filename(image->filename), image->mem->memory_size()));
+
+      if (image->mem->texture_cache_handle) {
+        stats->image.texture_cache.memory_full += image->metadata.width *
+                                                  image->metadata.height *
+                                                  image->mem->memory_elements_size(1);
+      }
     }
   }
+
+  if (texture_cache) {
+    const TextureCache::Statistics cache_stats = texture_cache->get_statistics();
+    stats->image.texture_cache.used = true;
+    stats->image.texture_cache.lookups = cache_stats.lookups;
+    stats->image.texture_cache.misses = cache_stats.misses;
+    stats->image.texture_cache.memory_used = cache_stats.memory_used;
+    stats->image.texture_cache.bytes_read = cache_stats.bytes_read;
+  }
 }
 
 CCL_NAMESPACE_END
@@ -24,6 +24,7 @@
 
 #include "util/util_image.h"
 #include "util/util_string.h"
+#include "util/util_texture_cache.h"
 #include "util/util_thread.h"
 #include "util/util_unique_ptr.h"
 #include "util/util_vector.h"
@@ -175,8 +176,15 @@ class ImageManager {
   vector<Image *> images[IMAGE_DATA_NUM_TYPES];
   void *osl_texture_system;
 
+  /* Out-of-core cache for image files, only supported when rendering on the CPU. */
+  bool texture_cache_supported;
+  unique_ptr<TextureCache> texture_cache;
+
   bool file_load_image_generic(Image *img, unique_ptr<ImageInput> *in);
 
+  template<typename DeviceType>
+  bool texture_cache_load_image(Image *img, device_vector<DeviceType> &tex_img);
+
   template<TypeDesc::BASETYPE FileFormat, typename StorageType, typename DeviceType>
   bool file_load_image(Image *img,
                        ImageDataType type,
@@ -185,6 +193,8 @@ class ImageManager {
 
   void metadata_detect_colorspace(ImageMetaData &metadata, const char *file_format);
 
+  void texture_cache_init(Scene *scene);
+
   void device_load_image(
       Device *device, Scene *scene, ImageDataType type, int slot, Progress *progress);
   void device_free_image(Device *device, ImageDataType type, int slot);
@@ -69,6 +69,10 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
   SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
+  SOCKET_BOOLEAN(use_adaptive_sampling, "Use Adaptive Sampling", false);
+  SOCKET_FLOAT(adaptive_threshold, "Adaptive Threshold", 0.01f);
+  SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 0);
 
   static NodeEnum method_enum;
   method_enum.insert("path", PATH);
@@ -182,6 +186,20 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
     kintegrator->light_inv_rr_threshold = 0.0f;
   }
 
+  /* Adaptive sampling checks for convergence every few samples, after a
+   * minimum number of samples that defaults to the square root of the total
+   * so that rare paths have a chance to show up first. */
+  kintegrator->use_adaptive_sampling = use_adaptive_sampling &&
+                                       device->info.has_adaptive_sampling;
+  kintegrator->adaptive_step = 4;
+  kintegrator->adaptive_threshold = adaptive_threshold;
+  if (adaptive_min_samples > 0) {
+    kintegrator->adaptive_min_samples = adaptive_min_samples;
+  }
+  else {
+    kintegrator->adaptive_min_samples = max(4, (int)sqrtf((float)aa_samples));
+  }
+
   /* sobol directions table */
   int max_samples = 1;
 
@@ -222,8 +240,20 @@ bool Integrator::modified(const Integrator &integrator)
   return !Node::equals(integrator);
 }
 
+bool Integrator::use_light_tree_sampling() const
+{
+  if (method == BRANCHED_PATH && (sample_all_lights_direct || sample_all_lights_indirect)) {
+    return false;
+  }
+  return use_light_tree;
+}
+
 void Integrator::tag_update(Scene *scene)
 {
+  if (use_light_tree_sampling() != scene->light_manager->use_light_tree) {
+    scene->light_manager->tag_update(scene);
+  }
+
   foreach (Shader *shader, scene->shaders) {
     if (shader->has_integrator_dependency) {
       scene->shader_manager->need_update = true;
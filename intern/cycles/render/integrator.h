@@ -74,6 +74,11 @@ class Integrator : public Node {
   bool sample_all_lights_direct;
   bool sample_all_lights_indirect;
   float light_sampling_threshold;
+  bool use_light_tree;
+
+  bool use_adaptive_sampling;
+  float adaptive_threshold;
+  int adaptive_min_samples;
 
   enum Method {
     BRANCHED_PATH = 0,
@@ -95,6 +100,9 @@ class Integrator : public Node {
   void device_free(Device *device, DeviceScene *dscene);
 
   bool modified(const Integrator &integrator);
+  /* Light tree is not used when sampling all lights, which relies on the
+   * probabilities of the light distribution. */
+  bool use_light_tree_sampling() const;
   void tag_update(Scene *scene);
 };
 
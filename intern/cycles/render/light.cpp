@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/light.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -182,6 +183,7 @@ LightManager::LightManager()
 {
   need_update = true;
   use_light_visibility = false;
+  use_light_tree = false;
 }
 
 LightManager::~LightManager()
@@ -257,6 +259,48 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Estimate of the power emitted per area by a shader, for the light tree.
+ * Emission varying over the surface is not known in advance, assume unit
+ * strength for it. */
+static float light_tree_shader_emission(Shader *shader)
+{
+  float3 emission;
+  if (shader->is_constant_emission(&emission)) {
+    return max(average(emission), 0.0f);
+  }
+  return 1.0f;
+}
+
+static LightTreePrimitive light_tree_lamp_primitive(const Light *light, int index)
+{
+  LightTreePrimitive prim;
+  prim.index = index;
+  prim.bbox = BoundBox::empty;
+  prim.energy = max(average(light->strength), 0.0f);
+
+  if (light->type == LIGHT_AREA) {
+    const float3 axisu = light->axisu * (light->sizeu * light->size * 0.5f);
+    const float3 axisv = light->axisv * (light->sizev * light->size * 0.5f);
+    prim.bbox.grow(light->co - axisu - axisv);
+    prim.bbox.grow(light->co - axisu + axisv);
+    prim.bbox.grow(light->co + axisu - axisv);
+    prim.bbox.grow(light->co + axisu + axisv);
+    /* Area lights emit to one side only. */
+    prim.cone = LightTreeCone(safe_normalize(light->dir), 0.0f, M_PI_2_F);
+  }
+  else {
+    prim.bbox.grow(light->co, light->size);
+    if (light->type == LIGHT_SPOT) {
+      prim.cone = LightTreeCone(safe_normalize(light->dir), light->spot_angle * 0.5f, M_PI_2_F);
+    }
+    else {
+      prim.cone = LightTreeCone(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+    }
+  }
+
+  return prim;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -272,6 +316,16 @@ void LightManager::device_update_distribution(Device *,
 
   bool background_mis = false;
 
+  /* Emitters for the light tree, when used. */
+  const bool build_light_tree = scene->integrator->use_light_tree_sampling();
+  vector<LightTreePrimitive> tree_prims;
+  vector<uint> tree_infinite;
+  vector<int> tree_triangles;
+
+  if (build_light_tree) {
+    tree_triangles.resize(scene->objects.size() * 2, 0);
+  }
+
   foreach (Light *light, scene->lights) {
     if (light->is_enabled) {
       num_lights++;
@@ -348,6 +402,24 @@ void LightManager::device_update_distribution(Device *,
     }
 
     size_t mesh_num_triangles = mesh->num_triangles();
+
+    /* Map from triangles of the object to the light distribution, to find
+     * the probability of picking a triangle that was hit. */
+    int tree_triangles_offset = 0;
+    vector<float> tree_emission;
+
+    if (build_light_tree) {
+      tree_triangles_offset = tree_triangles.size();
+      tree_triangles[object_id * 2] = tree_triangles_offset;
+      tree_triangles[object_id * 2 + 1] = mesh->prim_offset;
+      tree_triangles.resize(tree_triangles_offset + mesh_num_triangles, -1);
+
+      foreach (Shader *shader, mesh->used_shaders) {
+        tree_emission.push_back(light_tree_shader_emission(shader));
+      }
+      tree_emission.push_back(light_tree_shader_emission(scene->default_surface));
+    }
+
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->shader[i];
       Shader *shader = (shader_index < mesh->used_shaders.size()) ?
@@ -355,6 +427,10 @@ void LightManager::device_update_distribution(Device *,
                            scene->default_surface;
 
       if (shader->use_mis && shader->has_surface_emission) {
+        if (build_light_tree) {
+          tree_triangles[tree_triangles_offset + i] = offset;
+        }
+
         distribution[offset].totarea = totarea;
         distribution[offset].prim = i + mesh->prim_offset;
         distribution[offset].mesh_light.shader_flag = shader_flag;
@@ -375,7 +451,24 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (build_light_tree) {
+          LightTreePrimitive prim;
+          prim.index = offset - 1;
+          prim.bbox = BoundBox::empty;
+          prim.bbox.grow(p1);
+          prim.bbox.grow(p2);
+          prim.bbox.grow(p3);
+          /* Mesh lights emit from both sides. */
+          prim.cone = LightTreeCone(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+          prim.energy = area * tree_emission[min(shader_index, (int)mesh->used_shaders.size())];
+
+          if (prim.energy > 0.0f) {
+            tree_prims.push_back(prim);
+          }
+        }
       }
     }
 
@@ -399,6 +492,18 @@ void LightManager::device_update_distribution(Device *,
     distribution[offset].lamp.size = light->size;
     totarea += lightarea;
 
+    if (build_light_tree) {
+      if (light->type == LIGHT_DISTANT || light->type == LIGHT_BACKGROUND) {
+        tree_infinite.push_back(offset);
+      }
+      else {
+        LightTreePrimitive prim = light_tree_lamp_primitive(light, offset);
+        if (prim.energy > 0.0f) {
+          tree_prims.push_back(prim);
+        }
+      }
+    }
+
     if (light->type == LIGHT_DISTANT) {
       use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
     }
@@ -475,6 +580,14 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    if (build_light_tree) {
+      device_update_tree(dscene, num_distribution, tree_prims, tree_infinite, tree_triangles);
+    }
+    else {
+      kintegrator->use_light_tree = false;
+    }
+
     /* Portals */
     if (num_portals > 0) {
       kintegrator->portal_offset = light_index;
@@ -498,9 +611,103 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->num_portals = 0;
     kintegrator->portal_offset = 0;
     kintegrator->portal_pdf = 0.0f;
+    kintegrator->use_light_tree = false;
 
     kfilm->pass_shadow_scale = 1.0f;
   }
+
+  use_light_tree = build_light_tree;
+}
+
+void LightManager::device_update_tree(DeviceScene *dscene,
+                                      size_t num_distribution,
+                                      vector<LightTreePrimitive> &prims,
+                                      const vector<uint> &infinite,
+                                      const vector<int> &triangles)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+
+  if (prims.empty() && infinite.empty()) {
+    kintegrator->use_light_tree = false;
+    return;
+  }
+
+  double time_start = time_dt();
+
+  LightTree tree(prims);
+
+  /* Nodes. */
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(max(tree.nodes.size(), (size_t)1));
+  if (tree.nodes.empty()) {
+    memset(knodes, 0, sizeof(KernelLightTreeNode));
+  }
+  else {
+    memcpy(knodes, tree.nodes.data(), sizeof(KernelLightTreeNode) * tree.nodes.size());
+  }
+
+  /* Emitters, in leaf order followed by infinite lights. */
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_distribution);
+  uint *kprims = dscene->light_tree_prims.alloc(prims.size() + infinite.size());
+
+  for (size_t i = 0; i < num_distribution; i++) {
+    kemitters[i].energy = 0.0f;
+    kemitters[i].node = LIGHT_TREE_NODE_NONE;
+    kemitters[i].pad1 = 0;
+    kemitters[i].pad2 = 0;
+  }
+
+  for (size_t node = 0; node < tree.nodes.size(); node++) {
+    const KernelLightTreeNode &knode = tree.nodes[node];
+    for (int i = 0; i < knode.num_prims; i++) {
+      const LightTreePrimitive &prim = prims[knode.child_index + i];
+      kemitters[prim.index].energy = prim.energy;
+      kemitters[prim.index].node = node;
+    }
+  }
+
+  for (size_t i = 0; i < prims.size(); i++) {
+    kprims[i] = prims[i].index;
+  }
+
+  for (size_t i = 0; i < infinite.size(); i++) {
+    kemitters[infinite[i]].node = LIGHT_TREE_NODE_INFINITE;
+    kprims[prims.size() + i] = infinite[i];
+  }
+
+  /* Triangle lookup. */
+  int *ktriangles = dscene->light_tree_triangles.alloc(max(triangles.size(), (size_t)1));
+  if (triangles.empty()) {
+    ktriangles[0] = 0;
+  }
+  else {
+    memcpy(ktriangles, triangles.data(), sizeof(int) * triangles.size());
+  }
+
+  /* Without better estimate of their contribution, pick lights at infinity
+   * and those in the tree with equal probability. */
+  float infinite_probability = 0.0f;
+  if (prims.empty()) {
+    infinite_probability = 1.0f;
+  }
+  else if (!infinite.empty()) {
+    infinite_probability = 0.5f;
+  }
+
+  kintegrator->use_light_tree = true;
+  kintegrator->light_tree_num_infinite = infinite.size();
+  kintegrator->light_tree_infinite_offset = prims.size();
+  kintegrator->light_tree_infinite_probability = infinite_probability;
+  kintegrator->light_tree_infinite_pdf = (infinite.empty()) ?
+                                             0.0f :
+                                             infinite_probability / infinite.size();
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+  dscene->light_tree_prims.copy_to_device();
+  dscene->light_tree_triangles.copy_to_device();
+
+  VLOG(1) << "Light tree with " << tree.nodes.size() << " nodes for " << prims.size()
+          << " emitters built in " << time_dt() - time_start << " seconds.";
 }
 
 static void background_cdf(
@@ -937,6 +1144,10 @@ void LightManager::device_free(Device *, DeviceScene *dscene)
   dscene->lights.free();
   dscene->light_background_marginal_cdf.free();
   dscene->light_background_conditional_cdf.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->light_tree_prims.free();
+  dscene->light_tree_triangles.free();
   dscene->ies_lights.free();
 }
 
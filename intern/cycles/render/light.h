@@ -34,6 +34,7 @@ class Object;
 class Progress;
 class Scene;
 class Shader;
+struct LightTreePrimitive;
 
 class Light : public Node {
  public:
@@ -86,6 +87,7 @@ class Light : public Node {
 class LightManager {
  public:
   bool use_light_visibility;
+  bool use_light_tree;
   bool need_update;
 
   LightManager();
@@ -116,6 +118,11 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_tree(DeviceScene *dscene,
+                          size_t num_distribution,
+                          vector<LightTreePrimitive> &prims,
+                          const vector<uint> &infinite,
+                          const vector<int> &triangles);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Cone */
+
+void LightTreeCone::grow(const LightTreeCone &other)
+{
+  if (other.empty()) {
+    return;
+  }
+  if (empty()) {
+    *this = other;
+    return;
+  }
+
+  /* See "Importance Sampling of Many Lights with Adaptive Tree Splitting",
+   * Conty Estevez and Kulla, 2018. */
+  const float new_theta_e = max(theta_e, other.theta_e);
+
+  LightTreeCone a = *this;
+  LightTreeCone b = other;
+  if (b.theta_o > a.theta_o) {
+    swap(a, b);
+  }
+
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    /* Wider cone contains the other. */
+    *this = LightTreeCone(a.axis, a.theta_o, new_theta_e);
+    return;
+  }
+
+  const float new_theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  const float3 ortho = b.axis - a.axis * dot(a.axis, b.axis);
+
+  if (new_theta_o >= M_PI_F || len_squared(ortho) < 1e-12f) {
+    *this = LightTreeCone(a.axis, M_PI_F, new_theta_e);
+    return;
+  }
+
+  /* Rotate axis of the wider cone towards the other, so both fit. */
+  const float theta_r = new_theta_o - a.theta_o;
+  const float3 new_axis = normalize(a.axis * cosf(theta_r) + normalize(ortho) * sinf(theta_r));
+
+  *this = LightTreeCone(new_axis, new_theta_o, new_theta_e);
+}
+
+/* Tree */
+
+LightTree::LightTree(vector<LightTreePrimitive> &prims) : prims(prims)
+{
+  if (prims.empty()) {
+    return;
+  }
+
+  nodes.reserve(2 * prims.size() / MAX_LEAF_PRIMS + 1);
+  recursive_build(-1, 0, prims.size());
+}
+
+int LightTree::recursive_build(int parent, int start, int end)
+{
+  const int node_index = nodes.size();
+  nodes.push_back(KernelLightTreeNode());
+
+  /* Compute bounds. */
+  BoundBox bbox = BoundBox::empty;
+  BoundBox centroid_bbox = BoundBox::empty;
+  LightTreeCone cone;
+  double energy = 0.0;
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &prim = prims[i];
+    bbox.grow(prim.bbox);
+    centroid_bbox.grow(prim.bbox.center());
+    cone.grow(prim.cone);
+    energy += prim.energy;
+  }
+
+  KernelLightTreeNode knode;
+  knode.bbox_min[0] = bbox.min.x;
+  knode.bbox_min[1] = bbox.min.y;
+  knode.bbox_min[2] = bbox.min.z;
+  knode.bbox_max[0] = bbox.max.x;
+  knode.bbox_max[1] = bbox.max.y;
+  knode.bbox_max[2] = bbox.max.z;
+  knode.energy = (float)energy;
+  knode.axis[0] = cone.axis.x;
+  knode.axis[1] = cone.axis.y;
+  knode.axis[2] = cone.axis.z;
+  knode.theta_o = cone.theta_o;
+  knode.theta_e = cone.theta_e;
+  knode.parent = parent;
+  knode.pad = 0;
+
+  const int num_prims = end - start;
+
+  if (num_prims <= MAX_LEAF_PRIMS) {
+    knode.child_index = start;
+    knode.num_prims = num_prims;
+    nodes[node_index] = knode;
+    return node_index;
+  }
+
+  /* Split in the middle of the largest dimension of the centroid bounds. */
+  const float3 extent = centroid_bbox.size();
+  int dim = 0;
+  if (extent.y > extent[dim]) {
+    dim = 1;
+  }
+  if (extent.z > extent[dim]) {
+    dim = 2;
+  }
+
+  int mid = start;
+  if (extent[dim] > 0.0f) {
+    const float split = centroid_bbox.center()[dim];
+    mid = std::partition(prims.begin() + start,
+                         prims.begin() + end,
+                         [dim, split](const LightTreePrimitive &prim) {
+                           return prim.bbox.center()[dim] < split;
+                         }) -
+          prims.begin();
+  }
+
+  if (mid == start || mid == end) {
+    /* Fall back to splitting at the median, for coincident centroids. */
+    mid = (start + end) / 2;
+    if (extent[dim] > 0.0f) {
+      std::nth_element(prims.begin() + start,
+                       prims.begin() + mid,
+                       prims.begin() + end,
+                       [dim](const LightTreePrimitive &a, const LightTreePrimitive &b) {
+                         return a.bbox.center()[dim] < b.bbox.center()[dim];
+                       });
+    }
+  }
+
+  knode.num_prims = 0;
+  nodes[node_index] = knode;
+
+  recursive_build(node_index, start, mid);
+  nodes[node_index].child_index = recursive_build(node_index, mid, end);
+
+  return node_index;
+}
+
+CCL_NAMESPACE_END
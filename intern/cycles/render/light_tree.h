@@ -0,0 +1,90 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bounds of emission directions, as a cone of normals around an axis and the
+ * angle each of those normals emits in. */
+
+struct LightTreeCone {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  LightTreeCone() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(-1.0f), theta_e(0.0f)
+  {
+  }
+
+  LightTreeCone(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  bool empty() const
+  {
+    return theta_o < 0.0f;
+  }
+
+  void grow(const LightTreeCone &other);
+};
+
+/* Emitter from the light distribution to be sorted into the tree. */
+
+struct LightTreePrimitive {
+  /* Index in the light distribution. */
+  int index;
+  BoundBox bbox;
+  LightTreeCone cone;
+  float energy;
+};
+
+/* Light Tree
+ *
+ * Bounding volume hierarchy over emitters with finite position, where every
+ * node stores the total energy and the bounds of positions and emission
+ * directions of the emitters below it. The kernel traverses it from the root,
+ * choosing children proportional to their estimated contribution to the
+ * shading point, which gives much lower noise than picking lights by area
+ * alone in scenes with many lights. */
+
+class LightTree {
+ public:
+  /* Maximum number of emitters in a leaf, chosen between by energy only. */
+  static const int MAX_LEAF_PRIMS = 4;
+
+  explicit LightTree(vector<LightTreePrimitive> &prims);
+
+  /* Nodes in depth first order, the root is the first node. */
+  vector<KernelLightTreeNode> nodes;
+  /* Primitives referenced by the leaves, reordered to be contiguous. */
+  vector<LightTreePrimitive> &prims;
+
+ protected:
+  int recursive_build(int parent, int start, int end);
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -107,6 +107,10 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<uint> light_tree_prims;
+  device_vector<int> light_tree_triangles;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -169,6 +173,9 @@ class SceneParams {
   int num_bvh_time_steps;
   bool persistent_data;
   int texture_limit;
+  /* Memory budget in megabytes for reading image files through the texture cache,
+   * 0 loads images fully. Only used for CPU rendering. */
+  int texture_cache_size;
 
   bool background;
 
@@ -182,6 +189,7 @@ class SceneParams {
     num_bvh_time_steps = 0;
     persistent_data = false;
     texture_limit = 0;
+    texture_cache_size = 0;
     background = true;
   }
 
@@ -192,7 +200,8 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             texture_cache_size == params.texture_cache_size);
   }
 };
 
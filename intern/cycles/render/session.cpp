@@ -400,6 +400,8 @@ bool Session::acquire_tile(Device *tile_device, RenderTile &rtile)
   rtile.resolution = tile_manager.state.resolution_divider;
   rtile.tile_index = tile->index;
   rtile.task = (tile->state == Tile::DENOISE) ? RenderTile::DENOISE : RenderTile::PATH_TRACE;
+  rtile.skipped_pixel_samples = 0;
+  rtile.converged = false;
 
   tile_lock.unlock();
 
@@ -465,6 +467,15 @@ void Session::release_tile(RenderTile &rtile)
 
   progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
 
+  if (rtile.task == RenderTile::PATH_TRACE && adaptive_sampling_stats.used) {
+    adaptive_sampling_stats.pixel_samples += (uint64_t)rtile.w * rtile.h * rtile.num_samples;
+    adaptive_sampling_stats.skipped_pixel_samples += rtile.skipped_pixel_samples;
+    adaptive_sampling_stats.num_tiles++;
+    if (rtile.converged) {
+      adaptive_sampling_stats.num_converged_tiles++;
+    }
+  }
+
   bool delete_tile;
 
   if (tile_manager.finish_tile(rtile.tile_index, delete_tile)) {
@@ -823,6 +834,8 @@ void Session::reset_(BufferParams &buffer_params, int samples)
   tile_manager.reset(buffer_params, samples);
   progress.reset_sample();
 
+  adaptive_sampling_stats = AdaptiveSamplingStats();
+
   bool show_progress = params.background || tile_manager.get_num_effective_samples() != INT_MAX;
   progress.set_total_pixel_samples(show_progress ? tile_manager.state.total_pixel_samples : 0);
 
@@ -899,11 +912,12 @@ bool Session::update_scene()
   }
 
   /* number of samples is needed by multi jittered
-   * sampling pattern and by baking */
+   * sampling pattern, by baking and by adaptive sampling */
   Integrator *integrator = scene->integrator;
   BakeManager *bake_manager = scene->bake_manager;
 
-  if (integrator->sampling_pattern == SAMPLING_PATTERN_CMJ || bake_manager->get_baking()) {
+  if (integrator->sampling_pattern == SAMPLING_PATTERN_CMJ || bake_manager->get_baking() ||
+      integrator->use_adaptive_sampling) {
     int aa_samples = tile_manager.num_samples;
 
     if (aa_samples != integrator->aa_samples) {
@@ -1025,6 +1039,10 @@ void Session::render()
   task.update_progress_sample = function_bind(&Progress::add_samples, &this->progress, _1, _2);
   task.need_finish_queue = params.progressive_refine;
   task.integrator_branched = scene->integrator->method == Integrator::BRANCHED_PATH;
+  /* Adaptive sampling needs all samples of a tile to be rendered in one go. */
+  task.adaptive_sampling = scene->integrator->use_adaptive_sampling &&
+                           device->info.has_adaptive_sampling && !params.progressive;
+  adaptive_sampling_stats.used = task.adaptive_sampling;
   task.requested_tile_size = params.tile_size;
   task.passes_size = tile_manager.params.get_passes_size();
 
@@ -1129,6 +1147,7 @@ void Session::device_free()
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  render_stats->adaptive_sampling = adaptive_sampling_stats;
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene, profiler);
   }
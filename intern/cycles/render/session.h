@@ -214,6 +214,9 @@ class Session {
   thread_mutex buffers_mutex;
   thread_mutex display_mutex;
 
+  /* Accumulated in release_tile(), under tile_mutex. */
+  AdaptiveSamplingStats adaptive_sampling_stats;
+
   bool kernels_loaded;
   DeviceRequestedFeatures loaded_kernel_features;
 
@@ -210,6 +210,58 @@ string MeshStats::full_report(int indent_level)
   return result;
 }
 
+/* Texture cache statistics. */
+
+TextureCacheStats::TextureCacheStats()
+    : used(false), lookups(0), misses(0), memory_used(0), memory_full(0), bytes_read(0)
+{
+}
+
+string TextureCacheStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  const double hit_rate = (lookups) ? 100.0 * (double)(lookups - misses) / lookups : 0.0;
+  const size_t memory_saved = (memory_full > memory_used) ? memory_full - memory_used : 0;
+  string result = "";
+  result += string_printf("%sLookups: %s (hit rate: %.2f%%)\n",
+                          indent.c_str(),
+                          string_human_readable_number(lookups).c_str(),
+                          hit_rate);
+  result += string_printf("%sMemory: %s (full images: %s, saved: %s)\n",
+                          indent.c_str(),
+                          string_human_readable_size(memory_used).c_str(),
+                          string_human_readable_size(memory_full).c_str(),
+                          string_human_readable_size(memory_saved).c_str());
+  result += string_printf(
+      "%sRead from disk: %s\n", indent.c_str(), string_human_readable_size(bytes_read).c_str());
+  return result;
+}
+
+/* Adaptive sampling statistics. */
+
+AdaptiveSamplingStats::AdaptiveSamplingStats()
+    : used(false), pixel_samples(0), skipped_pixel_samples(0), num_tiles(0), num_converged_tiles(0)
+{
+}
+
+string AdaptiveSamplingStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  const uint64_t rendered = pixel_samples - skipped_pixel_samples;
+  const double skipped = (pixel_samples) ? 100.0 * (double)skipped_pixel_samples / pixel_samples :
+                                           0.0;
+  string result = "";
+  result += string_printf("%sPixel samples: %s (skipped: %.2f%%)\n",
+                          indent.c_str(),
+                          string_human_readable_number(rendered).c_str(),
+                          skipped);
+  result += string_printf("%sTiles converged early: %d of %d\n",
+                          indent.c_str(),
+                          num_converged_tiles,
+                          num_tiles);
+  return result;
+}
+
 /* Image statistics. */
 
 ImageStats::ImageStats()
@@ -221,6 +273,9 @@ string ImageStats::full_report(int indent_level)
   const string indent(indent_level * kIndentNumSpaces, ' ');
   string result = "";
   result += indent + "Textures:\n" + textures.full_report(indent_level + 1);
+  if (texture_cache.used) {
+    result += indent + "Texture Cache:\n" + texture_cache.full_report(indent_level + 1);
+  }
   return result;
 }
 
@@ -306,6 +361,9 @@ string RenderStats::full_report()
   string result = "";
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
+  if (adaptive_sampling.used) {
+    result += "Adaptive sampling statistics:\n" + adaptive_sampling.full_report(1);
+  }
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
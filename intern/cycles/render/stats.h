@@ -124,6 +124,48 @@ class MeshStats {
   NamedSizeStats geometry;
 };
 
+/* Statistics about images read through the texture cache. */
+class TextureCacheStats {
+ public:
+  TextureCacheStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  bool used;
+
+  /* Number of tile lookups, and how many of those had to read from disk. */
+  uint64_t lookups;
+  uint64_t misses;
+
+  /* Memory used by the cache, and what the cached images would use when
+   * fully loaded into memory. */
+  size_t memory_used;
+  size_t memory_full;
+
+  size_t bytes_read;
+};
+
+/* Statistics about pixel samples saved by adaptive sampling. */
+class AdaptiveSamplingStats {
+ public:
+  AdaptiveSamplingStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  bool used;
+
+  /* Pixel samples that would be taken without adaptive sampling, and how
+   * many of those were skipped for converged pixels. */
+  uint64_t pixel_samples;
+  uint64_t skipped_pixel_samples;
+
+  /* Tiles that converged before reaching the sample count. */
+  int num_tiles;
+  int num_converged_tiles;
+};
+
 /* Statistics about images held in memory. */
 class ImageStats {
  public:
@@ -133,6 +175,7 @@ class ImageStats {
   string full_report(int indent_level = 0);
 
   NamedSizeStats textures;
+  TextureCacheStats texture_cache;
 };
 
 /* Render process statistics. */
@@ -150,6 +193,7 @@ class RenderStats {
 
   MeshStats mesh;
   ImageStats image;
+  AdaptiveSamplingStats adaptive_sampling;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "kernel/kernel.h"
+#include "kernel/kernel_compat_cpu.h"
+#include "kernel/kernel_types.h"
+#include "kernel/split/kernel_split_data.h"
+#include "kernel/kernel_globals.h"
+
+#include "render/film.h"
+#include "render/scene.h"
+
+#include "util/util_logging.h"
+#include "util/util_stats.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class RenderAdaptiveSampling : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  KernelGlobals kg;
+
+  virtual void SetUp()
+  {
+    util_logging_start();
+
+    device_cpu = Device::create(device_info, stats, profiler, true);
+    scene = new Scene(scene_params, device_cpu);
+    kg = KernelGlobals();
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+  }
+
+  void film_update(const vector<Pass> &passes)
+  {
+    Film *film = scene->film;
+    film->tag_passes_update(scene, passes);
+    film->tag_update(scene);
+    film->device_update(device_cpu, &scene->dscene, scene);
+    kg.__data = scene->dscene.data;
+  }
+};
+
+/*
+ * Test that every pass of a pixel that stopped sampling early, including
+ * color and value AOVs, is scaled to the sample count of the tile.
+ */
+TEST_F(RenderAdaptiveSampling, adjust_samples_aovs)
+{
+  vector<Pass> passes;
+  Pass::add(PASS_COMBINED, passes);
+  Pass::add(PASS_AOV_COLOR, passes, "Color A");
+  Pass::add(PASS_AOV_VALUE, passes, "Value A");
+  Pass::add(PASS_AOV_COLOR, passes, "Color B");
+  Pass::add(PASS_AOV_VALUE, passes, "Value B");
+  Pass::add(PASS_ADAPTIVE_AUX_BUFFER, passes);
+  Pass::add(PASS_SAMPLE_COUNT, passes);
+  film_update(passes);
+
+  const KernelFilm &kfilm = kg.__data.film;
+  EXPECT_EQ(kfilm.num_aov_color, 2);
+  EXPECT_EQ(kfilm.num_aov_value, 2);
+
+  /* Two pixels, the first rendered 4 out of 16 samples. */
+  const int pass_stride = kfilm.pass_stride;
+  vector<float> buffer(pass_stride * 2, 1.0f);
+  buffer[kfilm.pass_sample_count] = 4.0f;
+  buffer[pass_stride + kfilm.pass_sample_count] = 16.0f;
+
+  for (int x = 0; x < 2; x++) {
+    kernel_cpu_adaptive_adjust_samples(&kg, buffer.data(), 16, x, 0, 0, 2);
+  }
+
+  for (int i = 0; i < 4 * kfilm.num_aov_color; i++) {
+    EXPECT_FLOAT_EQ(buffer[kfilm.pass_aov_color + i], 4.0f);
+    EXPECT_FLOAT_EQ(buffer[pass_stride + kfilm.pass_aov_color + i], 1.0f);
+  }
+  for (int i = 0; i < kfilm.num_aov_value; i++) {
+    EXPECT_FLOAT_EQ(buffer[kfilm.pass_aov_value + i], 4.0f);
+    EXPECT_FLOAT_EQ(buffer[pass_stride + kfilm.pass_aov_value + i], 1.0f);
+  }
+  for (int i = 0; i < 4; i++) {
+    EXPECT_FLOAT_EQ(buffer[i], 4.0f);
+    EXPECT_FLOAT_EQ(buffer[pass_stride + i], 1.0f);
+  }
+}
+
+CCL_NAMESPACE_END
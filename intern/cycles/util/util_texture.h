@@ -97,6 +97,8 @@ typedef struct TextureInfo {
   uint interpolation, extension;
   /* Dimensions. */
   uint width, height, depth;
+  /* CPU only, data is a handle to look up pixels through the texture cache. */
+  uint use_texture_cache;
 } TextureInfo;
 
 CCL_NAMESPACE_END
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/util_texture_cache.h"
+
+#include "util/util_foreach.h"
+#include "util/util_logging.h"
+
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+OIIO_NAMESPACE_USING
+
+struct TextureCacheHandle {
+  TextureSystem *texture_system;
+  TextureSystem::TextureHandle *texture_handle;
+  TextureOpt options;
+};
+
+TextureCache::TextureCache(size_t memory_budget)
+{
+  TextureSystem *ts = TextureSystem::create(false);
+
+  /* Generate tiles and mipmaps for images which are not stored that way. */
+  ts->attribute("automip", 1);
+  ts->attribute("autotile", 64);
+  ts->attribute("gray_to_rgb", 1);
+  ts->attribute("max_memory_MB", (float)(memory_budget / (1024.0 * 1024.0)));
+
+  texture_system = ts;
+}
+
+TextureCache::~TextureCache()
+{
+  foreach (TextureCacheHandle *handle, handles) {
+    delete handle;
+  }
+
+  TextureSystem::destroy((TextureSystem *)texture_system);
+}
+
+TextureCacheHandle *TextureCache::get_handle(const string &filename,
+                                             InterpolationType interpolation,
+                                             ExtensionType extension)
+{
+  TextureSystem *ts = (TextureSystem *)texture_system;
+  ustring name(filename);
+
+  int exists = 0;
+  if (!ts->get_texture_info(name, 0, ustring("exists"), TypeDesc::INT, &exists) || !exists) {
+    VLOG(1) << "Texture cache can't read '" << filename << "': " << ts->geterror();
+    return NULL;
+  }
+
+  TextureCacheHandle *handle = new TextureCacheHandle();
+  handle->texture_system = ts;
+  handle->texture_handle = ts->get_texture_handle(name);
+
+  switch (interpolation) {
+    case INTERPOLATION_CLOSEST:
+      handle->options.interpmode = TextureOpt::InterpClosest;
+      break;
+    case INTERPOLATION_LINEAR:
+      handle->options.interpmode = TextureOpt::InterpBilinear;
+      break;
+    default:
+      handle->options.interpmode = TextureOpt::InterpBicubic;
+      break;
+  }
+
+  switch (extension) {
+    case EXTENSION_EXTEND:
+      handle->options.swrap = handle->options.twrap = TextureOpt::WrapClamp;
+      break;
+    case EXTENSION_CLIP:
+      handle->options.swrap = handle->options.twrap = TextureOpt::WrapBlack;
+      break;
+    default:
+      handle->options.swrap = handle->options.twrap = TextureOpt::WrapPeriodic;
+      break;
+  }
+
+  /* Opaque alpha for images without alpha channel. */
+  handle->options.fill = 1.0f;
+
+  thread_scoped_lock lock(handles_mutex);
+  handles.push_back(handle);
+
+  return handle;
+}
+
+void TextureCache::invalidate(const string &filename)
+{
+  ((TextureSystem *)texture_system)->invalidate(ustring(filename));
+}
+
+static int64_t texture_system_statistic(TextureSystem *ts, const char *name)
+{
+  /* Type of statistics differs between versions of OpenImageIO. */
+  long long value = 0;
+  if (ts->getattribute(name, TypeDesc::INT64, &value)) {
+    return value;
+  }
+
+  int int_value = 0;
+  if (ts->getattribute(name, TypeDesc::INT, &int_value)) {
+    return int_value;
+  }
+
+  return 0;
+}
+
+TextureCache::Statistics TextureCache::get_statistics() const
+{
+  TextureSystem *ts = (TextureSystem *)texture_system;
+  Statistics stats;
+
+  stats.lookups = texture_system_statistic(ts, "stat:find_tile_calls");
+  stats.misses = texture_system_statistic(ts, "stat:find_tile_cache_misses");
+  stats.memory_used = texture_system_statistic(ts, "stat:cache_memory_used");
+  stats.bytes_read = texture_system_statistic(ts, "stat:bytes_read");
+
+  return stats;
+}
+
+bool texture_cache_lookup(const TextureCacheHandle *handle,
+                          float x,
+                          float y,
+                          float dxdx,
+                          float dydx,
+                          float dxdy,
+                          float dydy,
+                          float result[4])
+{
+  /* Options are modified by lookups, so use a copy. */
+  TextureOpt options = handle->options;
+
+  /* Flip vertically, OpenImageIO has the origin at the top left. */
+  return handle->texture_system->texture(handle->texture_handle,
+                                         NULL,
+                                         options,
+                                         x,
+                                         1.0f - y,
+                                         dxdx,
+                                         -dydx,
+                                         dxdy,
+                                         -dydy,
+                                         4,
+                                         result);
+}
+
+CCL_NAMESPACE_END
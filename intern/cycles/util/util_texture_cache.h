@@ -0,0 +1,88 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UTIL_TEXTURE_CACHE_H__
+#define __UTIL_TEXTURE_CACHE_H__
+
+#include "util/util_string.h"
+#include "util/util_texture.h"
+#include "util/util_thread.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Out-of-core cache for image textures rendered on the CPU.
+ *
+ * Instead of loading full images into memory, tiles of the mipmap level
+ * matching the lookup footprint are read from disk when first used, and the
+ * least recently used tiles are released once the memory budget is reached.
+ *
+ * Implemented on top of the OpenImageIO texture system, which generates tiles
+ * and mipmaps on the fly for files which are not stored that way. Converting
+ * images to tiled and mipmapped .tx files upfront avoids that overhead. */
+
+struct TextureCacheHandle;
+
+class TextureCache {
+ public:
+  explicit TextureCache(size_t memory_budget);
+  ~TextureCache();
+
+  /* Get handle for lookups into the given file, NULL if it can't be read.
+   * Handles stay valid for the lifetime of the cache. */
+  TextureCacheHandle *get_handle(const string &filename,
+                                 InterpolationType interpolation,
+                                 ExtensionType extension);
+
+  /* Release tiles of a file, for when it changed on disk. */
+  void invalidate(const string &filename);
+
+  struct Statistics {
+    /* Number of tile lookups, and how many of those had to read from disk. */
+    uint64_t lookups;
+    uint64_t misses;
+    /* Memory used by tiles currently in the cache. */
+    size_t memory_used;
+    /* Total amount of pixel data read from files. */
+    size_t bytes_read;
+  };
+
+  Statistics get_statistics() const;
+
+ protected:
+  void *texture_system;
+
+  thread_mutex handles_mutex;
+  vector<TextureCacheHandle *> handles;
+};
+
+/* Look up a filtered RGBA value. Coordinates and their screen space derivatives
+ * are in image space with the origin at the bottom left, like other image
+ * textures. Zero derivatives sample the full resolution. Returns false if the
+ * lookup failed. Safe to call from multiple threads. */
+bool texture_cache_lookup(const TextureCacheHandle *handle,
+                          float x,
+                          float y,
+                          float dxdx,
+                          float dydx,
+                          float dxdy,
+                          float dydy,
+                          float result[4]);
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_CACHE_H__ */
@@ -194,6 +194,11 @@ const UserDef U_default = {
     .filebrowser_display_type = USER_TEMP_SPACE_DISPLAY_WINDOW,
     .viewport_aa = 8,
 
+    .sequencer_disk_cache_dir = "",
+    .sequencer_disk_cache_compression = USER_SEQ_DISK_CACHE_COMPRESSION_LOW,
+    .sequencer_disk_cache_size_limit = 100,
+    .sequencer_disk_cache_flag = 0,
+
     .walk_navigation =
         {
             .mouse_speed = 1,
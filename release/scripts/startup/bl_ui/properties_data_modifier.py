@@ -132,6 +132,10 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
         layout.prop(md, "start_cap")
         layout.prop(md, "end_cap")
 
+        layout.separator()
+
+        layout.prop(md, "use_instances")
+
     def BEVEL(self, layout, ob, md):
         offset_type = md.offset_type
         if offset_type == 'PERCENT':
@@ -191,9 +195,13 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
         col.prop(md, "operation", text="")
 
         col = split.column()
-        col.label(text="Object:")
-        col.prop(md, "object", text="")
+        col.prop(md, "operand_type", text="")
+        if md.operand_type == 'OBJECT':
+            col.prop(md, "object", text="")
+        else:
+            col.prop(md, "collection", text="")
 
+        layout.prop(md, "solver")
         layout.prop(md, "double_threshold")
 
         if bpy.app.debug:
@@ -608,6 +608,16 @@ class USERPREF_PT_system_memory(SystemPanel, CenterAlignMixIn, Panel):
 
         flow = layout.grid_flow(row_major=False, columns=0, even_columns=True, even_rows=False, align=False)
 
+        flow.prop(system, "use_sequencer_disk_cache")
+        sub = flow.column()
+        sub.active = system.use_sequencer_disk_cache
+        sub.prop(system, "sequencer_disk_cache_size_limit", text="Disk Cache Limit")
+        sub.prop(system, "sequencer_disk_cache_compression", text="Disk Cache Compression")
+
+        layout.separator()
+
+        flow = layout.grid_flow(row_major=False, columns=0, even_columns=True, even_rows=False, align=False)
+
         flow.prop(system, "texture_time_out", text="Texture Time Out")
         flow.prop(system, "texture_collection_rate", text="Garbage Collection Rate")
 
@@ -1205,6 +1215,7 @@ class USERPREF_PT_file_paths_render(FilePathsPanel, Panel):
         col = self.layout.column()
         col.prop(paths, "render_output_directory", text="Render Output")
         col.prop(paths, "render_cache_directory", text="Render Cache")
+        col.prop(paths, "sequencer_disk_cache_dir", text="Sequencer Cache")
 
 
 class USERPREF_PT_file_paths_applications(FilePathsPanel, Panel):
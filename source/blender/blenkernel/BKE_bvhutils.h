@@ -244,4 +244,10 @@ bool bvhcache_has_tree(const BVHCache *cache, const BVHTree *tree);
 void bvhcache_insert(BVHCache **cache_p, BVHTree *tree, int type);
 void bvhcache_free(BVHCache **cache_p);
 
+uint bvhcache_topology_hash(const struct Mesh *mesh);
+void bvhcache_reuse_deformed(BVHCache **cache_p,
+                             BVHCache **cache_src_p,
+                             const uint topology_hash,
+                             const struct Mesh *mesh);
+
 #endif
@@ -62,6 +62,8 @@ typedef struct ClothSolverResult {
   int max_iterations, min_iterations;
   float avg_iterations;
   float max_error, min_error, avg_error;
+  /* Time spent in the linear solver, in seconds. */
+  float max_time, avg_time;
 } ClothSolverResult;
 
 /**
@@ -80,6 +80,15 @@ typedef struct BMEditMesh {
    */
   char needs_flush_to_id;
 
+  /**
+   * Only vertex positions changed since the last evaluation, set by transform.
+   * Drawing then only updates the faces in #deform_face_range,
+   * see #BKE_MESH_BATCH_DIRTY_DEFORM.
+   */
+  char is_deform_tagged;
+  /** Range of face indices whose positions or normals changed, when #is_deform_tagged is set. */
+  int deform_face_range[2];
+
 } BMEditMesh;
 
 /* editmesh.c */
@@ -213,7 +213,15 @@ void BKE_mesh_split_faces(struct Mesh *mesh, bool free_loop_normals);
  * preserves all possible custom data layers.
  *
  * NOTE: Dependency graph argument is required when preserve_all_data_layers is truth, and is
- * ignored otherwise. */
+ * ignored otherwise.
+ *
+ * Instances of the evaluated mesh are only part of the result when realize_instances is truth,
+ * otherwise they are left to the duplis of the object. BKE_mesh_new_from_object() realizes them,
+ * callers which also read the duplis of the object should use the extended version instead. */
+struct Mesh *BKE_mesh_new_from_object_ex(struct Depsgraph *depsgraph,
+                                         struct Object *object,
+                                         bool preserve_all_data_layers,
+                                         bool realize_instances);
 struct Mesh *BKE_mesh_new_from_object(struct Depsgraph *depsgraph,
                                       struct Object *object,
                                       bool preserve_all_data_layers);
@@ -691,6 +699,8 @@ enum {
   BKE_MESH_BATCH_DIRTY_SHADING,
   BKE_MESH_BATCH_DIRTY_UVEDIT_ALL,
   BKE_MESH_BATCH_DIRTY_UVEDIT_SELECT,
+  /* Only vertex coordinates and normals changed, topology and other layers are unchanged. */
+  BKE_MESH_BATCH_DIRTY_DEFORM,
 };
 void BKE_mesh_batch_cache_dirty_tag(struct Mesh *me, int mode);
 void BKE_mesh_batch_cache_free(struct Mesh *me);
@@ -0,0 +1,47 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BKE_MESH_BOOLEAN_H__
+#define __BKE_MESH_BOOLEAN_H__
+
+/** \file
+ * \ingroup bke
+ */
+
+struct Mesh;
+
+/** Boolean operations, values match #BooleanModifierOp. */
+enum {
+  MESH_BOOLEAN_INTERSECT = 0,
+  MESH_BOOLEAN_UNION = 1,
+  MESH_BOOLEAN_DIFFERENCE = 2,
+};
+
+typedef struct MeshBooleanOperand {
+  const struct Mesh *mesh;
+  /** Transform from the space of the operand to the space of the result. */
+  float obmat[4][4];
+  /** Optional remapping of material indices, see #BKE_material_remap_object_calc. */
+  const short *material_remap;
+  int material_remap_len;
+} MeshBooleanOperand;
+
+struct Mesh *BKE_mesh_boolean(const MeshBooleanOperand *operands,
+                              const int operands_len,
+                              const int operation,
+                              const float merge_threshold);
+
+#endif /* __BKE_MESH_BOOLEAN_H__ */
@@ -47,6 +47,8 @@ bool BKE_mesh_runtime_ensure_edit_data(struct Mesh *mesh);
 bool BKE_mesh_runtime_clear_edit_data(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_geometry(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_cache(struct Mesh *mesh);
+struct Mesh *BKE_mesh_runtime_instances_realize(const struct Mesh *mesh);
+struct Mesh *BKE_mesh_runtime_instances_realized_ensure(struct Mesh *mesh);
 
 void BKE_mesh_runtime_verttri_from_looptri(struct MVertTri *r_verttri,
                                            const struct MLoop *mloop,
@@ -413,10 +413,14 @@ bool BKE_object_empty_image_data_is_visible_in_view3d(const struct Object *ob,
  * preserves all possible custom data layers.
  *
  * NOTE: Dependency graph argument is required when preserve_all_data_layers is truth, and is
- * ignored otherwise. */
+ * ignored otherwise.
+ *
+ * Instances of the evaluated mesh are part of the result when realize_instances is truth,
+ * callers which read them from the duplis of the object should disable it. */
 struct Mesh *BKE_object_to_mesh(struct Depsgraph *depsgraph,
                                 struct Object *object,
-                                bool preserve_all_data_layers);
+                                bool preserve_all_data_layers,
+                                bool realize_instances);
 
 void BKE_object_to_mesh_clear(struct Object *object);
 
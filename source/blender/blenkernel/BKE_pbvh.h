@@ -73,6 +73,7 @@ typedef enum {
   PBVH_FullyUnmasked = 1 << 10,
 
   PBVH_UpdateTopology = 1 << 11,
+  PBVH_UpdateBMeshArrays = 1 << 12,
 } PBVHNodeFlags;
 
 typedef struct PBVHFrustumPlanes {
@@ -93,6 +94,9 @@ typedef void (*BKE_pbvh_SearchNearestCallback)(PBVHNode *node, void *data, float
 /* Building */
 
 PBVH *BKE_pbvh_new(void);
+/* Split nodes of mesh and grids PBVHs with the surface area heuristic instead of at the middle
+ * of the widest axis, must be set before building. */
+void BKE_pbvh_build_sah_set(PBVH *bvh, bool use_sah);
 void BKE_pbvh_build_mesh(PBVH *bvh,
                          const struct Mesh *mesh,
                          const struct MPoly *mpoly,
@@ -289,6 +293,7 @@ void BKE_pbvh_update_vertex_data(PBVH *bvh, int flags);
 void BKE_pbvh_update_normals(PBVH *bvh, struct SubdivCCG *subdiv_ccg);
 void BKE_pbvh_redraw_BB(PBVH *bvh, float bb_min[3], float bb_max[3]);
 void BKE_pbvh_get_grid_updates(PBVH *bvh, bool clear, void ***r_gridfaces, int *r_totface);
+void BKE_pbvh_update_mesh_pointers(PBVH *bvh, struct Mesh *mesh);
 void BKE_pbvh_grids_update(PBVH *bvh,
                            struct CCGElem **grid_elems,
                            void **gridfaces,
@@ -345,8 +350,7 @@ typedef struct PBVHVertexIter {
   float *vmask;
 
   /* bmesh */
-  struct GSetIterator bm_unique_verts;
-  struct GSetIterator bm_other_verts;
+  struct BMVert **bm_verts;
   struct CustomData *bm_vdata;
   int cd_vert_mask_offset;
 
@@ -403,20 +407,13 @@ void pbvh_vertex_iter_init(PBVH *bvh, PBVHNode *node, PBVHVertexIter *vi, int mo
             vi.mask = &vi.vmask[vi.vert_indices[vi.gx]]; \
         } \
         else { \
-          if (!BLI_gsetIterator_done(&vi.bm_unique_verts)) { \
-            vi.bm_vert = BLI_gsetIterator_getKey(&vi.bm_unique_verts); \
-            BLI_gsetIterator_step(&vi.bm_unique_verts); \
-          } \
-          else { \
-            vi.bm_vert = BLI_gsetIterator_getKey(&vi.bm_other_verts); \
-            BLI_gsetIterator_step(&vi.bm_other_verts); \
-          } \
+          vi.bm_vert = vi.bm_verts[vi.gx]; \
           if (mode == PBVH_ITER_UNIQUE && BM_elem_flag_test(vi.bm_vert, BM_ELEM_HIDDEN)) \
             continue; \
           vi.co = vi.bm_vert->co; \
           vi.fno = vi.bm_vert->no; \
           vi.index = BM_elem_index_get(vi.bm_vert); \
-          vi.mask = BM_ELEM_CD_GET_VOID_P(vi.bm_vert, vi.cd_vert_mask_offset); \
+          vi.mask = (float *)BM_ELEM_CD_GET_VOID_P(vi.bm_vert, vi.cd_vert_mask_offset); \
         }
 
 #define BKE_pbvh_vertex_iter_end \
@@ -1788,6 +1788,19 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
    * they aren't cleaned up properly on mode switch, causing crashes, e.g T58150. */
   BLI_assert(ob->id.tag & LIB_TAG_COPIED_ON_WRITE);
 
+  /* Keep the BVH trees of the previous evaluation, when only the positions changed (e.g. animated
+   * deformation) they are refitted instead of being built again. */
+  BVHCache *bvh_cache_prev = NULL;
+  uint bvh_topology_hash_prev = 0;
+  if (ob->runtime.mesh_eval != NULL && ob->runtime.is_mesh_eval_owned) {
+    Mesh *mesh_eval_prev = ob->runtime.mesh_eval;
+    if (mesh_eval_prev->runtime.bvh_cache != NULL) {
+      bvh_cache_prev = mesh_eval_prev->runtime.bvh_cache;
+      bvh_topology_hash_prev = bvhcache_topology_hash(mesh_eval_prev);
+      mesh_eval_prev->runtime.bvh_cache = NULL;
+    }
+  }
+
   BKE_object_free_derived_caches(ob);
   if (DEG_is_active(depsgraph)) {
     BKE_sculpt_update_object_before_eval(ob);
@@ -1818,6 +1831,18 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
 
   assign_object_mesh_eval(ob);
 
+  if (bvh_cache_prev != NULL) {
+    if (ob->runtime.is_mesh_eval_owned) {
+      bvhcache_reuse_deformed(&ob->runtime.mesh_eval->runtime.bvh_cache,
+                              &bvh_cache_prev,
+                              bvh_topology_hash_prev,
+                              ob->runtime.mesh_eval);
+    }
+    else {
+      bvhcache_free(&bvh_cache_prev);
+    }
+  }
+
   ob->runtime.last_data_mask = *dataMask;
   ob->runtime.last_need_mapping = need_mapping;
 
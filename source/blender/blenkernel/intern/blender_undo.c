@@ -119,6 +119,19 @@ MemFileUndoData *BKE_memfile_undo_encode(Main *bmain, MemFileUndoData *mfu_prev)
     MemFile *prevfile = (mfu_prev) ? &(mfu_prev->memfile) : NULL;
     /* success = */ /* UNUSED */ BLO_write_file_mem(bmain, prevfile, &mfu->memfile, G.fileflags);
     mfu->undo_size = mfu->memfile.size;
+
+    if (G.debug & G_DEBUG_IO) {
+      size_t buffers_len, buffers_size;
+      BLO_memfile_stats_get(&buffers_len, &buffers_size);
+      printf("Undo step: %zu bytes, %zu new (%.1f%% shared), %zu bytes in %zu chunk buffers\n",
+             mfu->memfile.size_total,
+             mfu->memfile.size,
+             mfu->memfile.size_total ?
+                 100.0 * (1.0 - (double)mfu->memfile.size / (double)mfu->memfile.size_total) :
+                 0.0,
+             buffers_size,
+             buffers_len);
+    }
   }
 
   bmain->is_memfile_undo_written = true;
@@ -30,8 +30,11 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_hash.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_linklist.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_bvhutils.h"
@@ -43,6 +46,9 @@
 
 static ThreadRWMutex cache_rwlock = BLI_RWLOCK_INITIALIZER;
 
+static bool bvhcache_is_deformed(const BVHCache *cache, int type);
+static void bvhcache_refit_deformed(BVHCache *cache, int type, Mesh *mesh);
+
 /* -------------------------------------------------------------------- */
 /** \name Local Callbacks
  * \{ */
@@ -1319,6 +1325,7 @@ BVHTree *BKE_bvhtree_from_mesh_get(struct BVHTreeFromMesh *data,
 
   BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
   bool is_cached = bvhcache_find(*bvh_cache, bvh_cache_type, &tree);
+  const bool is_deformed = is_cached && bvhcache_is_deformed(*bvh_cache, bvh_cache_type);
   BLI_rw_mutex_unlock(&cache_rwlock);
 
   if (is_cached && tree == NULL) {
@@ -1326,6 +1333,10 @@ BVHTree *BKE_bvhtree_from_mesh_get(struct BVHTreeFromMesh *data,
     return tree;
   }
 
+  if (is_deformed) {
+    bvhcache_refit_deformed(*bvh_cache, bvh_cache_type, mesh);
+  }
+
   switch (bvh_cache_type) {
     case BVHTREE_FROM_VERTS:
     case BVHTREE_FROM_LOOSEVERTS:
@@ -1624,21 +1635,38 @@ typedef struct BVHCacheItem {
   int type;
   BVHTree *tree;
 
+  /** The tree was built for another mesh with the same topology, see #bvhcache_reuse_deformed. */
+  bool deformed;
 } BVHCacheItem;
 
-/**
- * Queries a bvhcache for the cache bvhtree of the request type
- */
-bool bvhcache_find(const BVHCache *cache, int type, BVHTree **r_tree)
+static BVHCacheItem *bvhcache_find_item(const BVHCache *cache, int type)
 {
   while (cache) {
-    const BVHCacheItem *item = cache->link;
+    BVHCacheItem *item = cache->link;
     if (item->type == type) {
-      *r_tree = item->tree;
-      return true;
+      return item;
     }
     cache = cache->next;
   }
+  return NULL;
+}
+
+static bool bvhcache_is_deformed(const BVHCache *cache, int type)
+{
+  const BVHCacheItem *item = bvhcache_find_item(cache, type);
+  return item && item->deformed;
+}
+
+/**
+ * Queries a bvhcache for the cache bvhtree of the request type
+ */
+bool bvhcache_find(const BVHCache *cache, int type, BVHTree **r_tree)
+{
+  const BVHCacheItem *item = bvhcache_find_item(cache, type);
+  if (item) {
+    *r_tree = item->tree;
+    return true;
+  }
   return false;
 }
 
@@ -1672,6 +1700,7 @@ void bvhcache_insert(BVHCache **cache_p, BVHTree *tree, int type)
 
   item->type = type;
   item->tree = tree;
+  item->deformed = false;
 
   BLI_linklist_prepend(cache_p, item);
 }
@@ -1693,4 +1722,158 @@ void bvhcache_free(BVHCache **cache_p)
   *cache_p = NULL;
 }
 
+/**
+ * Number of leafs of the tree of a cache type, -1 for trees that are not built from all elements
+ * of the mesh and can't be refitted.
+ */
+static int bvhcache_refit_leafs_num(const Mesh *mesh, int type)
+{
+  switch (type) {
+    case BVHTREE_FROM_VERTS:
+      return mesh->totvert;
+    case BVHTREE_FROM_EDGES:
+      return mesh->totedge;
+    case BVHTREE_FROM_FACES:
+      return mesh->totface;
+    case BVHTREE_FROM_LOOPTRI:
+      return poly_to_tri_count(mesh->totpoly, mesh->totloop);
+  }
+  return -1;
+}
+
+/**
+ * Hash of the topology of a mesh, to know if the trees built for it can be used for another mesh
+ * after #bvhcache_reuse_deformed.
+ */
+uint bvhcache_topology_hash(const Mesh *mesh)
+{
+  uint hash = BLI_hash_int_2d(mesh->totvert, mesh->totedge);
+  hash = BLI_hash_int_2d(hash, mesh->totface);
+  hash = BLI_hash_int_2d(hash, mesh->totloop);
+  hash = BLI_hash_int_2d(hash, mesh->totpoly);
+  hash = BLI_hash_mm2((const uchar *)mesh->medge, sizeof(*mesh->medge) * mesh->totedge, hash);
+  hash = BLI_hash_mm2((const uchar *)mesh->mloop, sizeof(*mesh->mloop) * mesh->totloop, hash);
+  hash = BLI_hash_mm2((const uchar *)mesh->mpoly, sizeof(*mesh->mpoly) * mesh->totpoly, hash);
+  return hash;
+}
+
+/**
+ * Moves the trees of \a cache_src_p that can be used for \a mesh to \a cache_p, and frees the
+ * others. This is meant for a mesh that replaces the one the trees were built for, with only
+ * different positions (e.g. the next evaluation of an animated mesh): the trees are refitted
+ * when they are requested, which is much faster than building them again.
+ *
+ * \param topology_hash: #bvhcache_topology_hash of the mesh the trees were built for.
+ */
+void bvhcache_reuse_deformed(BVHCache **cache_p,
+                             BVHCache **cache_src_p,
+                             const uint topology_hash,
+                             const Mesh *mesh)
+{
+  const bool is_same_topology = (*cache_src_p != NULL) &&
+                                (bvhcache_topology_hash(mesh) == topology_hash);
+
+  LinkNode *link = *cache_src_p;
+  while (link) {
+    LinkNode *link_next = link->next;
+    BVHCacheItem *item = link->link;
+    if (is_same_topology && item->tree != NULL &&
+        BLI_bvhtree_get_len(item->tree) == bvhcache_refit_leafs_num(mesh, item->type) &&
+        bvhcache_find_item(*cache_p, item->type) == NULL) {
+      item->deformed = true;
+      link->next = *cache_p;
+      *cache_p = link;
+    }
+    else {
+      bvhcacheitem_free(item);
+      MEM_freeN(link);
+    }
+    link = link_next;
+  }
+  *cache_src_p = NULL;
+}
+
+typedef struct BVHRefitData {
+  BVHTree *tree;
+  const Mesh *mesh;
+  const MLoopTri *looptri;
+  int type;
+} BVHRefitData;
+
+static void bvhcache_refit_leaf_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHRefitData *data = userdata;
+  const MVert *mvert = data->mesh->mvert;
+  float co[4][3];
+  int numpoints = 0;
+
+  switch (data->type) {
+    case BVHTREE_FROM_VERTS:
+      copy_v3_v3(co[numpoints++], mvert[i].co);
+      break;
+    case BVHTREE_FROM_EDGES: {
+      const MEdge *medge = &data->mesh->medge[i];
+      copy_v3_v3(co[numpoints++], mvert[medge->v1].co);
+      copy_v3_v3(co[numpoints++], mvert[medge->v2].co);
+      break;
+    }
+    case BVHTREE_FROM_FACES: {
+      const MFace *mface = &data->mesh->mface[i];
+      copy_v3_v3(co[numpoints++], mvert[mface->v1].co);
+      copy_v3_v3(co[numpoints++], mvert[mface->v2].co);
+      copy_v3_v3(co[numpoints++], mvert[mface->v3].co);
+      if (mface->v4) {
+        copy_v3_v3(co[numpoints++], mvert[mface->v4].co);
+      }
+      break;
+    }
+    case BVHTREE_FROM_LOOPTRI: {
+      const MLoop *mloop = data->mesh->mloop;
+      const MLoopTri *lt = &data->looptri[i];
+      copy_v3_v3(co[numpoints++], mvert[mloop[lt->tri[0]].v].co);
+      copy_v3_v3(co[numpoints++], mvert[mloop[lt->tri[1]].v].co);
+      copy_v3_v3(co[numpoints++], mvert[mloop[lt->tri[2]].v].co);
+      break;
+    }
+    default:
+      BLI_assert(0);
+      return;
+  }
+
+  BLI_bvhtree_update_node(data->tree, i, co[0], NULL, numpoints);
+}
+
+/**
+ * Refit a tree moved to the cache of \a mesh by #bvhcache_reuse_deformed to its positions.
+ * The leafs were inserted in the order of the elements, so the bounds of every leaf are
+ * calculated in parallel before the tree is updated bottom-up.
+ */
+static void bvhcache_refit_deformed(BVHCache *cache, int type, Mesh *mesh)
+{
+  BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
+  BVHCacheItem *item = bvhcache_find_item(cache, type);
+  /* Another thread may have refitted it already. */
+  if (item->deformed) {
+    BVHRefitData data = {
+        .tree = item->tree,
+        .mesh = mesh,
+        .looptri = (type == BVHTREE_FROM_LOOPTRI) ? BKE_mesh_runtime_looptri_ensure(mesh) : NULL,
+        .type = type,
+    };
+    const int leafs_num = BLI_bvhtree_get_len(item->tree);
+    BLI_assert(leafs_num == bvhcache_refit_leafs_num(mesh, type));
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (leafs_num > 1024);
+    BLI_task_parallel_range(0, leafs_num, &data, bvhcache_refit_leaf_cb, &settings);
+    BLI_bvhtree_update_tree(item->tree);
+
+    item->deformed = false;
+  }
+  BLI_rw_mutex_unlock(&cache_rwlock);
+}
+
 /** \} */
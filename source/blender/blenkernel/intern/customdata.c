@@ -26,6 +26,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 /* Since we have versioning code here (CustomData_verify_versions()). */
 #define DNA_DEPRECATED_ALLOW
 
@@ -65,6 +67,16 @@ BLI_STATIC_ASSERT(ARRAY_SIZE(((CustomData *)NULL)->typemap) == CD_NUMTYPES, "siz
 
 static CLG_LogRef LOG = {"bke.customdata"};
 
+/**
+ * Number of layers using the same data, see #CD_SHARE.
+ * The data is freed by the last user, and has to be duplicated by any user before writing to it.
+ */
+typedef struct CustomDataSharingInfo {
+  int users;
+  /** Number of elements in the shared data, which can't change while it is shared. */
+  int totelem;
+} CustomDataSharingInfo;
+
 /** Update mask_dst with layers defined in mask_src (equivalent to a bitwise OR). */
 void CustomData_MeshMasks_update(CustomData_MeshMasks *mask_dst,
                                  const CustomData_MeshMasks *mask_src)
@@ -1848,6 +1860,90 @@ static bool customdata_typemap_is_valid(const CustomData *data)
 }
 #endif
 
+/* -------------------------------------------------------------------- */
+/** \name Layer Data Sharing
+ * \{ */
+
+/**
+ * Add a user to the data of \a layer, which becomes shared if it isn't yet.
+ * Sharing info is created lazily and atomically, as the same original can be
+ * copied from multiple threads (e.g. by several dependency graphs).
+ */
+static CustomDataSharingInfo *customData_layer_share(CustomDataLayer *layer, int totelem)
+{
+  CustomDataSharingInfo *sharing_info = layer->sharing_info;
+
+  if (sharing_info == NULL) {
+    CustomDataSharingInfo *new_sharing_info = MEM_mallocN(sizeof(*new_sharing_info), __func__);
+    new_sharing_info->users = 1;
+    new_sharing_info->totelem = totelem;
+
+    sharing_info = atomic_cas_ptr((void **)&layer->sharing_info, NULL, new_sharing_info);
+    if (sharing_info == NULL) {
+      sharing_info = new_sharing_info;
+    }
+    else {
+      MEM_freeN(new_sharing_info);
+    }
+  }
+
+  atomic_add_and_fetch_int32(&sharing_info->users, 1);
+  return sharing_info;
+}
+
+/**
+ * Remove \a layer from the users of its data.
+ * \return true when it was the last user, so the layer owns its data again.
+ */
+static bool customData_layer_unshare(CustomDataLayer *layer)
+{
+  CustomDataSharingInfo *sharing_info = layer->sharing_info;
+
+  if (sharing_info == NULL) {
+    return true;
+  }
+
+  layer->sharing_info = NULL;
+
+  if (atomic_sub_and_fetch_int32(&sharing_info->users, 1) == 0) {
+    MEM_freeN(sharing_info);
+    return true;
+  }
+  return false;
+}
+
+/* Layers which can't be written to without being duplicated first. */
+static bool customData_layer_is_referenced(const CustomDataLayer *layer)
+{
+  if (layer->flag & CD_FLAG_NOFREE) {
+    return true;
+  }
+  return (layer->sharing_info != NULL) &&
+         (atomic_add_and_fetch_int32(&layer->sharing_info->users, 0) > 1);
+}
+
+/* Add a layer using the data of \a source_layer, see #CD_SHARE. */
+static CustomDataLayer *customData_add_shared_layer__internal(CustomData *data,
+                                                              CustomDataLayer *source_layer,
+                                                              int totelem)
+{
+  CustomDataSharingInfo *sharing_info = customData_layer_share(source_layer, totelem);
+  CustomDataLayer *layer = customData_add_layer__internal(
+      data, source_layer->type, CD_ASSIGN, source_layer->data, totelem, source_layer->name);
+
+  if (layer && layer->data == source_layer->data && layer->sharing_info == NULL) {
+    layer->sharing_info = sharing_info;
+  }
+  else {
+    /* The source layer is still a user, this never frees anything. */
+    atomic_sub_and_fetch_int32(&sharing_info->users, 1);
+  }
+
+  return layer;
+}
+
+/** \} */
+
 bool CustomData_merge(const struct CustomData *source,
                       struct CustomData *dest,
                       CustomDataMask mask,
@@ -1899,6 +1995,7 @@ bool CustomData_merge(const struct CustomData *source,
       case CD_ASSIGN:
       case CD_REFERENCE:
       case CD_DUPLICATE:
+      case CD_SHARE:
         data = layer->data;
         break;
       default:
@@ -1910,11 +2007,26 @@ bool CustomData_merge(const struct CustomData *source,
       newlayer = customData_add_layer__internal(
           dest, type, CD_REFERENCE, data, totelem, layer->name);
     }
+    else if (alloctype == CD_SHARE) {
+      if ((flag & CD_FLAG_NOFREE) || (data == NULL)) {
+        /* Only data owned by the source can be shared, its lifetime is unknown otherwise. */
+        newlayer = customData_add_layer__internal(
+            dest, type, CD_DUPLICATE, data, totelem, layer->name);
+      }
+      else {
+        newlayer = customData_add_shared_layer__internal(dest, layer, totelem);
+      }
+    }
     else {
       newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
     }
 
     if (newlayer) {
+      if ((alloctype == CD_ASSIGN) && (newlayer->data == data)) {
+        /* Ownership of the data moves to the new layer, including its other users. */
+        newlayer->sharing_info = layer->sharing_info;
+        ((CustomDataLayer *)layer)->sharing_info = NULL;
+      }
       newlayer->uid = layer->uid;
 
       newlayer->active = lastactive;
@@ -1930,6 +2042,10 @@ bool CustomData_merge(const struct CustomData *source,
   return changed;
 }
 
+static void *customData_duplicate_referenced_layer_index(CustomData *data,
+                                                         const int layer_index,
+                                                         const int totelem);
+
 /* NOTE: Take care of referenced layers by yourself! */
 void CustomData_realloc(CustomData *data, int totelem)
 {
@@ -1941,6 +2057,10 @@ void CustomData_realloc(CustomData *data, int totelem)
       continue;
     }
     typeInfo = layerType_getInfo(layer->type);
+    if (layer->sharing_info) {
+      /* Other users still need the data as it is. */
+      customData_duplicate_referenced_layer_index(data, i, layer->sharing_info->totelem);
+    }
     layer->data = MEM_reallocN(layer->data, (size_t)totelem * typeInfo->size);
   }
 }
@@ -1965,6 +2085,11 @@ static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
   const LayerTypeInfo *typeInfo;
 
   if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
+    if (!customData_layer_unshare(layer)) {
+      /* Still used by other layers. */
+      return;
+    }
+
     typeInfo = layerType_getInfo(layer->type);
 
     if (typeInfo->free) {
@@ -2362,6 +2487,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   data->layers[index].type = type;
   data->layers[index].flag = flag;
   data->layers[index].data = newlayerdata;
+  data->layers[index].sharing_info = NULL;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2547,12 +2673,14 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
 
   layer = &data->layers[layer_index];
 
-  if (layer->flag & CD_FLAG_NOFREE) {
+  if (customData_layer_is_referenced(layer)) {
     /* MEM_dupallocN won't work in case of complex layers, like e.g.
      * CD_MDEFORMVERT, which has pointers to allocated data...
      * So in case a custom copy function is defined, use it!
      */
     const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+    void *old_data = layer->data;
+    const int old_totelem = layer->sharing_info ? layer->sharing_info->totelem : totelem;
 
     if (typeInfo->copy) {
       void *dst_data = MEM_malloc_arrayN(
@@ -2564,7 +2692,20 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
       layer->data = MEM_dupallocN(layer->data);
     }
 
-    layer->flag &= ~CD_FLAG_NOFREE;
+    if (layer->flag & CD_FLAG_NOFREE) {
+      layer->flag &= ~CD_FLAG_NOFREE;
+    }
+    else if (customData_layer_unshare(layer)) {
+      /* Other users went away in the meantime, free the data they left behind. */
+      if (typeInfo->free) {
+        typeInfo->free(old_data, old_totelem, typeInfo->size);
+      }
+      MEM_freeN(old_data);
+    }
+  }
+  else if (layer->sharing_info) {
+    /* Last user, the data is owned by this layer alone now. */
+    customData_layer_unshare(layer);
   }
 
   return layer->data;
@@ -2619,7 +2760,7 @@ bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 
   layer = &data->layers[layer_index];
 
-  return (layer->flag & CD_FLAG_NOFREE) != 0;
+  return customData_layer_is_referenced(layer);
 }
 
 void CustomData_free_temporary(CustomData *data, int totelem)
@@ -2801,7 +2942,7 @@ void CustomData_free_elem(CustomData *data, int index, int count)
   const LayerTypeInfo *typeInfo;
 
   for (i = 0; i < data->totlayer; i++) {
-    if (!(data->layers[i].flag & CD_FLAG_NOFREE)) {
+    if (!customData_layer_is_referenced(&data->layers[i])) {
       typeInfo = layerType_getInfo(data->layers[i].type);
 
       if (typeInfo->free) {
@@ -3053,6 +3194,7 @@ void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
     return NULL;
   }
 
+  customData_layer_unshare(&data->layers[layer_index]);
   data->layers[layer_index].data = ptr;
 
   return ptr;
@@ -3066,6 +3208,7 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
     return NULL;
   }
 
+  customData_layer_unshare(&data->layers[layer_index]);
   data->layers[layer_index].data = ptr;
 
   return ptr;
@@ -3432,7 +3575,11 @@ void CustomData_bmesh_free_block_data(CustomData *data, void *block)
   }
 }
 
-static void CustomData_bmesh_alloc_block(CustomData *data, void **block)
+/**
+ * Allocate a block from the pool of \a data, without initializing its layers.
+ * Allows to allocate blocks serially and fill them from multiple threads.
+ */
+void CustomData_bmesh_alloc_block(CustomData *data, void **block)
 {
 
   if (*block) {
@@ -3683,7 +3830,7 @@ bool CustomData_has_referenced(const struct CustomData *data)
 {
   int i;
   for (i = 0; i < data->totlayer; i++) {
-    if (data->layers[i].flag & CD_FLAG_NOFREE) {
+    if (customData_layer_is_referenced(&data->layers[i])) {
       return true;
     }
   }
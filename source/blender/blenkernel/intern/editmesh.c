@@ -55,6 +55,7 @@ BMEditMesh *BKE_editmesh_copy(BMEditMesh *em)
 
   em_copy->mesh_eval_cage = em_copy->mesh_eval_final = NULL;
   em_copy->bb_cage = NULL;
+  em_copy->is_deform_tagged = false;
 
   em_copy->bm = BM_mesh_copy(em->bm);
 
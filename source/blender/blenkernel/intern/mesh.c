@@ -587,7 +587,13 @@ void BKE_mesh_copy_data(Main *bmain, Mesh *me_dst, const Mesh *me_src, const int
 
   me_dst->mat = MEM_dupallocN(me_src->mat);
 
-  const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ? CD_REFERENCE : CD_DUPLICATE;
+  eCDAllocType alloc_type = CD_DUPLICATE;
+  if (flag & LIB_ID_COPY_CD_REFERENCE) {
+    alloc_type = CD_REFERENCE;
+  }
+  else if (flag & LIB_ID_COPY_CD_SHARE) {
+    alloc_type = CD_SHARE;
+  }
   CustomData_copy(&me_src->vdata, &me_dst->vdata, mask.vmask, alloc_type, me_dst->totvert);
   CustomData_copy(&me_src->edata, &me_dst->edata, mask.emask, alloc_type, me_dst->totedge);
   CustomData_copy(&me_src->ldata, &me_dst->ldata, mask.lmask, alloc_type, me_dst->totloop);
@@ -1280,8 +1286,13 @@ bool BKE_mesh_minmax(const Mesh *me, float r_min[3], float r_max[3])
 void BKE_mesh_transform(Mesh *me, float mat[4][4], bool do_keys)
 {
   int i;
-  MVert *mvert = me->mvert;
-  float(*lnors)[3] = CustomData_get_layer(&me->ldata, CD_NORMAL);
+  MVert *mvert;
+  float(*lnors)[3];
+
+  /* Layers shared with another mesh (see #CD_SHARE) must keep their coordinates. */
+  me->mvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
+  mvert = me->mvert;
+  lnors = CustomData_duplicate_referenced_layer(&me->ldata, CD_NORMAL, me->totloop);
 
   for (i = 0; i < me->totvert; i++, mvert++) {
     mul_m4_v3(mat, mvert->co);
@@ -1315,6 +1326,9 @@ void BKE_mesh_translate(Mesh *me, const float offset[3], const bool do_keys)
 {
   int i = me->totvert;
   MVert *mvert;
+
+  /* Layers shared with another mesh (see #CD_SHARE) must keep their coordinates. */
+  me->mvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
   for (mvert = me->mvert; i--; mvert++) {
     add_v3_v3(mvert->co, offset);
   }
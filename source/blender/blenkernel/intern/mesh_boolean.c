@@ -0,0 +1,1222 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * Boolean operations working directly on #Mesh arrays, without converting to BMesh.
+ *
+ * - The triangles of every operand are put in a BVH tree, the triangle pairs of different
+ *   operands found by #BLI_bvhtree_overlap are intersected in parallel.
+ * - Each triangle crossed by intersection segments is re-triangulated on its own,
+ *   with a constrained delaunay triangulation in the plane of the triangle.
+ * - Every face is classified as inside or outside of the other operands
+ *   using the winding number of a ray cast, the kept faces are copied into the result.
+ *
+ * Faces which are not crossed by any intersection are copied as they are,
+ * only the polygons that are cut end up triangulated.
+ *
+ * \note Like #BM_mesh_intersect, intersections between coplanar faces are not detected.
+ * Coplanar faces which overlap entirely are handled by the classification.
+ */
+
+#include <float.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_bitmap.h"
+#include "BLI_delaunay_2d.h"
+#include "BLI_kdopbvh.h"
+#include "BLI_kdtree.h"
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_boolean.h" /* own include */
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Types
+ * \{ */
+
+/** Smallest merge distance, relative to the largest coordinate of the operands. */
+#define BOOL_MERGE_EPSILON_REL 1e-6f
+/** Faces with normals closer than this (as a cosine) and touching each other are coplanar. */
+#define BOOL_COPLANAR_COS (1.0f - 1e-5f)
+
+typedef struct BoolOperand {
+  const Mesh *mesh;
+  MLoopTri *looptri;
+  int looptri_len;
+  /** First triangle of each polygon. */
+  int *poly_tri_start;
+  BVHTree *bvhtree;
+  float min[3], max[3];
+  const short *material_remap;
+  int material_remap_len;
+  /** The transform is negative, the surface is inside-out in the result space. */
+  bool is_flip;
+  /** Offsets of the elements of this operand in the arrays of #BoolContext. */
+  int vert_offset;
+  int tri_offset;
+  int poly_offset;
+} BoolOperand;
+
+/** Intersection segment between two triangles of different operands. */
+typedef struct BoolIsect {
+  /** Triangles, indices into all triangles of the operands, -1 when they don't intersect. */
+  int tri[2];
+  float co[2][3];
+} BoolIsect;
+
+/** Re-triangulation of a triangle crossed by intersection segments. */
+typedef struct BoolTriSplit {
+  /** Vertex indices, negative values reference #extra_co (-1 for the first). */
+  int (*tris)[3];
+  int tris_len;
+  /** Vertices created by the triangulation, where segments cross each other. */
+  float (*extra_co)[3];
+  int extra_len;
+} BoolTriSplit;
+
+/** A face of the result, either a whole polygon or a triangle of a cut polygon. */
+typedef struct BoolFace {
+  int poly;
+  /** Source triangle when only a triangle is kept, -1 for the whole polygon. */
+  int tri;
+  int v[3];
+} BoolFace;
+
+typedef struct BoolContext {
+  BoolOperand *operands;
+  int operands_len;
+  int operation;
+  float merge_dist;
+
+  /**
+   * Coordinates in the result space of the vertices of all operands,
+   * followed by the end points of the intersections, then the vertices of the splits.
+   */
+  float (*vert_co)[3];
+  int verts_len;
+  /** Number of vertices of all operands. */
+  int verts_orig_len;
+  /** For each vertex past #verts_orig_len, the triangle to interpolate its data from. */
+  int *vert_new_tri;
+  /** Vertex to merge each vertex into, its own index when unchanged. */
+  int *vert_merge;
+
+  int tris_len;
+  int polys_len;
+
+  BoolIsect *isects;
+  int isects_len;
+  /** Intersections of each triangle, as a range of #tri_isect_index. */
+  int *tri_isect_offset;
+  int *tri_isect_index;
+
+  /** Triangles which have intersections and their splits. */
+  int *split_tris;
+  BoolTriSplit *splits;
+  int splits_len;
+  /** Index into #splits for each triangle, -1 when it isn't split. */
+  int *tri_split;
+
+  BoolFace *faces;
+  int faces_len;
+  bool *face_keep;
+
+  /* Result. */
+  Mesh *result;
+  int *face_dst_loop;
+  int *face_dst_poly;
+  int *vert_dst;
+  int *vert_dst_src;
+} BoolContext;
+
+static int bool_operand_from_vert(const BoolContext *ctx, const int vert)
+{
+  int o = ctx->operands_len - 1;
+  while (ctx->operands[o].vert_offset > vert) {
+    o--;
+  }
+  return o;
+}
+
+static int bool_operand_from_tri(const BoolContext *ctx, const int tri)
+{
+  int o = ctx->operands_len - 1;
+  while (ctx->operands[o].tri_offset > tri) {
+    o--;
+  }
+  return o;
+}
+
+static int bool_operand_from_poly(const BoolContext *ctx, const int poly)
+{
+  int o = ctx->operands_len - 1;
+  while (ctx->operands[o].poly_offset > poly) {
+    o--;
+  }
+  return o;
+}
+
+/** Vertices of a triangle, as indices into #BoolContext.vert_co. */
+static void bool_tri_verts(const BoolContext *ctx, const int tri, int r_verts[3])
+{
+  const BoolOperand *op = &ctx->operands[bool_operand_from_tri(ctx, tri)];
+  const MLoopTri *lt = &op->looptri[tri - op->tri_offset];
+  const MLoop *mloop = op->mesh->mloop;
+  r_verts[0] = op->vert_offset + (int)mloop[lt->tri[0]].v;
+  r_verts[1] = op->vert_offset + (int)mloop[lt->tri[1]].v;
+  r_verts[2] = op->vert_offset + (int)mloop[lt->tri[2]].v;
+}
+
+/* Faces of cutters are flipped for the difference, so they close the hole they cut. */
+static bool bool_operand_is_flip(const BoolContext *ctx, const int o)
+{
+  return ctx->operands[o].is_flip != (ctx->operation == MESH_BOOLEAN_DIFFERENCE && o > 0);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Operands Setup
+ * \{ */
+
+typedef struct BoolTransformData {
+  float (*vert_co)[3];
+  const MVert *mvert;
+  float (*obmat)[4];
+} BoolTransformData;
+
+static void bool_vert_transform_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolTransformData *data = userdata;
+  mul_v3_m4v3(data->vert_co[i], data->obmat, data->mvert[i].co);
+}
+
+static void bool_operand_bvhtree_cb(void *__restrict userdata,
+                                    const int o,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolContext *ctx = userdata;
+  BoolOperand *op = &ctx->operands[o];
+  const MLoop *mloop = op->mesh->mloop;
+  const MPoly *mpoly = op->mesh->mpoly;
+  const float(*vert_co)[3] = ctx->vert_co + op->vert_offset;
+
+  for (int i = 0, tri = 0; i < op->mesh->totpoly; i++) {
+    op->poly_tri_start[i] = tri;
+    tri += max_ii(mpoly[i].totloop - 2, 0);
+  }
+
+  if (op->looptri_len == 0) {
+    return;
+  }
+
+  op->bvhtree = BLI_bvhtree_new(op->looptri_len, ctx->merge_dist, 4, 8);
+  for (int i = 0; i < op->looptri_len; i++) {
+    const MLoopTri *lt = &op->looptri[i];
+    float co[3][3];
+    copy_v3_v3(co[0], vert_co[mloop[lt->tri[0]].v]);
+    copy_v3_v3(co[1], vert_co[mloop[lt->tri[1]].v]);
+    copy_v3_v3(co[2], vert_co[mloop[lt->tri[2]].v]);
+    BLI_bvhtree_insert(op->bvhtree, i, co[0], 3);
+  }
+  BLI_bvhtree_balance(op->bvhtree);
+}
+
+static void bool_operands_init(BoolContext *ctx, const MeshBooleanOperand *operands)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+
+  for (int o = 0; o < ctx->operands_len; o++) {
+    BoolOperand *op = &ctx->operands[o];
+    const Mesh *mesh = operands[o].mesh;
+    op->mesh = mesh;
+    op->material_remap = operands[o].material_remap;
+    op->material_remap_len = operands[o].material_remap_len;
+    op->is_flip = is_negative_m4((float(*)[4])operands[o].obmat);
+    op->vert_offset = ctx->verts_len;
+    op->tri_offset = ctx->tris_len;
+    op->poly_offset = ctx->polys_len;
+
+    op->looptri_len = poly_to_tri_count(mesh->totpoly, mesh->totloop);
+    op->looptri = MEM_malloc_arrayN(max_ii(op->looptri_len, 1), sizeof(*op->looptri), __func__);
+    op->poly_tri_start = MEM_malloc_arrayN(max_ii(mesh->totpoly, 1), sizeof(int), __func__);
+    BKE_mesh_recalc_looptri(
+        mesh->mloop, mesh->mpoly, mesh->mvert, mesh->totloop, mesh->totpoly, op->looptri);
+
+    ctx->verts_len += mesh->totvert;
+    ctx->tris_len += op->looptri_len;
+    ctx->polys_len += mesh->totpoly;
+  }
+  ctx->verts_orig_len = ctx->verts_len;
+
+  ctx->vert_co = MEM_malloc_arrayN(max_ii(ctx->verts_len, 1), sizeof(*ctx->vert_co), __func__);
+  for (int o = 0; o < ctx->operands_len; o++) {
+    BoolOperand *op = &ctx->operands[o];
+    BoolTransformData data = {
+        .vert_co = ctx->vert_co + op->vert_offset,
+        .mvert = op->mesh->mvert,
+        .obmat = (float(*)[4])operands[o].obmat,
+    };
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, op->mesh->totvert, &data, bool_vert_transform_cb, &settings);
+
+    INIT_MINMAX(op->min, op->max);
+    for (int i = 0; i < op->mesh->totvert; i++) {
+      minmax_v3v3_v3(op->min, op->max, data.vert_co[i]);
+    }
+  }
+
+  /* The precision of the intersections depends on the magnitude of the coordinates. */
+  float co_max = 0.0f;
+  for (int o = 0; o < ctx->operands_len; o++) {
+    const BoolOperand *op = &ctx->operands[o];
+    if (op->mesh->totvert != 0) {
+      for (int k = 0; k < 3; k++) {
+        co_max = max_fff(co_max, fabsf(op->min[k]), fabsf(op->max[k]));
+      }
+    }
+  }
+  ctx->merge_dist = max_ff(ctx->merge_dist, co_max * BOOL_MERGE_EPSILON_REL);
+
+  /* Each tree is built on its own thread. */
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, ctx->operands_len, ctx, bool_operand_bvhtree_cb, &settings);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Triangle Intersection
+ * \{ */
+
+static void bool_isect_calc_cb(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolContext *ctx = userdata;
+  BoolIsect *isect = &ctx->isects[i];
+  int verts_a[3], verts_b[3];
+  bool_tri_verts(ctx, isect->tri[0], verts_a);
+  bool_tri_verts(ctx, isect->tri[1], verts_b);
+
+  const float(*vert_co)[3] = ctx->vert_co;
+  if (!isect_tri_tri_epsilon_v3(vert_co[verts_a[0]],
+                                vert_co[verts_a[1]],
+                                vert_co[verts_a[2]],
+                                vert_co[verts_b[0]],
+                                vert_co[verts_b[1]],
+                                vert_co[verts_b[2]],
+                                isect->co[0],
+                                isect->co[1],
+                                FLT_EPSILON) ||
+      (len_squared_v3v3(isect->co[0], isect->co[1]) <= SQUARE(ctx->merge_dist))) {
+    isect->tri[0] = isect->tri[1] = -1;
+  }
+}
+
+/**
+ * Find the intersection segments between triangles of all pairs of operands,
+ * and the intersections of each triangle.
+ */
+static void bool_isects_calc(BoolContext *ctx)
+{
+  int isects_alloc = 0;
+
+  for (int a = 0; a < ctx->operands_len; a++) {
+    const BoolOperand *op_a = &ctx->operands[a];
+    for (int b = a + 1; b < ctx->operands_len; b++) {
+      const BoolOperand *op_b = &ctx->operands[b];
+      if (op_a->bvhtree == NULL || op_b->bvhtree == NULL ||
+          !isect_aabb_aabb_v3(op_a->min, op_a->max, op_b->min, op_b->max)) {
+        continue;
+      }
+
+      uint overlap_len;
+      BVHTreeOverlap *overlap = BLI_bvhtree_overlap(
+          op_a->bvhtree, op_b->bvhtree, &overlap_len, NULL, NULL);
+      if (overlap == NULL) {
+        continue;
+      }
+
+      if (ctx->isects_len + (int)overlap_len > isects_alloc) {
+        isects_alloc = max_ii(isects_alloc * 2, ctx->isects_len + (int)overlap_len);
+        ctx->isects = MEM_reallocN(ctx->isects, sizeof(*ctx->isects) * (size_t)isects_alloc);
+      }
+      for (uint i = 0; i < overlap_len; i++) {
+        BoolIsect *isect = &ctx->isects[ctx->isects_len++];
+        isect->tri[0] = op_a->tri_offset + overlap[i].indexA;
+        isect->tri[1] = op_b->tri_offset + overlap[i].indexB;
+      }
+      MEM_freeN(overlap);
+    }
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(0, ctx->isects_len, ctx, bool_isect_calc_cb, &settings);
+
+  /* Only keep the pairs which really intersect. */
+  int isects_len = 0;
+  for (int i = 0; i < ctx->isects_len; i++) {
+    if (ctx->isects[i].tri[0] != -1) {
+      ctx->isects[isects_len++] = ctx->isects[i];
+    }
+  }
+  ctx->isects_len = isects_len;
+
+  /* Group the intersections by triangle. */
+  ctx->tri_isect_offset = MEM_calloc_arrayN(ctx->tris_len + 1, sizeof(int), __func__);
+  ctx->tri_isect_index = MEM_malloc_arrayN(max_ii(isects_len * 2, 1), sizeof(int), __func__);
+  for (int i = 0; i < isects_len; i++) {
+    ctx->tri_isect_offset[ctx->isects[i].tri[0] + 1]++;
+    ctx->tri_isect_offset[ctx->isects[i].tri[1] + 1]++;
+  }
+  for (int tri = 0; tri < ctx->tris_len; tri++) {
+    ctx->tri_isect_offset[tri + 1] += ctx->tri_isect_offset[tri];
+  }
+  int *tri_fill = MEM_dupallocN(ctx->tri_isect_offset);
+  for (int i = 0; i < isects_len; i++) {
+    ctx->tri_isect_index[tri_fill[ctx->isects[i].tri[0]]++] = i;
+    ctx->tri_isect_index[tri_fill[ctx->isects[i].tri[1]]++] = i;
+  }
+  MEM_freeN(tri_fill);
+
+  /* The end points of the intersections are new vertices, shared by both triangles. */
+  ctx->verts_len += isects_len * 2;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Triangle Splitting
+ * \{ */
+
+/** A triangle with one corner within \a eps of the opposite edge. */
+static bool bool_tri_is_sliver_v2(const float v0[2],
+                                  const float v1[2],
+                                  const float v2[2],
+                                  const float eps)
+{
+  const float edge_len = max_fff(len_v2v2(v0, v1), len_v2v2(v1, v2), len_v2v2(v2, v0));
+  return fabsf(cross_tri_v2(v0, v1, v2)) <= edge_len * eps;
+}
+
+static void bool_tri_split_cb(void *__restrict userdata,
+                              const int i,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolContext *ctx = userdata;
+  BoolTriSplit *split = &ctx->splits[i];
+  const int tri = ctx->split_tris[i];
+  const int isect_start = ctx->tri_isect_offset[tri];
+  const int isect_len = ctx->tri_isect_offset[tri + 1] - isect_start;
+  const int verts_len = 3 + isect_len * 2;
+  const float(*vert_co)[3] = ctx->vert_co;
+
+  int *vert_index = MEM_malloc_arrayN(verts_len, sizeof(int), __func__);
+  float(*co_2d)[2] = MEM_malloc_arrayN(verts_len, sizeof(*co_2d), __func__);
+  int(*edges)[2] = MEM_malloc_arrayN(isect_len, sizeof(*edges), __func__);
+
+  bool_tri_verts(ctx, tri, vert_index);
+  for (int j = 0; j < isect_len; j++) {
+    const int isect = ctx->tri_isect_index[isect_start + j];
+    vert_index[3 + j * 2] = ctx->verts_orig_len + isect * 2;
+    vert_index[3 + j * 2 + 1] = ctx->verts_orig_len + isect * 2 + 1;
+    edges[j][0] = 3 + j * 2;
+    edges[j][1] = 3 + j * 2 + 1;
+  }
+
+  float no[3], axis_mat[3][3];
+  normal_tri_v3(no, vert_co[vert_index[0]], vert_co[vert_index[1]], vert_co[vert_index[2]]);
+  axis_dominant_v3_to_m3(axis_mat, no);
+  for (int j = 0; j < verts_len; j++) {
+    mul_v2_m3v3(co_2d[j], axis_mat, vert_co[vert_index[j]]);
+  }
+
+  /* The triangulation expects a counter-clockwise face. */
+  const bool is_cw = cross_tri_v2(co_2d[0], co_2d[1], co_2d[2]) < 0.0f;
+  int face[3] = {0, is_cw ? 2 : 1, is_cw ? 1 : 2};
+  int face_start = 0, face_len = 3;
+
+  CDT_input in = {
+      .verts_len = verts_len,
+      .edges_len = isect_len,
+      .faces_len = 1,
+      .vert_coords = co_2d,
+      .edges = edges,
+      .faces = face,
+      .faces_start_table = &face_start,
+      .faces_len_table = &face_len,
+      .epsilon = ctx->merge_dist,
+  };
+  CDT_result *out = BLI_delaunay_2d_cdt_calc(&in, CDT_INSIDE);
+
+  /* Output vertices map to the lowest input vertex merged into them, preferring the corners
+   * of the triangle, vertices added by the triangulation only map to indices past the input. */
+  int *out_vert = MEM_malloc_arrayN(max_ii(out->verts_len, 1), sizeof(int), __func__);
+  split->extra_len = 0;
+  for (int v = 0; v < out->verts_len; v++) {
+    const int orig_start = out->verts_orig_start_table[v];
+    int orig = out->verts_orig[orig_start];
+    for (int j = 1; j < out->verts_orig_len_table[v]; j++) {
+      orig = min_ii(orig, out->verts_orig[orig_start + j]);
+    }
+    out_vert[v] = orig;
+    if (orig >= verts_len) {
+      split->extra_len++;
+    }
+  }
+  if (split->extra_len) {
+    split->extra_co = MEM_malloc_arrayN(split->extra_len, sizeof(*split->extra_co), __func__);
+  }
+
+  int extra = 0;
+  for (int v = 0; v < out->verts_len; v++) {
+    if (out_vert[v] < verts_len) {
+      out_vert[v] = vert_index[out_vert[v]];
+    }
+    else {
+      float w[3];
+      barycentric_weights_v2(co_2d[0], co_2d[1], co_2d[2], out->vert_coords[v], w);
+      interp_v3_v3v3v3(split->extra_co[extra],
+                       vert_co[vert_index[0]],
+                       vert_co[vert_index[1]],
+                       vert_co[vert_index[2]],
+                       w);
+      out_vert[v] = -1 - extra;
+      extra++;
+    }
+  }
+
+  split->tris_len = 0;
+  for (int f = 0; f < out->faces_len; f++) {
+    split->tris_len += max_ii(out->faces_len_table[f] - 2, 0);
+  }
+  split->tris = MEM_malloc_arrayN(max_ii(split->tris_len, 1), sizeof(*split->tris), __func__);
+
+  int tri_index = 0;
+  for (int f = 0; f < out->faces_len; f++) {
+    const int *f_verts = &out->faces[out->faces_start_table[f]];
+    for (int j = 2; j < out->faces_len_table[f]; j++) {
+      /* Intersections on the edges of the triangle can leave slivers along them,
+       * the neighbor triangle has the vertex on its side of the edge instead. */
+      if (bool_tri_is_sliver_v2(out->vert_coords[f_verts[0]],
+                                out->vert_coords[f_verts[j - 1]],
+                                out->vert_coords[f_verts[j]],
+                                ctx->merge_dist)) {
+        continue;
+      }
+      /* Restore the winding of the source triangle. */
+      int *t = split->tris[tri_index++];
+      t[0] = out_vert[f_verts[0]];
+      t[1] = out_vert[f_verts[is_cw ? j : j - 1]];
+      t[2] = out_vert[f_verts[is_cw ? j - 1 : j]];
+    }
+  }
+  split->tris_len = tri_index;
+
+  BLI_delaunay_2d_cdt_free(out);
+  MEM_freeN(out_vert);
+  MEM_freeN(vert_index);
+  MEM_freeN(co_2d);
+  MEM_freeN(edges);
+}
+
+/**
+ * Re-triangulate all triangles crossed by intersections,
+ * then give the new vertices their place in #BoolContext.vert_co.
+ */
+static void bool_tris_split(BoolContext *ctx)
+{
+  ctx->tri_split = MEM_malloc_arrayN(max_ii(ctx->tris_len, 1), sizeof(int), __func__);
+  ctx->split_tris = MEM_malloc_arrayN(max_ii(ctx->tris_len, 1), sizeof(int), __func__);
+  for (int tri = 0; tri < ctx->tris_len; tri++) {
+    if (ctx->tri_isect_offset[tri + 1] > ctx->tri_isect_offset[tri]) {
+      ctx->tri_split[tri] = ctx->splits_len;
+      ctx->split_tris[ctx->splits_len++] = tri;
+    }
+    else {
+      ctx->tri_split[tri] = -1;
+    }
+  }
+  ctx->splits = MEM_calloc_arrayN(max_ii(ctx->splits_len, 1), sizeof(*ctx->splits), __func__);
+
+  /* Only the coordinates of the operands are needed for this,
+   * add the end points of the intersections first. */
+  int verts_len = ctx->verts_len;
+  ctx->vert_co = MEM_reallocN(ctx->vert_co, sizeof(*ctx->vert_co) * (size_t)max_ii(verts_len, 1));
+  for (int i = 0; i < ctx->isects_len; i++) {
+    copy_v3_v3(ctx->vert_co[ctx->verts_orig_len + i * 2], ctx->isects[i].co[0]);
+    copy_v3_v3(ctx->vert_co[ctx->verts_orig_len + i * 2 + 1], ctx->isects[i].co[1]);
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 16;
+  BLI_task_parallel_range(0, ctx->splits_len, ctx, bool_tri_split_cb, &settings);
+
+  for (int i = 0; i < ctx->splits_len; i++) {
+    verts_len += ctx->splits[i].extra_len;
+  }
+  ctx->vert_co = MEM_reallocN(ctx->vert_co, sizeof(*ctx->vert_co) * (size_t)max_ii(verts_len, 1));
+  ctx->vert_new_tri = MEM_malloc_arrayN(
+      max_ii(verts_len - ctx->verts_orig_len, 1), sizeof(int), __func__);
+  for (int i = 0; i < ctx->isects_len; i++) {
+    ctx->vert_new_tri[i * 2] = ctx->vert_new_tri[i * 2 + 1] = ctx->isects[i].tri[0];
+  }
+
+  /* Resolve the references to extra vertices. */
+  for (int i = 0; i < ctx->splits_len; i++) {
+    BoolTriSplit *split = &ctx->splits[i];
+    const int extra_start = ctx->verts_len;
+    for (int j = 0; j < split->extra_len; j++) {
+      copy_v3_v3(ctx->vert_co[extra_start + j], split->extra_co[j]);
+      ctx->vert_new_tri[extra_start + j - ctx->verts_orig_len] = ctx->split_tris[i];
+    }
+    for (int j = 0; j < split->tris_len; j++) {
+      for (int k = 0; k < 3; k++) {
+        if (split->tris[j][k] < 0) {
+          split->tris[j][k] = extra_start - 1 - split->tris[j][k];
+        }
+      }
+    }
+    ctx->verts_len += split->extra_len;
+    MEM_SAFE_FREE(split->extra_co);
+  }
+  BLI_assert(ctx->verts_len == verts_len);
+}
+
+/**
+ * Intersection end points are calculated for each triangle pair, merge those that
+ * coincide (on edges shared by triangles) and the ones on the corners of the split triangles.
+ * Vertices of the operands are never merged into other vertices.
+ */
+static void bool_verts_merge(BoolContext *ctx)
+{
+  ctx->vert_merge = MEM_malloc_arrayN(max_ii(ctx->verts_len, 1), sizeof(int), __func__);
+  for (int v = 0; v < ctx->verts_len; v++) {
+    ctx->vert_merge[v] = v;
+  }
+  if (ctx->splits_len == 0) {
+    return;
+  }
+
+  BLI_bitmap *vert_used = BLI_BITMAP_NEW(ctx->verts_orig_len, __func__);
+  int weld_len = ctx->verts_len - ctx->verts_orig_len;
+  for (int i = 0; i < ctx->splits_len; i++) {
+    int verts[3];
+    bool_tri_verts(ctx, ctx->split_tris[i], verts);
+    for (int k = 0; k < 3; k++) {
+      if (!BLI_BITMAP_TEST(vert_used, verts[k])) {
+        BLI_BITMAP_ENABLE(vert_used, verts[k]);
+        weld_len++;
+      }
+    }
+  }
+
+  int *weld_verts = MEM_malloc_arrayN(weld_len, sizeof(int), __func__);
+  int *duplicates = MEM_malloc_arrayN(weld_len, sizeof(int), __func__);
+  KDTree_3d *tree = BLI_kdtree_3d_new(weld_len);
+  int weld_index = 0;
+  for (int v = 0; v < ctx->verts_orig_len; v++) {
+    if (BLI_BITMAP_TEST(vert_used, v)) {
+      /* Can be a target but won't be merged. */
+      duplicates[weld_index] = weld_index;
+      weld_verts[weld_index] = v;
+      BLI_kdtree_3d_insert(tree, weld_index++, ctx->vert_co[v]);
+    }
+  }
+  for (int v = ctx->verts_orig_len; v < ctx->verts_len; v++) {
+    duplicates[weld_index] = -1;
+    weld_verts[weld_index] = v;
+    BLI_kdtree_3d_insert(tree, weld_index++, ctx->vert_co[v]);
+  }
+  BLI_kdtree_3d_balance(tree);
+  BLI_kdtree_3d_calc_duplicates_fast(tree, ctx->merge_dist, true, duplicates);
+
+  for (int i = 0; i < weld_len; i++) {
+    if (duplicates[i] != -1 && duplicates[i] != i) {
+      ctx->vert_merge[weld_verts[i]] = weld_verts[duplicates[i]];
+    }
+  }
+
+  BLI_kdtree_3d_free(tree);
+  MEM_freeN(weld_verts);
+  MEM_freeN(duplicates);
+  MEM_freeN(vert_used);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Face Classification
+ * \{ */
+
+/* Not aligned to any axis, to avoid running along edges of axis aligned geometry. */
+static const float bool_ray_dir[3] = {0.5366563f, 0.6708204f, 0.5118579f};
+
+typedef struct BoolRayData {
+  const BoolContext *ctx;
+  const BoolOperand *op;
+  struct IsectRayPrecalc isect_precalc;
+  int winding;
+} BoolRayData;
+
+static void bool_ray_winding_cb(void *userdata,
+                                int index,
+                                const BVHTreeRay *ray,
+                                BVHTreeRayHit *UNUSED(hit))
+{
+  BoolRayData *data = userdata;
+  const BoolOperand *op = data->op;
+  const MLoopTri *lt = &op->looptri[index];
+  const MLoop *mloop = op->mesh->mloop;
+  const float(*vert_co)[3] = data->ctx->vert_co + op->vert_offset;
+  const float *v0 = vert_co[mloop[lt->tri[0]].v];
+  const float *v1 = vert_co[mloop[lt->tri[1]].v];
+  const float *v2 = vert_co[mloop[lt->tri[2]].v];
+  float dist;
+
+  if (isect_ray_tri_watertight_v3(ray->origin, &data->isect_precalc, v0, v1, v2, &dist, NULL) &&
+      dist > 0.0f) {
+    float no[3];
+    normal_tri_v3(no, v0, v1, v2);
+    /* Leaving through a face pointing away adds one, entering through it removes one. */
+    data->winding += (dot_v3v3(no, ray->direction) > 0.0f) ? 1 : -1;
+  }
+}
+
+static bool bool_point_in_bounds(const float co[3],
+                                 const float min[3],
+                                 const float max[3],
+                                 const float eps)
+{
+  return (co[0] >= min[0] - eps && co[0] <= max[0] + eps && co[1] >= min[1] - eps &&
+          co[1] <= max[1] + eps && co[2] >= min[2] - eps && co[2] <= max[2] + eps);
+}
+
+/** Position of a face relative to the volume of another operand. */
+enum {
+  BOOL_SIDE_OUTSIDE = 0,
+  BOOL_SIDE_INSIDE = 1,
+  /** On a coplanar face of the operand, both facing the same way. */
+  BOOL_SIDE_ON_SAME = 2,
+  /** On a coplanar face of the operand, facing each other. */
+  BOOL_SIDE_ON_OPPOSITE = 3,
+};
+
+typedef struct BoolCoplanarData {
+  const BoolContext *ctx;
+  const BoolOperand *op;
+  const float *co;
+  const float *no;
+  int side;
+} BoolCoplanarData;
+
+static void bool_coplanar_cb(void *userdata,
+                             int index,
+                             const float UNUSED(co[3]),
+                             float UNUSED(dist_sq))
+{
+  BoolCoplanarData *data = userdata;
+  if (data->side != BOOL_SIDE_OUTSIDE) {
+    return;
+  }
+
+  const BoolOperand *op = data->op;
+  const MLoopTri *lt = &op->looptri[index];
+  const MLoop *mloop = op->mesh->mloop;
+  const float(*vert_co)[3] = data->ctx->vert_co + op->vert_offset;
+  const float *v0 = vert_co[mloop[lt->tri[0]].v];
+  const float *v1 = vert_co[mloop[lt->tri[1]].v];
+  const float *v2 = vert_co[mloop[lt->tri[2]].v];
+
+  float no[3], closest[3];
+  normal_tri_v3(no, v0, v1, v2);
+  if (op->is_flip) {
+    negate_v3(no);
+  }
+  const float cos = dot_v3v3(no, data->no);
+  if (fabsf(cos) < BOOL_COPLANAR_COS) {
+    return;
+  }
+  closest_on_tri_to_point_v3(closest, data->co, v0, v1, v2);
+  if (len_squared_v3v3(closest, data->co) <= SQUARE(data->ctx->merge_dist)) {
+    data->side = (cos > 0.0f) ? BOOL_SIDE_ON_SAME : BOOL_SIDE_ON_OPPOSITE;
+  }
+}
+
+/**
+ * Find on which side of operand \a o the point \a co of a face with normal \a no is.
+ * Intersections between coplanar faces are not cut, faces lying on the surface of the operand
+ * are told apart from the ones inside or outside of it, the ray cast can't decide for them.
+ */
+static int bool_point_side(const BoolContext *ctx,
+                           const int o,
+                           const float co[3],
+                           const float no[3])
+{
+  const BoolOperand *op = &ctx->operands[o];
+  if (op->bvhtree == NULL || !bool_point_in_bounds(co, op->min, op->max, ctx->merge_dist)) {
+    return BOOL_SIDE_OUTSIDE;
+  }
+
+  BoolCoplanarData coplanar = {.ctx = ctx, .op = op, .co = co, .no = no};
+  BLI_bvhtree_range_query(op->bvhtree, co, ctx->merge_dist, bool_coplanar_cb, &coplanar);
+  if (coplanar.side != BOOL_SIDE_OUTSIDE) {
+    return coplanar.side;
+  }
+
+  BoolRayData data = {.ctx = ctx, .op = op};
+  isect_ray_tri_watertight_v3_precalc(&data.isect_precalc, bool_ray_dir);
+  BLI_bvhtree_ray_cast_all(
+      op->bvhtree, co, bool_ray_dir, 0.0f, BVH_RAYCAST_DIST_MAX, bool_ray_winding_cb, &data);
+
+  return ((op->is_flip ? -data.winding : data.winding) > 0) ? BOOL_SIDE_INSIDE :
+                                                               BOOL_SIDE_OUTSIDE;
+}
+
+/**
+ * Whether a face of operand \a o is kept, given its side of operand \a q.
+ * Of coplanar faces facing the same way only the one of the first operand is kept,
+ * coplanar faces facing each other are inside the result or touch from outside.
+ */
+static bool bool_face_keep_side(const BoolContext *ctx, const int o, const int q, const int side)
+{
+  const bool on_same_keep = (side == BOOL_SIDE_ON_SAME) && (o < q);
+  switch (ctx->operation) {
+    case MESH_BOOLEAN_UNION:
+      return (side == BOOL_SIDE_OUTSIDE) || on_same_keep;
+    case MESH_BOOLEAN_INTERSECT:
+      return (side == BOOL_SIDE_INSIDE) || on_same_keep;
+    case MESH_BOOLEAN_DIFFERENCE:
+      if (o == 0) {
+        /* The first operand keeps what is outside of the cutters. */
+        return ELEM(side, BOOL_SIDE_OUTSIDE, BOOL_SIDE_ON_OPPOSITE);
+      }
+      if (q == 0) {
+        /* Cutters keep what is inside the first operand. */
+        return side == BOOL_SIDE_INSIDE;
+      }
+      /* And outside the other cutters. */
+      return (side == BOOL_SIDE_OUTSIDE) || on_same_keep;
+  }
+  return false;
+}
+
+static void bool_face_classify_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolContext *ctx = userdata;
+  const BoolFace *face = &ctx->faces[i];
+  const int o = bool_operand_from_poly(ctx, face->poly);
+  const BoolOperand *op = &ctx->operands[o];
+  const int *vert_merge = ctx->vert_merge;
+  int verts[3];
+
+  if (face->tri == -1) {
+    const MPoly *mp = &op->mesh->mpoly[face->poly - op->poly_offset];
+    if (mp->totloop < 3) {
+      ctx->face_keep[i] = false;
+      return;
+    }
+    /* Uncut polygons are entirely on one side, any of their triangles tells which. */
+    bool_tri_verts(ctx, op->tri_offset + op->poly_tri_start[face->poly - op->poly_offset], verts);
+  }
+  else {
+    /* Skip triangles collapsed by merging. */
+    if (ELEM(vert_merge[face->v[0]], vert_merge[face->v[1]], vert_merge[face->v[2]]) ||
+        vert_merge[face->v[1]] == vert_merge[face->v[2]]) {
+      ctx->face_keep[i] = false;
+      return;
+    }
+    copy_v3_v3_int(verts, face->v);
+  }
+
+  const float(*vert_co)[3] = ctx->vert_co;
+  float center[3], no[3];
+  mid_v3_v3v3v3(center, vert_co[verts[0]], vert_co[verts[1]], vert_co[verts[2]]);
+  normal_tri_v3(no, vert_co[verts[0]], vert_co[verts[1]], vert_co[verts[2]]);
+  if (op->is_flip) {
+    negate_v3(no);
+  }
+
+  bool keep = true;
+  for (int q = 0; q < ctx->operands_len && keep; q++) {
+    if (q != o) {
+      keep = bool_face_keep_side(ctx, o, q, bool_point_side(ctx, q, center, no));
+    }
+  }
+  ctx->face_keep[i] = keep;
+}
+
+/** Build the list of faces which can be part of the result and decide which ones to keep. */
+static void bool_faces_classify(BoolContext *ctx)
+{
+  bool *poly_is_cut = MEM_calloc_arrayN(max_ii(ctx->polys_len, 1), sizeof(bool), __func__);
+  for (int i = 0; i < ctx->splits_len; i++) {
+    const int tri = ctx->split_tris[i];
+    const BoolOperand *op = &ctx->operands[bool_operand_from_tri(ctx, tri)];
+    poly_is_cut[op->poly_offset + (int)op->looptri[tri - op->tri_offset].poly] = true;
+  }
+
+  /* Cut polygons are replaced by their triangles, split or not. */
+  for (int o = 0; o < ctx->operands_len; o++) {
+    const BoolOperand *op = &ctx->operands[o];
+    const MPoly *mpoly = op->mesh->mpoly;
+    for (int p = 0; p < op->mesh->totpoly; p++) {
+      if (!poly_is_cut[op->poly_offset + p]) {
+        ctx->faces_len++;
+        continue;
+      }
+      const int tri_start = op->tri_offset + op->poly_tri_start[p];
+      for (int tri = tri_start; tri < tri_start + mpoly[p].totloop - 2; tri++) {
+        const int split = ctx->tri_split[tri];
+        ctx->faces_len += (split == -1) ? 1 : ctx->splits[split].tris_len;
+      }
+    }
+  }
+
+  ctx->faces = MEM_malloc_arrayN(max_ii(ctx->faces_len, 1), sizeof(*ctx->faces), __func__);
+  ctx->face_keep = MEM_malloc_arrayN(max_ii(ctx->faces_len, 1), sizeof(bool), __func__);
+  BoolFace *face = ctx->faces;
+  for (int o = 0; o < ctx->operands_len; o++) {
+    const BoolOperand *op = &ctx->operands[o];
+    const MPoly *mpoly = op->mesh->mpoly;
+    for (int p = 0; p < op->mesh->totpoly; p++) {
+      const int poly = op->poly_offset + p;
+      if (!poly_is_cut[poly]) {
+        face->poly = poly;
+        face->tri = -1;
+        face++;
+        continue;
+      }
+      const int tri_start = op->tri_offset + op->poly_tri_start[p];
+      for (int tri = tri_start; tri < tri_start + mpoly[p].totloop - 2; tri++) {
+        const int split = ctx->tri_split[tri];
+        if (split == -1) {
+          face->poly = poly;
+          face->tri = tri;
+          bool_tri_verts(ctx, tri, face->v);
+          face++;
+          continue;
+        }
+        for (int j = 0; j < ctx->splits[split].tris_len; j++) {
+          face->poly = poly;
+          face->tri = tri;
+          copy_v3_v3_int(face->v, ctx->splits[split].tris[j]);
+          face++;
+        }
+      }
+    }
+  }
+  BLI_assert(face - ctx->faces == ctx->faces_len);
+  MEM_freeN(poly_is_cut);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(0, ctx->faces_len, ctx, bool_face_classify_cb, &settings);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Result Assembly
+ * \{ */
+
+static void bool_result_vert_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolContext *ctx = userdata;
+  Mesh *result = ctx->result;
+  const int v = ctx->vert_dst_src[i];
+
+  if (v < ctx->verts_orig_len) {
+    const BoolOperand *op = &ctx->operands[bool_operand_from_vert(ctx, v)];
+    CustomData_copy_data(&op->mesh->vdata, &result->vdata, v - op->vert_offset, i, 1);
+  }
+  else {
+    const int tri = ctx->vert_new_tri[v - ctx->verts_orig_len];
+    const BoolOperand *op = &ctx->operands[bool_operand_from_tri(ctx, tri)];
+    int verts[3], src_verts[3];
+    float w[3];
+    bool_tri_verts(ctx, tri, verts);
+    interp_weights_tri_v3(
+        w, ctx->vert_co[verts[0]], ctx->vert_co[verts[1]], ctx->vert_co[verts[2]], ctx->vert_co[v]);
+    for (int k = 0; k < 3; k++) {
+      src_verts[k] = verts[k] - op->vert_offset;
+    }
+    CustomData_interp(&op->mesh->vdata, &result->vdata, src_verts, w, NULL, 3, i);
+  }
+
+  copy_v3_v3(result->mvert[i].co, ctx->vert_co[v]);
+}
+
+static void bool_result_face_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BoolContext *ctx = userdata;
+  if (!ctx->face_keep[i]) {
+    return;
+  }
+
+  Mesh *result = ctx->result;
+  const BoolFace *face = &ctx->faces[i];
+  const int o = bool_operand_from_poly(ctx, face->poly);
+  const BoolOperand *op = &ctx->operands[o];
+  const Mesh *mesh = op->mesh;
+  const MPoly *mp_src = &mesh->mpoly[face->poly - op->poly_offset];
+  const bool is_flip = bool_operand_is_flip(ctx, o);
+  const int poly_dst = ctx->face_dst_poly[i];
+  const int loop_dst = ctx->face_dst_loop[i];
+
+  CustomData_copy_data(&mesh->pdata, &result->pdata, face->poly - op->poly_offset, poly_dst, 1);
+  MPoly *mp = &result->mpoly[poly_dst];
+  mp->loopstart = loop_dst;
+  mp->totloop = (face->tri == -1) ? mp_src->totloop : 3;
+  if (op->material_remap && mp->mat_nr < op->material_remap_len) {
+    mp->mat_nr = op->material_remap[mp->mat_nr];
+  }
+
+  if (face->tri == -1) {
+    for (int k = 0; k < mp_src->totloop; k++) {
+      const int loop_src = mp_src->loopstart +
+                           (is_flip ? (mp_src->totloop - k) % mp_src->totloop : k);
+      CustomData_copy_data(&mesh->ldata, &result->ldata, loop_src, loop_dst + k, 1);
+      const int v = ctx->vert_merge[op->vert_offset + (int)mesh->mloop[loop_src].v];
+      result->mloop[loop_dst + k].v = (uint)ctx->vert_dst[v];
+    }
+    return;
+  }
+
+  const MLoopTri *lt = &op->looptri[face->tri - op->tri_offset];
+  int tri_verts[3];
+  bool_tri_verts(ctx, face->tri, tri_verts);
+  for (int k = 0; k < 3; k++) {
+    const int v_src = face->v[is_flip ? (3 - k) % 3 : k];
+    int corner = -1;
+    for (int j = 0; j < 3; j++) {
+      if (tri_verts[j] == v_src) {
+        corner = j;
+      }
+    }
+
+    if (corner != -1) {
+      CustomData_copy_data(
+          &mesh->ldata, &result->ldata, (int)lt->tri[corner], loop_dst + k, 1);
+    }
+    else {
+      const int src_loops[3] = {(int)lt->tri[0], (int)lt->tri[1], (int)lt->tri[2]};
+      float w[3];
+      interp_weights_tri_v3(w,
+                            ctx->vert_co[tri_verts[0]],
+                            ctx->vert_co[tri_verts[1]],
+                            ctx->vert_co[tri_verts[2]],
+                            ctx->vert_co[v_src]);
+      CustomData_interp(&mesh->ldata, &result->ldata, src_loops, w, NULL, 3, loop_dst + k);
+    }
+    result->mloop[loop_dst + k].v = (uint)ctx->vert_dst[ctx->vert_merge[v_src]];
+  }
+}
+
+/** Copy the edge flags of polygons kept as a whole, other edges only get default flags. */
+static void bool_result_edges_copy(BoolContext *ctx)
+{
+  Mesh *result = ctx->result;
+  for (int i = 0; i < ctx->faces_len; i++) {
+    const BoolFace *face = &ctx->faces[i];
+    if (!ctx->face_keep[i] || face->tri != -1) {
+      continue;
+    }
+    const int o = bool_operand_from_poly(ctx, face->poly);
+    const BoolOperand *op = &ctx->operands[o];
+    const MPoly *mp_src = &op->mesh->mpoly[face->poly - op->poly_offset];
+    const bool is_flip = bool_operand_is_flip(ctx, o);
+    const int totloop = mp_src->totloop;
+    for (int k = 0; k < totloop; k++) {
+      /* Flipped polygons go backwards, the edge of a loop is the one of the previous loop. */
+      const int loop_src = mp_src->loopstart + (is_flip ? (totloop - k - 1) : k);
+      const MEdge *med_src = &op->mesh->medge[op->mesh->mloop[loop_src].e];
+      MEdge *med = &result->medge[result->mloop[ctx->face_dst_loop[i] + k].e];
+      med->flag |= med_src->flag & (ME_SEAM | ME_SHARP);
+      med->crease = med_src->crease;
+      med->bweight = med_src->bweight;
+    }
+  }
+}
+
+static Mesh *bool_result_create(BoolContext *ctx)
+{
+  int polys_len = 0, loops_len = 0;
+  ctx->face_dst_poly = MEM_malloc_arrayN(max_ii(ctx->faces_len, 1), sizeof(int), __func__);
+  ctx->face_dst_loop = MEM_malloc_arrayN(max_ii(ctx->faces_len, 1), sizeof(int), __func__);
+  ctx->vert_dst = MEM_malloc_arrayN(max_ii(ctx->verts_len, 1), sizeof(int), __func__);
+  copy_vn_i(ctx->vert_dst, ctx->verts_len, -1);
+
+  for (int i = 0; i < ctx->faces_len; i++) {
+    if (!ctx->face_keep[i]) {
+      continue;
+    }
+    const BoolFace *face = &ctx->faces[i];
+    ctx->face_dst_poly[i] = polys_len++;
+    ctx->face_dst_loop[i] = loops_len;
+    if (face->tri == -1) {
+      const BoolOperand *op = &ctx->operands[bool_operand_from_poly(ctx, face->poly)];
+      const MPoly *mp = &op->mesh->mpoly[face->poly - op->poly_offset];
+      const MLoop *ml = &op->mesh->mloop[mp->loopstart];
+      for (int k = 0; k < mp->totloop; k++) {
+        ctx->vert_dst[ctx->vert_merge[op->vert_offset + (int)ml[k].v]] = 0;
+      }
+      loops_len += mp->totloop;
+    }
+    else {
+      for (int k = 0; k < 3; k++) {
+        ctx->vert_dst[ctx->vert_merge[face->v[k]]] = 0;
+      }
+      loops_len += 3;
+    }
+  }
+
+  int verts_len = 0;
+  for (int v = 0; v < ctx->verts_len; v++) {
+    if (ctx->vert_dst[v] != -1) {
+      ctx->vert_dst[v] = verts_len++;
+    }
+  }
+  ctx->vert_dst_src = MEM_malloc_arrayN(max_ii(verts_len, 1), sizeof(int), __func__);
+  for (int v = 0; v < ctx->verts_len; v++) {
+    if (ctx->vert_dst[v] != -1) {
+      ctx->vert_dst_src[ctx->vert_dst[v]] = v;
+    }
+  }
+
+  Mesh *result = BKE_mesh_new_nomain_from_template(
+      ctx->operands[0].mesh, verts_len, 0, 0, loops_len, polys_len);
+  for (int o = 1; o < ctx->operands_len; o++) {
+    const Mesh *mesh = ctx->operands[o].mesh;
+    CustomData_merge(&mesh->vdata, &result->vdata, CD_MASK_EVERYTHING.vmask, CD_CALLOC, verts_len);
+    CustomData_merge(&mesh->ldata, &result->ldata, CD_MASK_EVERYTHING.lmask, CD_CALLOC, loops_len);
+    CustomData_merge(&mesh->pdata, &result->pdata, CD_MASK_EVERYTHING.pmask, CD_CALLOC, polys_len);
+    result->cd_flag |= mesh->cd_flag;
+  }
+  BKE_mesh_update_customdata_pointers(result, false);
+  ctx->result = result;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, verts_len, ctx, bool_result_vert_cb, &settings);
+  BLI_task_parallel_range(0, ctx->faces_len, ctx, bool_result_face_cb, &settings);
+
+  BKE_mesh_calc_edges(result, false, false);
+  bool_result_edges_copy(ctx);
+
+  result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+
+  return result;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Public API
+ * \{ */
+
+static void bool_context_free(BoolContext *ctx)
+{
+  for (int o = 0; o < ctx->operands_len; o++) {
+    BoolOperand *op = &ctx->operands[o];
+    if (op->bvhtree) {
+      BLI_bvhtree_free(op->bvhtree);
+    }
+    MEM_freeN(op->looptri);
+    MEM_freeN(op->poly_tri_start);
+  }
+  for (int i = 0; i < ctx->splits_len; i++) {
+    MEM_freeN(ctx->splits[i].tris);
+  }
+  MEM_freeN(ctx->operands);
+  MEM_SAFE_FREE(ctx->vert_co);
+  MEM_SAFE_FREE(ctx->vert_new_tri);
+  MEM_SAFE_FREE(ctx->vert_merge);
+  MEM_SAFE_FREE(ctx->isects);
+  MEM_SAFE_FREE(ctx->tri_isect_offset);
+  MEM_SAFE_FREE(ctx->tri_isect_index);
+  MEM_SAFE_FREE(ctx->split_tris);
+  MEM_SAFE_FREE(ctx->splits);
+  MEM_SAFE_FREE(ctx->tri_split);
+  MEM_SAFE_FREE(ctx->faces);
+  MEM_SAFE_FREE(ctx->face_keep);
+  MEM_SAFE_FREE(ctx->face_dst_poly);
+  MEM_SAFE_FREE(ctx->face_dst_loop);
+  MEM_SAFE_FREE(ctx->vert_dst);
+  MEM_SAFE_FREE(ctx->vert_dst_src);
+}
+
+/**
+ * Calculate a boolean operation between any number of meshes in a single pass.
+ *
+ * For #MESH_BOOLEAN_DIFFERENCE all other operands are subtracted from the first one.
+ * The result uses the custom-data layers of all operands, in the space of the first operand.
+ *
+ * \param merge_threshold: Distance under which intersection points are merged,
+ * at least the precision of the coordinates of the operands.
+ * \return A new mesh, which is empty when nothing of the operands is kept.
+ */
+Mesh *BKE_mesh_boolean(const MeshBooleanOperand *operands,
+                       const int operands_len,
+                       const int operation,
+                       const float merge_threshold)
+{
+  BLI_assert(operands_len > 0);
+
+  BoolContext ctx = {
+      .operands = MEM_calloc_arrayN(operands_len, sizeof(BoolOperand), __func__),
+      .operands_len = operands_len,
+      .operation = operation,
+      .merge_dist = max_ff(merge_threshold, FLT_EPSILON),
+  };
+
+  bool_operands_init(&ctx, operands);
+  bool_isects_calc(&ctx);
+  bool_tris_split(&ctx);
+  bool_verts_merge(&ctx);
+  bool_faces_classify(&ctx);
+  Mesh *result = bool_result_create(&ctx);
+
+  bool_context_free(&ctx);
+
+  return result;
+}
+
+/** \} */
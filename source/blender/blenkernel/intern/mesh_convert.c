@@ -1138,7 +1138,10 @@ static Mesh *mesh_new_from_mesh_object(Depsgraph *depsgraph,
   return mesh_new_from_mesh(object, mesh_input);
 }
 
-Mesh *BKE_mesh_new_from_object(Depsgraph *depsgraph, Object *object, bool preserve_all_data_layers)
+Mesh *BKE_mesh_new_from_object_ex(Depsgraph *depsgraph,
+                                  Object *object,
+                                  bool preserve_all_data_layers,
+                                  bool realize_instances)
 {
   Mesh *new_mesh = NULL;
   switch (object->type) {
@@ -1161,12 +1164,29 @@ Mesh *BKE_mesh_new_from_object(Depsgraph *depsgraph, Object *object, bool preser
     /* Happens in special cases like request of mesh for non-mother meta ball. */
     return NULL;
   }
+  if (new_mesh->runtime.instance_mats_len != 0) {
+    if (realize_instances) {
+      Mesh *mesh_realized = BKE_mesh_runtime_instances_realize(new_mesh);
+      BLI_strncpy(mesh_realized->id.name, new_mesh->id.name, sizeof(mesh_realized->id.name));
+      BKE_id_free(NULL, new_mesh);
+      new_mesh = mesh_realized;
+    }
+    else {
+      MEM_SAFE_FREE(new_mesh->runtime.instance_mats);
+      new_mesh->runtime.instance_mats_len = 0;
+    }
+  }
   /* The result must have 0 users, since it's just a mesh which is free-dangling data-block.
    * All the conversion functions are supposed to ensure mesh is not counted. */
   BLI_assert(new_mesh->id.us == 0);
   return new_mesh;
 }
 
+Mesh *BKE_mesh_new_from_object(Depsgraph *depsgraph, Object *object, bool preserve_all_data_layers)
+{
+  return BKE_mesh_new_from_object_ex(depsgraph, object, preserve_all_data_layers, true);
+}
+
 static int foreach_libblock_make_original_callback(void *UNUSED(user_data_v),
                                                    ID *UNUSED(id_self),
                                                    ID **id_p,
@@ -1356,6 +1376,13 @@ Mesh *BKE_mesh_create_derived_for_modifier(struct Depsgraph *depsgraph,
     if (mesh_temp != result) {
       BKE_id_free(NULL, mesh_temp);
     }
+
+    /* The applied modifier is baked into the geometry, including its instances. */
+    if (result->runtime.instance_mats_len != 0) {
+      Mesh *mesh_realized = BKE_mesh_runtime_instances_realize(result);
+      BKE_id_free(NULL, result);
+      result = mesh_realized;
+    }
   }
 
   return result;
@@ -30,6 +30,8 @@
 #include "DNA_object_types.h"
 
 #include "BLI_math_geom.h"
+#include "BLI_math_matrix.h"
+#include "BLI_math_vector.h"
 #include "BLI_threads.h"
 
 #include "BKE_bvhutils.h"
@@ -69,6 +71,10 @@ void BKE_mesh_runtime_reset_on_copy(Mesh *mesh, const int UNUSED(flag))
   memset(&runtime->looptris, 0, sizeof(runtime->looptris));
   runtime->bvh_cache = NULL;
   runtime->shrinkwrap_data = NULL;
+  if (runtime->instance_mats != NULL) {
+    runtime->instance_mats = MEM_dupallocN(runtime->instance_mats);
+  }
+  runtime->instances_realized = NULL;
 
   mesh->runtime.eval_mutex = MEM_mallocN(sizeof(ThreadMutex), "mesh runtime eval_mutex");
   BLI_mutex_init(mesh->runtime.eval_mutex);
@@ -89,6 +95,91 @@ void BKE_mesh_runtime_clear_cache(Mesh *mesh)
   BKE_mesh_runtime_clear_geometry(mesh);
   BKE_mesh_batch_cache_free(mesh);
   BKE_mesh_runtime_clear_edit_data(mesh);
+  MEM_SAFE_FREE(mesh->runtime.instance_mats);
+  mesh->runtime.instance_mats_len = 0;
+}
+
+/**
+ * Create a mesh with the geometry of the mesh and of all its instances,
+ * for when the evaluated mesh is applied or converted.
+ */
+Mesh *BKE_mesh_runtime_instances_realize(const Mesh *mesh)
+{
+  const int copies_len = mesh->runtime.instance_mats_len + 1;
+  const int totvert = mesh->totvert;
+  const int totedge = mesh->totedge;
+  const int totloop = mesh->totloop;
+  const int totpoly = mesh->totpoly;
+
+  Mesh *result = BKE_mesh_new_nomain_from_template(mesh,
+                                                   totvert * copies_len,
+                                                   totedge * copies_len,
+                                                   0,
+                                                   totloop * copies_len,
+                                                   totpoly * copies_len);
+
+  for (int c = 0; c < copies_len; c++) {
+    CustomData_copy_data(&mesh->vdata, &result->vdata, 0, c * totvert, totvert);
+    CustomData_copy_data(&mesh->edata, &result->edata, 0, c * totedge, totedge);
+    CustomData_copy_data(&mesh->ldata, &result->ldata, 0, c * totloop, totloop);
+    CustomData_copy_data(&mesh->pdata, &result->pdata, 0, c * totpoly, totpoly);
+    if (c == 0) {
+      continue;
+    }
+
+    float(*mat)[4] = mesh->runtime.instance_mats[c - 1];
+    MVert *mv = &result->mvert[c * totvert];
+    for (int i = 0; i < totvert; i++, mv++) {
+      float no[3];
+      mul_m4_v3(mat, mv->co);
+      normal_short_to_float_v3(no, mv->no);
+      mul_mat3_m4_v3(mat, no);
+      normalize_v3(no);
+      normal_float_to_short_v3(mv->no, no);
+    }
+
+    MEdge *me = &result->medge[c * totedge];
+    for (int i = 0; i < totedge; i++, me++) {
+      me->v1 += c * totvert;
+      me->v2 += c * totvert;
+    }
+
+    MPoly *mp = &result->mpoly[c * totpoly];
+    for (int i = 0; i < totpoly; i++, mp++) {
+      mp->loopstart += c * totloop;
+    }
+
+    MLoop *ml = &result->mloop[c * totloop];
+    for (int i = 0; i < totloop; i++, ml++) {
+      ml->v += c * totvert;
+      ml->e += c * totedge;
+    }
+  }
+
+  result->runtime.cd_dirty_vert |= mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL;
+
+  return result;
+}
+
+/**
+ * Get the geometry of the mesh including its instances, for objects and tools reading the mesh
+ * of another object, which don't see the instances as duplis. The mesh itself is returned when
+ * it has no instances, the realized mesh is cached until the geometry is cleared.
+ */
+Mesh *BKE_mesh_runtime_instances_realized_ensure(Mesh *mesh)
+{
+  if (mesh->runtime.instance_mats_len == 0) {
+    return mesh;
+  }
+
+  /* Readers of an object can run on many threads. */
+  BLI_mutex_lock(mesh->runtime.eval_mutex);
+  if (mesh->runtime.instances_realized == NULL) {
+    mesh->runtime.instances_realized = BKE_mesh_runtime_instances_realize(mesh);
+  }
+  BLI_mutex_unlock(mesh->runtime.eval_mutex);
+
+  return mesh->runtime.instances_realized;
 }
 
 /* This is a ported copy of DM_ensure_looptri_data(dm) */
@@ -235,6 +326,10 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
     mesh->runtime.subdiv_ccg = NULL;
   }
   BKE_shrinkwrap_discard_boundary_data(mesh);
+  if (mesh->runtime.instances_realized != NULL) {
+    BKE_id_free(NULL, mesh->runtime.instances_realized);
+    mesh->runtime.instances_realized = NULL;
+  }
 }
 
 /** \} */
@@ -44,6 +44,7 @@
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.h"
+#include "BLI_trace.h"
 
 #include "BLT_translation.h"
 
@@ -56,6 +57,7 @@
 #include "BKE_library.h"
 #include "BKE_library_query.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_runtime.h"
 #include "BKE_multires.h"
 #include "BKE_object.h"
 #include "BKE_DerivedMesh.h"
@@ -71,6 +73,8 @@
 
 #include "CLG_log.h"
 
+#include "PIL_time.h"
+
 static CLG_LogRef LOG = {"bke.modifier"};
 static ModifierTypeInfo *modifier_types[NUM_MODIFIER_TYPES] = {NULL};
 static VirtualModifierData virtualModifierCommonData;
@@ -946,6 +950,16 @@ void modifier_path_init(char *path, int path_maxlen, const char *name)
   BLI_join_dirfile(path, path_maxlen, G.relbase_valid ? "//" : BKE_tempdir_session(), name);
 }
 
+/* Record evaluation of a modifier for `--debug-trace`. */
+static void modwrap_trace_event(const ModifierData *md,
+                                const ModifierEvalContext *ctx,
+                                double start_time)
+{
+  char name[MAX_ID_NAME + sizeof(md->name) + 1];
+  BLI_snprintf(name, sizeof(name), "%s/%s", ctx->object->id.name, md->name);
+  BLI_trace_event("modifier", name, start_time, PIL_check_seconds_timer());
+}
+
 /* wrapper around ModifierTypeInfo.applyModifier that ensures valid normals */
 
 struct Mesh *modwrap_applyModifier(ModifierData *md,
@@ -953,12 +967,19 @@ struct Mesh *modwrap_applyModifier(ModifierData *md,
                                    struct Mesh *me)
 {
   const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+  const bool do_trace = BLI_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
   BLI_assert(CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
   if (mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     BKE_mesh_calc_normals(me);
   }
-  return mti->applyModifier(md, ctx, me);
+  Mesh *result = mti->applyModifier(md, ctx, me);
+
+  if (do_trace) {
+    modwrap_trace_event(md, ctx, start_time);
+  }
+  return result;
 }
 
 void modwrap_deformVerts(ModifierData *md,
@@ -968,12 +989,18 @@ void modwrap_deformVerts(ModifierData *md,
                          int numVerts)
 {
   const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+  const bool do_trace = BLI_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
   BLI_assert(!me || CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
   if (me && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     BKE_mesh_calc_normals(me);
   }
   mti->deformVerts(md, ctx, me, vertexCos, numVerts);
+
+  if (do_trace) {
+    modwrap_trace_event(md, ctx, start_time);
+  }
 }
 
 void modwrap_deformVertsEM(ModifierData *md,
@@ -984,12 +1011,18 @@ void modwrap_deformVertsEM(ModifierData *md,
                            int numVerts)
 {
   const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+  const bool do_trace = BLI_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
   BLI_assert(!me || CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
   if (me && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     BKE_mesh_calc_normals(me);
   }
   mti->deformVertsEM(md, ctx, em, me, vertexCos, numVerts);
+
+  if (do_trace) {
+    modwrap_trace_event(md, ctx, start_time);
+  }
 }
 
 /* end modifier callback wrappers */
@@ -1023,6 +1056,11 @@ Mesh *BKE_modifier_get_evaluated_mesh_from_evaluated_object(Object *ob_eval,
              ob_eval->runtime.mesh_eval;
   }
 
+  /* Other objects don't see the instances as duplis, give them the whole geometry. */
+  if (me != NULL) {
+    me = BKE_mesh_runtime_instances_realized_ensure(me);
+  }
+
   return me;
 }
 
@@ -3528,6 +3528,10 @@ bool nodeUpdateID(bNodeTree *ntree, ID *id)
       if (node->typeinfo->updatefunc) {
         node->typeinfo->updatefunc(ntree, node);
       }
+      /* cached results depend on the old contents of the data-block */
+      if (ntree->typeinfo->free_node_cache) {
+        ntree->typeinfo->free_node_cache(ntree, node);
+      }
       /* clear update flag */
       node->update = 0;
     }
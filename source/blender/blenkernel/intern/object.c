@@ -739,6 +739,11 @@ int BKE_object_visibility(const Object *ob, const int dag_eval_mode)
     }
   }
 
+  /* Instances of the evaluated mesh are copies of the object itself, which stays visible. */
+  if (ob->transflag & OB_DUPLIMESH) {
+    visibility |= OB_VISIBLE_INSTANCES;
+  }
+
   return visibility;
 }
 
@@ -2783,6 +2788,19 @@ void BKE_object_boundbox_calc_from_mesh(struct Object *ob, struct Mesh *me_eval)
     zero_v3(max);
   }
 
+  /* The instances are drawn as part of the object, include them without realizing the mesh. */
+  if (me_eval->runtime.instance_mats_len != 0) {
+    BoundBox bb_mesh;
+    BKE_boundbox_init_from_minmax(&bb_mesh, min, max);
+    for (int i = 0; i < me_eval->runtime.instance_mats_len; i++) {
+      for (int j = 0; j < 8; j++) {
+        float co[3];
+        mul_v3_m4v3(co, me_eval->runtime.instance_mats[i], bb_mesh.vec[j]);
+        minmax_v3v3_v3(min, max, co);
+      }
+    }
+  }
+
   if (ob->runtime.bb == NULL) {
     ob->runtime.bb = MEM_callocN(sizeof(BoundBox), "DM-BoundBox");
   }
@@ -4451,11 +4469,15 @@ void BKE_object_update_select_id(struct Main *bmain)
   }
 }
 
-Mesh *BKE_object_to_mesh(Depsgraph *depsgraph, Object *object, bool preserve_all_data_layers)
+Mesh *BKE_object_to_mesh(Depsgraph *depsgraph,
+                         Object *object,
+                         bool preserve_all_data_layers,
+                         bool realize_instances)
 {
   BKE_object_to_mesh_clear(object);
 
-  Mesh *mesh = BKE_mesh_new_from_object(depsgraph, object, preserve_all_data_layers);
+  Mesh *mesh = BKE_mesh_new_from_object_ex(
+      depsgraph, object, preserve_all_data_layers, realize_instances);
   object->runtime.object_as_temp_mesh = mesh;
   return mesh;
 }
@@ -43,6 +43,7 @@
 #include "DNA_scene_types.h"
 
 #include "BKE_action.h"
+#include "BKE_customdata.h"
 #include "BKE_deform.h"
 #include "BKE_editmesh.h"
 #include "BKE_object_deform.h" /* own include */
@@ -198,6 +199,7 @@ bool BKE_object_defgroup_clear(Object *ob, bDeformGroup *dg, const bool use_sele
         MVert *mv;
         int i;
 
+        me->dvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MDEFORMVERT, me->totvert);
         mv = me->mvert;
         dv = me->dvert;
 
@@ -547,6 +549,8 @@ bool BKE_object_defgroup_array_get(ID *id, MDeformVert **dvert_arr, int *dvert_t
     switch (GS(id->name)) {
       case ID_ME: {
         Mesh *me = (Mesh *)id;
+        /* Callers write to the weights, which may be shared with the evaluated mesh. */
+        me->dvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MDEFORMVERT, me->totvert);
         *dvert_arr = me->dvert;
         *dvert_tot = me->totvert;
         return true;
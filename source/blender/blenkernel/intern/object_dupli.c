@@ -91,6 +91,8 @@ typedef struct DupliGenerator {
 } DupliGenerator;
 
 static const DupliGenerator *get_dupli_generator(const DupliContext *ctx);
+static const DupliGenerator *get_dupli_instances_generator(const DupliContext *ctx);
+static void make_duplis_all(const DupliContext *ctx);
 
 /* create initial context for root object */
 static void init_context(DupliContext *r_ctx,
@@ -214,9 +216,7 @@ static void make_recursive_duplis(const DupliContext *ctx,
   if (ctx->level < MAX_DUPLI_RECUR) {
     DupliContext rctx;
     copy_dupli_context(&rctx, ctx, ob, space_mat, index);
-    if (rctx.gen) {
-      rctx.gen->make_duplis(&rctx);
-    }
+    make_duplis_all(&rctx);
   }
 }
 
@@ -321,6 +321,30 @@ static const DupliGenerator gen_dupli_collection = {
     make_duplis_collection /* make_duplis */
 };
 
+/* OB_DUPLIMESH */
+static void make_duplis_mesh_instances(const DupliContext *ctx)
+{
+  Object *ob = ctx->object;
+  Mesh *me_eval = ob->runtime.mesh_eval;
+
+  if (me_eval == NULL) {
+    return;
+  }
+
+  /* The instances are copies of the object itself, placed relative to it. They take up a single
+   * level of persistent id, so they don't collide with particles instancing the object itself. */
+  for (int i = 0; i < me_eval->runtime.instance_mats_len; i++) {
+    float mat[4][4];
+    mul_m4_m4m4(mat, ob->obmat, me_eval->runtime.instance_mats[i]);
+    make_dupli(ctx, ob, mat, i);
+  }
+}
+
+static const DupliGenerator gen_dupli_mesh_instances = {
+    OB_DUPLIMESH,              /* type */
+    make_duplis_mesh_instances /* make_duplis */
+};
+
 /* OB_DUPLIVERTS */
 typedef struct VertexDupliData {
   Mesh *me_eval;
@@ -1119,6 +1143,39 @@ static const DupliGenerator *get_dupli_generator(const DupliContext *ctx)
   return NULL;
 }
 
+/* select generator for the mesh instances, made in addition to the duplis of the other kinds */
+static const DupliGenerator *get_dupli_instances_generator(const DupliContext *ctx)
+{
+  int transflag = ctx->object->transflag;
+  int restrictflag = ctx->object->restrictflag;
+
+  if ((transflag & OB_DUPLIMESH) == 0 || ctx->object->type != OB_MESH) {
+    return NULL;
+  }
+
+  if (DEG_get_mode(ctx->depsgraph) == DAG_EVAL_RENDER ? (restrictflag & OB_RESTRICT_RENDER) :
+                                                        (restrictflag & OB_RESTRICT_VIEWPORT)) {
+    return NULL;
+  }
+
+  return &gen_dupli_mesh_instances;
+}
+
+/* make duplis of all kinds for the context object */
+static void make_duplis_all(const DupliContext *ctx)
+{
+  const DupliGenerator *gen_instances = get_dupli_instances_generator(ctx);
+
+  if (ctx->gen) {
+    ctx->gen->make_duplis(ctx);
+  }
+  if (gen_instances) {
+    DupliContext ictx = *ctx;
+    ictx.gen = gen_instances;
+    ictx.gen->make_duplis(&ictx);
+  }
+}
+
 /* ---- ListBase dupli container implementation ---- */
 
 /* Returns a list of DupliObject */
@@ -1127,10 +1184,8 @@ ListBase *object_duplilist(Depsgraph *depsgraph, Scene *sce, Object *ob)
   ListBase *duplilist = MEM_callocN(sizeof(ListBase), "duplilist");
   DupliContext ctx;
   init_context(&ctx, depsgraph, sce, ob, NULL);
-  if (ctx.gen) {
-    ctx.duplilist = duplilist;
-    ctx.gen->make_duplis(&ctx);
-  }
+  ctx.duplilist = duplilist;
+  make_duplis_all(&ctx);
 
   return duplilist;
 }
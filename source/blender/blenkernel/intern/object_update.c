@@ -183,6 +183,11 @@ void BKE_object_handle_data_update(Depsgraph *depsgraph, Scene *scene, Object *o
       else {
         makeDerivedMesh(depsgraph, scene, ob, NULL, &cddata_masks);
       }
+      /* Copies output by modifiers as instances of the evaluated mesh. */
+      ob->transflag &= ~OB_DUPLIMESH;
+      if (ob->runtime.mesh_eval != NULL && ob->runtime.mesh_eval->runtime.instance_mats_len != 0) {
+        ob->transflag |= OB_DUPLIMESH;
+      }
       break;
     }
     case OB_ARMATURE:
@@ -348,12 +353,35 @@ void BKE_object_batch_cache_dirty_tag(Object *ob)
   }
 }
 
+/* Edit-mesh vertices only moved by transform, update just their faces when drawn directly. */
+static bool object_batch_cache_deform_tag(Object *ob)
+{
+  if (ob->type != OB_MESH) {
+    return false;
+  }
+  Mesh *me = ob->data;
+  BMEditMesh *em = me->edit_mesh;
+  if (em == NULL || !em->is_deform_tagged) {
+    return false;
+  }
+  const bool use_deform = (em->mesh_eval_final != NULL) &&
+                          (em->mesh_eval_final == em->mesh_eval_cage) &&
+                          em->mesh_eval_final->runtime.is_original;
+  if (use_deform) {
+    BKE_mesh_batch_cache_dirty_tag(me, BKE_MESH_BATCH_DIRTY_DEFORM);
+  }
+  em->is_deform_tagged = false;
+  return use_deform;
+}
+
 void BKE_object_eval_uber_data(Depsgraph *depsgraph, Scene *scene, Object *ob)
 {
   DEG_debug_print_eval(depsgraph, __func__, ob->id.name, ob);
   BLI_assert(ob->type != OB_ARMATURE);
   BKE_object_handle_data_update(depsgraph, scene, ob);
-  BKE_object_batch_cache_dirty_tag(ob);
+  if (!object_batch_cache_deform_tag(ob)) {
+    BKE_object_batch_cache_dirty_tag(ob);
+  }
 }
 
 void BKE_object_eval_ptcache_reset(Depsgraph *depsgraph, Scene *scene, Object *object)
@@ -1242,13 +1242,17 @@ static void sculpt_update_object(
     ss->mloop = NULL;
   }
   else {
+    /* Sculpting writes into the original mesh, which may share its layers with the evaluated
+     * copy (see #CD_SHARE). Those must keep the data they were evaluated from. */
+    me->mvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
+
     ss->totvert = me->totvert;
     ss->totpoly = me->totpoly;
     ss->mvert = me->mvert;
     ss->mpoly = me->mpoly;
     ss->mloop = me->mloop;
     ss->multires = NULL;
-    ss->vmask = CustomData_get_layer(&me->vdata, CD_PAINT_MASK);
+    ss->vmask = CustomData_duplicate_referenced_layer(&me->vdata, CD_PAINT_MASK, me->totvert);
   }
 
   ss->subdiv_ccg = me_eval->runtime.subdiv_ccg;
@@ -1569,6 +1573,10 @@ PBVH *BKE_sculpt_object_pbvh_ensure(Depsgraph *depsgraph, Object *ob)
         BKE_sculpt_bvh_update_from_ccg(pbvh, subdiv_ccg);
       }
     }
+    else if (BKE_pbvh_type(pbvh) == PBVH_FACES) {
+      /* Vertices may have been re-allocated to stop sharing them with the evaluated mesh. */
+      BKE_pbvh_update_mesh_pointers(pbvh, BKE_object_get_original_mesh(ob));
+    }
     return pbvh;
   }
 
@@ -48,6 +48,13 @@
 
 #define LEAF_LIMIT 10000
 
+/* Minimum number of primitives of a node to partition it in parallel. */
+#define PARTITION_PARALLEL_MIN 100000
+#define PARTITION_CHUNK_SIZE 16384
+
+/* Number of candidate split planes per axis for the surface area heuristic. */
+#define SAH_BINS 16
+
 //#define PERFCNTRS
 
 #define STACK_FIXED_DEPTH 100
@@ -173,7 +180,8 @@ static bool grid_materials_match(const DMFlagMat *f1, const DMFlagMat *f2)
 
 /* Adapted from BLI_kdopbvh.c */
 /* Returns the index of the first element on the right of the partition */
-static int partition_indices(int *prim_indices, int lo, int hi, int axis, float mid, BBC *prim_bbc)
+static int partition_indices(
+    int *prim_indices, int lo, int hi, int axis, float mid, const BBC *prim_bbc)
 {
   int i = lo, j = hi;
   for (;;) {
@@ -252,16 +260,19 @@ void pbvh_grow_nodes(PBVH *bvh, int totnode)
 
 /* Add a vertex to the map, with a positive value for unique vertices and
  * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *bvh, GHash *map, unsigned int *face_verts, unsigned int *uniq_verts, int vertex)
+static int map_insert_vert(const int *vert_owner,
+                           int leaf,
+                           GHash *map,
+                           unsigned int *face_verts,
+                           unsigned int *uniq_verts,
+                           int vertex)
 {
   void *key, **value_p;
 
   key = POINTER_FROM_INT(vertex);
   if (!BLI_ghash_ensure_p(map, key, &value_p)) {
     int value_i;
-    if (BLI_BITMAP_TEST(bvh->vert_bitmap, vertex) == 0) {
-      BLI_BITMAP_ENABLE(bvh->vert_bitmap, vertex);
+    if (vert_owner[vertex] == leaf) {
       value_i = *uniq_verts;
       (*uniq_verts)++;
     }
@@ -277,8 +288,9 @@ static int map_insert_vert(
   }
 }
 
-/* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node)
+/* Find vertices used by the faces in this node and update the draw buffers,
+ * vert_owner is the first leaf using each vertex, which stores it as unique vertex */
+static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node, const int *vert_owner, int leaf)
 {
   bool has_visible = false;
 
@@ -296,7 +308,7 @@ static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node)
     const MLoopTri *lt = &bvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
       face_vert_indices[i][j] = map_insert_vert(
-          bvh, map, &node->face_verts, &node->uniq_verts, bvh->mloop[lt->tri[j]].v);
+          vert_owner, leaf, map, &node->face_verts, &node->uniq_verts, bvh->mloop[lt->tri[j]].v);
     }
 
     if (!paint_is_face_hidden(lt, bvh->verts, bvh->mloop)) {
@@ -338,7 +350,7 @@ static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node)
   BLI_ghash_free(map, NULL, NULL);
 }
 
-static void update_vb(PBVH *bvh, PBVHNode *node, BBC *prim_bbc, int offset, int count)
+static void update_vb(PBVH *bvh, PBVHNode *node, const BBC *prim_bbc, int offset, int count)
 {
   BB_reset(&node->vb);
   for (int i = offset + count - 1; i >= offset; i--) {
@@ -388,24 +400,6 @@ static void build_grid_leaf_node(PBVH *bvh, PBVHNode *node)
   BKE_pbvh_node_mark_rebuild_draw(node);
 }
 
-static void build_leaf(PBVH *bvh, int node_index, BBC *prim_bbc, int offset, int count)
-{
-  bvh->nodes[node_index].flag |= PBVH_Leaf;
-
-  bvh->nodes[node_index].prim_indices = bvh->prim_indices + offset;
-  bvh->nodes[node_index].totprim = count;
-
-  /* Still need vb for searches */
-  update_vb(bvh, &bvh->nodes[node_index], prim_bbc, offset, count);
-
-  if (bvh->looptri) {
-    build_mesh_leaf_node(bvh, bvh->nodes + node_index);
-  }
-  else {
-    build_grid_leaf_node(bvh, bvh->nodes + node_index);
-  }
-}
-
 /* Return zero if all primitives in the node can be drawn with the
  * same material (including flat/smooth shading), non-zero otherwise */
 static bool leaf_needs_material_split(PBVH *bvh, int offset, int count)
@@ -440,19 +434,334 @@ static bool leaf_needs_material_split(PBVH *bvh, int offset, int count)
   return false;
 }
 
-/* Recursively build a node in the tree
+/* -------------------------------------------------------------------- */
+/** \name Tree Build
  *
- * vb is the voxel box around all of the primitives contained in
- * this node.
+ * Subtrees are partitioned in parallel into a temporary tree, which is then flattened
+ * into the nodes array in the same order as a serial depth first build. Leaves are
+ * filled in parallel afterwards.
+ * \{ */
+
+typedef struct PBVHBuildNode {
+  struct PBVHBuildNode *children[2];
+  int offset, count;
+} PBVHBuildNode;
+
+typedef struct PBVHBuildData {
+  PBVH *bvh;
+  const BBC *prim_bbc;
+  /* Temporary copy of the primitive indices, for partitioning in parallel. */
+  int *prim_indices_scratch;
+} PBVHBuildData;
+
+typedef struct PBVHPartitionData {
+  const BBC *prim_bbc;
+  int *prim_indices;
+  int *prim_indices_scratch;
+  int axis;
+  float mid;
+  int count;
+  /* Number of primitives left of mid for each chunk, then the offset of the chunk on the left
+   * and right side. */
+  int *chunk_left;
+  int *chunk_right;
+} PBVHPartitionData;
+
+static void partition_count_task_cb(void *__restrict userdata,
+                                    const int chunk,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHPartitionData *data = userdata;
+  const int start = chunk * PARTITION_CHUNK_SIZE;
+  const int end = min_ii(start + PARTITION_CHUNK_SIZE, data->count);
+  int left = 0;
+
+  for (int i = start; i < end; i++) {
+    if (data->prim_bbc[data->prim_indices[i]].bcentroid[data->axis] < data->mid) {
+      left++;
+    }
+  }
+  data->chunk_left[chunk] = left;
+}
+
+static void partition_scatter_task_cb(void *__restrict userdata,
+                                      const int chunk,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHPartitionData *data = userdata;
+  const int start = chunk * PARTITION_CHUNK_SIZE;
+  const int end = min_ii(start + PARTITION_CHUNK_SIZE, data->count);
+  int left = data->chunk_left[chunk];
+  int right = data->chunk_right[chunk];
+
+  for (int i = start; i < end; i++) {
+    const int prim = data->prim_indices[i];
+    if (data->prim_bbc[prim].bcentroid[data->axis] < data->mid) {
+      data->prim_indices_scratch[left++] = prim;
+    }
+    else {
+      data->prim_indices_scratch[right++] = prim;
+    }
+  }
+}
+
+/* Returns the index of the first element on the right of the partition */
+static int partition_indices_parallel(
+    PBVHBuildData *build, int offset, int count, int axis, float mid)
+{
+  PBVHPartitionData data;
+  const int num_chunks = (count + PARTITION_CHUNK_SIZE - 1) / PARTITION_CHUNK_SIZE;
+
+  data.prim_bbc = build->prim_bbc;
+  data.prim_indices = build->bvh->prim_indices + offset;
+  data.prim_indices_scratch = build->prim_indices_scratch + offset;
+  data.axis = axis;
+  data.mid = mid;
+  data.count = count;
+  data.chunk_left = MEM_mallocN(sizeof(int) * num_chunks, __func__);
+  data.chunk_right = MEM_mallocN(sizeof(int) * num_chunks, __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, num_chunks, &data, partition_count_task_cb, &settings);
+
+  int totleft = 0;
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    totleft += data.chunk_left[chunk];
+  }
+
+  if (ELEM(totleft, 0, count)) {
+    /* Centroids too close to be separated by mid, let the serial partition split them. */
+    MEM_freeN(data.chunk_left);
+    MEM_freeN(data.chunk_right);
+    return partition_indices(
+        build->bvh->prim_indices, offset, offset + count - 1, axis, mid, build->prim_bbc);
+  }
+
+  int left = 0, right = totleft;
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    const int chunk_left = data.chunk_left[chunk];
+    const int chunk_size = min_ii(PARTITION_CHUNK_SIZE, count - chunk * PARTITION_CHUNK_SIZE);
+    data.chunk_left[chunk] = left;
+    data.chunk_right[chunk] = right;
+    left += chunk_left;
+    right += chunk_size - chunk_left;
+  }
+
+  BLI_task_parallel_range(0, num_chunks, &data, partition_scatter_task_cb, &settings);
+  memcpy(data.prim_indices, data.prim_indices_scratch, sizeof(int) * count);
+
+  MEM_freeN(data.chunk_left);
+  MEM_freeN(data.chunk_right);
+
+  return offset + totleft;
+}
+
+typedef struct PBVHBoundsChunk {
+  BB cb;
+  /* Surface area heuristic bins of the centroids along each axis. */
+  BB bins_bb[3][SAH_BINS];
+  int bins_count[3][SAH_BINS];
+} PBVHBoundsChunk;
+
+typedef struct PBVHBoundsData {
+  const BBC *prim_bbc;
+  const int *prim_indices;
+  /* Centroid bounds the bins are spread over, NULL to only calculate centroid bounds. */
+  const BB *bin_cb;
+  PBVHBoundsChunk *result;
+} PBVHBoundsData;
+
+static int sah_bin_index(const BB *cb, int axis, float co)
+{
+  const float extent = cb->bmax[axis] - cb->bmin[axis];
+  const int bin = (int)((co - cb->bmin[axis]) * (SAH_BINS / extent));
+  return clamp_i(bin, 0, SAH_BINS - 1);
+}
+
+static void bounds_task_cb(void *__restrict userdata,
+                           const int i,
+                           const TaskParallelTLS *__restrict tls)
+{
+  PBVHBoundsData *data = userdata;
+  PBVHBoundsChunk *chunk = tls->userdata_chunk;
+  const BBC *bbc = &data->prim_bbc[data->prim_indices[i]];
+
+  if (data->bin_cb == NULL) {
+    BB_expand(&chunk->cb, bbc->bcentroid);
+    return;
+  }
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (data->bin_cb->bmax[axis] > data->bin_cb->bmin[axis]) {
+      const int bin = sah_bin_index(data->bin_cb, axis, bbc->bcentroid[axis]);
+      BB_expand_with_bb(&chunk->bins_bb[axis][bin], (BB *)bbc);
+      chunk->bins_count[axis][bin]++;
+    }
+  }
+}
+
+static void bounds_finalize(void *__restrict userdata, void *__restrict userdata_chunk)
+{
+  PBVHBoundsData *data = userdata;
+  PBVHBoundsChunk *chunk = userdata_chunk;
+  BB_expand_with_bb(&data->result->cb, &chunk->cb);
+}
+
+static void bins_finalize(void *__restrict userdata, void *__restrict userdata_chunk)
+{
+  PBVHBoundsData *data = userdata;
+  PBVHBoundsChunk *bins = data->result;
+  PBVHBoundsChunk *chunk = userdata_chunk;
+  for (int axis = 0; axis < 3; axis++) {
+    for (int bin = 0; bin < SAH_BINS; bin++) {
+      BB_expand_with_bb(&bins->bins_bb[axis][bin], &chunk->bins_bb[axis][bin]);
+      bins->bins_count[axis][bin] += chunk->bins_count[axis][bin];
+    }
+  }
+}
+
+static void bounds_chunk_init(PBVHBoundsChunk *chunk)
+{
+  BB_reset(&chunk->cb);
+  for (int axis = 0; axis < 3; axis++) {
+    for (int bin = 0; bin < SAH_BINS; bin++) {
+      BB_reset(&chunk->bins_bb[axis][bin]);
+      chunk->bins_count[axis][bin] = 0;
+    }
+  }
+}
+
+/* Bounding box around the centroids of the primitives */
+static void build_centroid_bounds(PBVHBuildData *build, int offset, int count, BB *r_cb)
+{
+  PBVHBoundsData data;
+  PBVHBoundsChunk chunk, *result;
+
+  result = MEM_mallocN(sizeof(*result), __func__);
+  bounds_chunk_init(result);
+  bounds_chunk_init(&chunk);
+  data.prim_bbc = build->prim_bbc;
+  data.prim_indices = build->bvh->prim_indices + offset;
+  data.bin_cb = NULL;
+  data.result = result;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = count >= PARTITION_PARALLEL_MIN;
+  settings.min_iter_per_thread = PARTITION_CHUNK_SIZE;
+  settings.userdata_chunk = &chunk;
+  settings.userdata_chunk_size = sizeof(chunk);
+  settings.func_finalize = bounds_finalize;
+  BLI_task_parallel_range(0, count, &data, bounds_task_cb, &settings);
+
+  *r_cb = result->cb;
+  MEM_freeN(result);
+}
+
+static float BB_half_area(const BB *bb)
+{
+  float dim[3];
+  sub_v3_v3v3(dim, bb->bmax, bb->bmin);
+  return dim[0] * dim[1] + dim[1] * dim[2] + dim[2] * dim[0];
+}
+
+/* Find the split plane with the lowest surface area heuristic cost, returns false when the
+ * centroids can not be split */
+static bool build_sah_split(
+    PBVHBuildData *build, const BB *cb, int offset, int count, int *r_axis, float *r_mid)
+{
+  PBVHBoundsData data;
+  PBVHBoundsChunk chunk, *bins;
+
+  bins = MEM_mallocN(sizeof(*bins), __func__);
+  bounds_chunk_init(bins);
+  bounds_chunk_init(&chunk);
+  data.prim_bbc = build->prim_bbc;
+  data.prim_indices = build->bvh->prim_indices + offset;
+  data.bin_cb = cb;
+  data.result = bins;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = count >= PARTITION_PARALLEL_MIN;
+  settings.min_iter_per_thread = PARTITION_CHUNK_SIZE;
+  settings.userdata_chunk = &chunk;
+  settings.userdata_chunk_size = sizeof(chunk);
+  settings.func_finalize = bins_finalize;
+  BLI_task_parallel_range(0, count, &data, bounds_task_cb, &settings);
+
+  float best_cost = FLT_MAX;
+  bool found = false;
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (!(cb->bmax[axis] > cb->bmin[axis])) {
+      continue;
+    }
+
+    /* Sweep from the right to get the cost of each right side. */
+    float right_cost[SAH_BINS];
+    BB right_bb;
+    int right_count = 0;
+    BB_reset(&right_bb);
+    for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+      BB_expand_with_bb(&right_bb, &bins->bins_bb[axis][bin]);
+      right_count += bins->bins_count[axis][bin];
+      right_cost[bin] = right_count ? BB_half_area(&right_bb) * right_count : -1.0f;
+    }
+
+    BB left_bb;
+    int left_count = 0;
+    BB_reset(&left_bb);
+    for (int bin = 1; bin < SAH_BINS; bin++) {
+      BB_expand_with_bb(&left_bb, &bins->bins_bb[axis][bin - 1]);
+      left_count += bins->bins_count[axis][bin - 1];
+      if (left_count == 0 || right_cost[bin] < 0.0f) {
+        continue;
+      }
+      const float cost = BB_half_area(&left_bb) * left_count + right_cost[bin];
+      if (cost < best_cost) {
+        best_cost = cost;
+        *r_axis = axis;
+        *r_mid = cb->bmin[axis] + (cb->bmax[axis] - cb->bmin[axis]) * bin / SAH_BINS;
+        found = true;
+      }
+    }
+  }
+
+  MEM_freeN(bins);
+  return found;
+}
+
+static PBVHBuildNode *build_node_new(int offset, int count)
+{
+  PBVHBuildNode *node = MEM_callocN(sizeof(PBVHBuildNode), __func__);
+  node->offset = offset;
+  node->count = count;
+  return node;
+}
+
+static void build_sub(
+    PBVHBuildData *build, TaskPool *pool, int threadid, PBVHBuildNode *node, BB *cb);
+
+static void build_sub_task_cb(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+  build_sub(BLI_task_pool_userdata(pool), pool, threadid, taskdata, NULL);
+}
+
+/* Recursively partition a node in the tree
  *
  * cb is the bounding box around all the centroids of the primitives
  * contained in this node
  *
- * offset and start indicate a range in the array of primitive indices
+ * offset and count of the node indicate a range in the array of primitive indices
  */
-
-static void build_sub(PBVH *bvh, int node_index, BB *cb, BBC *prim_bbc, int offset, int count)
+static void build_sub(
+    PBVHBuildData *build, TaskPool *pool, int threadid, PBVHBuildNode *node, BB *cb)
 {
+  PBVH *bvh = build->bvh;
+  const int offset = node->offset;
+  const int count = node->count;
   int end;
   BB cb_backing;
 
@@ -460,46 +769,178 @@ static void build_sub(PBVH *bvh, int node_index, BB *cb, BBC *prim_bbc, int offs
   const bool below_leaf_limit = count <= bvh->leaf_limit;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(bvh, offset, count)) {
-      build_leaf(bvh, node_index, prim_bbc, offset, count);
       return;
     }
   }
 
-  /* Add two child nodes */
-  bvh->nodes[node_index].children_offset = bvh->totnode;
-  pbvh_grow_nodes(bvh, bvh->totnode + 2);
-
-  /* Update parent node bounding box */
-  update_vb(bvh, &bvh->nodes[node_index], prim_bbc, offset, count);
-
   if (!below_leaf_limit) {
     /* Find axis with widest range of primitive centroids */
     if (!cb) {
       cb = &cb_backing;
-      BB_reset(cb);
-      for (int i = offset + count - 1; i >= offset; i--) {
-        BB_expand(cb, prim_bbc[bvh->prim_indices[i]].bcentroid);
-      }
+      build_centroid_bounds(build, offset, count, cb);
+    }
+    int axis;
+    float mid;
+    const bool use_sah = (bvh->flags & PBVH_BUILD_SAH) != 0;
+    if (!(use_sah && build_sah_split(build, cb, offset, count, &axis, &mid))) {
+      axis = BB_widest_axis(cb);
+      mid = (cb->bmax[axis] + cb->bmin[axis]) * 0.5f;
     }
-    const int axis = BB_widest_axis(cb);
 
     /* Partition primitives along that axis */
-    end = partition_indices(bvh->prim_indices,
-                            offset,
-                            offset + count - 1,
-                            axis,
-                            (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
-                            prim_bbc);
+    if (count >= PARTITION_PARALLEL_MIN) {
+      end = partition_indices_parallel(build, offset, count, axis, mid);
+    }
+    else {
+      end = partition_indices(
+          bvh->prim_indices, offset, offset + count - 1, axis, mid, build->prim_bbc);
+    }
   }
   else {
     /* Partition primitives by material */
     end = partition_indices_material(bvh, offset, offset + count - 1);
   }
 
-  /* Build children */
-  build_sub(bvh, bvh->nodes[node_index].children_offset, NULL, prim_bbc, offset, end - offset);
-  build_sub(
-      bvh, bvh->nodes[node_index].children_offset + 1, NULL, prim_bbc, end, offset + count - end);
+  /* Build children, the ones that are going to be split again in their own task */
+  node->children[0] = build_node_new(offset, end - offset);
+  node->children[1] = build_node_new(end, offset + count - end);
+
+  for (int i = 0; i < 2; i++) {
+    PBVHBuildNode *child = node->children[i];
+    if (i == 0 && child->count > bvh->leaf_limit) {
+      BLI_task_pool_push_from_thread(
+          pool, build_sub_task_cb, child, false, TASK_PRIORITY_HIGH, threadid);
+    }
+    else {
+      build_sub(build, pool, threadid, child, NULL);
+    }
+  }
+}
+
+static int build_count_leaves(const PBVHBuildNode *node)
+{
+  if (node->children[0] == NULL) {
+    return 1;
+  }
+  return build_count_leaves(node->children[0]) + build_count_leaves(node->children[1]);
+}
+
+/* Copy the temporary tree into the nodes array and free it, leaves are added to leaf_indices
+ * in depth first order */
+static void build_flatten(
+    PBVH *bvh, PBVHBuildNode *build_node, int node_index, int *leaf_indices, int *r_totleaf)
+{
+  if (build_node->children[0] == NULL) {
+    PBVHNode *node = &bvh->nodes[node_index];
+    node->flag |= PBVH_Leaf;
+    node->prim_indices = bvh->prim_indices + build_node->offset;
+    node->totprim = build_node->count;
+    leaf_indices[(*r_totleaf)++] = node_index;
+  }
+  else {
+    /* Add two child nodes */
+    const int children_offset = bvh->totnode;
+    bvh->nodes[node_index].children_offset = children_offset;
+    pbvh_grow_nodes(bvh, bvh->totnode + 2);
+
+    build_flatten(bvh, build_node->children[0], children_offset, leaf_indices, r_totleaf);
+    build_flatten(bvh, build_node->children[1], children_offset + 1, leaf_indices, r_totleaf);
+  }
+
+  MEM_freeN(build_node);
+}
+
+typedef struct PBVHLeafBuildData {
+  PBVH *bvh;
+  const BBC *prim_bbc;
+  const int *leaf_indices;
+  /* For each vertex, the first leaf using it in depth first order. */
+  int *vert_owner;
+} PBVHLeafBuildData;
+
+static void atomic_min_int32(int32_t *p, int32_t value)
+{
+  int32_t old = *p;
+  while (value < old) {
+    const int32_t prev = atomic_cas_int32(p, old, value);
+    if (prev == old) {
+      break;
+    }
+    old = prev;
+  }
+}
+
+static void build_vert_owner_task_cb(void *__restrict userdata,
+                                     const int leaf,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHLeafBuildData *data = userdata;
+  PBVH *bvh = data->bvh;
+  const PBVHNode *node = &bvh->nodes[data->leaf_indices[leaf]];
+
+  for (int i = 0; i < node->totprim; i++) {
+    const MLoopTri *lt = &bvh->looptri[node->prim_indices[i]];
+    for (int j = 0; j < 3; j++) {
+      atomic_min_int32(&data->vert_owner[bvh->mloop[lt->tri[j]].v], leaf);
+    }
+  }
+}
+
+static void build_leaf_task_cb(void *__restrict userdata,
+                               const int leaf,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHLeafBuildData *data = userdata;
+  PBVH *bvh = data->bvh;
+  PBVHNode *node = &bvh->nodes[data->leaf_indices[leaf]];
+
+  /* Still need vb for searches */
+  update_vb(bvh, node, data->prim_bbc, node->prim_indices - bvh->prim_indices, node->totprim);
+
+  if (bvh->looptri) {
+    build_mesh_leaf_node(bvh, node, data->vert_owner, leaf);
+  }
+  else {
+    build_grid_leaf_node(bvh, node);
+  }
+}
+
+static void build_leaves(PBVH *bvh, const BBC *prim_bbc, const int *leaf_indices, int totleaf)
+{
+  PBVHLeafBuildData data;
+  data.bvh = bvh;
+  data.prim_bbc = prim_bbc;
+  data.leaf_indices = leaf_indices;
+  data.vert_owner = NULL;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.scheduling_mode = TASK_SCHEDULING_DYNAMIC;
+
+  if (bvh->looptri) {
+    data.vert_owner = MEM_mallocN(sizeof(int) * bvh->totvert, __func__);
+    for (int i = 0; i < bvh->totvert; i++) {
+      data.vert_owner[i] = INT_MAX;
+    }
+    BLI_task_parallel_range(0, totleaf, &data, build_vert_owner_task_cb, &settings);
+  }
+
+  BLI_task_parallel_range(0, totleaf, &data, build_leaf_task_cb, &settings);
+
+  if (data.vert_owner) {
+    MEM_freeN(data.vert_owner);
+  }
+
+  /* Update parent node bounding boxes, children always come after their parent */
+  for (int i = bvh->totnode - 1; i >= 0; i--) {
+    PBVHNode *node = &bvh->nodes[i];
+    if (!(node->flag & PBVH_Leaf)) {
+      BB_reset(&node->vb);
+      BB_expand_with_bb(&node->vb, &bvh->nodes[node->children_offset].vb);
+      BB_expand_with_bb(&node->vb, &bvh->nodes[node->children_offset + 1].vb);
+      node->orig_vb = node->vb;
+    }
+  }
 }
 
 static void pbvh_build(PBVH *bvh, BB *cb, BBC *prim_bbc, int totprim)
@@ -523,8 +964,114 @@ static void pbvh_build(PBVH *bvh, BB *cb, BBC *prim_bbc, int totprim)
     }
   }
 
+  PBVHBuildData build;
+  build.bvh = bvh;
+  build.prim_bbc = prim_bbc;
+  build.prim_indices_scratch = NULL;
+  if (totprim >= PARTITION_PARALLEL_MIN) {
+    build.prim_indices_scratch = MEM_mallocN(sizeof(int) * totprim, __func__);
+  }
+
+  /* Partition the primitives */
+  PBVHBuildNode *root = build_node_new(0, totprim);
+  TaskScheduler *scheduler = BLI_task_scheduler_get();
+  TaskPool *pool = BLI_task_pool_create(scheduler, &build);
+  build_sub(&build, pool, -1, root, cb);
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  if (build.prim_indices_scratch) {
+    MEM_freeN(build.prim_indices_scratch);
+  }
+
+  /* Create the nodes */
+  int totleaf = 0;
+  int *leaf_indices = MEM_mallocN(sizeof(int) * build_count_leaves(root), __func__);
   bvh->totnode = 1;
-  build_sub(bvh, 0, cb, prim_bbc, 0, totprim);
+  build_flatten(bvh, root, 0, leaf_indices, &totleaf);
+
+  build_leaves(bvh, prim_bbc, leaf_indices, totleaf);
+  MEM_freeN(leaf_indices);
+}
+
+/** \} */
+
+typedef struct PBVHPrimBoundsData {
+  const PBVH *bvh;
+  BBC *prim_bbc;
+  BB cb;
+} PBVHPrimBoundsData;
+
+static void prim_bounds_finalize(void *__restrict userdata, void *__restrict userdata_chunk)
+{
+  PBVHPrimBoundsData *data = userdata;
+  BB_expand_with_bb(&data->cb, userdata_chunk);
+}
+
+static void mesh_prim_bounds_task_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict tls)
+{
+  PBVHPrimBoundsData *data = userdata;
+  const PBVH *bvh = data->bvh;
+  const MLoopTri *lt = &bvh->looptri[i];
+  const int sides = 3;
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < sides; j++) {
+    BB_expand((BB *)bbc, bvh->verts[bvh->mloop[lt->tri[j]].v].co);
+  }
+
+  BBC_update_centroid(bbc);
+
+  BB_expand(tls->userdata_chunk, bbc->bcentroid);
+}
+
+static void grid_prim_bounds_task_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict tls)
+{
+  PBVHPrimBoundsData *data = userdata;
+  const PBVH *bvh = data->bvh;
+  const CCGKey *key = &bvh->gridkey;
+  CCGElem *grid = bvh->grids[i];
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < key->grid_size * key->grid_size; j++) {
+    BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
+  }
+
+  BBC_update_centroid(bbc);
+
+  BB_expand(tls->userdata_chunk, bbc->bcentroid);
+}
+
+/* For each primitive, store the AABB and the AABB centroid,
+ * returns the bounding box around all centroids */
+static void pbvh_prim_bounds(
+    PBVH *bvh, BBC *prim_bbc, int totprim, TaskParallelRangeFunc func, BB *r_cb)
+{
+  PBVHPrimBoundsData data;
+  data.bvh = bvh;
+  data.prim_bbc = prim_bbc;
+  BB_reset(&data.cb);
+
+  BB cb_chunk;
+  BB_reset(&cb_chunk);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  settings.userdata_chunk = &cb_chunk;
+  settings.userdata_chunk_size = sizeof(cb_chunk);
+  settings.func_finalize = prim_bounds_finalize;
+  BLI_task_parallel_range(0, totprim, &data, func, &settings);
+
+  *r_cb = data.cb;
 }
 
 /**
@@ -553,39 +1100,21 @@ void BKE_pbvh_build_mesh(PBVH *bvh,
   bvh->mloop = mloop;
   bvh->looptri = looptri;
   bvh->verts = verts;
-  bvh->vert_bitmap = BLI_BITMAP_NEW(totvert, "bvh->vert_bitmap");
   bvh->totvert = totvert;
   bvh->leaf_limit = LEAF_LIMIT;
   bvh->vdata = vdata;
   bvh->ldata = ldata;
 
-  BB_reset(&cb);
-
   /* For each face, store the AABB and the AABB centroid */
   prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
 
-  for (int i = 0; i < looptri_num; i++) {
-    const MLoopTri *lt = &looptri[i];
-    const int sides = 3;
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < sides; j++) {
-      BB_expand((BB *)bbc, verts[bvh->mloop[lt->tri[j]].v].co);
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  pbvh_prim_bounds(bvh, prim_bbc, looptri_num, mesh_prim_bounds_task_cb, &cb);
 
   if (looptri_num) {
     pbvh_build(bvh, &cb, prim_bbc, looptri_num);
   }
 
   MEM_freeN(prim_bbc);
-  MEM_freeN(bvh->vert_bitmap);
 }
 
 /* Do a full rebuild with on Grids data structure */
@@ -609,25 +1138,11 @@ void BKE_pbvh_build_grids(PBVH *bvh,
   bvh->leaf_limit = max_ii(LEAF_LIMIT / ((gridsize - 1) * (gridsize - 1)), 1);
 
   BB cb;
-  BB_reset(&cb);
 
   /* For each grid, store the AABB and the AABB centroid */
   BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
 
-  for (int i = 0; i < totgrid; i++) {
-    CCGElem *grid = grids[i];
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < gridsize * gridsize; j++) {
-      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  pbvh_prim_bounds(bvh, prim_bbc, totgrid, grid_prim_bounds_task_cb, &cb);
 
   if (totgrid) {
     pbvh_build(bvh, &cb, prim_bbc, totgrid);
@@ -636,6 +1151,11 @@ void BKE_pbvh_build_grids(PBVH *bvh,
   MEM_freeN(prim_bbc);
 }
 
+void BKE_pbvh_build_sah_set(PBVH *bvh, bool use_sah)
+{
+  SET_FLAG_FROM_TEST(bvh->flags, use_sah, PBVH_BUILD_SAH);
+}
+
 PBVH *BKE_pbvh_new(void)
 {
   PBVH *bvh = MEM_callocN(sizeof(PBVH), "pbvh");
@@ -669,6 +1189,8 @@ void BKE_pbvh_free(PBVH *bvh)
       if (node->bm_other_verts) {
         BLI_gset_free(node->bm_other_verts, NULL);
       }
+      MEM_SAFE_FREE(node->bm_vert_array);
+      MEM_SAFE_FREE(node->bm_face_array);
     }
   }
 
@@ -2505,6 +3027,16 @@ void BKE_pbvh_draw_debug_cb(
   }
 }
 
+void BKE_pbvh_update_mesh_pointers(PBVH *bvh, Mesh *mesh)
+{
+  BLI_assert(bvh->type == PBVH_FACES);
+
+  /* Deformed PBVH owns its vertices. */
+  if (!bvh->deformed) {
+    bvh->verts = mesh->mvert;
+  }
+}
+
 void BKE_pbvh_grids_update(
     PBVH *bvh, CCGElem **grids, void **gridfaces, DMFlagMat *flagmats, BLI_bitmap **grid_hidden)
 {
@@ -2705,8 +3237,8 @@ void pbvh_vertex_iter_init(PBVH *bvh, PBVHNode *node, PBVHVertexIter *vi, int mo
   vi->mverts = verts;
 
   if (bvh->type == PBVH_BMESH) {
-    BLI_gsetIterator_init(&vi->bm_unique_verts, node->bm_unique_verts);
-    BLI_gsetIterator_init(&vi->bm_other_verts, node->bm_other_verts);
+    BLI_assert(!(node->flag & PBVH_UpdateBMeshArrays));
+    vi->bm_verts = node->bm_vert_array;
     vi->bm_vdata = &bvh->bm->vdata;
     vi->cd_vert_mask_offset = CustomData_get_offset(vi->bm_vdata, CD_PAINT_MASK);
   }
@@ -26,6 +26,7 @@
 #include "BLI_heap_simple.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
 
 #include "BKE_ccg.h"
 #include "BKE_DerivedMesh.h"
@@ -199,6 +200,71 @@ static BMVert *bm_vert_hash_lookup_chain(GHash *deleted_verts, BMVert *v)
 
 /****************************** Building ******************************/
 
+/* Copy the element sets of a leaf into its arrays, which are walked by the vertex iterator,
+ * raycasts and normal updates. Unique verts are stored before the other verts. */
+static void pbvh_bmesh_node_arrays_update(PBVHNode *n)
+{
+  GSetIterator gs_iter;
+  int i;
+
+  n->bm_tot_unique_verts = BLI_gset_len(n->bm_unique_verts);
+  n->bm_tot_verts = n->bm_tot_unique_verts + BLI_gset_len(n->bm_other_verts);
+  n->bm_tot_faces = BLI_gset_len(n->bm_faces);
+
+  n->bm_vert_array = MEM_reallocN(n->bm_vert_array, sizeof(BMVert *) * n->bm_tot_verts);
+  n->bm_face_array = MEM_reallocN(n->bm_face_array, sizeof(BMFace *) * n->bm_tot_faces);
+
+  i = 0;
+  GSET_ITER (gs_iter, n->bm_unique_verts) {
+    n->bm_vert_array[i++] = BLI_gsetIterator_getKey(&gs_iter);
+  }
+  GSET_ITER (gs_iter, n->bm_other_verts) {
+    n->bm_vert_array[i++] = BLI_gsetIterator_getKey(&gs_iter);
+  }
+
+  i = 0;
+  GSET_ITER (gs_iter, n->bm_faces) {
+    n->bm_face_array[i++] = BLI_gsetIterator_getKey(&gs_iter);
+  }
+
+  n->flag &= ~PBVH_UpdateBMeshArrays;
+}
+
+static void pbvh_bmesh_node_arrays_update_task_cb(void *__restrict userdata,
+                                                  const int n,
+                                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHNode **nodes = userdata;
+  pbvh_bmesh_node_arrays_update(nodes[n]);
+}
+
+/* Update the arrays of all leaves whose sets changed, the leaves are independent. */
+static void pbvh_bmesh_arrays_update(PBVH *bvh)
+{
+  PBVHNode **nodes = NULL;
+  int totnode = 0;
+
+  for (int i = 0; i < bvh->totnode; i++) {
+    PBVHNode *node = &bvh->nodes[i];
+    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateBMeshArrays)) {
+      if (nodes == NULL) {
+        nodes = MEM_malloc_arrayN(bvh->totnode, sizeof(*nodes), __func__);
+      }
+      nodes[totnode++] = node;
+    }
+  }
+
+  if (nodes == NULL) {
+    return;
+  }
+
+  PBVHParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+  BKE_pbvh_parallel_range(0, totnode, nodes, pbvh_bmesh_node_arrays_update_task_cb, &settings);
+
+  MEM_freeN(nodes);
+}
+
 /* Update node data after splitting */
 static void pbvh_bmesh_node_finalize(PBVH *bvh,
                                      const int node_index,
@@ -250,6 +316,8 @@ static void pbvh_bmesh_node_finalize(PBVH *bvh,
 
   n->orig_vb = n->vb;
 
+  pbvh_bmesh_node_arrays_update(n);
+
   /* Build GPU buffers for new node and update vertex normals */
   BKE_pbvh_node_mark_rebuild_draw(n);
 
@@ -358,6 +426,9 @@ static void pbvh_bmesh_node_split(PBVH *bvh, const BBC *bbc_array, int node_inde
     MEM_freeN(n->layer_disp);
   }
 
+  MEM_SAFE_FREE(n->bm_vert_array);
+  MEM_SAFE_FREE(n->bm_face_array);
+
   n->bm_faces = NULL;
   n->bm_unique_verts = NULL;
   n->bm_other_verts = NULL;
@@ -504,7 +575,7 @@ static BMVert *pbvh_bmesh_vert_create(
   BLI_gset_insert(node->bm_unique_verts, v);
   BM_ELEM_CD_SET_INT(v, bvh->cd_vert_node_offset, node_index);
 
-  node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB;
+  node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB | PBVH_UpdateBMeshArrays;
 
   /* Log the new vertex */
   BM_log_vert_added(bvh->bm_log, v, cd_vert_mask_offset);
@@ -530,7 +601,7 @@ static BMFace *pbvh_bmesh_face_create(
   BM_ELEM_CD_SET_INT(f, bvh->cd_face_node_offset, node_index);
 
   /* mark node for update */
-  node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateNormals;
+  node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateNormals | PBVH_UpdateBMeshArrays;
   node->flag &= ~PBVH_FullyHidden;
 
   /* Log the new face */
@@ -605,7 +676,7 @@ static void pbvh_bmesh_vert_ownership_transfer(PBVH *bvh, PBVHNode *new_owner, B
 {
   PBVHNode *current_owner = pbvh_bmesh_node_from_vert(bvh, v);
   /* mark node for update */
-  current_owner->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB;
+  current_owner->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB | PBVH_UpdateBMeshArrays;
 
   BLI_assert(current_owner != new_owner);
 
@@ -619,7 +690,7 @@ static void pbvh_bmesh_vert_ownership_transfer(PBVH *bvh, PBVHNode *new_owner, B
   BLI_assert(!BLI_gset_haskey(new_owner->bm_other_verts, v));
 
   /* mark node for update */
-  new_owner->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB;
+  new_owner->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB | PBVH_UpdateBMeshArrays;
 }
 
 static void pbvh_bmesh_vert_remove(PBVH *bvh, BMVert *v)
@@ -630,6 +701,7 @@ static void pbvh_bmesh_vert_remove(PBVH *bvh, BMVert *v)
   PBVHNode *v_node = pbvh_bmesh_node_from_vert(bvh, v);
   BLI_gset_remove(v_node->bm_unique_verts, v, NULL);
   BM_ELEM_CD_SET_INT(v, bvh->cd_vert_node_offset, DYNTOPO_NODE_NONE);
+  v_node->flag |= PBVH_UpdateBMeshArrays;
 
   /* Have to check each neighboring face's node */
   BMFace *f;
@@ -642,7 +714,7 @@ static void pbvh_bmesh_vert_remove(PBVH *bvh, BMVert *v)
       f_node_index_prev = f_node_index;
 
       PBVHNode *f_node = &bvh->nodes[f_node_index];
-      f_node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB;
+      f_node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB | PBVH_UpdateBMeshArrays;
 
       /* Remove current ownership */
       BLI_gset_remove(f_node->bm_other_verts, v, NULL);
@@ -691,7 +763,7 @@ static void pbvh_bmesh_face_remove(PBVH *bvh, BMFace *f)
   BM_log_face_removed(bvh->bm_log, f);
 
   /* mark node for update */
-  f_node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateNormals;
+  f_node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateNormals | PBVH_UpdateBMeshArrays;
 }
 
 static void pbvh_bmesh_edge_loops(BLI_Buffer *buf, BMEdge *e)
@@ -1530,10 +1602,8 @@ bool pbvh_bmesh_node_raycast(PBVHNode *node,
     }
   }
   else {
-    GSetIterator gs_iter;
-
-    GSET_ITER (gs_iter, node->bm_faces) {
-      BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+    for (int i = 0; i < node->bm_tot_faces; i++) {
+      BMFace *f = node->bm_face_array[i];
 
       BLI_assert(f->len == 3);
       if (!BM_elem_flag_test(f, BM_ELEM_HIDDEN)) {
@@ -1578,12 +1648,11 @@ bool BKE_pbvh_bmesh_node_raycast_detail(PBVHNode *node,
     return 0;
   }
 
-  GSetIterator gs_iter;
   bool hit = false;
   BMFace *f_hit = NULL;
 
-  GSET_ITER (gs_iter, node->bm_faces) {
-    BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+  for (int i = 0; i < node->bm_tot_faces; i++) {
+    BMFace *f = node->bm_face_array[i];
 
     BLI_assert(f->len == 3);
     if (!BM_elem_flag_test(f, BM_ELEM_HIDDEN)) {
@@ -1636,10 +1705,8 @@ bool pbvh_bmesh_node_nearest_to_ray(PBVHNode *node,
     }
   }
   else {
-    GSetIterator gs_iter;
-
-    GSET_ITER (gs_iter, node->bm_faces) {
-      BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+    for (int i = 0; i < node->bm_tot_faces; i++) {
+      BMFace *f = node->bm_face_array[i];
 
       BLI_assert(f->len == 3);
       if (!BM_elem_flag_test(f, BM_ELEM_HIDDEN)) {
@@ -1661,17 +1728,14 @@ void pbvh_bmesh_normals_update(PBVHNode **nodes, int totnode)
     PBVHNode *node = nodes[n];
 
     if (node->flag & PBVH_UpdateNormals) {
-      GSetIterator gs_iter;
+      BLI_assert(!(node->flag & PBVH_UpdateBMeshArrays));
 
-      GSET_ITER (gs_iter, node->bm_faces) {
-        BM_face_normal_update(BLI_gsetIterator_getKey(&gs_iter));
-      }
-      GSET_ITER (gs_iter, node->bm_unique_verts) {
-        BM_vert_normal_update(BLI_gsetIterator_getKey(&gs_iter));
+      for (int i = 0; i < node->bm_tot_faces; i++) {
+        BM_face_normal_update(node->bm_face_array[i]);
       }
-      /* This should be unneeded normally */
-      GSET_ITER (gs_iter, node->bm_other_verts) {
-        BM_vert_normal_update(BLI_gsetIterator_getKey(&gs_iter));
+      /* Updating the other verts should be unneeded normally */
+      for (int i = 0; i < node->bm_tot_verts; i++) {
+        BM_vert_normal_update(node->bm_vert_array[i]);
       }
       node->flag &= ~PBVH_UpdateNormals;
     }
@@ -1865,6 +1929,8 @@ static void pbvh_bmesh_create_nodes_fast_recursive(
 
     n->orig_vb = n->vb;
 
+    pbvh_bmesh_node_arrays_update(n);
+
     /* Build GPU buffers for new node and update vertex normals */
     BKE_pbvh_node_mark_rebuild_draw(n);
 
@@ -2021,6 +2087,8 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *bvh,
       node->flag &= ~PBVH_UpdateTopology;
     }
   }
+  pbvh_bmesh_arrays_update(bvh);
+
   BLI_buffer_free(&edge_loops);
   BLI_buffer_free(&deleted_faces);
 
@@ -102,6 +102,15 @@ struct PBVHNode {
   GSet *bm_faces;
   GSet *bm_unique_verts;
   GSet *bm_other_verts;
+  /* Contents of the sets above as arrays, unique verts first, so brushes can walk them
+   * linearly. Rebuilt after topology changes, see #PBVH_UpdateBMeshArrays.
+   *
+   * These only store pointers, the vertex data and adjacency stay in the BMesh elements.
+   * Topology updates and #BMLog undo work on the BMesh, copying the data into compact arrays
+   * would need syncing it back after every brush step. */
+  struct BMVert **bm_vert_array;
+  struct BMFace **bm_face_array;
+  int bm_tot_unique_verts, bm_tot_verts, bm_tot_faces;
   float (*bm_orco)[3];
   int (*bm_ortri)[3];
   int bm_tot_ortri;
@@ -109,6 +118,7 @@ struct PBVHNode {
 
 typedef enum {
   PBVH_DYNTOPO_SMOOTH_SHADING = 1,
+  PBVH_BUILD_SAH = 2,
 } PBVHFlags;
 
 typedef struct PBVHBMeshLog PBVHBMeshLog;
@@ -143,10 +153,6 @@ struct PBVH {
   int totgrid;
   BLI_bitmap **grid_hidden;
 
-  /* Only used during BVH build and update,
-   * don't need to remain valid after */
-  BLI_bitmap *vert_bitmap;
-
 #ifdef PERFCNTRS
   int perf_modified;
 #endif
@@ -20,26 +20,42 @@
  * \ingroup bke
  */
 
+#include <limits.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <memory.h>
 
+#include "zlib.h"
+
 #include "MEM_guardedalloc.h"
 
+#include "DNA_color_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
+#include "DNA_vfont_types.h"
 
+#include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
 #include "BLI_mempool.h"
 #include "BLI_threads.h"
 #include "BLI_listbase.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
 
+#include "BKE_appdir.h"
 #include "BKE_sequencer.h"
 #include "BKE_scene.h"
 #include "BKE_main.h"
 
+#include "atomic_ops.h"
+
 /**
  * Sequencer Cache Design Notes
  * ============================
@@ -63,6 +79,15 @@
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * Disk Cache:
+ * When enabled in the preferences, permanent entries which are recycled to free memory are
+ * written to disk, compressed, by a worker thread owned by the cache. A cache miss in memory
+ * then tries to read the image back from disk before it is rendered again.
+ * Files are stored in a directory per blend file, scene and strip, named by frame, cache type
+ * and a hash of the key and the strip settings, so they are still valid after reopening the file.
+ * Editing a strip removes its files for the affected frame range, oldest files are removed once
+ * the size limit is exceeded.
  */
 
 typedef struct SeqCache {
@@ -72,6 +97,10 @@ typedef struct SeqCache {
   struct BLI_mempool *items_pool;
   struct SeqCacheKey *last_key;
   size_t memory_used;
+  /** Main the cache was created for, used to locate the disk cache. */
+  struct Main *bmain;
+  /** Created on first use of the disk cache. */
+  struct SeqDiskCache *disk_cache;
 } SeqCache;
 
 typedef struct SeqCacheItem {
@@ -92,6 +121,9 @@ typedef struct SeqCacheKey {
   /* ID of task for asigning temp cache entries to particular task(thread, etc.) */
   eSeqTaskId task_id;
   int type;
+  /** Hash of the image for the disk cache, see #seq_disk_cache_render_key_hash. */
+  bool has_disk_key_hash;
+  unsigned int disk_key_hash;
 } SeqCacheKey;
 
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
@@ -191,6 +223,848 @@ static void seq_cache_valfree(void *val)
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Disk Cache
+ * \{ */
+
+#define SEQ_DISK_CACHE_VERSION 2
+#define SEQ_DISK_CACHE_FILE_EXT ".dcf"
+/** Don't hold on to more evicted images than this while they wait to be written. */
+#define SEQ_DISK_CACHE_QUEUE_MAX 64
+/** Once over the size limit, remove files until this fraction of the limit is used. */
+#define SEQ_DISK_CACHE_PRUNE_FACTOR 0.9
+
+typedef struct SeqDiskCache {
+  /** Single worker thread, so writing and invalidating files happens in order. */
+  ListBase threads;
+  ThreadQueue *queue;
+  /** Reading is skipped while invalidations are queued, so no outdated image is read. */
+  int invalidations_pending;
+} SeqDiskCache;
+
+typedef struct SeqDiskCacheHeader {
+  char magic[8];
+  int version;
+  unsigned int key_hash;
+  int x, y, planes, channels;
+  int is_float;
+  /** #eUserpref_DiskCacheCompression. */
+  int compression;
+  unsigned int data_size;
+  float cost;
+  char colorspace[64];
+} SeqDiskCacheHeader;
+
+typedef struct SeqDiskCacheJob {
+  /** File to write, or directory to remove files from. */
+  char path[FILE_MAX];
+
+  /** Write job. */
+  ImBuf *ibuf;
+  SeqDiskCacheHeader header;
+
+  /** Invalidation job, files in the (strip) directories of #SeqDiskCacheJob.path. */
+  bool invalidate_all_strips;
+  int invalidate_types;
+  int range_start, range_end;
+} SeqDiskCacheJob;
+
+/** Size of the disk cache, shared by all scenes, computed on first write. */
+static struct {
+  ThreadMutex mutex;
+  size_t size_used;
+  bool size_known;
+} g_seq_disk_cache = {BLI_MUTEX_INITIALIZER, 0, false};
+
+/** Cache files are stored per blend file, so unsaved files have none. */
+static bool seq_disk_cache_has_files(Main *bmain)
+{
+  return ((bmain != NULL) && (BKE_main_blendfile_path(bmain)[0] != '\0'));
+}
+
+static bool seq_disk_cache_is_enabled(Main *bmain)
+{
+  return ((U.sequencer_disk_cache_flag & SEQ_CACHE_DISK_CACHE_ENABLE) &&
+          seq_disk_cache_has_files(bmain));
+}
+
+static size_t seq_disk_cache_get_size_limit(void)
+{
+  return ((size_t)U.sequencer_disk_cache_size_limit) * 1024 * 1024 * 1024;
+}
+
+static void seq_disk_cache_base_dir_get(char r_dir[FILE_MAX])
+{
+  if (U.sequencer_disk_cache_dir[0] != '\0') {
+    BLI_strncpy(r_dir, U.sequencer_disk_cache_dir, FILE_MAX);
+  }
+  else {
+    BLI_join_dirfile(r_dir, FILE_MAX, BKE_tempdir_base(), "blender_sequencer_cache");
+  }
+}
+
+/** Directory of all strips of a scene, per blend file so files with the same name don't mix. */
+static void seq_disk_cache_scene_dir_get(Main *bmain, Scene *scene, char r_dir[FILE_MAX])
+{
+  const char *blendfile_path = BKE_main_blendfile_path(bmain);
+  char base_dir[FILE_MAX], blendfile_dir[FILE_MAXFILE], scene_name[MAX_ID_NAME];
+
+  BLI_snprintf(blendfile_dir,
+               sizeof(blendfile_dir),
+               "%s_%08x",
+               BLI_path_basename(blendfile_path),
+               BLI_hash_mm2((const unsigned char *)blendfile_path, strlen(blendfile_path), 0));
+  BLI_filename_make_safe(blendfile_dir);
+  BLI_strncpy(scene_name, scene->id.name + 2, sizeof(scene_name));
+  BLI_filename_make_safe(scene_name);
+
+  seq_disk_cache_base_dir_get(base_dir);
+  BLI_path_join(r_dir, FILE_MAX, base_dir, blendfile_dir, scene_name, NULL);
+}
+
+static void seq_disk_cache_strip_dir_get(Main *bmain,
+                                         Scene *scene,
+                                         Sequence *seq,
+                                         char r_dir[FILE_MAX])
+{
+  char scene_dir[FILE_MAX], seq_name[sizeof(seq->name)];
+
+  seq_disk_cache_scene_dir_get(bmain, scene, scene_dir);
+  BLI_strncpy(seq_name, seq->name + 2, sizeof(seq_name));
+  BLI_filename_make_safe(seq_name);
+  BLI_join_dirfile(r_dir, FILE_MAX, scene_dir, seq_name);
+}
+
+/** Effect inputs and meta strips nested deeper than this are not cached on disk. */
+#define SEQ_DISK_CACHE_HASH_DEPTH_MAX 32
+
+static bool seq_disk_cache_hash_strip(BLI_HashMurmur2A *mm2,
+                                      ListBase *seqbase,
+                                      Sequence *seq,
+                                      int cfra,
+                                      int depth);
+
+static void seq_disk_cache_hash_curve_mapping(BLI_HashMurmur2A *mm2, const CurveMapping *cumap)
+{
+  BLI_hash_mm2a_add_int(mm2, cumap->flag);
+  BLI_hash_mm2a_add_int(mm2, cumap->tone);
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)&cumap->clipr, sizeof(cumap->clipr));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)cumap->black, sizeof(cumap->black));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)cumap->white, sizeof(cumap->white));
+
+  for (int i = 0; i < ARRAY_SIZE(cumap->cm); i++) {
+    const CurveMap *cuma = &cumap->cm[i];
+    BLI_hash_mm2a_add_int(mm2, cuma->totpoint);
+    for (int a = 0; cuma->curve && a < cuma->totpoint; a++) {
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)&cuma->curve[a].x, sizeof(float[2]));
+      BLI_hash_mm2a_add_int(mm2, cuma->curve[a].flag);
+    }
+  }
+}
+
+static void seq_disk_cache_hash_effect(BLI_HashMurmur2A *mm2, const Sequence *seq)
+{
+  if (seq->effectdata == NULL) {
+    return;
+  }
+
+  const unsigned char *data = seq->effectdata;
+  switch (seq->type) {
+    case SEQ_TYPE_WIPE:
+      BLI_hash_mm2a_add(mm2, data, sizeof(WipeVars));
+      break;
+    case SEQ_TYPE_GLOW:
+      BLI_hash_mm2a_add(mm2, data, sizeof(GlowVars));
+      break;
+    case SEQ_TYPE_TRANSFORM:
+      BLI_hash_mm2a_add(mm2, data, sizeof(TransformVars));
+      break;
+    case SEQ_TYPE_COLOR:
+      BLI_hash_mm2a_add(mm2, data, sizeof(SolidColorVars));
+      break;
+    case SEQ_TYPE_GAUSSIAN_BLUR:
+      BLI_hash_mm2a_add(mm2, data, sizeof(GaussianBlurVars));
+      break;
+    case SEQ_TYPE_COLORMIX:
+      BLI_hash_mm2a_add(mm2, data, sizeof(ColorMixVars));
+      break;
+    case SEQ_TYPE_SPEED: {
+      /* Skip the frame map, it's computed from these settings. */
+      const SpeedControlVars *speed = seq->effectdata;
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)&speed->globalSpeed, sizeof(float));
+      BLI_hash_mm2a_add_int(mm2, speed->flags);
+      break;
+    }
+    case SEQ_TYPE_TEXT: {
+      /* Skip the font pointer and run-time font ID, use the font file instead. */
+      const TextVars *text = seq->effectdata;
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)text->text, strlen(text->text));
+      BLI_hash_mm2a_add_int(mm2, text->text_size);
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)text->color, sizeof(text->color));
+      BLI_hash_mm2a_add(
+          mm2, (const unsigned char *)text->shadow_color, sizeof(text->shadow_color));
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)text->loc, sizeof(text->loc));
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)&text->wrap_width, sizeof(float));
+      BLI_hash_mm2a_add_int(mm2, text->flag);
+      BLI_hash_mm2a_add_int(mm2, text->align);
+      BLI_hash_mm2a_add_int(mm2, text->align_y);
+      if (text->text_font) {
+        const char *font_path = text->text_font->name;
+        BLI_hash_mm2a_add(mm2, (const unsigned char *)font_path, strlen(font_path));
+      }
+      break;
+    }
+  }
+}
+
+static bool seq_disk_cache_hash_modifiers(
+    BLI_HashMurmur2A *mm2, ListBase *seqbase, Sequence *seq, int cfra, int depth)
+{
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    BLI_hash_mm2a_add(mm2, (const unsigned char *)smd->name, strlen(smd->name));
+    BLI_hash_mm2a_add_int(mm2, smd->type);
+    BLI_hash_mm2a_add_int(mm2, smd->flag);
+    BLI_hash_mm2a_add_int(mm2, smd->mask_input_type);
+    BLI_hash_mm2a_add_int(mm2, smd->mask_time);
+
+    if (smd->mask_input_type == SEQUENCE_MASK_INPUT_STRIP) {
+      if (smd->mask_sequence &&
+          !seq_disk_cache_hash_strip(mm2, seqbase, smd->mask_sequence, cfra, depth + 1)) {
+        return false;
+      }
+    }
+    else if (smd->mask_id) {
+      /* Masks are edited without changing the strip. */
+      return false;
+    }
+
+    switch (smd->type) {
+      case seqModifierType_ColorBalance: {
+        const ColorBalanceModifierData *cbmd = (ColorBalanceModifierData *)smd;
+        BLI_hash_mm2a_add(mm2,
+                          (const unsigned char *)&cbmd->color_balance,
+                          sizeof(cbmd->color_balance));
+        BLI_hash_mm2a_add(mm2, (const unsigned char *)&cbmd->color_multiply, sizeof(float));
+        break;
+      }
+      case seqModifierType_Curves:
+        seq_disk_cache_hash_curve_mapping(mm2, &((CurvesModifierData *)smd)->curve_mapping);
+        break;
+      case seqModifierType_HueCorrect:
+        seq_disk_cache_hash_curve_mapping(mm2, &((HueCorrectModifierData *)smd)->curve_mapping);
+        break;
+      case seqModifierType_BrightContrast: {
+        const BrightContrastModifierData *bcmd = (BrightContrastModifierData *)smd;
+        BLI_hash_mm2a_add(mm2, (const unsigned char *)&bcmd->bright, sizeof(float));
+        BLI_hash_mm2a_add(mm2, (const unsigned char *)&bcmd->contrast, sizeof(float));
+        break;
+      }
+      case seqModifierType_WhiteBalance: {
+        const WhiteBalanceModifierData *wbmd = (WhiteBalanceModifierData *)smd;
+        BLI_hash_mm2a_add(
+            mm2, (const unsigned char *)wbmd->white_value, sizeof(wbmd->white_value));
+        break;
+      }
+      case seqModifierType_Tonemap: {
+        const SequencerTonemapModifierData *tmmd = (SequencerTonemapModifierData *)smd;
+        const float values[] = {tmmd->key,
+                                tmmd->offset,
+                                tmmd->gamma,
+                                tmmd->intensity,
+                                tmmd->contrast,
+                                tmmd->adaptation,
+                                tmmd->correction};
+        BLI_hash_mm2a_add(mm2, (const unsigned char *)values, sizeof(values));
+        BLI_hash_mm2a_add_int(mm2, tmmd->type);
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Hash strips of \a seqbase which are visible at \a cfra below \a channel,
+ * for images which are composited over them.
+ */
+static bool seq_disk_cache_hash_lower_channels(
+    BLI_HashMurmur2A *mm2, ListBase *seqbase, int channel, int cfra, int depth)
+{
+  LISTBASE_FOREACH (Sequence *, seq_iter, seqbase) {
+    if (seq_iter->machine < channel && seq_iter->startdisp <= cfra && seq_iter->enddisp > cfra) {
+      BLI_hash_mm2a_add_int(mm2, seq_iter->machine);
+      if (!seq_disk_cache_hash_strip(mm2, seqbase, seq_iter, cfra, depth + 1)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Hash all settings of \a seq and of the strips it reads from which affect its image at \a cfra.
+ * \return false when the image depends on data outside of the strips (scenes, clips, masks),
+ * which can change without invalidating the cache, so it must not be cached on disk.
+ */
+static bool seq_disk_cache_hash_strip(
+    BLI_HashMurmur2A *mm2, ListBase *seqbase, Sequence *seq, int cfra, int depth)
+{
+  if (depth > SEQ_DISK_CACHE_HASH_DEPTH_MAX ||
+      ELEM(seq->type, SEQ_TYPE_SCENE, SEQ_TYPE_MOVIECLIP, SEQ_TYPE_MASK)) {
+    return false;
+  }
+
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)seq->name, strlen(seq->name));
+  BLI_hash_mm2a_add_int(mm2, seq->type);
+  BLI_hash_mm2a_add_int(mm2, seq->flag & ~(SEQ_ALLSEL | SEQ_OVERLAP | SEQ_LOCK));
+  BLI_hash_mm2a_add_int(mm2, seq->start);
+  BLI_hash_mm2a_add_int(mm2, seq->len);
+  BLI_hash_mm2a_add_int(mm2, seq->startofs);
+  BLI_hash_mm2a_add_int(mm2, seq->endofs);
+  BLI_hash_mm2a_add_int(mm2, seq->startstill);
+  BLI_hash_mm2a_add_int(mm2, seq->endstill);
+  BLI_hash_mm2a_add_int(mm2, seq->anim_startofs);
+  BLI_hash_mm2a_add_int(mm2, seq->anim_endofs);
+  BLI_hash_mm2a_add_int(mm2, seq->streamindex);
+  BLI_hash_mm2a_add_int(mm2, seq->multicam_source);
+  BLI_hash_mm2a_add_int(mm2, seq->blend_mode);
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)&seq->blend_opacity, sizeof(float));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)&seq->mul, sizeof(float));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)&seq->sat, sizeof(float));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)&seq->effect_fader, sizeof(float));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)&seq->speed_fader, sizeof(float));
+  BLI_hash_mm2a_add_int(mm2, seq->alpha_mode);
+  BLI_hash_mm2a_add_int(mm2, seq->views_format);
+  if (seq->stereo3d_format) {
+    BLI_hash_mm2a_add(mm2, (const unsigned char *)seq->stereo3d_format, sizeof(Stereo3dFormat));
+  }
+
+  if (seq->strip) {
+    Strip *strip = seq->strip;
+    BLI_hash_mm2a_add(mm2, (const unsigned char *)strip->dir, strlen(strip->dir));
+    BLI_hash_mm2a_add(mm2,
+                      (const unsigned char *)strip->colorspace_settings.name,
+                      strlen(strip->colorspace_settings.name));
+    if (strip->stripdata) {
+      const StripElem *elem = BKE_sequencer_give_stripelem(seq, cfra);
+      if (elem) {
+        BLI_hash_mm2a_add(mm2, (const unsigned char *)elem->name, strlen(elem->name));
+      }
+    }
+    if ((seq->flag & SEQ_USE_CROP) && strip->crop) {
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)strip->crop, sizeof(StripCrop));
+    }
+    if ((seq->flag & SEQ_USE_TRANSFORM) && strip->transform) {
+      BLI_hash_mm2a_add(mm2, (const unsigned char *)strip->transform, sizeof(StripTransform));
+    }
+  }
+
+  seq_disk_cache_hash_effect(mm2, seq);
+
+  if (!seq_disk_cache_hash_modifiers(mm2, seqbase, seq, cfra, depth)) {
+    return false;
+  }
+
+  Sequence *inputs[] = {seq->seq1, seq->seq2, seq->seq3};
+  for (int i = 0; i < ARRAY_SIZE(inputs); i++) {
+    if (inputs[i] && !seq_disk_cache_hash_strip(mm2, seqbase, inputs[i], cfra, depth + 1)) {
+      return false;
+    }
+  }
+
+  if (seq->type == SEQ_TYPE_META) {
+    LISTBASE_FOREACH (Sequence *, seq_iter, &seq->seqbase) {
+      BLI_hash_mm2a_add_int(mm2, seq_iter->machine);
+      if (!seq_disk_cache_hash_strip(mm2, &seq->seqbase, seq_iter, cfra, depth + 1)) {
+        return false;
+      }
+    }
+  }
+  else if (ELEM(seq->type, SEQ_TYPE_MULTICAM, SEQ_TYPE_ADJUSTMENT)) {
+    /* Uses the image of strips in lower channels. */
+    if (!seq_disk_cache_hash_lower_channels(mm2, seqbase, seq->machine, cfra, depth)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Same data as #seq_cache_hashhash, without pointers so it stays valid after reopening the file,
+ * and with all settings the image depends on, so files of a strip changed without invalidating
+ * them (e.g. while the disk cache was disabled) don't match.
+ * \return false when the image can't be cached on disk, see #seq_disk_cache_hash_strip.
+ */
+static bool seq_disk_cache_key_hash(
+    const SeqRenderData *context, Sequence *seq, float nfra, int type, unsigned int *r_key_hash)
+{
+  Editing *ed = context->scene->ed;
+  ListBase *seqbase = ed ? BKE_sequence_seqbase(&ed->seqbase, seq) : NULL;
+  const int cfra = (int)(seq->start + nfra);
+  BLI_HashMurmur2A mm2;
+
+  if (seqbase == NULL) {
+    return false;
+  }
+
+  BLI_hash_mm2a_init(&mm2, SEQ_DISK_CACHE_VERSION);
+  BLI_hash_mm2a_add(&mm2, (const unsigned char *)&nfra, sizeof(float));
+  BLI_hash_mm2a_add_int(&mm2, type);
+  BLI_hash_mm2a_add_int(&mm2, context->rectx);
+  BLI_hash_mm2a_add_int(&mm2, context->recty);
+  BLI_hash_mm2a_add_int(&mm2, context->preview_render_size);
+  BLI_hash_mm2a_add(&mm2, (const unsigned char *)&context->motion_blur_shutter, sizeof(float));
+  BLI_hash_mm2a_add_int(&mm2, context->motion_blur_samples);
+  BLI_hash_mm2a_add_int(&mm2, context->scene->r.views_format);
+  BLI_hash_mm2a_add_int(&mm2, context->view_id);
+
+  if (!seq_disk_cache_hash_strip(&mm2, seqbase, seq, cfra, 0)) {
+    return false;
+  }
+
+  /* Composited images include all strips below. */
+  if (type & (SEQ_CACHE_STORE_COMPOSITE | SEQ_CACHE_STORE_FINAL_OUT)) {
+    if (!seq_disk_cache_hash_lower_channels(&mm2, seqbase, seq->machine, cfra, 0)) {
+      return false;
+    }
+  }
+
+  *r_key_hash = BLI_hash_mm2a_end(&mm2);
+  return true;
+}
+
+/**
+ * Hash the image for the disk cache from the strips being rendered. When prefetching, these are
+ * the prefetch job's own copies, so the original strips which the UI can edit meanwhile are
+ * never read from the prefetch thread. Call before switching to the original context.
+ */
+static bool seq_disk_cache_render_key_hash(const SeqRenderData *context,
+                                           Sequence *seq,
+                                           float cfra,
+                                           int type,
+                                           unsigned int *r_key_hash)
+{
+  const SeqRenderData *context_orig = context->is_prefetch_render ?
+                                          BKE_sequencer_prefetch_get_original_context(context) :
+                                          context;
+
+  if (seq == NULL || context->skip_cache || context->is_proxy_render ||
+      !seq_disk_cache_is_enabled(context_orig->bmain)) {
+    return false;
+  }
+
+  return seq_disk_cache_key_hash(context, seq, cfra - seq->start, type, r_key_hash);
+}
+
+static void seq_disk_cache_filepath_get(Scene *scene,
+                                        const SeqCacheKey *key,
+                                        unsigned int key_hash,
+                                        char r_filepath[FILE_MAX])
+{
+  char dir[FILE_MAX], filename[FILE_MAXFILE];
+
+  seq_disk_cache_strip_dir_get(key->context.bmain, scene, key->seq, dir);
+  BLI_snprintf(filename,
+               sizeof(filename),
+               "%d-%d-%08x" SEQ_DISK_CACHE_FILE_EXT,
+               (int)(key->seq->start + key->nfra),
+               key->type,
+               key_hash);
+  BLI_join_dirfile(r_filepath, FILE_MAX, dir, filename);
+}
+
+static size_t seq_disk_cache_ibuf_data_size(const ImBuf *ibuf, bool is_float)
+{
+  return (size_t)ibuf->x * (size_t)ibuf->y *
+         (is_float ? (size_t)ibuf->channels * sizeof(float) : 4 * sizeof(char));
+}
+
+typedef struct SeqDiskCacheFile {
+  struct SeqDiskCacheFile *next, *prev;
+  char path[FILE_MAX];
+  int64_t mtime;
+  size_t size;
+} SeqDiskCacheFile;
+
+/** Gather cache files from \a dir and its sub-directories up to \a depth levels deep. */
+static void seq_disk_cache_files_gather(const char *dir, int depth, ListBase *r_files)
+{
+  struct direntry *filelist;
+  const unsigned int filelist_len = BLI_filelist_dir_contents(dir, &filelist);
+
+  for (unsigned int i = 0; i < filelist_len; i++) {
+    const struct direntry *file = &filelist[i];
+    if (FILENAME_IS_CURRPAR(file->relname)) {
+      continue;
+    }
+    if (S_ISDIR(file->type)) {
+      if (depth > 0) {
+        seq_disk_cache_files_gather(file->path, depth - 1, r_files);
+      }
+    }
+    else if (BLI_path_extension_check(file->relname, SEQ_DISK_CACHE_FILE_EXT)) {
+      SeqDiskCacheFile *cache_file = MEM_callocN(sizeof(*cache_file), __func__);
+      BLI_strncpy(cache_file->path, file->path, sizeof(cache_file->path));
+      cache_file->mtime = (int64_t)file->s.st_mtime;
+      cache_file->size = (size_t)file->s.st_size;
+      BLI_addtail(r_files, cache_file);
+    }
+  }
+
+  BLI_filelist_free(filelist, filelist_len);
+}
+
+static int seq_disk_cache_file_cmp_mtime(const void *a, const void *b)
+{
+  const SeqDiskCacheFile *file_a = a;
+  const SeqDiskCacheFile *file_b = b;
+  return (file_a->mtime > file_b->mtime) - (file_a->mtime < file_b->mtime);
+}
+
+/** Account for a written file, removing the oldest files when over the size limit. */
+static void seq_disk_cache_size_add(size_t size)
+{
+  const size_t size_limit = seq_disk_cache_get_size_limit();
+
+  BLI_mutex_lock(&g_seq_disk_cache.mutex);
+  g_seq_disk_cache.size_used += size;
+
+  if (!g_seq_disk_cache.size_known || g_seq_disk_cache.size_used > size_limit) {
+    char base_dir[FILE_MAX];
+    ListBase files = {NULL, NULL};
+
+    /* Blend file, scene and strip directories. */
+    seq_disk_cache_base_dir_get(base_dir);
+    seq_disk_cache_files_gather(base_dir, 3, &files);
+
+    g_seq_disk_cache.size_used = 0;
+    LISTBASE_FOREACH (SeqDiskCacheFile *, file, &files) {
+      g_seq_disk_cache.size_used += file->size;
+    }
+    g_seq_disk_cache.size_known = true;
+
+    if (g_seq_disk_cache.size_used > size_limit) {
+      const size_t size_target = (size_t)((double)size_limit * SEQ_DISK_CACHE_PRUNE_FACTOR);
+      BLI_listbase_sort(&files, seq_disk_cache_file_cmp_mtime);
+      LISTBASE_FOREACH (SeqDiskCacheFile *, file, &files) {
+        if (g_seq_disk_cache.size_used <= size_target) {
+          break;
+        }
+        if (BLI_delete(file->path, false, false) == 0) {
+          g_seq_disk_cache.size_used -= file->size;
+        }
+      }
+    }
+
+    BLI_freelistN(&files);
+  }
+
+  BLI_mutex_unlock(&g_seq_disk_cache.mutex);
+}
+
+static void seq_disk_cache_size_remove(size_t size)
+{
+  BLI_mutex_lock(&g_seq_disk_cache.mutex);
+  g_seq_disk_cache.size_used -= MIN2(size, g_seq_disk_cache.size_used);
+  BLI_mutex_unlock(&g_seq_disk_cache.mutex);
+}
+
+static void seq_disk_cache_write_file(SeqDiskCacheJob *job)
+{
+  /* Files are named by their contents, an existing file was read back earlier. */
+  if (BLI_exists(job->path)) {
+    return;
+  }
+
+  ImBuf *ibuf = job->ibuf;
+  SeqDiskCacheHeader *header = &job->header;
+  const void *data = header->is_float ? (void *)ibuf->rect_float : (void *)ibuf->rect;
+  const size_t data_size = seq_disk_cache_ibuf_data_size(ibuf, header->is_float);
+  void *data_compressed = NULL;
+
+  if (header->compression != USER_SEQ_DISK_CACHE_COMPRESSION_NONE) {
+    uLongf data_compressed_size = compressBound((uLong)data_size);
+    data_compressed = MEM_mallocN(data_compressed_size, __func__);
+    const int level = (header->compression == USER_SEQ_DISK_CACHE_COMPRESSION_HIGH) ?
+                          Z_BEST_COMPRESSION :
+                          Z_BEST_SPEED;
+    if (compress2(data_compressed, &data_compressed_size, data, (uLong)data_size, level) !=
+        Z_OK) {
+      MEM_freeN(data_compressed);
+      return;
+    }
+    data = data_compressed;
+    header->data_size = (unsigned int)data_compressed_size;
+  }
+  else {
+    header->data_size = (unsigned int)data_size;
+  }
+
+  /* Write to a temporary file first, so a file that is being written is never read. */
+  char filepath_temp[FILE_MAX];
+  BLI_snprintf(filepath_temp, sizeof(filepath_temp), "%s.tmp", job->path);
+
+  bool ok = false;
+  if (BLI_make_existing_file(filepath_temp)) {
+    FILE *file = BLI_fopen(filepath_temp, "wb");
+    if (file) {
+      ok = ((fwrite(header, sizeof(*header), 1, file) == 1) &&
+            (fwrite(data, header->data_size, 1, file) == 1));
+      ok = (fclose(file) == 0) && ok;
+      ok = ok && (BLI_rename(filepath_temp, job->path) == 0);
+      if (!ok) {
+        BLI_delete(filepath_temp, false, false);
+      }
+    }
+  }
+
+  if (data_compressed) {
+    MEM_freeN(data_compressed);
+  }
+
+  if (ok) {
+    seq_disk_cache_size_add(sizeof(*header) + header->data_size);
+  }
+}
+
+static void seq_disk_cache_invalidate_dir(const char *dir, const SeqDiskCacheJob *job)
+{
+  struct direntry *filelist;
+  const unsigned int filelist_len = BLI_filelist_dir_contents(dir, &filelist);
+
+  for (unsigned int i = 0; i < filelist_len; i++) {
+    const struct direntry *file = &filelist[i];
+    int cfra, type;
+    if (S_ISDIR(file->type) || !BLI_path_extension_check(file->relname, SEQ_DISK_CACHE_FILE_EXT)) {
+      continue;
+    }
+    if (sscanf(file->relname, "%d-%d-", &cfra, &type) != 2) {
+      continue;
+    }
+    if ((type & job->invalidate_types) && (cfra >= job->range_start) &&
+        (cfra <= job->range_end)) {
+      if (BLI_delete(file->path, false, false) == 0) {
+        seq_disk_cache_size_remove((size_t)file->s.st_size);
+      }
+    }
+  }
+
+  BLI_filelist_free(filelist, filelist_len);
+}
+
+static void seq_disk_cache_invalidate_files(SeqDiskCacheJob *job)
+{
+  if (!job->invalidate_all_strips) {
+    seq_disk_cache_invalidate_dir(job->path, job);
+    return;
+  }
+
+  struct direntry *filelist;
+  const unsigned int filelist_len = BLI_filelist_dir_contents(job->path, &filelist);
+
+  for (unsigned int i = 0; i < filelist_len; i++) {
+    const struct direntry *file = &filelist[i];
+    if (S_ISDIR(file->type) && !FILENAME_IS_CURRPAR(file->relname)) {
+      seq_disk_cache_invalidate_dir(file->path, job);
+    }
+  }
+
+  BLI_filelist_free(filelist, filelist_len);
+}
+
+static void *seq_disk_cache_thread(void *disk_cache_v)
+{
+  SeqDiskCache *disk_cache = disk_cache_v;
+  SeqDiskCacheJob *job;
+
+  while ((job = BLI_thread_queue_pop(disk_cache->queue))) {
+    if (job->ibuf) {
+      seq_disk_cache_write_file(job);
+      IMB_freeImBuf(job->ibuf);
+    }
+    else {
+      seq_disk_cache_invalidate_files(job);
+      atomic_sub_and_fetch_int32(&disk_cache->invalidations_pending, 1);
+    }
+    MEM_freeN(job);
+  }
+
+  return NULL;
+}
+
+static SeqDiskCache *seq_disk_cache_ensure(SeqCache *cache)
+{
+  if (cache->disk_cache == NULL) {
+    SeqDiskCache *disk_cache = MEM_callocN(sizeof(*disk_cache), "SeqDiskCache");
+    disk_cache->queue = BLI_thread_queue_init();
+    BLI_threadpool_init(&disk_cache->threads, seq_disk_cache_thread, 1);
+    BLI_threadpool_insert(&disk_cache->threads, disk_cache);
+    cache->disk_cache = disk_cache;
+  }
+  return cache->disk_cache;
+}
+
+/** Finishes all queued jobs, so invalidated files don't outlive the cache. */
+static void seq_disk_cache_free(SeqDiskCache *disk_cache)
+{
+  BLI_thread_queue_nowait(disk_cache->queue);
+  BLI_threadpool_end(&disk_cache->threads);
+  BLI_thread_queue_free(disk_cache->queue);
+  MEM_freeN(disk_cache);
+}
+
+/** Queue writing an image that is recycled from memory, cache must be locked. */
+static void seq_disk_cache_write_async(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
+{
+  if (!seq_disk_cache_is_enabled(key->context.bmain)) {
+    return;
+  }
+
+  SeqDiskCache *disk_cache = seq_disk_cache_ensure(key->cache_owner);
+  if (BLI_thread_queue_len(disk_cache->queue) >= SEQ_DISK_CACHE_QUEUE_MAX) {
+    return;
+  }
+
+  const bool is_float = (ibuf->rect_float != NULL);
+  if (!key->has_disk_key_hash || (!is_float && ibuf->rect == NULL)) {
+    return;
+  }
+
+  SeqDiskCacheJob *job = MEM_callocN(sizeof(*job), "SeqDiskCacheJob");
+  SeqDiskCacheHeader *header = &job->header;
+
+  memcpy(header->magic, "BSEQDCF", sizeof(header->magic));
+  header->version = SEQ_DISK_CACHE_VERSION;
+  header->key_hash = key->disk_key_hash;
+  header->x = ibuf->x;
+  header->y = ibuf->y;
+  header->planes = ibuf->planes;
+  header->channels = ibuf->channels;
+  header->is_float = is_float;
+  header->compression = U.sequencer_disk_cache_compression;
+  header->cost = key->cost;
+  const char *colorspace = is_float ? IMB_colormanagement_get_float_colorspace(ibuf) :
+                                      IMB_colormanagement_get_rect_colorspace(ibuf);
+  BLI_strncpy(header->colorspace, colorspace ? colorspace : "", sizeof(header->colorspace));
+
+  seq_disk_cache_filepath_get(scene, key, header->key_hash, job->path);
+
+  IMB_refImBuf(ibuf);
+  job->ibuf = ibuf;
+  BLI_thread_queue_push(disk_cache->queue, job);
+}
+
+/**
+ * Queue removing files of \a seq, or of all strips when NULL, cache must be locked.
+ * Reading from disk is disabled until the files are removed.
+ * Also done while the disk cache is disabled, so files don't outlive changes made meanwhile.
+ */
+static void seq_disk_cache_invalidate(
+    Scene *scene, Sequence *seq, int invalidate_types, int range_start, int range_end)
+{
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (!invalidate_types || !cache || !seq_disk_cache_has_files(cache->bmain)) {
+    return;
+  }
+
+  SeqDiskCache *disk_cache = seq_disk_cache_ensure(cache);
+  SeqDiskCacheJob *job = MEM_callocN(sizeof(*job), "SeqDiskCacheJob");
+
+  if (seq) {
+    seq_disk_cache_strip_dir_get(cache->bmain, scene, seq, job->path);
+  }
+  else {
+    seq_disk_cache_scene_dir_get(cache->bmain, scene, job->path);
+    job->invalidate_all_strips = true;
+  }
+  job->invalidate_types = invalidate_types;
+  job->range_start = range_start;
+  job->range_end = range_end;
+
+  atomic_add_and_fetch_int32(&disk_cache->invalidations_pending, 1);
+  BLI_thread_queue_push(disk_cache->queue, job);
+}
+
+/** Read an image written by #seq_disk_cache_write_async, returns NULL when there is none. */
+static ImBuf *seq_disk_cache_read(Scene *scene,
+                                  SeqCacheKey *key,
+                                  unsigned int key_hash,
+                                  float *r_cost)
+{
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (cache == NULL || !seq_disk_cache_is_enabled(key->context.bmain)) {
+    return NULL;
+  }
+  if (cache->disk_cache &&
+      atomic_add_and_fetch_int32(&cache->disk_cache->invalidations_pending, 0) != 0) {
+    return NULL;
+  }
+
+  char filepath[FILE_MAX];
+  seq_disk_cache_filepath_get(scene, key, key_hash, filepath);
+
+  FILE *file = BLI_fopen(filepath, "rb");
+  if (file == NULL) {
+    return NULL;
+  }
+
+  ImBuf *ibuf = NULL;
+  SeqDiskCacheHeader header;
+  if ((fread(&header, sizeof(header), 1, file) == 1) &&
+      STREQLEN(header.magic, "BSEQDCF", sizeof(header.magic)) &&
+      (header.version == SEQ_DISK_CACHE_VERSION) && (header.key_hash == key_hash) &&
+      (header.x > 0) && (header.y > 0) && (header.channels > 0) && (header.channels <= 4)) {
+    ibuf = IMB_allocImBuf(
+        header.x, header.y, header.planes, header.is_float ? IB_rectfloat : IB_rect);
+  }
+
+  if (ibuf) {
+    const size_t data_size = seq_disk_cache_ibuf_data_size(ibuf, header.is_float);
+    void *data = header.is_float ? (void *)ibuf->rect_float : (void *)ibuf->rect;
+    bool ok;
+
+    ibuf->channels = header.channels;
+
+    if (header.compression != USER_SEQ_DISK_CACHE_COMPRESSION_NONE) {
+      void *data_compressed = MEM_mallocN(header.data_size, __func__);
+      uLongf data_uncompressed_size = (uLongf)data_size;
+      ok = (fread(data_compressed, header.data_size, 1, file) == 1) &&
+           (uncompress(data, &data_uncompressed_size, data_compressed, header.data_size) ==
+            Z_OK) &&
+           (data_uncompressed_size == data_size);
+      MEM_freeN(data_compressed);
+    }
+    else {
+      ok = (header.data_size == data_size) && (fread(data, data_size, 1, file) == 1);
+    }
+
+    if (ok) {
+      header.colorspace[sizeof(header.colorspace) - 1] = '\0';
+      if (header.colorspace[0] != '\0') {
+        if (header.is_float) {
+          IMB_colormanagement_assign_float_colorspace(ibuf, header.colorspace);
+        }
+        else {
+          IMB_colormanagement_assign_rect_colorspace(ibuf, header.colorspace);
+        }
+      }
+      *r_cost = header.cost;
+    }
+    else {
+      IMB_freeImBuf(ibuf);
+      ibuf = NULL;
+    }
+  }
+
+  fclose(file);
+
+  return ibuf;
+}
+
+/** \} */
+
 static void seq_cache_put(SeqCache *cache, SeqCacheKey *key, ImBuf *ibuf)
 {
   SeqCacheItem *item;
@@ -297,6 +1171,18 @@ static SeqCacheKey *seq_cache_choose_key(Scene *scene, SeqCacheKey *lkey, SeqCac
   return finalkey;
 }
 
+static void seq_cache_recycle_to_disk(Scene *scene, SeqCache *cache, SeqCacheKey *key)
+{
+  if (key->is_temp_cache) {
+    return;
+  }
+
+  SeqCacheItem *item = BLI_ghash_lookup(cache->hash, key);
+  if (item && item->ibuf) {
+    seq_disk_cache_write_async(scene, key, item->ibuf);
+  }
+}
+
 static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
@@ -308,6 +1194,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
 
   while (base) {
     SeqCacheKey *prev = base->link_prev;
+    seq_cache_recycle_to_disk(scene, cache, base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
     base = prev;
   }
@@ -315,6 +1202,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
   base = next;
   while (base) {
     next = base->link_next;
+    seq_cache_recycle_to_disk(scene, cache, base);
     BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
     base = next;
   }
@@ -432,11 +1320,12 @@ static void seq_cache_set_temp_cache_linked(Scene *scene, SeqCacheKey *base)
   }
 }
 
-static void BKE_sequencer_cache_create(Scene *scene)
+static void BKE_sequencer_cache_create(Main *bmain, Scene *scene)
 {
   BLI_mutex_lock(&cache_create_lock);
   if (scene->ed->cache == NULL) {
     SeqCache *cache = MEM_callocN(sizeof(SeqCache), "SeqCache");
+    cache->bmain = bmain;
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
@@ -478,6 +1367,10 @@ void BKE_sequencer_cache_destruct(Scene *scene)
     return;
   }
 
+  if (cache->disk_cache) {
+    seq_disk_cache_free(cache->disk_cache);
+  }
+
   BLI_ghash_free(cache->hash, seq_cache_keyfree, seq_cache_valfree);
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
@@ -492,7 +1385,7 @@ void BKE_sequencer_cache_cleanup_all(Main *bmain)
     BKE_sequencer_cache_cleanup(scene);
   }
 }
-void BKE_sequencer_cache_cleanup(Scene *scene)
+static void seq_cache_cleanup_ex(Scene *scene, const bool invalidate_disk)
 {
   BKE_sequencer_prefetch_stop(scene);
 
@@ -503,6 +1396,10 @@ void BKE_sequencer_cache_cleanup(Scene *scene)
 
   seq_cache_lock(scene);
 
+  if (invalidate_disk) {
+    seq_disk_cache_invalidate(scene, NULL, SEQ_CACHE_ALL_TYPES, INT_MIN, INT_MAX);
+  }
+
   GHashIterator gh_iter;
   BLI_ghashIterator_init(&gh_iter, cache->hash);
   while (!BLI_ghashIterator_done(&gh_iter)) {
@@ -515,6 +1412,17 @@ void BKE_sequencer_cache_cleanup(Scene *scene)
   seq_cache_unlock(scene);
 }
 
+void BKE_sequencer_cache_cleanup(Scene *scene)
+{
+  seq_cache_cleanup_ex(scene, true);
+}
+
+/** Free images cached in memory, keeping the ones cached on disk. */
+void BKE_sequencer_cache_cleanup_memory(Scene *scene)
+{
+  seq_cache_cleanup_ex(scene, false);
+}
+
 void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
                                           Sequence *seq,
                                           Sequence *seq_changed,
@@ -542,6 +1450,10 @@ void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
   int invalidate_source = invalidate_types & (SEQ_CACHE_STORE_RAW | SEQ_CACHE_STORE_PREPROCESSED |
                                               SEQ_CACHE_STORE_COMPOSITE);
 
+  seq_disk_cache_invalidate(scene, NULL, invalidate_composite, range_start, range_end);
+  seq_disk_cache_invalidate(
+      scene, seq, invalidate_source, seq_changed->startdisp, seq_changed->enddisp);
+
   GHashIterator gh_iter;
   BLI_ghashIterator_init(&gh_iter, cache->hash);
   while (!BLI_ghashIterator_done(&gh_iter)) {
@@ -572,21 +1484,13 @@ void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
   seq_cache_unlock(scene);
 }
 
-struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
-                                      Sequence *seq,
-                                      float cfra,
-                                      int type)
+/* Look up an image in memory only, context must not be a prefetch context. */
+static ImBuf *seq_cache_lookup(const SeqRenderData *context, Sequence *seq, float cfra, int type)
 {
   Scene *scene = context->scene;
 
-  if (context->is_prefetch_render) {
-    context = BKE_sequencer_prefetch_get_original_context(context);
-    scene = context->scene;
-    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
-  }
-
   if (!scene->ed->cache) {
-    BKE_sequencer_cache_create(scene);
+    BKE_sequencer_cache_create(context->bmain, scene);
     return NULL;
   }
 
@@ -609,52 +1513,30 @@ struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
   return ibuf;
 }
 
-bool BKE_sequencer_cache_put_if_possible(
-    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *ibuf, float cost)
+/* Put an image of the original \a seq, \a disk_key_hash is NULL when it can't go to disk. */
+static void seq_cache_put_orig(const SeqRenderData *context,
+                               Sequence *seq,
+                               float cfra,
+                               int type,
+                               ImBuf *i,
+                               float cost,
+                               const unsigned int *disk_key_hash)
 {
   Scene *scene = context->scene;
 
-  if (context->is_prefetch_render) {
-    context = BKE_sequencer_prefetch_get_original_context(context);
-    scene = context->scene;
-    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
-  }
-
-  if (BKE_sequencer_cache_recycle_item(scene)) {
-    BKE_sequencer_cache_put(context, seq, cfra, type, ibuf, cost);
-    return true;
-  }
-  else {
-    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-    scene->ed->cache->last_key = NULL;
-    return false;
-  }
-}
-
-void BKE_sequencer_cache_put(
-    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *i, float cost)
-{
-  Scene *scene = context->scene;
-
-  if (context->is_prefetch_render) {
-    context = BKE_sequencer_prefetch_get_original_context(context);
-    scene = context->scene;
-    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
-  }
-
   if (i == NULL || context->skip_cache || context->is_proxy_render || !seq) {
     return;
   }
 
   /* Prevent reinserting, it breaks cache key linking */
-  ImBuf *test = BKE_sequencer_cache_get(context, seq, cfra, type);
+  ImBuf *test = seq_cache_lookup(context, seq, cfra, type);
   if (test) {
     IMB_freeImBuf(test);
     return;
   }
 
   if (!scene->ed->cache) {
-    BKE_sequencer_cache_create(scene);
+    BKE_sequencer_cache_create(context->bmain, scene);
   }
 
   seq_cache_lock(scene);
@@ -687,6 +1569,8 @@ void BKE_sequencer_cache_put(
   key->link_next = NULL;
   key->is_temp_cache = true;
   key->task_id = context->task_id;
+  key->has_disk_key_hash = (disk_key_hash != NULL);
+  key->disk_key_hash = disk_key_hash ? *disk_key_hash : 0;
 
   /* Item stored for later use */
   if (flag & type) {
@@ -717,6 +1601,103 @@ void BKE_sequencer_cache_put(
   seq_cache_unlock(scene);
 }
 
+static bool seq_cache_put_if_possible_orig(const SeqRenderData *context,
+                                           Sequence *seq,
+                                           float cfra,
+                                           int type,
+                                           ImBuf *ibuf,
+                                           float cost,
+                                           const unsigned int *disk_key_hash)
+{
+  Scene *scene = context->scene;
+
+  if (BKE_sequencer_cache_recycle_item(scene)) {
+    seq_cache_put_orig(context, seq, cfra, type, ibuf, cost, disk_key_hash);
+    return true;
+  }
+  else {
+    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
+    scene->ed->cache->last_key = NULL;
+    return false;
+  }
+}
+
+struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
+                                      Sequence *seq,
+                                      float cfra,
+                                      int type)
+{
+  const SeqRenderData *context_render = context;
+  Sequence *seq_render = seq;
+  Scene *scene = context->scene;
+
+  if (context->is_prefetch_render) {
+    context = BKE_sequencer_prefetch_get_original_context(context);
+    scene = context->scene;
+    seq = BKE_sequencer_prefetch_get_original_sequence(seq, scene);
+  }
+
+  ImBuf *ibuf = seq_cache_lookup(context, seq, cfra, type);
+
+  /* Try the disk cache, and keep the image in memory again when found. */
+  unsigned int disk_key_hash;
+  if (ibuf == NULL && seq &&
+      seq_disk_cache_render_key_hash(context_render, seq_render, cfra, type, &disk_key_hash)) {
+    SeqCacheKey key;
+    float cost;
+
+    key.seq = seq;
+    key.context = *context;
+    key.nfra = cfra - seq->start;
+    key.type = type;
+
+    ibuf = seq_disk_cache_read(scene, &key, disk_key_hash, &cost);
+
+    if (ibuf) {
+      if (type == SEQ_CACHE_STORE_FINAL_OUT) {
+        seq_cache_put_if_possible_orig(context, seq, cfra, type, ibuf, cost, &disk_key_hash);
+      }
+      else {
+        seq_cache_put_orig(context, seq, cfra, type, ibuf, cost, &disk_key_hash);
+      }
+    }
+  }
+
+  return ibuf;
+}
+
+bool BKE_sequencer_cache_put_if_possible(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *ibuf, float cost)
+{
+  unsigned int disk_key_hash;
+  const bool has_disk_key_hash = seq_disk_cache_render_key_hash(
+      context, seq, cfra, type, &disk_key_hash);
+
+  if (context->is_prefetch_render) {
+    context = BKE_sequencer_prefetch_get_original_context(context);
+    seq = BKE_sequencer_prefetch_get_original_sequence(seq, context->scene);
+  }
+
+  return seq_cache_put_if_possible_orig(
+      context, seq, cfra, type, ibuf, cost, has_disk_key_hash ? &disk_key_hash : NULL);
+}
+
+void BKE_sequencer_cache_put(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *i, float cost)
+{
+  unsigned int disk_key_hash;
+  const bool has_disk_key_hash = seq_disk_cache_render_key_hash(
+      context, seq, cfra, type, &disk_key_hash);
+
+  if (context->is_prefetch_render) {
+    context = BKE_sequencer_prefetch_get_original_context(context);
+    seq = BKE_sequencer_prefetch_get_original_sequence(seq, context->scene);
+  }
+
+  seq_cache_put_orig(
+      context, seq, cfra, type, i, cost, has_disk_key_hash ? &disk_key_hash : NULL);
+}
+
 void BKE_sequencer_cache_iterate(
     struct Scene *scene,
     void *userdata,
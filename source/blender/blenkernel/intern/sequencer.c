@@ -6107,5 +6107,5 @@ void BKE_sequencer_all_free_anim_ibufs(Scene *scene, int cfra)
     return;
   }
   sequencer_all_free_anim_ibufs(&ed->seqbase, cfra);
-  BKE_sequencer_cache_cleanup(scene);
+  BKE_sequencer_cache_cleanup_memory(scene);
 }
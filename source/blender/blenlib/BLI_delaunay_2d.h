@@ -125,6 +125,8 @@ typedef struct CDT_input {
  *
  * The output may have merged some input vertices together,
  * if they were closer than some epsilon distance.
+ * The output edges and faces always refer to output vertex indices,
+ * so a merged input vertex appears in them as the vertex it was merged into.
  * The output edges may be overlapping sub-segments of some
  * input edges; or they may be new edges for the triangulation.
  * The output faces may be pieces of some input faces, or they
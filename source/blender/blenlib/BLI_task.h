@@ -36,8 +36,10 @@ struct BLI_mempool;
 
 /* Task Scheduler
  *
- * Central scheduler that holds running threads ready to execute tasks. A single
- * queue holds the task from all pools.
+ * Central scheduler that holds running threads ready to execute tasks. Every
+ * thread has its own queue of tasks: tasks pushed from a thread go to its own
+ * queue, and threads which run out of work steal tasks from the queues of the
+ * other threads.
  *
  * Init/exit must be called before/after any task pools are created/freed, and
  * must be called from the main threads. All other scheduler and pool functions
@@ -0,0 +1,75 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+#ifndef __BLI_TRACE_H__
+#define __BLI_TRACE_H__
+
+/** \file
+ * \ingroup BLI
+ *
+ * Opt-in recording of timed events from any thread, for profiling.
+ * Events are written in the trace event format, which can be viewed in
+ * chrome://tracing or Perfetto, showing what every thread was busy with.
+ */
+
+#include <stdio.h>
+
+#include "BLI_sys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Start recording events, which are written to the file when recording ends. */
+void BLI_trace_begin(const char *filepath);
+/* Stop recording and write all recorded events, does nothing when not recording. */
+void BLI_trace_end(void);
+
+bool BLI_trace_is_enabled(void);
+
+/* Record an event which took place between the given times, as returned by
+ * PIL_check_seconds_timer(). The category is expected to be a static string,
+ * the name is copied and may be truncated. */
+void BLI_trace_event(const char *category, const char *name, double start_time, double end_time);
+
+/* Writing of events in the trace event format, for the recorded trace as well as for
+ * timings gathered by other means. */
+typedef struct TraceWriter {
+  FILE *file;
+  bool is_first;
+} TraceWriter;
+
+void BLI_trace_writer_begin(TraceWriter *writer, FILE *file);
+/* Write an event which started the given number of seconds after the trace began.
+ * The numeric argument is shown with the event, it is skipped when its name is NULL. */
+void BLI_trace_writer_event(TraceWriter *writer,
+                            const char *category,
+                            const char *name,
+                            int thread_id,
+                            double start_time,
+                            double duration,
+                            const char *arg_name,
+                            double arg_value);
+void BLI_trace_writer_end(TraceWriter *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_TRACE_H__ */
@@ -1032,18 +1032,39 @@ bool BLI_bvhtree_update_node(
   return true;
 }
 
+static void bvhtree_update_tree_task_cb(void *__restrict userdata,
+                                        const int j,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHTree *tree = userdata;
+  node_join(tree, tree->nodes[tree->totleaf + j - 1]);
+}
+
 /* call BLI_bvhtree_update_node() first for every node/point/triangle */
 void BLI_bvhtree_update_tree(BVHTree *tree)
 {
-  /* Update bottom=>top
-   * TRICKY: the way we build the tree all the childs have an index greater than the parent
-   * This allows us todo a bottom up update by starting on the bigger numbered branch */
+  /* Update bottom=>top, one level at a time.
+   * TRICKY: the way we build the tree (see #non_recursive_bvh_div_nodes) the childs of a branch
+   * are leafs or branches of the next level, so all branches of a level can be joined in
+   * parallel once the next level is done. */
+  const int tree_type = tree->tree_type;
+  const int tree_offset = 2 - tree->tree_type;
+  const int num_branches = tree->totbranch;
 
-  BVHNode **root = tree->nodes + tree->totleaf;
-  BVHNode **index = tree->nodes + tree->totleaf + tree->totbranch - 1;
+  int level_first[32];
+  int num_levels = 0;
+  for (int i = 1; i <= num_branches; i = i * tree_type + tree_offset) {
+    level_first[num_levels++] = i;
+  }
+
+  for (int level = num_levels - 1; level >= 0; level--) {
+    const int i = level_first[level];
+    const int i_stop = (level + 1 < num_levels) ? level_first[level + 1] : num_branches + 1;
 
-  for (; index >= root; index--) {
-    node_join(tree, *index);
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (i_stop - i > KDOPBVH_THREAD_LEAF_THRESHOLD);
+    BLI_task_parallel_range(i, i_stop, tree, bvhtree_update_tree_task_cb, &settings);
   }
 }
 /**
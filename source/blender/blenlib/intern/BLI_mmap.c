@@ -0,0 +1,288 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include "BLI_mmap.h"
+#include "BLI_utildefines.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "atomic_ops.h"
+
+#include <string.h>
+
+#ifndef WIN32
+#  include <pthread.h>
+#  include <sched.h> /* For sched_yield. */
+#  include <signal.h>
+#  include <stdio.h>
+#  include <stdlib.h>
+#  include <sys/mman.h> /* For mmap. */
+#  include <unistd.h>   /* For lseek. */
+#else
+#  include "BLI_winstuff.h"
+#  include <io.h> /* For _get_osfhandle. */
+#endif
+
+struct BLI_mmap_file {
+  /* The address to which the file was mapped. */
+  char *memory;
+
+  /* The length of the file (and therefore the mapped region). */
+  size_t length;
+
+  /* Platform-specific handle for the mapping. */
+  void *handle;
+
+  /* Flag to indicate IO errors. Needs to be volatile since it's being set from
+   * within the signal handler, which is not part of the normal execution flow. */
+  volatile bool io_error;
+};
+
+#ifndef WIN32
+/* When using memory-mapped files, any IO errors will result in a SIGBUS signal.
+ * Therefore, we need to catch that signal and stop reading the file in question.
+ * To do so, we keep track of all current FileDatas that use memory-mapped files,
+ * and if a SIGBUS is caught, we check if the failed address is inside one of the
+ * mapped regions.
+ * If it is, we set a flag to indicate a failed read and remap the memory in
+ * question to a zero-backed region in order to avoid additional signals.
+ * The code that actually reads the memory area has to check whether the flag was
+ * set after it's done reading.
+ * If the error occurred outside of a memory-mapped region, we call the previous
+ * handler if one was configured and abort the process otherwise.
+ */
+
+/* Maximum number of files mapped at the same time, #BLI_mmap_open fails above it and callers
+ * fall back to regular reads. */
+#  define MMAP_FILES_MAX 1024
+
+/* The signal handler can't take locks, so the files are kept in slots which are set and cleared
+ * with atomic operations. A file is only freed once no handler is running, so the handler never
+ * reads a freed file. */
+static BLI_mmap_file *volatile open_mmaps[MMAP_FILES_MAX];
+static uint32_t sigbus_handlers_running = 0;
+
+static pthread_once_t sigbus_handler_once = PTHREAD_ONCE_INIT;
+static bool sigbus_handler_configured = false;
+static struct sigaction sigbus_next_action;
+
+static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
+{
+  /* We only handle SIGBUS here for now. */
+  BLI_assert(sig == SIGBUS);
+
+  atomic_add_and_fetch_uint32(&sigbus_handlers_running, 1);
+
+  char *error_addr = (char *)siginfo->si_addr;
+  /* Find the file that this error belongs to. */
+  for (int i = 0; i < MMAP_FILES_MAX; i++) {
+    BLI_mmap_file *file = open_mmaps[i];
+
+    /* Is the address where the error occurred in this file's mapped range? */
+    if (file && error_addr >= file->memory && error_addr < file->memory + file->length) {
+      file->io_error = true;
+
+      /* Replace the mapped memory with zeroes. */
+      const void *mapped_memory = mmap(
+          file->memory, file->length, PROT_READ, MAP_FIXED | MAP_PRIVATE | MAP_ANON, -1, 0);
+      if (mapped_memory == MAP_FAILED) {
+        fprintf(stderr, "SIGBUS handler: Error replacing mapped file with zeros\n");
+      }
+
+      atomic_sub_and_fetch_uint32(&sigbus_handlers_running, 1);
+      return;
+    }
+  }
+
+  atomic_sub_and_fetch_uint32(&sigbus_handlers_running, 1);
+
+  /* Fall back to other handler if there was one. */
+  if ((sigbus_next_action.sa_flags & SA_SIGINFO) && sigbus_next_action.sa_sigaction &&
+      sigbus_next_action.sa_sigaction != sigbus_handler) {
+    sigbus_next_action.sa_sigaction(sig, siginfo, ptr);
+  }
+  else if (!(sigbus_next_action.sa_flags & SA_SIGINFO) &&
+           !ELEM(sigbus_next_action.sa_handler, SIG_DFL, SIG_IGN, NULL)) {
+    sigbus_next_action.sa_handler(sig);
+  }
+  else {
+    fprintf(stderr, "Unhandled SIGBUS caught\n");
+    abort();
+  }
+}
+
+static void sigbus_handler_setup_once(void)
+{
+  struct sigaction newact = {0}, oldact = {0};
+
+  newact.sa_sigaction = sigbus_handler;
+  newact.sa_flags = SA_SIGINFO;
+
+  if (sigaction(SIGBUS, &newact, &oldact)) {
+    return;
+  }
+
+  /* Remember the previously configured handler to fall back to it if the error
+   * does not belong to any of the mapped files. */
+  sigbus_next_action = oldact;
+  sigbus_handler_configured = true;
+}
+
+/* Ensures that the error handler is set up and ready, only the first call installs it. */
+static bool sigbus_handler_setup(void)
+{
+  pthread_once(&sigbus_handler_once, sigbus_handler_setup_once);
+  return sigbus_handler_configured;
+}
+
+/* Adds a file to the slots that the error handler checks. */
+static bool sigbus_handler_add(BLI_mmap_file *file)
+{
+  for (int i = 0; i < MMAP_FILES_MAX; i++) {
+    if (atomic_cas_ptr((void **)&open_mmaps[i], NULL, file) == NULL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Removes a file from the slots that the error handler checks,
+ * and waits for running handlers which may still access it. */
+static void sigbus_handler_remove(BLI_mmap_file *file)
+{
+  for (int i = 0; i < MMAP_FILES_MAX; i++) {
+    if (atomic_cas_ptr((void **)&open_mmaps[i], file, NULL) == file) {
+      break;
+    }
+  }
+  while (atomic_add_and_fetch_uint32(&sigbus_handlers_running, 0) != 0) {
+    sched_yield();
+  }
+}
+#endif
+
+BLI_mmap_file *BLI_mmap_open(int fd)
+{
+  void *memory, *handle = NULL;
+  const int64_t file_length = lseek(fd, 0, SEEK_END);
+  if (UNLIKELY(file_length < 0 || (uint64_t)file_length > (uint64_t)SIZE_MAX)) {
+    return NULL;
+  }
+  const size_t length = (size_t)file_length;
+
+#ifndef WIN32
+  /* Ensure that the SIGBUS handler is configured. */
+  if (!sigbus_handler_setup()) {
+    return NULL;
+  }
+
+  /* Map the given file to memory. */
+  memory = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (memory == MAP_FAILED) {
+    return NULL;
+  }
+#else
+  /* Convert the POSIX-style file descriptor to a Windows handle. */
+  void *file_handle = (void *)_get_osfhandle(fd);
+  /* Memory mapping an empty file will not work on Windows. */
+  if (file_handle == INVALID_HANDLE_VALUE || length == 0) {
+    return NULL;
+  }
+  /* Tell Windows to create a mapping object for the file. */
+  handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (handle == NULL) {
+    return NULL;
+  }
+  /* Tell Windows to map the entire file. */
+  memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  if (memory == NULL) {
+    CloseHandle(handle);
+    return NULL;
+  }
+#endif
+
+  /* Now that the mapping was successful, allocate memory and set up the BLI_mmap_file. */
+  BLI_mmap_file *file = MEM_callocN(sizeof(BLI_mmap_file), __func__);
+  file->memory = memory;
+  file->handle = handle;
+  file->length = length;
+
+#ifndef WIN32
+  /* Register the file with the error handler. */
+  if (!sigbus_handler_add(file)) {
+    munmap(memory, length);
+    MEM_freeN(file);
+    return NULL;
+  }
+#endif
+
+  return file;
+}
+
+bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
+{
+  /* If a previous read has already failed or we try to read past the end,
+   * don't even attempt to read any further. */
+  if (file->io_error || (offset + length > file->length)) {
+    return false;
+  }
+
+  memcpy(dest, file->memory + offset, length);
+
+  /* If an error occurred in this call, sigbus_handler will have set
+   * file->io_error to true, so report that the read failed. */
+  return !file->io_error;
+}
+
+const void *BLI_mmap_get_pointer(BLI_mmap_file *file)
+{
+  return file->memory;
+}
+
+size_t BLI_mmap_get_length(const BLI_mmap_file *file)
+{
+  return file->length;
+}
+
+bool BLI_mmap_any_io_error(const BLI_mmap_file *file)
+{
+  return file->io_error;
+}
+
+void BLI_mmap_free(BLI_mmap_file *file)
+{
+#ifndef WIN32
+  /* Unregister first, so the handler doesn't match a new mapping at the same address. */
+  sigbus_handler_remove(file);
+  munmap((void *)file->memory, file->length);
+#else
+  if (file->memory) {
+    UnmapViewOfFile(file->memory);
+  }
+  if (file->handle) {
+    CloseHandle(file->handle);
+  }
+#endif
+
+  MEM_freeN(file);
+}
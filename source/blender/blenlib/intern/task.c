@@ -26,6 +26,7 @@
 
 #include "DNA_listBase.h"
 
+#include "BLI_alloca.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_mempool.h"
@@ -161,6 +162,8 @@ struct TaskPool {
   TaskScheduler *scheduler;
 
   volatile size_t num;
+  /* Number of tasks of this pool which are currently in the scheduler's thread queues. */
+  size_t num_queued;
   ThreadMutex num_mutex;
   ThreadCondition num_cond;
 
@@ -201,15 +204,42 @@ struct TaskPool {
 #endif
 };
 
+/* Queue of tasks owned by a single scheduler thread.
+ *
+ * Every thread of the scheduler, including the main thread at index 0, has its
+ * own queue. The owner thread pushes and pops tasks at the head of its queue,
+ * so the most recently pushed (and likely cache-hot) tasks are handled first,
+ * while idle threads steal from the tail of the queues of other threads.
+ *
+ * Each queue has its own spin lock, so threads only contend when they happen to
+ * access the same queue, instead of all of them serializing on a single global
+ * queue mutex.
+ *
+ * NOTE: Queues are not lock-free since BLI_task_pool_work_and_wait() and
+ * BLI_task_pool_cancel() need to pick tasks of a specific pool from the middle
+ * of the queue. */
+typedef struct TaskQueue {
+  ListBase list;
+  SpinLock lock;
+} TaskQueue;
+
 struct TaskScheduler {
   pthread_t *threads;
   struct TaskThread *task_threads;
   int num_threads;
   bool background_thread_only;
 
-  ListBase queue;
-  ThreadMutex queue_mutex;
-  ThreadCondition queue_cond;
+  /* Number of tasks in all the thread queues which can be picked up by worker
+   * threads. Used to decide whether worker thread can go to sleep. */
+  size_t num_queued;
+  /* Counter used to distribute tasks pushed from outside of scheduler threads
+   * over the worker queues. */
+  uint32_t push_counter;
+
+  /* Worker threads which did not find any task to steal sleep here. */
+  ThreadMutex sleep_mutex;
+  ThreadCondition sleep_cond;
+  int num_sleeping;
 
   ThreadMutex startup_mutex;
   ThreadCondition startup_cond;
@@ -224,6 +254,9 @@ struct TaskScheduler {
 typedef struct TaskThread {
   TaskScheduler *scheduler;
   int id;
+  /* State of the random number generator used to pick a victim thread to steal from. */
+  uint32_t steal_seed;
+  TaskQueue queue;
   TaskThreadLocalStorage tls;
 } TaskThread;
 
@@ -353,55 +386,179 @@ static void task_pool_num_increase(TaskPool *pool, size_t new)
   BLI_mutex_unlock(&pool->num_mutex);
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+/* Whether worker threads are allowed to pick up tasks from the given pool. */
+BLI_INLINE bool task_is_visible_to_workers(TaskScheduler *scheduler, TaskPool *pool)
 {
-  bool found_task = false;
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  return !scheduler->background_thread_only || pool->run_in_background;
+}
 
-  while (!scheduler->queue.first && !scheduler->do_exit) {
-    BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+/* Get index of the thread queue to which task of the given pool pushed from the given thread is
+ * to be added. */
+static int task_scheduler_queue_index(TaskScheduler *scheduler, TaskPool *pool, int thread_id)
+{
+  if (scheduler->background_thread_only) {
+    /* The only worker thread only handles background pools, tasks from other pools are handled by
+     * the thread which does work_and_wait() on them. */
+    return pool->run_in_background ? 1 : 0;
   }
+  if (thread_id != -1) {
+    return thread_id;
+  }
+  /* Task is pushed from an unknown thread, spread such tasks over the worker threads. */
+  const uint32_t counter = atomic_fetch_and_add_uint32(&scheduler->push_counter, 1);
+  return 1 + (int)(counter % (uint32_t)scheduler->num_threads);
+}
 
-  do {
-    Task *current_task;
+static void task_queue_num_increase(TaskScheduler *scheduler, TaskPool *pool, size_t new)
+{
+  atomic_add_and_fetch_z(&pool->num_queued, new);
+  if (task_is_visible_to_workers(scheduler, pool)) {
+    atomic_add_and_fetch_z(&scheduler->num_queued, new);
+  }
+}
 
-    /* Assuming we can only have a void queue in 'exit' case here seems logical
-     * (we should only be here after our worker thread has been woken up from a
-     * condition_wait(), which only happens after a new task was added to the queue),
-     * but it is wrong.
-     * Waiting on condition may wake up the thread even if condition is not signaled
-     * (spurious wake-ups), and some race condition may also empty the queue **after**
-     * condition has been signaled, but **before** awoken thread reaches this point...
-     * See http://stackoverflow.com/questions/8594591
-     *
-     * So we only abort here if do_exit is set.
-     */
-    if (scheduler->do_exit) {
-      BLI_mutex_unlock(&scheduler->queue_mutex);
-      return false;
-    }
+static void task_queue_num_decrease(TaskScheduler *scheduler, TaskPool *pool, size_t done)
+{
+  atomic_sub_and_fetch_z(&pool->num_queued, done);
+  if (task_is_visible_to_workers(scheduler, pool)) {
+    atomic_sub_and_fetch_z(&scheduler->num_queued, done);
+  }
+}
 
-    for (current_task = scheduler->queue.first; current_task != NULL;
-         current_task = current_task->next) {
-      TaskPool *pool = current_task->pool;
+/* Wake up sleeping worker threads after new tasks were queued. */
+static void task_scheduler_wakeup(TaskScheduler *scheduler, TaskPool *pool, const bool all)
+{
+  if (!task_is_visible_to_workers(scheduler, pool)) {
+    /* Only the thread doing work_and_wait() on the pool can handle the task, make sure it does
+     * not miss it. */
+    BLI_mutex_lock(&pool->num_mutex);
+    BLI_condition_notify_all(&pool->num_cond);
+    BLI_mutex_unlock(&pool->num_mutex);
+    return;
+  }
+  if (atomic_add_and_fetch_int32(&scheduler->num_sleeping, 0) == 0) {
+    return;
+  }
+  BLI_mutex_lock(&scheduler->sleep_mutex);
+  if (all) {
+    BLI_condition_notify_all(&scheduler->sleep_cond);
+  }
+  else {
+    BLI_condition_notify_one(&scheduler->sleep_cond);
+  }
+  BLI_mutex_unlock(&scheduler->sleep_mutex);
+}
 
-      if (scheduler->background_thread_only && !pool->run_in_background) {
-        continue;
-      }
+/* Pop task from the head of the queue, used by the thread which owns the queue. */
+static Task *task_queue_pop(TaskScheduler *scheduler, TaskQueue *queue)
+{
+  /* Unlocked check to avoid locking empty queues, if a task is missed here, the worker will
+   * notice it from the scheduler's number of queued tasks and retry. */
+  if (queue->list.first == NULL) {
+    return NULL;
+  }
+  BLI_spin_lock(&queue->lock);
+  Task *task = BLI_pophead(&queue->list);
+  BLI_spin_unlock(&queue->lock);
+  if (task != NULL) {
+    task_queue_num_decrease(scheduler, task->pool, 1);
+  }
+  return task;
+}
 
-      *task = current_task;
-      found_task = true;
-      BLI_remlink(&scheduler->queue, *task);
-      break;
+/* Steal task from the tail of the queue of another thread. */
+static Task *task_queue_steal(TaskScheduler *scheduler, TaskQueue *queue)
+{
+  if (queue->list.last == NULL) {
+    return NULL;
+  }
+  BLI_spin_lock(&queue->lock);
+  Task *task = BLI_poptail(&queue->list);
+  BLI_spin_unlock(&queue->lock);
+  if (task != NULL) {
+    task_queue_num_decrease(scheduler, task->pool, 1);
+  }
+  return task;
+}
+
+/* Find task of the given pool in any of the thread queues, starting with the queue of the thread
+ * which created the pool. */
+static Task *task_scheduler_pop_from_pool(TaskScheduler *scheduler, TaskPool *pool)
+{
+  const int num_queues = scheduler->num_threads + 1;
+  for (int i = 0; i < num_queues; i++) {
+    TaskQueue *queue = &scheduler->task_threads[(pool->thread_id + i) % num_queues].queue;
+    if (queue->list.first == NULL) {
+      continue;
+    }
+    Task *found_task = NULL;
+    BLI_spin_lock(&queue->lock);
+    for (Task *task = queue->list.first; task != NULL; task = task->next) {
+      if (task->pool == pool) {
+        BLI_remlink(&queue->list, task);
+        found_task = task;
+        break;
+      }
     }
-    if (!found_task) {
-      BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+    BLI_spin_unlock(&queue->lock);
+    if (found_task != NULL) {
+      task_queue_num_decrease(scheduler, pool, 1);
+      return found_task;
     }
-  } while (!found_task);
+  }
+  return NULL;
+}
 
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+BLI_INLINE uint32_t task_thread_random_next(TaskThread *thread)
+{
+  /* Xorshift, good enough to spread thieves over the victims. */
+  uint32_t x = thread->steal_seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  thread->steal_seed = x;
+  return x;
+}
 
-  return true;
+/* Get next task for the worker thread: from its own queue first, then steal from the other
+ * threads, starting at a random victim. */
+static Task *task_scheduler_thread_pop(TaskScheduler *scheduler, TaskThread *thread)
+{
+  Task *task = task_queue_pop(scheduler, &thread->queue);
+  if (task != NULL || scheduler->background_thread_only) {
+    return task;
+  }
+  const int num_queues = scheduler->num_threads + 1;
+  const int start = (int)(task_thread_random_next(thread) % (uint32_t)num_queues);
+  for (int i = 0; i < num_queues; i++) {
+    const int victim = (start + i) % num_queues;
+    if (victim == thread->id) {
+      continue;
+    }
+    task = task_queue_steal(scheduler, &scheduler->task_threads[victim].queue);
+    if (task != NULL) {
+      return task;
+    }
+  }
+  return NULL;
+}
+
+/* Put worker thread to sleep until there are tasks it can pick up.
+ * Returns false when the scheduler is exiting. */
+static bool task_scheduler_thread_wait(TaskScheduler *scheduler)
+{
+  BLI_mutex_lock(&scheduler->sleep_mutex);
+  /* NOTE: The number of sleeping threads is incremented before checking the number of queued
+   * tasks, and the pushing side increments number of queued tasks before checking number of
+   * sleeping threads, so at least one of the sides sees the change of the other. */
+  atomic_add_and_fetch_int32(&scheduler->num_sleeping, 1);
+  while (atomic_add_and_fetch_z(&scheduler->num_queued, 0) == 0 && !scheduler->do_exit) {
+    BLI_condition_wait(&scheduler->sleep_cond, &scheduler->sleep_mutex);
+  }
+  atomic_sub_and_fetch_int32(&scheduler->num_sleeping, 1);
+  const bool do_exit = scheduler->do_exit;
+  BLI_mutex_unlock(&scheduler->sleep_mutex);
+  return !do_exit;
 }
 
 BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls, const int thread_id)
@@ -442,7 +599,15 @@ static void *task_scheduler_thread_run(void *thread_p)
   BLI_mutex_unlock(&scheduler->startup_mutex);
 
   /* keep popping off tasks */
-  while (task_scheduler_thread_wait_pop(scheduler, &task)) {
+  while (!scheduler->do_exit) {
+    task = task_scheduler_thread_pop(scheduler, thread);
+    if (task == NULL) {
+      if (!task_scheduler_thread_wait(scheduler)) {
+        break;
+      }
+      continue;
+    }
+
     TaskPool *pool = task->pool;
 
     /* run task */
@@ -471,9 +636,8 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
    * threads, so we keep track of the number of users. */
   scheduler->do_exit = false;
 
-  BLI_listbase_clear(&scheduler->queue);
-  BLI_mutex_init(&scheduler->queue_mutex);
-  BLI_condition_init(&scheduler->queue_cond);
+  BLI_mutex_init(&scheduler->sleep_mutex);
+  BLI_condition_init(&scheduler->sleep_cond);
 
   BLI_mutex_init(&scheduler->startup_mutex);
   BLI_condition_init(&scheduler->startup_cond);
@@ -496,6 +660,16 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
   scheduler->task_threads = MEM_mallocN(sizeof(TaskThread) * (num_threads + 1),
                                         "TaskScheduler task threads");
 
+  /* Initialize queues of all threads before any of the threads starts stealing. */
+  for (int i = 0; i < num_threads + 1; i++) {
+    TaskThread *thread = &scheduler->task_threads[i];
+    thread->scheduler = scheduler;
+    thread->id = i;
+    thread->steal_seed = 0x9e3779b9u * (uint32_t)(i + 1);
+    BLI_listbase_clear(&thread->queue.list);
+    BLI_spin_init(&thread->queue.lock);
+  }
+
   /* Initialize TLS for main thread. */
   initialize_task_tls(&scheduler->task_threads[0].tls);
 
@@ -510,8 +684,6 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 
     for (i = 0; i < num_threads; i++) {
       TaskThread *thread = &scheduler->task_threads[i + 1];
-      thread->scheduler = scheduler;
-      thread->id = i + 1;
       initialize_task_tls(&thread->tls);
 
       if (pthread_create(&scheduler->threads[i], NULL, task_scheduler_thread_run, thread) != 0) {
@@ -539,10 +711,10 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
   Task *task;
 
   /* stop all waiting threads */
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  BLI_mutex_lock(&scheduler->sleep_mutex);
   scheduler->do_exit = true;
-  BLI_condition_notify_all(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  BLI_condition_notify_all(&scheduler->sleep_cond);
+  BLI_mutex_unlock(&scheduler->sleep_mutex);
 
   pthread_key_delete(scheduler->tls_id_key);
 
@@ -562,22 +734,23 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
   /* Delete task thread data */
   if (scheduler->task_threads) {
     for (int i = 0; i < scheduler->num_threads + 1; i++) {
-      TaskThreadLocalStorage *tls = &scheduler->task_threads[i].tls;
-      free_task_tls(tls);
+      TaskThread *thread = &scheduler->task_threads[i];
+      free_task_tls(&thread->tls);
+
+      /* delete leftover tasks */
+      for (task = thread->queue.list.first; task; task = task->next) {
+        task_data_free(task, 0);
+      }
+      BLI_freelistN(&thread->queue.list);
+      BLI_spin_end(&thread->queue.lock);
     }
 
     MEM_freeN(scheduler->task_threads);
   }
 
-  /* delete leftover tasks */
-  for (task = scheduler->queue.first; task; task = task->next) {
-    task_data_free(task, 0);
-  }
-  BLI_freelistN(&scheduler->queue);
-
   /* delete mutex/condition */
-  BLI_mutex_end(&scheduler->queue_mutex);
-  BLI_condition_end(&scheduler->queue_cond);
+  BLI_mutex_end(&scheduler->sleep_mutex);
+  BLI_condition_end(&scheduler->sleep_cond);
   BLI_mutex_end(&scheduler->startup_mutex);
   BLI_condition_end(&scheduler->startup_cond);
 
@@ -589,43 +762,93 @@ int BLI_task_scheduler_num_threads(TaskScheduler *scheduler)
   return scheduler->num_threads + 1;
 }
 
-static void task_scheduler_push(TaskScheduler *scheduler, Task *task, TaskPriority priority)
+static void task_scheduler_push(TaskScheduler *scheduler,
+                                Task *task,
+                                TaskPriority priority,
+                                int thread_id)
 {
-  task_pool_num_increase(task->pool, 1);
+  TaskPool *pool = task->pool;
+  TaskQueue *queue =
+      &scheduler->task_threads[task_scheduler_queue_index(scheduler, pool, thread_id)].queue;
+
+  task_pool_num_increase(pool, 1);
+  task_queue_num_increase(scheduler, pool, 1);
 
   /* add task to queue */
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  BLI_spin_lock(&queue->lock);
 
   if (priority == TASK_PRIORITY_HIGH) {
-    BLI_addhead(&scheduler->queue, task);
+    BLI_addhead(&queue->list, task);
   }
   else {
-    BLI_addtail(&scheduler->queue, task);
+    BLI_addtail(&queue->list, task);
   }
 
-  BLI_condition_notify_one(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  BLI_spin_unlock(&queue->lock);
+
+  task_scheduler_wakeup(scheduler, pool, false);
 }
 
-static void task_scheduler_push_all(TaskScheduler *scheduler,
-                                    TaskPool *pool,
-                                    Task **tasks,
-                                    int num_tasks)
+static void task_scheduler_push_all(
+    TaskScheduler *scheduler, TaskPool *pool, Task **tasks, int num_tasks, int thread_id)
 {
   if (num_tasks == 0) {
     return;
   }
 
+  TaskQueue *queue =
+      &scheduler->task_threads[task_scheduler_queue_index(scheduler, pool, thread_id)].queue;
+
   task_pool_num_increase(pool, num_tasks);
+  task_queue_num_increase(scheduler, pool, num_tasks);
 
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  BLI_spin_lock(&queue->lock);
 
   for (int i = 0; i < num_tasks; i++) {
-    BLI_addhead(&scheduler->queue, tasks[i]);
+    BLI_addhead(&queue->list, tasks[i]);
+  }
+
+  BLI_spin_unlock(&queue->lock);
+
+  task_scheduler_wakeup(scheduler, pool, true);
+}
+
+/* Move all tasks from the suspended pool to the thread queues, spreading them evenly so that
+ * worker threads do not all steal from the same queue. Tasks are dealt round-robin, so that the
+ * first tasks of the suspended queue are at the head of all queues and are picked up first. */
+static void task_scheduler_push_suspended(TaskScheduler *scheduler, TaskPool *pool)
+{
+  const size_t num_tasks = pool->num_suspended;
+  const int num_queues = scheduler->background_thread_only ? 1 : scheduler->num_threads + 1;
+  ListBase *queue_tasks = BLI_array_alloca(queue_tasks, (size_t)num_queues);
+
+  task_pool_num_increase(pool, num_tasks);
+  task_queue_num_increase(scheduler, pool, num_tasks);
+
+  for (int i = 0; i < num_queues; i++) {
+    BLI_listbase_clear(&queue_tasks[i]);
   }
+  Task *task = pool->suspended_queue.first;
+  for (int i = 0; task != NULL; i = (i + 1) % num_queues) {
+    Task *next_task = task->next;
+    BLI_addtail(&queue_tasks[i], task);
+    task = next_task;
+  }
+
+  for (int i = 0; i < num_queues && !BLI_listbase_is_empty(&queue_tasks[i]); i++) {
+    const int queue_index = scheduler->background_thread_only ?
+                                task_scheduler_queue_index(scheduler, pool, 0) :
+                                i;
+    TaskQueue *queue = &scheduler->task_threads[queue_index].queue;
+
+    BLI_spin_lock(&queue->lock);
+    BLI_movelisttolist(&queue->list, &queue_tasks[i]);
+    BLI_spin_unlock(&queue->lock);
+  }
+  BLI_listbase_clear(&pool->suspended_queue);
+  pool->num_suspended = 0;
 
-  BLI_condition_notify_all(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  task_scheduler_wakeup(scheduler, pool, true);
 }
 
 static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
@@ -633,21 +856,27 @@ static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
   Task *task, *nexttask;
   size_t done = 0;
 
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  /* free all tasks from this pool from the queues */
+  for (int i = 0; i < scheduler->num_threads + 1; i++) {
+    TaskQueue *queue = &scheduler->task_threads[i].queue;
 
-  /* free all tasks from this pool from the queue */
-  for (task = scheduler->queue.first; task; task = nexttask) {
-    nexttask = task->next;
+    BLI_spin_lock(&queue->lock);
 
-    if (task->pool == pool) {
-      task_data_free(task, pool->thread_id);
-      BLI_freelinkN(&scheduler->queue, task);
+    for (task = queue->list.first; task; task = nexttask) {
+      nexttask = task->next;
 
-      done++;
+      if (task->pool == pool) {
+        task_data_free(task, pool->thread_id);
+        BLI_freelinkN(&queue->list, task);
+
+        done++;
+      }
     }
+
+    BLI_spin_unlock(&queue->lock);
   }
 
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  task_queue_num_decrease(scheduler, pool, done);
 
   /* notify done */
   task_pool_num_decrease(pool, done);
@@ -677,6 +906,7 @@ static TaskPool *task_pool_create_ex(TaskScheduler *scheduler,
 
   pool->scheduler = scheduler;
   pool->num = 0;
+  pool->num_queued = 0;
   pool->do_cancel = false;
   pool->do_work = false;
   pool->is_suspended = is_suspended;
@@ -852,7 +1082,7 @@ static void task_pool_push(TaskPool *pool,
   /* Do push to a global execution pool, slowest possible method,
    * causes quite reasonable amount of threading overhead.
    */
-  task_scheduler_push(pool->scheduler, task, priority);
+  task_scheduler_push(pool->scheduler, task, priority, thread_id);
 }
 
 void BLI_task_pool_push_ex(TaskPool *pool,
@@ -888,15 +1118,7 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
   if (atomic_fetch_and_and_uint8((uint8_t *)&pool->is_suspended, 0)) {
     if (pool->num_suspended) {
-      task_pool_num_increase(pool, pool->num_suspended);
-      BLI_mutex_lock(&scheduler->queue_mutex);
-
-      BLI_movelisttolist(&scheduler->queue, &pool->suspended_queue);
-
-      BLI_condition_notify_all(&scheduler->queue_cond);
-      BLI_mutex_unlock(&scheduler->queue_mutex);
-
-      pool->num_suspended = 0;
+      task_scheduler_push_suspended(scheduler, pool);
     }
   }
 
@@ -909,27 +1131,18 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
   BLI_mutex_lock(&pool->num_mutex);
 
   while (pool->num != 0) {
-    Task *task, *work_task = NULL;
+    Task *work_task = NULL;
     bool found_task = false;
 
     BLI_mutex_unlock(&pool->num_mutex);
 
-    BLI_mutex_lock(&scheduler->queue_mutex);
-
     /* find task from this pool. if we get a task from another pool,
      * we can get into deadlock */
-
-    for (task = scheduler->queue.first; task; task = task->next) {
-      if (task->pool == pool) {
-        work_task = task;
-        found_task = true;
-        BLI_remlink(&scheduler->queue, task);
-        break;
-      }
+    if (atomic_add_and_fetch_z(&pool->num_queued, 0) != 0) {
+      work_task = task_scheduler_pop_from_pool(scheduler, pool);
+      found_task = (work_task != NULL);
     }
 
-    BLI_mutex_unlock(&scheduler->queue_mutex);
-
     /* if found task, do it, otherwise wait until other tasks are done */
     if (found_task) {
       /* run task */
@@ -938,7 +1151,7 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
       BLI_assert(!tls->do_delayed_push);
 
       /* delete task */
-      task_free(pool, task, pool->thread_id);
+      task_free(pool, work_task, pool->thread_id);
 
       /* Handle all tasks from local queue. */
       handle_local_queue(tls, pool->thread_id);
@@ -952,7 +1165,9 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
       break;
     }
 
-    if (!found_task) {
+    /* NOTE: Do not wait if some tasks of this pool are still queued, those might have been
+     * missed by the unlocked checks above. */
+    if (!found_task && atomic_add_and_fetch_z(&pool->num_queued, 0) == 0) {
       BLI_condition_wait(&pool->num_cond, &pool->num_mutex);
     }
   }
@@ -1016,7 +1231,8 @@ void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
     ASSERT_THREAD_ID(pool->scheduler, thread_id);
     TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
     BLI_assert(tls->do_delayed_push);
-    task_scheduler_push_all(pool->scheduler, pool, tls->delayed_queue, tls->num_delayed_queue);
+    task_scheduler_push_all(
+        pool->scheduler, pool, tls->delayed_queue, tls->num_delayed_queue, thread_id);
     tls->do_delayed_push = false;
     tls->num_delayed_queue = 0;
   }
@@ -0,0 +1,250 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Every thread records events into its own list of chunks without locking,
+ * the lists of all threads are only joined when the trace is written.
+ */
+
+#include <stdio.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_listBase.h"
+
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "BLI_trace.h" /* own include */
+
+#include "PIL_time.h"
+
+#define TRACE_CHUNK_SIZE 1024
+
+typedef struct TraceEvent {
+  const char *category;
+  char name[128];
+  double start_time;
+  double end_time;
+} TraceEvent;
+
+typedef struct TraceChunk {
+  struct TraceChunk *next;
+  int num_events;
+  TraceEvent events[TRACE_CHUNK_SIZE];
+} TraceChunk;
+
+typedef struct TraceThread {
+  struct TraceThread *next, *prev;
+  int thread_id;
+  /* Chunks in reverse order, the first one is being filled in. */
+  TraceChunk *chunks;
+} TraceThread;
+
+static struct Trace {
+  bool is_enabled;
+  /* Incremented for every recording, starting at 1, so that threads notice their stale
+   * storage. */
+  int session;
+  char filepath[FILE_MAX];
+  double start_time;
+  SpinLock lock;
+  ListBase threads;
+} trace = {false};
+
+/* Storage of the current thread, only valid when it was created for the current recording. */
+static ThreadLocal(TraceThread *) trace_thread;
+static ThreadLocal(void *) trace_thread_session;
+static bool trace_thread_local_created = false;
+
+void BLI_trace_begin(const char *filepath)
+{
+  BLI_trace_end();
+
+  if (!trace_thread_local_created) {
+    BLI_thread_local_create(trace_thread);
+    BLI_thread_local_create(trace_thread_session);
+    BLI_spin_init(&trace.lock);
+    trace_thread_local_created = true;
+  }
+
+  trace.session++;
+  BLI_strncpy(trace.filepath, filepath, sizeof(trace.filepath));
+  trace.start_time = PIL_check_seconds_timer();
+  BLI_listbase_clear(&trace.threads);
+  trace.is_enabled = true;
+}
+
+bool BLI_trace_is_enabled(void)
+{
+  return trace.is_enabled;
+}
+
+static TraceThread *trace_thread_ensure(void)
+{
+  if (POINTER_AS_INT(BLI_thread_local_get(trace_thread_session)) == trace.session) {
+    return BLI_thread_local_get(trace_thread);
+  }
+
+  TraceThread *thread = MEM_callocN(sizeof(TraceThread), __func__);
+
+  BLI_spin_lock(&trace.lock);
+  thread->thread_id = BLI_listbase_count(&trace.threads);
+  BLI_addtail(&trace.threads, thread);
+  BLI_spin_unlock(&trace.lock);
+
+  BLI_thread_local_set(trace_thread, thread);
+  BLI_thread_local_set(trace_thread_session, POINTER_FROM_INT(trace.session));
+  return thread;
+}
+
+void BLI_trace_event(const char *category, const char *name, double start_time, double end_time)
+{
+  if (!trace.is_enabled) {
+    return;
+  }
+
+  TraceThread *thread = trace_thread_ensure();
+  TraceChunk *chunk = thread->chunks;
+  if (chunk == NULL || chunk->num_events == TRACE_CHUNK_SIZE) {
+    chunk = MEM_mallocN(sizeof(TraceChunk), __func__);
+    chunk->num_events = 0;
+    chunk->next = thread->chunks;
+    thread->chunks = chunk;
+  }
+
+  TraceEvent *event = &chunk->events[chunk->num_events++];
+  event->category = category;
+  BLI_strncpy(event->name, name, sizeof(event->name));
+  event->start_time = start_time;
+  event->end_time = end_time;
+}
+
+static void trace_write_string(FILE *f, const char *str)
+{
+  fputc('"', f);
+  for (const char *ch = str; *ch; ch++) {
+    if (*ch == '"' || *ch == '\\') {
+      fputc('\\', f);
+    }
+    if ((unsigned char)*ch >= 0x20) {
+      fputc(*ch, f);
+    }
+  }
+  fputc('"', f);
+}
+
+void BLI_trace_writer_begin(TraceWriter *writer, FILE *file)
+{
+  writer->file = file;
+  writer->is_first = true;
+  fprintf(file, "{\"traceEvents\": [\n");
+}
+
+void BLI_trace_writer_event(TraceWriter *writer,
+                            const char *category,
+                            const char *name,
+                            int thread_id,
+                            double start_time,
+                            double duration,
+                            const char *arg_name,
+                            double arg_value)
+{
+  FILE *f = writer->file;
+
+  fprintf(f, "%s  {\"name\": ", writer->is_first ? "" : ",\n");
+  trace_write_string(f, name);
+  fprintf(f, ", \"cat\": ");
+  trace_write_string(f, category);
+  fprintf(f,
+          ", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+          thread_id,
+          start_time * 1e6,
+          duration * 1e6);
+  if (arg_name != NULL) {
+    fprintf(f, ", \"args\": {");
+    trace_write_string(f, arg_name);
+    fprintf(f, ": %.3f}", arg_value);
+  }
+  fputc('}', f);
+  writer->is_first = false;
+}
+
+void BLI_trace_writer_end(TraceWriter *writer)
+{
+  fprintf(writer->file, "\n], \"displayTimeUnit\": \"ms\"}\n");
+}
+
+static void trace_write(FILE *f)
+{
+  TraceWriter writer;
+
+  BLI_trace_writer_begin(&writer, f);
+  LISTBASE_FOREACH (TraceThread *, thread, &trace.threads) {
+    for (TraceChunk *chunk = thread->chunks; chunk; chunk = chunk->next) {
+      for (int i = 0; i < chunk->num_events; i++) {
+        const TraceEvent *event = &chunk->events[i];
+        BLI_trace_writer_event(&writer,
+                               event->category,
+                               event->name,
+                               thread->thread_id,
+                               event->start_time - trace.start_time,
+                               event->end_time - event->start_time,
+                               NULL,
+                               0.0);
+      }
+    }
+  }
+  BLI_trace_writer_end(&writer);
+}
+
+void BLI_trace_end(void)
+{
+  if (!trace.is_enabled) {
+    return;
+  }
+  trace.is_enabled = false;
+
+  FILE *f = BLI_fopen(trace.filepath, "w");
+  if (f != NULL) {
+    trace_write(f);
+    fclose(f);
+    printf("Trace written to '%s'\n", trace.filepath);
+  }
+  else {
+    fprintf(stderr, "Failed to write trace to '%s'\n", trace.filepath);
+  }
+
+  LISTBASE_FOREACH_MUTABLE (TraceThread *, thread, &trace.threads) {
+    TraceChunk *chunk = thread->chunks;
+    while (chunk) {
+      TraceChunk *next_chunk = chunk->next;
+      MEM_freeN(chunk);
+      chunk = next_chunk;
+    }
+    MEM_freeN(thread);
+  }
+  BLI_listbase_clear(&trace.threads);
+}
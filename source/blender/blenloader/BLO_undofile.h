@@ -25,6 +25,7 @@
  * \ingroup blenloader
  */
 
+struct MemFileSharedBuffer;
 struct Scene;
 
 typedef struct {
@@ -32,13 +33,21 @@ typedef struct {
   const char *buf;
   /** Size in bytes. */
   unsigned int size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** When true, this chunk is identical to the chunk at the same position in the previous step. */
   bool is_identical;
+  /**
+   * Reference counted storage of #MemFileChunk.buf,
+   * shared by all chunks with the same contents in any #MemFile.
+   */
+  struct MemFileSharedBuffer *shared;
 } MemFileChunk;
 
 typedef struct MemFile {
   ListBase chunks;
+  /** Size of the chunk buffers this memfile added, not shared with any existing chunk. */
   size_t size;
+  /** Size of all chunks, including the shared ones. */
+  size_t size_total;
 } MemFile;
 
 typedef struct MemFileUndoData {
@@ -56,6 +65,7 @@ extern void memfile_chunk_add(MemFile *memfile,
 /* exports */
 extern void BLO_memfile_free(MemFile *memfile);
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
+extern void BLO_memfile_stats_get(size_t *r_buffers_len, size_t *r_buffers_size);
 
 /* utilities */
 extern struct Main *BLO_memfile_main_get(struct MemFile *memfile,
@@ -100,7 +100,11 @@
 #include "BLI_math.h"
 #include "BLI_threads.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
 #include "BLI_ghash.h"
+#include "BLI_task.h"
+
+#include "PIL_time.h"
 
 #include "BLT_translation.h"
 
@@ -977,6 +981,25 @@ static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
   return success;
 }
 
+/**
+ * When the file is memory mapped, get a pointer to the data of a block which was not read yet,
+ * so it can be used directly instead of being read into a temporary buffer first.
+ * Returns NULL when the file is not memory mapped.
+ */
+static const void *blo_bhead_data_mapped(FileData *fd, BHead *thisblock)
+{
+  if (fd->mmap_file == NULL) {
+    return NULL;
+  }
+  BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
+  BLI_assert(new_bhead->has_data == false && new_bhead->file_offset != 0);
+  if ((size_t)new_bhead->file_offset + (size_t)thisblock->len >
+      BLI_mmap_get_length(fd->mmap_file)) {
+    return NULL;
+  }
+  return POINTER_OFFSET(BLI_mmap_get_pointer(fd->mmap_file), new_bhead->file_offset);
+}
+
 static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
 {
   BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
@@ -1156,20 +1179,550 @@ static off64_t fd_seek_data_from_file(FileData *filedata, off64_t offset, int wh
   return filedata->file_offset;
 }
 
-/* GZip file reading. */
+/* Memory-mapped file reading.
+ * Only the pages of the file which are actually accessed get read from disk, so the data of
+ * blocks which are never expanded (e.g. when linking a few IDs from a big library) is not read
+ * at all. */
+
+static int fd_read_from_mmap(FileData *filedata, void *buffer, uint size)
+{
+  /* don't read more bytes then there are available in the file */
+  const size_t length = BLI_mmap_get_length(filedata->mmap_file);
+  if ((size_t)filedata->file_offset >= length) {
+    return 0;
+  }
+  const size_t readsize = MIN2((size_t)size, length - (size_t)filedata->file_offset);
+
+  if (!BLI_mmap_read(filedata->mmap_file, buffer, (size_t)filedata->file_offset, readsize)) {
+    return 0;
+  }
+  filedata->file_offset += readsize;
+
+  return (int)readsize;
+}
+
+static off64_t fd_seek_from_mmap(FileData *filedata, off64_t offset, int whence)
+{
+  const off64_t length = (off64_t)BLI_mmap_get_length(filedata->mmap_file);
+  off64_t new_pos;
+
+  if (whence == SEEK_CUR) {
+    new_pos = filedata->file_offset + offset;
+  }
+  else if (whence == SEEK_SET) {
+    new_pos = offset;
+  }
+  else if (whence == SEEK_END) {
+    new_pos = length + offset;
+  }
+  else {
+    return -1;
+  }
+
+  if (new_pos < 0 || new_pos > length) {
+    return -1;
+  }
+
+  filedata->file_offset = new_pos;
+  return filedata->file_offset;
+}
+
+/* GZip file reading, for files without member sizes (see #GzipIndex).
+ * Decompression runs ahead of the reading on a separate thread, so inflating the file overlaps
+ * with parsing its blocks. */
+
+#define GZIP_READ_AHEAD_BLOCK_SIZE (1 << 18) /* 256kb */
+#define GZIP_READ_AHEAD_BLOCKS_MAX 4
+
+typedef struct GzipReadAheadBlock {
+  struct GzipReadAheadBlock *next, *prev;
+  /** Size of the decompressed data which follows this struct. */
+  int data_len;
+} GzipReadAheadBlock;
+
+typedef struct GzipReadAhead {
+  gzFile gzfile;
+  ListBase threads;
+
+  ThreadMutex mutex;
+  ThreadCondition cond;
+  /** Decompressed blocks ready to be read. */
+  ListBase blocks;
+  int blocks_len;
+  /** Set by the decompression thread on end of file or error. */
+  bool is_eof;
+  /** Set when reading is done, stops the decompression thread. */
+  bool do_exit;
+
+  /** Block being read and the read position in it, only accessed by the reading thread. */
+  GzipReadAheadBlock *block_current;
+  int block_current_ofs;
+} GzipReadAhead;
+
+static void *gzip_read_ahead_thread(void *gzra_v)
+{
+  GzipReadAhead *gzra = gzra_v;
+
+  while (true) {
+    BLI_mutex_lock(&gzra->mutex);
+    while (gzra->blocks_len >= GZIP_READ_AHEAD_BLOCKS_MAX && !gzra->do_exit) {
+      BLI_condition_wait(&gzra->cond, &gzra->mutex);
+    }
+    const bool do_exit = gzra->do_exit;
+    BLI_mutex_unlock(&gzra->mutex);
+
+    if (do_exit) {
+      break;
+    }
+
+    GzipReadAheadBlock *block = MEM_mallocN(sizeof(*block) + GZIP_READ_AHEAD_BLOCK_SIZE,
+                                            __func__);
+    block->data_len = gzread(gzra->gzfile, block + 1, GZIP_READ_AHEAD_BLOCK_SIZE);
+
+    const bool is_eof = (block->data_len <= 0);
+    BLI_mutex_lock(&gzra->mutex);
+    if (is_eof) {
+      gzra->is_eof = true;
+    }
+    else {
+      BLI_addtail(&gzra->blocks, block);
+      gzra->blocks_len++;
+    }
+    BLI_condition_notify_all(&gzra->cond);
+    BLI_mutex_unlock(&gzra->mutex);
+
+    if (is_eof) {
+      MEM_freeN(block);
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+static GzipReadAhead *gzip_read_ahead_begin(gzFile gzfile)
+{
+  GzipReadAhead *gzra = MEM_callocN(sizeof(*gzra), __func__);
+  gzra->gzfile = gzfile;
+  BLI_mutex_init(&gzra->mutex);
+  BLI_condition_init(&gzra->cond);
+
+  BLI_threadpool_init(&gzra->threads, gzip_read_ahead_thread, 1);
+  BLI_threadpool_insert(&gzra->threads, gzra);
+
+  return gzra;
+}
+
+static void gzip_read_ahead_end(GzipReadAhead *gzra)
+{
+  BLI_mutex_lock(&gzra->mutex);
+  gzra->do_exit = true;
+  BLI_condition_notify_all(&gzra->cond);
+  BLI_mutex_unlock(&gzra->mutex);
+
+  BLI_threadpool_end(&gzra->threads);
+
+  BLI_freelistN(&gzra->blocks);
+  MEM_SAFE_FREE(gzra->block_current);
+  BLI_mutex_end(&gzra->mutex);
+  BLI_condition_end(&gzra->cond);
+  MEM_freeN(gzra);
+}
 
 static int fd_read_gzip_from_file(FileData *filedata, void *buffer, uint size)
 {
-  int readsize = gzread(filedata->gzfiledes, buffer, size);
+  GzipReadAhead *gzra = filedata->gz_read_ahead;
+  uint readsize = 0;
 
-  if (readsize < 0) {
-    readsize = EOF;
+  while (readsize < size) {
+    GzipReadAheadBlock *block = gzra->block_current;
+    if (block == NULL || gzra->block_current_ofs == block->data_len) {
+      MEM_SAFE_FREE(gzra->block_current);
+
+      BLI_mutex_lock(&gzra->mutex);
+      while (BLI_listbase_is_empty(&gzra->blocks) && !gzra->is_eof) {
+        BLI_condition_wait(&gzra->cond, &gzra->mutex);
+      }
+      block = BLI_pophead(&gzra->blocks);
+      if (block != NULL) {
+        gzra->blocks_len--;
+        BLI_condition_notify_all(&gzra->cond);
+      }
+      BLI_mutex_unlock(&gzra->mutex);
+
+      gzra->block_current = block;
+      gzra->block_current_ofs = 0;
+      if (block == NULL) {
+        break;
+      }
+    }
+
+    const uint len = MIN2(size - readsize, (uint)(block->data_len - gzra->block_current_ofs));
+    memcpy(POINTER_OFFSET(buffer, readsize),
+           POINTER_OFFSET(block + 1, gzra->block_current_ofs),
+           len);
+    gzra->block_current_ofs += len;
+    readsize += len;
+  }
+
+  filedata->file_offset += readsize;
+
+  return (int)readsize;
+}
+
+/* Indexed GZip file reading.
+ * Files written by Blender store the size of each gzip member in its header, so members are
+ * located without inflating them. Members ahead of the read position are inflated in parallel,
+ * and seeking only needs to inflate the member containing the new position. */
+
+enum {
+  GZIP_MEMBER_NONE = 0,
+  /** Compressed data is read, waiting to be inflated by a task or the reading thread. */
+  GZIP_MEMBER_QUEUED,
+  GZIP_MEMBER_RUNNING,
+  GZIP_MEMBER_DONE,
+};
+
+typedef struct GzipMember {
+  /** Location of the whole member in the file. */
+  off64_t file_offset;
+  uint file_len;
+  /** Location of the member's uncompressed data in the uncompressed stream. */
+  uint data_len;
+  off64_t data_offset;
+
+  /** Protected by the #GzipIndex mutex. */
+  int state;
+  /** Compressed member, freed once inflated. */
+  void *file_data;
+  /** Uncompressed data, NULL when the member is corrupt. */
+  void *data;
+} GzipMember;
+
+typedef struct GzipIndex {
+  int filedes;
+  GzipMember *members;
+  int members_len;
+  /** Size of the uncompressed stream. */
+  off64_t data_len;
+
+  TaskPool *task_pool;
+  ThreadMutex mutex;
+  ThreadCondition cond;
+
+  /** Members which are requested for inflating, starting with the one being read. */
+  int window_start, window_end;
+  int window_len_max;
+} GzipIndex;
+
+static uint gzip_uint32_decode(const uchar *data)
+{
+  return (uint)data[0] | ((uint)data[1] << 8) | ((uint)data[2] << 16) | ((uint)data[3] << 24);
+}
+
+static bool gzip_member_header_is_valid(const uchar header[BLO_GZIP_MEMBER_HEADER_SIZE])
+{
+  /* Gzip magic, deflate method, only the FEXTRA flag, 12 bytes of extra data containing a single
+   * "BL" sub-field of 8 bytes. */
+  return (header[0] == 0x1f && header[1] == 0x8b && header[2] == 8 && header[3] == 4 &&
+          header[10] == 12 && header[11] == 0 && header[12] == 'B' && header[13] == 'L' &&
+          header[14] == 8 && header[15] == 0);
+}
+
+/**
+ * Locate all members of the file by walking their headers.
+ * \return NULL when the file was not written with member sizes (older or external files).
+ */
+static GzipIndex *gzip_index_create(int filedes)
+{
+  GzipMember *members = NULL;
+  int members_len = 0;
+  int members_len_alloc = 0;
+  off64_t file_offset = 0;
+  off64_t data_offset = 0;
+  bool ok = true;
+
+  while (true) {
+    uchar header[BLO_GZIP_MEMBER_HEADER_SIZE];
+    if (lseek(filedes, file_offset, SEEK_SET) == -1) {
+      ok = false;
+      break;
+    }
+    const int header_len = read(filedes, header, sizeof(header));
+    if (header_len == 0) {
+      /* End of file. */
+      break;
+    }
+    if (header_len != sizeof(header) || !gzip_member_header_is_valid(header)) {
+      ok = false;
+      break;
+    }
+
+    const uint file_len = gzip_uint32_decode(&header[16]);
+    const uint data_len = gzip_uint32_decode(&header[20]);
+    if (file_len < BLO_GZIP_MEMBER_HEADER_SIZE + BLO_GZIP_MEMBER_TRAILER_SIZE ||
+        data_len > INT_MAX) {
+      ok = false;
+      break;
+    }
+
+    if (members_len == members_len_alloc) {
+      members_len_alloc = members_len_alloc ? members_len_alloc * 2 : 64;
+      members = MEM_reallocN_id(members, sizeof(*members) * members_len_alloc, __func__);
+    }
+    GzipMember *member = &members[members_len++];
+    memset(member, 0, sizeof(*member));
+    member->file_offset = file_offset;
+    member->file_len = file_len;
+    member->data_offset = data_offset;
+    member->data_len = data_len;
+
+    file_offset += file_len;
+    data_offset += data_len;
+  }
+
+  lseek(filedes, 0, SEEK_SET);
+
+  if (!ok || members_len == 0) {
+    MEM_SAFE_FREE(members);
+    return NULL;
+  }
+
+  TaskScheduler *scheduler = BLI_task_scheduler_get();
+  GzipIndex *gzi = MEM_callocN(sizeof(*gzi), __func__);
+  gzi->filedes = filedes;
+  gzi->members = members;
+  gzi->members_len = members_len;
+  gzi->data_len = data_offset;
+  gzi->window_start = gzi->window_end = -1;
+  gzi->window_len_max = max_ii(BLI_task_scheduler_num_threads(scheduler) * 2, 2);
+  BLI_mutex_init(&gzi->mutex);
+  BLI_condition_init(&gzi->cond);
+  gzi->task_pool = BLI_task_pool_create(scheduler, gzi);
+
+  return gzi;
+}
+
+static void gzip_index_member_inflate(GzipIndex *gzi, GzipMember *member)
+{
+  void *data = NULL;
+
+  if (member->file_data != NULL) {
+    const uchar *trailer = (const uchar *)member->file_data + member->file_len -
+                           BLO_GZIP_MEMBER_TRAILER_SIZE;
+    data = MEM_mallocN(MAX2(member->data_len, 1), __func__);
+
+    z_stream strm = {NULL};
+    bool ok = false;
+    if (inflateInit2(&strm, -MAX_WBITS) == Z_OK) {
+      strm.next_in = (Bytef *)member->file_data + BLO_GZIP_MEMBER_HEADER_SIZE;
+      strm.avail_in = member->file_len - BLO_GZIP_MEMBER_HEADER_SIZE -
+                      BLO_GZIP_MEMBER_TRAILER_SIZE;
+      strm.next_out = data;
+      strm.avail_out = member->data_len;
+      ok = (inflate(&strm, Z_FINISH) == Z_STREAM_END) && (strm.total_out == member->data_len) &&
+           (gzip_uint32_decode(&trailer[0]) ==
+            (uint)crc32(crc32(0L, Z_NULL, 0), data, member->data_len)) &&
+           (gzip_uint32_decode(&trailer[4]) == member->data_len);
+      inflateEnd(&strm);
+    }
+    if (!ok) {
+      MEM_SAFE_FREE(data);
+    }
+  }
+
+  BLI_mutex_lock(&gzi->mutex);
+  MEM_SAFE_FREE(member->file_data);
+  member->data = data;
+  member->state = GZIP_MEMBER_DONE;
+  BLI_condition_notify_all(&gzi->cond);
+  BLI_mutex_unlock(&gzi->mutex);
+}
+
+/** Take over inflating a member which no one started inflating yet. */
+static bool gzip_index_member_claim(GzipIndex *gzi, GzipMember *member)
+{
+  BLI_mutex_lock(&gzi->mutex);
+  const bool is_queued = (member->state == GZIP_MEMBER_QUEUED);
+  if (is_queued) {
+    member->state = GZIP_MEMBER_RUNNING;
+  }
+  BLI_mutex_unlock(&gzi->mutex);
+  return is_queued;
+}
+
+static void gzip_index_member_inflate_fn(TaskPool *__restrict pool,
+                                         void *taskdata,
+                                         int UNUSED(threadid))
+{
+  GzipIndex *gzi = BLI_task_pool_userdata(pool);
+  GzipMember *member = taskdata;
+
+  if (gzip_index_member_claim(gzi, member)) {
+    gzip_index_member_inflate(gzi, member);
+  }
+}
+
+/** Read the compressed member and queue it for inflating. */
+static void gzip_index_member_request(GzipIndex *gzi, GzipMember *member)
+{
+  BLI_mutex_lock(&gzi->mutex);
+  const bool is_requested = (member->state != GZIP_MEMBER_NONE);
+  BLI_mutex_unlock(&gzi->mutex);
+  if (is_requested) {
+    return;
+  }
+
+  void *file_data = MEM_mallocN(member->file_len, __func__);
+  if (lseek(gzi->filedes, member->file_offset, SEEK_SET) == -1 ||
+      read(gzi->filedes, file_data, member->file_len) != (int)member->file_len) {
+    MEM_SAFE_FREE(file_data);
+  }
+
+  BLI_mutex_lock(&gzi->mutex);
+  member->file_data = file_data;
+  member->state = GZIP_MEMBER_QUEUED;
+  BLI_mutex_unlock(&gzi->mutex);
+
+  BLI_task_pool_push(gzi->task_pool, gzip_index_member_inflate_fn, member, false, TASK_PRIORITY_HIGH);
+}
+
+static void gzip_index_member_release(GzipIndex *gzi, GzipMember *member)
+{
+  BLI_mutex_lock(&gzi->mutex);
+  while (member->state == GZIP_MEMBER_RUNNING) {
+    BLI_condition_wait(&gzi->cond, &gzi->mutex);
+  }
+  MEM_SAFE_FREE(member->file_data);
+  MEM_SAFE_FREE(member->data);
+  member->state = GZIP_MEMBER_NONE;
+  BLI_mutex_unlock(&gzi->mutex);
+}
+
+/**
+ * \return the uncompressed data of the member, waiting for it to be inflated (or inflating it on
+ * this thread when no task started on it yet, so reading from within a task can't stall).
+ */
+static const void *gzip_index_member_acquire(GzipIndex *gzi, GzipMember *member)
+{
+  if (gzip_index_member_claim(gzi, member)) {
+    gzip_index_member_inflate(gzi, member);
   }
   else {
-    filedata->file_offset += readsize;
+    BLI_mutex_lock(&gzi->mutex);
+    while (member->state != GZIP_MEMBER_DONE) {
+      BLI_condition_wait(&gzi->cond, &gzi->mutex);
+    }
+    BLI_mutex_unlock(&gzi->mutex);
   }
+  return member->data;
+}
 
-  return (readsize);
+/** Start inflating the members following \a index, freeing the ones no longer needed. */
+static void gzip_index_window_set(GzipIndex *gzi, const int index)
+{
+  /* Only read ahead when moving forward, not when seeking back to read data on demand. */
+  const bool use_read_ahead = (gzi->window_start == -1) ||
+                              (index > gzi->window_start && index <= gzi->window_end);
+  const int window_end = min_ii(index + (use_read_ahead ? gzi->window_len_max : 1),
+                                gzi->members_len);
+
+  for (int i = max_ii(gzi->window_start, 0); i < gzi->window_end; i++) {
+    if (i < index || i >= window_end) {
+      gzip_index_member_release(gzi, &gzi->members[i]);
+    }
+  }
+  for (int i = index; i < window_end; i++) {
+    gzip_index_member_request(gzi, &gzi->members[i]);
+  }
+
+  gzi->window_start = index;
+  gzi->window_end = window_end;
+}
+
+/** \return the member containing \a data_offset in its uncompressed data. */
+static int gzip_index_member_find(const GzipIndex *gzi, const off64_t data_offset)
+{
+  int min = 0;
+  int max = gzi->members_len - 1;
+  while (min < max) {
+    const int mid = (min + max + 1) / 2;
+    if (gzi->members[mid].data_offset <= data_offset) {
+      min = mid;
+    }
+    else {
+      max = mid - 1;
+    }
+  }
+  return min;
+}
+
+static void gzip_index_free(GzipIndex *gzi)
+{
+  for (int i = max_ii(gzi->window_start, 0); i < gzi->window_end; i++) {
+    gzip_index_member_release(gzi, &gzi->members[i]);
+  }
+  BLI_task_pool_free(gzi->task_pool);
+
+  BLI_mutex_end(&gzi->mutex);
+  BLI_condition_end(&gzi->cond);
+  MEM_freeN(gzi->members);
+  MEM_freeN(gzi);
+}
+
+static int fd_read_gzip_from_index(FileData *filedata, void *buffer, uint size)
+{
+  GzipIndex *gzi = filedata->gz_index;
+  uint readsize = 0;
+
+  while (readsize < size && filedata->file_offset < gzi->data_len) {
+    const int index = gzip_index_member_find(gzi, filedata->file_offset);
+    if (index != gzi->window_start) {
+      gzip_index_window_set(gzi, index);
+    }
+
+    GzipMember *member = &gzi->members[index];
+    const void *data = gzip_index_member_acquire(gzi, member);
+    if (data == NULL) {
+      /* Corrupt file. */
+      break;
+    }
+
+    const uint member_ofs = (uint)(filedata->file_offset - member->data_offset);
+    const uint len = MIN2(size - readsize, member->data_len - member_ofs);
+    memcpy(POINTER_OFFSET(buffer, readsize), POINTER_OFFSET(data, member_ofs), len);
+    filedata->file_offset += len;
+    readsize += len;
+  }
+
+  return (int)readsize;
+}
+
+static off64_t fd_seek_gzip_from_index(FileData *filedata, off64_t offset, int whence)
+{
+  const off64_t length = filedata->gz_index->data_len;
+  off64_t new_pos;
+
+  if (whence == SEEK_CUR) {
+    new_pos = filedata->file_offset + offset;
+  }
+  else if (whence == SEEK_SET) {
+    new_pos = offset;
+  }
+  else if (whence == SEEK_END) {
+    new_pos = length + offset;
+  }
+  else {
+    return -1;
+  }
+
+  if (new_pos < 0 || new_pos > length) {
+    return -1;
+  }
+
+  /* Members are inflated when reading. */
+  filedata->file_offset = new_pos;
+  return filedata->file_offset;
 }
 
 /* Memory reading. */
@@ -1296,8 +1849,10 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 {
   FileDataReadFn *read_fn = NULL;
   FileDataSeekFn *seek_fn = NULL; /* Optional. */
+  BLI_mmap_file *mmap_file = NULL;
 
   gzFile gzfile = (gzFile)Z_NULL;
+  GzipIndex *gz_index = NULL;
 
   char header[7];
 
@@ -1317,8 +1872,19 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   /* Regular file. */
   if (memcmp(header, "BLENDER", sizeof(header)) == 0) {
-    read_fn = fd_read_data_from_file;
-    seek_fn = fd_seek_data_from_file;
+    /* Try memory-mapped IO first, so only the parts of the file which are needed are read. */
+    mmap_file = BLI_mmap_open(file);
+    if (mmap_file != NULL) {
+      read_fn = fd_read_from_mmap;
+      seek_fn = fd_seek_from_mmap;
+    }
+    else {
+      /* Fall back to regular reading, e.g. when the address space is too small. */
+      read_fn = fd_read_data_from_file;
+      seek_fn = fd_seek_data_from_file;
+    }
+    /* Opening the memory map seeks to the end of the file. */
+    lseek(file, 0, SEEK_SET);
   }
 
   /* Gzip file. */
@@ -1326,20 +1892,29 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   if ((read_fn == NULL) &&
       /* Check header magic. */
       (header[0] == 0x1f && header[1] == 0x8b)) {
-    gzfile = BLI_gzopen(filepath, "rb");
-    if (gzfile == (gzFile)Z_NULL) {
-      BKE_reportf(reports,
-                  RPT_WARNING,
-                  "Unable to open '%s': %s",
-                  filepath,
-                  errno ? strerror(errno) : TIP_("unknown error reading file"));
-      return NULL;
+    /* Files written by Blender store the member sizes needed for parallel inflating and seeking,
+     * other files are inflated as a single stream. */
+    gz_index = gzip_index_create(file);
+    if (gz_index != NULL) {
+      read_fn = fd_read_gzip_from_index;
+      seek_fn = fd_seek_gzip_from_index;
     }
     else {
-      /* 'seek_fn' is too slow for gzip, don't set it. */
-      read_fn = fd_read_gzip_from_file;
-      /* Caller must close. */
-      file = -1;
+      gzfile = BLI_gzopen(filepath, "rb");
+      if (gzfile == (gzFile)Z_NULL) {
+        BKE_reportf(reports,
+                    RPT_WARNING,
+                    "Unable to open '%s': %s",
+                    filepath,
+                    errno ? strerror(errno) : TIP_("unknown error reading file"));
+        return NULL;
+      }
+      else {
+        /* 'seek_fn' is too slow for gzip, don't set it. */
+        read_fn = fd_read_gzip_from_file;
+        /* Caller must close. */
+        file = -1;
+      }
     }
   }
 
@@ -1352,6 +1927,11 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   fd->filedes = file;
   fd->gzfiledes = gzfile;
+  fd->mmap_file = mmap_file;
+  fd->gz_index = gz_index;
+  if (gzfile != (gzFile)Z_NULL) {
+    fd->gz_read_ahead = gzip_read_ahead_begin(gzfile);
+  }
 
   fd->read = read_fn;
   fd->seek = seek_fn;
@@ -1416,20 +1996,27 @@ static int fd_read_gzip_from_memory(FileData *filedata, void *buffer, uint size)
   filedata->strm.next_out = (Bytef *)buffer;
   filedata->strm.avail_out = size;
 
-  // Inflate another chunk.
-  err = inflate(&filedata->strm, Z_SYNC_FLUSH);
+  while (filedata->strm.avail_out != 0) {
+    // Inflate another chunk.
+    err = inflate(&filedata->strm, Z_SYNC_FLUSH);
 
-  if (err == Z_STREAM_END) {
-    return 0;
-  }
-  else if (err != Z_OK) {
-    printf("fd_read_gzip_from_memory: zlib error\n");
-    return 0;
+    if (err == Z_STREAM_END) {
+      /* Compressed files are written as a sequence of gzip members (see writefile.c),
+       * continue with the next one if there is any. */
+      if (filedata->strm.avail_in == 0 || inflateReset(&filedata->strm) != Z_OK) {
+        break;
+      }
+    }
+    else if (err != Z_OK) {
+      printf("fd_read_gzip_from_memory: zlib error\n");
+      return 0;
+    }
   }
 
-  filedata->file_offset += size;
+  const uint readsize = size - filedata->strm.avail_out;
+  filedata->file_offset += readsize;
 
-  return (size);
+  return (int)readsize;
 }
 
 static int fd_read_gzip_from_memory_init(FileData *fd)
@@ -1504,10 +2091,22 @@ void blo_filedata_free(FileData *fd)
       close(fd->filedes);
     }
 
+    if (fd->gz_read_ahead != NULL) {
+      gzip_read_ahead_end(fd->gz_read_ahead);
+    }
+
+    if (fd->gz_index != NULL) {
+      gzip_index_free(fd->gz_index);
+    }
+
     if (fd->gzfiledes != NULL) {
       gzclose(fd->gzfiledes);
     }
 
+    if (fd->mmap_file != NULL) {
+      BLI_mmap_free(fd->mmap_file);
+    }
+
     if (fd->strm.next_in) {
       if (inflateEnd(&fd->strm) != Z_OK) {
         printf("close gzip stream error\n");
@@ -2248,17 +2847,30 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
       if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+        const void *data = (bh + 1);
 #ifdef USE_BHEAD_READ_ON_DEMAND
         if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
+          /* Reconstruct directly from the memory mapped file when possible,
+           * avoiding a temporary copy of the block. */
+          data = blo_bhead_data_mapped(fd, bh);
+          if (data == NULL) {
+            bh = blo_bhead_read_full(fd, bh);
+            if (UNLIKELY(bh == NULL)) {
+              fd->flags &= ~FD_FLAGS_FILE_OK;
+              return NULL;
+            }
+            data = (bh + 1);
           }
         }
 #endif
         temp = DNA_struct_reconstruct(
-            fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh + 1));
+            fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, data);
+#ifdef USE_BHEAD_READ_ON_DEMAND
+        if (UNLIKELY(fd->mmap_file != NULL && BLI_mmap_any_io_error(fd->mmap_file))) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+          MEM_SAFE_FREE(temp);
+        }
+#endif
       }
       else {
         /* SDNA_CMP_EQUAL */
@@ -4828,6 +5440,7 @@ static void direct_link_customdata(FileData *fd, CustomData *data, int count)
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->sharing_info = NULL;
 
     if (CustomData_verify_versions(data, i)) {
       layer->data = newdataadr(fd, layer->data);
@@ -11692,59 +12305,59 @@ static void read_library_clear_weak_links(FileData *basefd, ListBase *mainlist,
   }
 }
 
-static FileData *read_library_file_data(FileData *basefd,
-                                        ListBase *mainlist,
-                                        Main *mainl,
-                                        Main *mainptr)
+static void read_library_file_data_report(FileData *basefd, Main *mainptr)
 {
-  FileData *fd = mainptr->curlib->filedata;
-
-  if (fd != NULL) {
-    /* File already open. */
-    return fd;
-  }
-
   if (mainptr->curlib->packedfile) {
-    /* Read packed file. */
-    PackedFile *pf = mainptr->curlib->packedfile;
-
     blo_reportf_wrap(basefd->reports,
                      RPT_INFO,
                      TIP_("Read packed library:  '%s', parent '%s'"),
                      mainptr->curlib->name,
                      library_parent_filepath(mainptr->curlib));
-    fd = blo_filedata_from_memory(pf->data, pf->size, basefd->reports);
-
-    /* Needed for library_append and read_libraries. */
-    BLI_strncpy(fd->relabase, mainptr->curlib->filepath, sizeof(fd->relabase));
   }
   else {
-    /* Read file on disk. */
     blo_reportf_wrap(basefd->reports,
                      RPT_INFO,
                      TIP_("Read library:  '%s', '%s', parent '%s'"),
                      mainptr->curlib->filepath,
                      mainptr->curlib->name,
                      library_parent_filepath(mainptr->curlib));
-    fd = blo_filedata_from_file(mainptr->curlib->filepath, basefd->reports);
   }
+}
 
-  if (fd) {
-    /* Share the mainlist, so all libraries are added immediately in a
-     * single list. It used to be that all FileData's had their own list,
-     * but with indirectly linking this meant we didn't catch duplicate
-     * libraries properly. */
-    fd->mainlist = mainlist;
+/**
+ * Open the library file and index its BHeads.
+ *
+ * Only touches data owned by this library, so libraries can be opened from multiple threads
+ * as long as each uses its own \a reports.
+ */
+static FileData *read_library_file_data_open(Main *mainptr, ReportList *reports)
+{
+  const double time_start = PIL_check_seconds_timer();
+  FileData *fd;
 
-    fd->reports = basefd->reports;
+  if (mainptr->curlib->packedfile) {
+    /* Read packed file. */
+    PackedFile *pf = mainptr->curlib->packedfile;
+
+    fd = blo_filedata_from_memory(pf->data, pf->size, reports);
+
+    if (fd) {
+      /* Needed for library_append and read_libraries. */
+      BLI_strncpy(fd->relabase, mainptr->curlib->filepath, sizeof(fd->relabase));
+    }
+  }
+  else {
+    /* Read file on disk. */
+    fd = blo_filedata_from_file(mainptr->curlib->filepath, reports);
+  }
 
+  if (fd) {
     if (fd->libmap) {
       oldnewmap_free(fd->libmap);
     }
 
     fd->libmap = oldnewmap_new();
 
-    mainptr->curlib->filedata = fd;
     mainptr->versionfile = fd->fileversion;
 
     /* subversion */
@@ -11752,6 +12365,26 @@ static FileData *read_library_file_data(FileData *basefd,
 #ifdef USE_GHASH_BHEAD
     read_file_bhead_idname_map_create(fd);
 #endif
+
+    fd->library_timing.open = PIL_check_seconds_timer() - time_start;
+  }
+
+  return fd;
+}
+
+static FileData *read_library_file_data_init(
+    FileData *basefd, ListBase *mainlist, Main *mainl, Main *mainptr, FileData *fd)
+{
+  if (fd) {
+    /* Share the mainlist, so all libraries are added immediately in a
+     * single list. It used to be that all FileData's had their own list,
+     * but with indirectly linking this meant we didn't catch duplicate
+     * libraries properly. */
+    fd->mainlist = mainlist;
+
+    fd->reports = basefd->reports;
+
+    mainptr->curlib->filedata = fd;
   }
   else {
     mainptr->curlib->filedata = NULL;
@@ -11769,6 +12402,121 @@ static FileData *read_library_file_data(FileData *basefd,
   return fd;
 }
 
+static FileData *read_library_file_data(FileData *basefd,
+                                        ListBase *mainlist,
+                                        Main *mainl,
+                                        Main *mainptr)
+{
+  FileData *fd = mainptr->curlib->filedata;
+
+  if (fd != NULL) {
+    /* File already open. */
+    return fd;
+  }
+
+  read_library_file_data_report(basefd, mainptr);
+  fd = read_library_file_data_open(mainptr, basefd->reports);
+
+  return read_library_file_data_init(basefd, mainlist, mainl, mainptr, fd);
+}
+
+typedef struct LibraryOpenTask {
+  Main *mainptr;
+  FileData *fd;
+  /**
+   * Reports are gathered per library and moved to the main report list in order once all are
+   * opened, NULL when reading without a report list.
+   */
+  ReportList *reports;
+  ReportList reports_data;
+} LibraryOpenTask;
+
+static void read_library_open_task_fn(TaskPool *__restrict UNUSED(pool),
+                                      void *taskdata,
+                                      int UNUSED(threadid))
+{
+  LibraryOpenTask *task = taskdata;
+  task->fd = read_library_file_data_open(task->mainptr, task->reports);
+}
+
+/**
+ * Open all libraries that have linked data-blocks to read but no file data yet in parallel,
+ * opening and indexing files is independent for each library and dominates when many
+ * libraries are linked. Reading the data-blocks itself stays serial, since it replaces
+ * placeholders in all libraries.
+ */
+static void read_library_file_data_open_all(FileData *basefd, ListBase *mainlist, Main *mainl)
+{
+  int tasks_len = 0;
+  for (Main *mainptr = mainl->next; mainptr; mainptr = mainptr->next) {
+    if (mainptr->curlib->filedata == NULL && has_linked_ids_to_read(mainptr)) {
+      tasks_len++;
+    }
+  }
+
+  /* A single library is opened by #read_library_file_data directly. */
+  if (tasks_len < 2) {
+    return;
+  }
+
+  /* Uncompressed libraries are memory-mapped, #BLI_mmap_open installs its IO error handler only
+   * once and tracks open files without locks, so opening them concurrently is safe. */
+  LibraryOpenTask *tasks = MEM_calloc_arrayN(tasks_len, sizeof(*tasks), __func__);
+
+  TaskScheduler *scheduler = BLI_task_scheduler_get();
+  TaskPool *task_pool = BLI_task_pool_create(scheduler, NULL);
+
+  int i = 0;
+  for (Main *mainptr = mainl->next; mainptr; mainptr = mainptr->next) {
+    if (mainptr->curlib->filedata == NULL && has_linked_ids_to_read(mainptr)) {
+      LibraryOpenTask *task = &tasks[i++];
+      task->mainptr = mainptr;
+      if (basefd->reports) {
+        /* Same settings as the main report list, so messages are printed as usual. */
+        task->reports = &task->reports_data;
+        BKE_reports_init(task->reports, basefd->reports->flag);
+        task->reports->printlevel = basefd->reports->printlevel;
+        task->reports->storelevel = basefd->reports->storelevel;
+      }
+      BLI_task_pool_push(task_pool, read_library_open_task_fn, task, false, TASK_PRIORITY_HIGH);
+    }
+  }
+
+  BLI_task_pool_work_and_wait(task_pool);
+  BLI_task_pool_free(task_pool);
+
+  for (i = 0; i < tasks_len; i++) {
+    LibraryOpenTask *task = &tasks[i];
+
+    read_library_file_data_report(basefd, task->mainptr);
+    if (task->reports) {
+      BLI_movelisttolist(&basefd->reports->list, &task->reports->list);
+    }
+
+    read_library_file_data_init(basefd, mainlist, mainl, task->mainptr, task->fd);
+  }
+
+  MEM_freeN(tasks);
+}
+
+/* Printed with `--debug-io`, to find which libraries dominate the load time. */
+static void read_library_timing_print(FileData *fd, Library *lib)
+{
+  const double time_total = fd->library_timing.open + fd->library_timing.read_ids +
+                            fd->library_timing.expand + fd->library_timing.versioning +
+                            fd->library_timing.lib_link;
+  printf(
+      "Read library '%s': %.4fs "
+      "(open %.4fs, read %.4fs, expand %.4fs, versioning %.4fs, link %.4fs)\n",
+      lib->filepath,
+      time_total,
+      fd->library_timing.open,
+      fd->library_timing.read_ids,
+      fd->library_timing.expand,
+      fd->library_timing.versioning,
+      fd->library_timing.lib_link);
+}
+
 static void read_libraries(FileData *basefd, ListBase *mainlist)
 {
   Main *mainl = mainlist->first;
@@ -11787,6 +12535,9 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
   while (do_it) {
     do_it = false;
 
+    /* Open the files of all libraries encountered so far at once. */
+    read_library_file_data_open_all(basefd, mainlist, mainl);
+
     /* Loop over mains of all library blend files encountered so far. Note
      * this list gets longer as more indirectly library blends are found. */
     for (Main *mainptr = mainl->next; mainptr; mainptr = mainptr->next) {
@@ -11807,11 +12558,19 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
 
         /* Read linked data-locks for each link placeholder, and replace
          * the placeholder with the real data-lock. */
+        double time_start = PIL_check_seconds_timer();
         read_library_linked_ids(basefd, fd, mainlist, mainptr);
+        if (fd) {
+          fd->library_timing.read_ids += PIL_check_seconds_timer() - time_start;
+        }
 
         /* Test if linked data-locks need to read further linked data-locks
          * and create link placeholders for them. */
+        time_start = PIL_check_seconds_timer();
         BLO_expand_main(fd, mainptr);
+        if (fd) {
+          fd->library_timing.expand += PIL_check_seconds_timer() - time_start;
+        }
       }
     }
   }
@@ -11831,7 +12590,10 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
 
       /* File data can be zero with link/append. */
       if (mainptr->curlib->filedata) {
+        const double time_start = PIL_check_seconds_timer();
         do_versions(mainptr->curlib->filedata, mainptr->curlib, main_newid);
+        mainptr->curlib->filedata->library_timing.versioning = PIL_check_seconds_timer() -
+                                                               time_start;
       }
       else {
         do_versions(basefd, NULL, main_newid);
@@ -11842,7 +12604,13 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
 
     /* Lib linking. */
     if (mainptr->curlib->filedata) {
+      const double time_start = PIL_check_seconds_timer();
       lib_link_all(mainptr->curlib->filedata, mainptr);
+      mainptr->curlib->filedata->library_timing.lib_link = PIL_check_seconds_timer() - time_start;
+
+      if (G.debug & G_DEBUG_IO) {
+        read_library_timing_print(mainptr->curlib->filedata, mainptr->curlib);
+      }
     }
 
     /* Free file data we no longer need. */
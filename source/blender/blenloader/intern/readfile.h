@@ -30,6 +30,9 @@
 #include "DNA_space_types.h"
 #include "DNA_windowmanager_types.h" /* for ReportType */
 
+struct BLI_mmap_file;
+struct GzipIndex;
+struct GzipReadAhead;
 struct Key;
 struct MemFile;
 struct Object;
@@ -48,6 +51,15 @@ enum eFileDataFlag {
   FD_FLAGS_NOT_MY_LIBMAP = 1 << 5,
 };
 
+/**
+ * Compressed files are written as a sequence of independent gzip members. The header of each
+ * member has an extra field (sub-field ID "BL") storing the size of the whole member in the file
+ * and the size of its uncompressed data, as little endian 32 bit integers. This way members can
+ * be located without inflating them, so they can be inflated in parallel and seeked to.
+ */
+#define BLO_GZIP_MEMBER_HEADER_SIZE 24
+#define BLO_GZIP_MEMBER_TRAILER_SIZE 8
+
 /* Disallow since it's 32bit on ms-windows. */
 #ifdef __GNUC__
 #  pragma GCC poison off_t
@@ -74,6 +86,9 @@ typedef struct FileData {
   /** Regular file reading. */
   int filedes;
 
+  /** Memory-mapped file reading, used for uncompressed files when possible. */
+  struct BLI_mmap_file *mmap_file;
+
   /** Variables needed for reading from memory / stream. */
   const char *buffer;
   /** Variables needed for reading from memfile (undo). */
@@ -81,6 +96,20 @@ typedef struct FileData {
 
   /** Variables needed for reading from file. */
   gzFile gzfiledes;
+  /** Decompresses #FileData.gzfiledes on a separate thread. */
+  struct GzipReadAhead *gz_read_ahead;
+  /** Member index of compressed files written with #BLO_GZIP_MEMBER_HEADER_SIZE headers,
+   * used instead of #FileData.gzfiledes when available. */
+  struct GzipIndex *gz_index;
+
+  /** Time spent in each stage when reading this file as a library, in seconds. */
+  struct {
+    double open;
+    double read_ids;
+    double expand;
+    double versioning;
+    double lib_link;
+  } library_timing;
   /** Gzip stream for memory decompression. */
   z_stream strm;
 
@@ -41,6 +41,8 @@
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
 
 #include "BLO_undofile.h"
 #include "BLO_readfile.h"
@@ -52,18 +54,122 @@
 
 /* **************** support for memory-write, for undo buffers *************** */
 
+/* -------------------------------------------------------------------- */
+/** \name Shared Chunk Buffers
+ *
+ * Chunk buffers are stored once per unique content and reference counted, so data that did not
+ * change is shared between all undo steps, even when it moved to another position in the file.
+ *
+ * \note Undo steps are only written and freed from the main thread.
+ * \{ */
+
+typedef struct MemFileSharedBuffer {
+  const char *buf;
+  uint size;
+  uint hash;
+  /** Number of #MemFileChunk using this buffer. */
+  uint users;
+} MemFileSharedBuffer;
+
+/** All buffers in use by any #MemFile, created on demand and freed once empty. */
+static struct {
+  GSet *buffers;
+  size_t buffers_size;
+} g_memfile_store = {NULL};
+
+static uint memfile_shared_buffer_hash(const void *key)
+{
+  const MemFileSharedBuffer *shared = key;
+  return shared->hash;
+}
+
+static bool memfile_shared_buffer_cmp(const void *a, const void *b)
+{
+  const MemFileSharedBuffer *shared_a = a;
+  const MemFileSharedBuffer *shared_b = b;
+  return ((shared_a->hash != shared_b->hash) || (shared_a->size != shared_b->size) ||
+          (memcmp(shared_a->buf, shared_b->buf, shared_a->size) != 0));
+}
+
+/**
+ * Find the buffer with the same contents as \a buf, or add a copy of it.
+ *
+ * \param r_is_new: Set when the buffer did not exist yet.
+ */
+static MemFileSharedBuffer *memfile_shared_buffer_ensure(const char *buf,
+                                                         uint size,
+                                                         bool *r_is_new)
+{
+  if (g_memfile_store.buffers == NULL) {
+    g_memfile_store.buffers = BLI_gset_new(
+        memfile_shared_buffer_hash, memfile_shared_buffer_cmp, __func__);
+  }
+
+  const MemFileSharedBuffer key = {
+      .buf = buf,
+      .size = size,
+      .hash = BLI_hash_mm2((const unsigned char *)buf, size, 0),
+  };
+
+  MemFileSharedBuffer *shared = BLI_gset_lookup(g_memfile_store.buffers, &key);
+  *r_is_new = (shared == NULL);
+
+  if (shared == NULL) {
+    char *buf_new = MEM_mallocN(size, "Chunk buffer");
+    memcpy(buf_new, buf, size);
+
+    shared = MEM_mallocN(sizeof(*shared), __func__);
+    *shared = key;
+    shared->buf = buf_new;
+    BLI_gset_insert(g_memfile_store.buffers, shared);
+    g_memfile_store.buffers_size += size;
+  }
+
+  shared->users++;
+  return shared;
+}
+
+static void memfile_shared_buffer_release(MemFileSharedBuffer *shared)
+{
+  BLI_assert(shared->users > 0);
+  if (--shared->users != 0) {
+    return;
+  }
+
+  BLI_gset_remove(g_memfile_store.buffers, shared, NULL);
+  g_memfile_store.buffers_size -= shared->size;
+  MEM_freeN((void *)shared->buf);
+  MEM_freeN(shared);
+
+  if (BLI_gset_len(g_memfile_store.buffers) == 0) {
+    BLI_gset_free(g_memfile_store.buffers, NULL);
+    g_memfile_store.buffers = NULL;
+  }
+}
+
+/**
+ * Statistics on the buffers used by all memfiles, compare with #MemFile.size_total
+ * of the existing steps to see how much memory sharing chunks saves.
+ */
+void BLO_memfile_stats_get(size_t *r_buffers_len, size_t *r_buffers_size)
+{
+  *r_buffers_len = g_memfile_store.buffers ? BLI_gset_len(g_memfile_store.buffers) : 0;
+  *r_buffers_size = g_memfile_store.buffers_size;
+}
+
+/** \} */
+
 /* not memfile itself */
 void BLO_memfile_free(MemFile *memfile)
 {
   MemFileChunk *chunk;
 
   while ((chunk = BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_freeN((void *)chunk->buf);
-    }
+    memfile_shared_buffer_release(chunk->shared);
     MEM_freeN(chunk);
   }
   memfile->size = 0;
+  memfile->size_total = 0;
 }
 
 /* to keep list of memfiles consistent, 'first' is always first in list */
@@ -72,21 +178,17 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
   MemFileChunk *fc, *sc;
 
+  /* Buffers are reference counted, only keep #MemFileChunk.is_identical valid for the step
+   * before 'first', which becomes the previous step of 'second'. */
   fc = first->chunks.first;
   sc = second->chunks.first;
-  while (fc || sc) {
-    if (fc && sc) {
-      if (sc->is_identical) {
-        sc->is_identical = false;
-        fc->is_identical = true;
-      }
-    }
-    if (fc) {
-      fc = fc->next;
-    }
-    if (sc) {
-      sc = sc->next;
-    }
+  while (fc && sc) {
+    sc->is_identical = sc->is_identical && fc->is_identical;
+    fc = fc->next;
+    sc = sc->next;
+  }
+  for (; sc; sc = sc->next) {
+    sc->is_identical = false;
   }
 
   BLO_memfile_free(first);
@@ -98,27 +200,33 @@ void memfile_chunk_add(MemFile *memfile, const char *buf, uint size, MemFileChun
   curchunk->size = size;
   curchunk->buf = NULL;
   curchunk->is_identical = false;
+  curchunk->shared = NULL;
   BLI_addtail(&memfile->chunks, curchunk);
 
-  /* we compare compchunk with buf */
+  /* we compare compchunk with buf, cheaper than hashing when the data didn't change */
   if (*compchunk_step != NULL) {
     MemFileChunk *compchunk = *compchunk_step;
     if (compchunk->size == curchunk->size) {
       if (memcmp(compchunk->buf, buf, size) == 0) {
-        curchunk->buf = compchunk->buf;
+        curchunk->shared = compchunk->shared;
+        curchunk->shared->users++;
         curchunk->is_identical = true;
       }
     }
     *compchunk_step = compchunk->next;
   }
 
-  /* not equal... */
-  if (curchunk->buf == NULL) {
-    char *buf_new = MEM_mallocN(size, "Chunk buffer");
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+  /* not equal, look for the same data anywhere else... */
+  if (curchunk->shared == NULL) {
+    bool is_new;
+    curchunk->shared = memfile_shared_buffer_ensure(buf, size, &is_new);
+    if (is_new) {
+      memfile->size += size;
+    }
   }
+
+  curchunk->buf = curchunk->shared->buf;
+  memfile->size_total += size;
 }
 
 struct Main *BLO_memfile_main_get(struct MemFile *memfile,
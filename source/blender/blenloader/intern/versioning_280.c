@@ -3551,7 +3551,7 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
       }
 
       ob->transflag &= ~(OB_TRANSFLAG_UNUSED_0 | OB_TRANSFLAG_UNUSED_1 | OB_TRANSFLAG_UNUSED_3 |
-                         OB_TRANSFLAG_UNUSED_6 | OB_TRANSFLAG_UNUSED_12);
+                         OB_TRANSFLAG_UNUSED_6 | OB_DUPLIMESH);
 
       ob->nlaflag &= ~(OB_ADS_UNUSED_1 | OB_ADS_UNUSED_2);
     }
@@ -4440,5 +4440,14 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
         br->pose_ik_segments = 1;
       }
     }
+
+    /* Compositor result cache. */
+    if (!DNA_struct_elem_find(fd->filesdna, "bNodeTree", "int", "cache_limit")) {
+      for (Scene *scene = bmain->scenes.first; scene; scene = scene->id.next) {
+        if (scene->nodetree) {
+          scene->nodetree->cache_limit = 512;
+        }
+      }
+    }
   }
 }
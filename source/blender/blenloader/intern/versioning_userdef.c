@@ -714,6 +714,10 @@ void BLO_version_defaults_userpref_blend(Main *bmain, UserDef *userdef)
    */
   {
     /* Keep this block, even when empty. */
+    if (userdef->sequencer_disk_cache_size_limit == 0) {
+      userdef->sequencer_disk_cache_size_limit = U_default.sequencer_disk_cache_size_limit;
+      userdef->sequencer_disk_cache_compression = U_default.sequencer_disk_cache_compression;
+    }
   }
 
   if (userdef->pixelsize == 0.0f) {
@@ -145,6 +145,8 @@
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "BKE_action.h"
 #include "BKE_blender_version.h"
@@ -203,6 +205,7 @@ typedef enum {
 } eWriteWrapType;
 
 typedef struct WriteWrap WriteWrap;
+struct ZlibWriteData;
 struct WriteWrap {
   /* callbacks */
   bool (*open)(WriteWrap *ww, const char *filepath);
@@ -215,7 +218,7 @@ struct WriteWrap {
   /* internal */
   union {
     int file_handle;
-    gzFile gz_handle;
+    struct ZlibWriteData *zlib_data;
   } _user_data;
 };
 
@@ -246,17 +249,180 @@ static size_t ww_write_none(WriteWrap *ww, const char *buf, size_t buf_len)
 }
 #undef FILE_HANDLE
 
-/* zlib */
-#define FILE_HANDLE(ww) (ww)->_user_data.gz_handle
+/* zlib
+ *
+ * Data is split into blocks which are compressed as independent gzip members by worker threads,
+ * while serialization continues on the calling thread. Compressed blocks are written to the file
+ * in their original order. Concatenated gzip members are a valid gzip stream, so the result can
+ * be read by any gzip reader, while Blender uses the member sizes stored in their headers to
+ * inflate them in parallel (see #BLO_GZIP_MEMBER_HEADER_SIZE). */
+
+/* Size of uncompressed data in a single gzip member. */
+#define ZLIB_BLOCK_SIZE (1 << 20) /* 1mb */
+
+typedef struct ZlibBlock {
+  struct ZlibBlock *next, *prev;
+
+  char *data_in;
+  size_t data_in_len;
+  char *data_out;
+  size_t data_out_len;
+
+  /* Set by the worker thread when compression is finished (protected by the #ZlibWriteData
+   * mutex). */
+  bool is_done;
+  bool error;
+} ZlibBlock;
+
+typedef struct ZlibWriteData {
+  int file_handle;
+  TaskPool *task_pool;
+
+  /* Blocks being compressed or waiting to be written, in file order. */
+  ListBase blocks;
+  int blocks_len;
+  /* Maximum number of blocks in flight, limits memory used by uncompressed data. */
+  int blocks_len_max;
+  ThreadMutex mutex;
+  ThreadCondition cond;
+
+  /* Block which is being filled by #ww_write_zlib. */
+  ZlibBlock *block_current;
+
+  bool error;
+} ZlibWriteData;
+
+#define ZLIB_DATA(ww) (ww)->_user_data.zlib_data
+
+static void ww_zlib_uint32_encode(uchar *data, uint value)
+{
+  data[0] = (uchar)(value & 0xff);
+  data[1] = (uchar)((value >> 8) & 0xff);
+  data[2] = (uchar)((value >> 16) & 0xff);
+  data[3] = (uchar)((value >> 24) & 0xff);
+}
+
+static void ww_zlib_block_compress_fn(TaskPool *__restrict pool,
+                                      void *taskdata,
+                                      int UNUSED(threadid))
+{
+  ZlibWriteData *zwd = BLI_task_pool_userdata(pool);
+  ZlibBlock *block = taskdata;
+  bool error = true;
+
+  /* Raw deflate, the gzip header and trailer are written here so the header can store the
+   * member size, see #BLO_GZIP_MEMBER_HEADER_SIZE. */
+  z_stream strm = {NULL};
+  if (deflateInit2(&strm, 1, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+    const size_t data_out_len_max = BLO_GZIP_MEMBER_HEADER_SIZE +
+                                    deflateBound(&strm, block->data_in_len) +
+                                    BLO_GZIP_MEMBER_TRAILER_SIZE;
+    uchar *data_out = MEM_mallocN(data_out_len_max, __func__);
+    block->data_out = (char *)data_out;
+
+    strm.next_in = (Bytef *)block->data_in;
+    strm.avail_in = block->data_in_len;
+    strm.next_out = data_out + BLO_GZIP_MEMBER_HEADER_SIZE;
+    strm.avail_out = data_out_len_max - BLO_GZIP_MEMBER_HEADER_SIZE;
+
+    if (deflate(&strm, Z_FINISH) == Z_STREAM_END) {
+      const size_t member_len = BLO_GZIP_MEMBER_HEADER_SIZE + strm.total_out +
+                                BLO_GZIP_MEMBER_TRAILER_SIZE;
+
+      /* Magic, deflate method, FEXTRA flag, no modification time, fastest level, unknown OS. */
+      const uchar header[12] = {0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 4, 255, 12, 0};
+      memcpy(data_out, header, sizeof(header));
+      /* Extra sub-field "BL" with 8 bytes of data. */
+      data_out[12] = 'B';
+      data_out[13] = 'L';
+      data_out[14] = 8;
+      data_out[15] = 0;
+      ww_zlib_uint32_encode(&data_out[16], (uint)member_len);
+      ww_zlib_uint32_encode(&data_out[20], (uint)block->data_in_len);
+
+      uchar *trailer = data_out + member_len - BLO_GZIP_MEMBER_TRAILER_SIZE;
+      ww_zlib_uint32_encode(
+          &trailer[0],
+          (uint)crc32(crc32(0L, Z_NULL, 0), (const Bytef *)block->data_in, block->data_in_len));
+      ww_zlib_uint32_encode(&trailer[4], (uint)block->data_in_len);
+
+      block->data_out_len = member_len;
+      error = false;
+    }
+    deflateEnd(&strm);
+  }
+
+  MEM_freeN(block->data_in);
+  block->data_in = NULL;
+
+  BLI_mutex_lock(&zwd->mutex);
+  block->error = error;
+  block->is_done = true;
+  BLI_condition_notify_all(&zwd->cond);
+  BLI_mutex_unlock(&zwd->mutex);
+}
+
+/**
+ * Write compressed blocks to the file in order,
+ * waiting for blocks to be compressed while more than \a blocks_len_max are in flight.
+ */
+static void ww_zlib_blocks_write(ZlibWriteData *zwd, const int blocks_len_max)
+{
+  ZlibBlock *block;
+  while ((block = zwd->blocks.first)) {
+    BLI_mutex_lock(&zwd->mutex);
+    if (!block->is_done && zwd->blocks_len <= blocks_len_max) {
+      BLI_mutex_unlock(&zwd->mutex);
+      break;
+    }
+    while (!block->is_done) {
+      BLI_condition_wait(&zwd->cond, &zwd->mutex);
+    }
+    BLI_mutex_unlock(&zwd->mutex);
+
+    if (!zwd->error) {
+      if (block->error || (size_t)write(zwd->file_handle, block->data_out, block->data_out_len) !=
+                              block->data_out_len) {
+        zwd->error = true;
+      }
+    }
+
+    BLI_remlink(&zwd->blocks, block);
+    zwd->blocks_len--;
+    MEM_SAFE_FREE(block->data_out);
+    MEM_freeN(block);
+  }
+}
+
+static void ww_zlib_block_submit(ZlibWriteData *zwd)
+{
+  ZlibBlock *block = zwd->block_current;
+  zwd->block_current = NULL;
+
+  BLI_addtail(&zwd->blocks, block);
+  zwd->blocks_len++;
+  BLI_task_pool_push(zwd->task_pool, ww_zlib_block_compress_fn, block, false, TASK_PRIORITY_LOW);
+
+  ww_zlib_blocks_write(zwd, zwd->blocks_len_max);
+}
 
 static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
 {
-  gzFile file;
+  int file;
 
-  file = BLI_gzopen(filepath, "wb1");
+  file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
 
-  if (file != Z_NULL) {
-    FILE_HANDLE(ww) = file;
+  if (file != -1) {
+    TaskScheduler *scheduler = BLI_task_scheduler_get();
+    ZlibWriteData *zwd = MEM_callocN(sizeof(*zwd), __func__);
+    zwd->file_handle = file;
+    zwd->blocks_len_max = BLI_task_scheduler_num_threads(scheduler) * 2;
+    BLI_mutex_init(&zwd->mutex);
+    BLI_condition_init(&zwd->cond);
+    /* Background pool ensures blocks get compressed without #BLI_task_pool_work_and_wait,
+     * also in the single threaded case. */
+    zwd->task_pool = BLI_task_pool_create_background(scheduler, zwd);
+    ZLIB_DATA(ww) = zwd;
     return true;
   }
   else {
@@ -265,13 +431,47 @@ static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
 }
 static bool ww_close_zlib(WriteWrap *ww)
 {
-  return (gzclose(FILE_HANDLE(ww)) == Z_OK);
+  ZlibWriteData *zwd = ZLIB_DATA(ww);
+
+  if (zwd->block_current) {
+    ww_zlib_block_submit(zwd);
+  }
+  ww_zlib_blocks_write(zwd, 0);
+  BLI_assert(BLI_listbase_is_empty(&zwd->blocks));
+
+  BLI_task_pool_free(zwd->task_pool);
+  BLI_mutex_end(&zwd->mutex);
+  BLI_condition_end(&zwd->cond);
+
+  const bool ok = (close(zwd->file_handle) != -1) && !zwd->error;
+  MEM_freeN(zwd);
+  return ok;
 }
 static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 {
-  return gzwrite(FILE_HANDLE(ww), buf, buf_len);
+  ZlibWriteData *zwd = ZLIB_DATA(ww);
+  size_t buf_ofs = 0;
+
+  while (buf_ofs < buf_len) {
+    ZlibBlock *block = zwd->block_current;
+    if (block == NULL) {
+      block = zwd->block_current = MEM_callocN(sizeof(*block), __func__);
+      block->data_in = MEM_mallocN(ZLIB_BLOCK_SIZE, __func__);
+    }
+
+    const size_t len = MIN2(buf_len - buf_ofs, ZLIB_BLOCK_SIZE - block->data_in_len);
+    memcpy(block->data_in + block->data_in_len, buf + buf_ofs, len);
+    block->data_in_len += len;
+    buf_ofs += len;
+
+    if (block->data_in_len == ZLIB_BLOCK_SIZE) {
+      ww_zlib_block_submit(zwd);
+    }
+  }
+
+  return zwd->error ? 0 : buf_len;
 }
-#undef FILE_HANDLE
+#undef ZLIB_DATA
 
 /* --- end compression types --- */
 
@@ -4091,9 +4291,12 @@ bool BLO_write_file(Main *mainvar,
   }
 
   /* actual file writing */
-  const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, thumb);
+  bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, thumb);
 
-  ww.close(&ww);
+  /* Compressed data may only be written out when closing. */
+  if (ww.close(&ww) == false) {
+    err = true;
+  }
 
   if (UNLIKELY(path_list_backup)) {
     BKE_bpath_list_restore(mainvar, path_list_flag, path_list_backup);
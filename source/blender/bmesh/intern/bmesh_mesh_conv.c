@@ -81,6 +81,7 @@
 #include "BLI_listbase.h"
 #include "BLI_alloca.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_mesh.h"
 #include "BKE_mesh_runtime.h"
@@ -174,6 +175,121 @@ static BMFace *bm_face_create_from_mpoly(
   return BM_face_create(bm, verts, edges, mp->totloop, NULL, BM_CREATE_SKIP_CD);
 }
 
+typedef struct BMeshFromMeshData {
+  BMesh *bm;
+  const Mesh *me;
+  const struct BMeshFromMeshParams *params;
+  BMVert **vtable;
+  BMEdge **etable;
+  /* NULL for faces that could not be created. */
+  BMFace **ftable;
+
+  const float (**shape_key_table)[3];
+  int tot_shape_keys;
+
+  int cd_vert_bweight_offset;
+  int cd_edge_bweight_offset;
+  int cd_edge_crease_offset;
+  int cd_shape_key_offset;
+  int cd_shape_keyindex_offset;
+} BMeshFromMeshData;
+
+static void bm_vert_from_mvert_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMeshFromMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  const MVert *mvert = &data->me->mvert[i];
+  BMVert *v = data->vtable[i];
+
+  BM_elem_index_set(v, i); /* set_ok */
+
+  /* Transfer flag. */
+  v->head.hflag = BM_vert_flag_from_mflag(mvert->flag & ~SELECT);
+
+  normal_short_to_float_v3(v->no, mvert->no);
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_block(&data->me->vdata, &bm->vdata, i, &v->head.data, true);
+
+  if (data->cd_vert_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(v, data->cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
+  }
+
+  /* Set shape key original index. */
+  if (data->cd_shape_keyindex_offset != -1) {
+    BM_ELEM_CD_SET_INT(v, data->cd_shape_keyindex_offset, i);
+  }
+
+  /* Set shape-key data. */
+  if (data->tot_shape_keys) {
+    float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, data->cd_shape_key_offset);
+    for (int j = 0; j < data->tot_shape_keys; j++, co_dst++) {
+      copy_v3_v3(*co_dst, data->shape_key_table[j][i]);
+    }
+  }
+}
+
+static void bm_edge_from_medge_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMeshFromMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  const MEdge *medge = &data->me->medge[i];
+  BMEdge *e = data->etable[i];
+
+  BM_elem_index_set(e, i); /* set_ok */
+
+  /* Transfer flags. */
+  e->head.hflag = BM_edge_flag_from_mflag(medge->flag & ~SELECT);
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_block(&data->me->edata, &bm->edata, i, &e->head.data, true);
+
+  if (data->cd_edge_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
+  }
+  if (data->cd_edge_crease_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_crease_offset, (float)medge->crease / 255.0f);
+  }
+}
+
+static void bm_face_from_mpoly_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMeshFromMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  const MPoly *mp = &data->me->mpoly[i];
+  BMFace *f = data->ftable[i];
+  BMLoop *l_iter, *l_first;
+
+  if (f == NULL) {
+    return;
+  }
+
+  /* Transfer flag. */
+  f->head.hflag = BM_face_flag_from_mflag(mp->flag & ~ME_FACE_SEL);
+
+  f->mat_nr = mp->mat_nr;
+
+  int j = mp->loopstart;
+  l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+  do {
+    /* Save index of corresponding #MLoop. */
+    CustomData_to_bmesh_block(&data->me->ldata, &bm->ldata, j++, &l_iter->head.data, true);
+  } while ((l_iter = l_iter->next) != l_first);
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_block(&data->me->pdata, &bm->pdata, i, &f->head.data, true);
+
+  if (data->params->calc_face_normal) {
+    BM_face_normal_update(f);
+  }
+}
+
 /**
  * \brief Mesh -> BMesh
  * \param bm: The mesh to write into, while this is typically a newly created BMesh,
@@ -304,90 +420,71 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
                                            -1;
 
   vtable = MEM_mallocN(sizeof(BMVert **) * me->totvert, __func__);
-
+  etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
+  ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
+
+  BMeshFromMeshData data = {
+      .bm = bm,
+      .me = me,
+      .params = params,
+      .vtable = vtable,
+      .etable = etable,
+      .ftable = ftable,
+      .shape_key_table = shape_key_table,
+      .tot_shape_keys = tot_shape_keys,
+      .cd_vert_bweight_offset = cd_vert_bweight_offset,
+      .cd_edge_bweight_offset = cd_edge_bweight_offset,
+      .cd_edge_crease_offset = cd_edge_crease_offset,
+      .cd_shape_key_offset = cd_shape_key_offset,
+      .cd_shape_keyindex_offset = cd_shape_keyindex_offset,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+
+  /* Elements are created and linked into the disk and radial cycles in order on a single thread,
+   * their attributes and custom-data are copied in parallel once they all exist. */
   for (i = 0, mvert = me->mvert; i < me->totvert; i++, mvert++) {
     v = vtable[i] = BM_vert_create(bm, keyco ? keyco[i] : mvert->co, NULL, BM_CREATE_SKIP_CD);
-    BM_elem_index_set(v, i); /* set_ok */
-
-    /* Transfer flag. */
-    v->head.hflag = BM_vert_flag_from_mflag(mvert->flag & ~SELECT);
+    CustomData_bmesh_alloc_block(&bm->vdata, &v->head.data);
+  }
+  settings.use_threading = (me->totvert >= BM_OMP_LIMIT);
+  BLI_task_parallel_range(0, me->totvert, &data, bm_vert_from_mvert_cb, &settings);
 
+  for (i = 0, mvert = me->mvert; i < me->totvert; i++, mvert++) {
     /* This is necessary for selection counts to work properly. */
     if (mvert->flag & SELECT) {
-      BM_vert_select_set(bm, v, true);
-    }
-
-    normal_short_to_float_v3(v->no, mvert->no);
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->vdata, &bm->vdata, i, &v->head.data, true);
-
-    if (cd_vert_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(v, cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
-    }
-
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
-
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
-      }
+      BM_vert_select_set(bm, vtable[i], true);
     }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
   }
 
-  etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
-
-  medge = me->medge;
-  for (i = 0; i < me->totedge; i++, medge++) {
+  for (i = 0, medge = me->medge; i < me->totedge; i++, medge++) {
     e = etable[i] = BM_edge_create(
         bm, vtable[medge->v1], vtable[medge->v2], NULL, BM_CREATE_SKIP_CD);
-    BM_elem_index_set(e, i); /* set_ok */
-
-    /* Transfer flags. */
-    e->head.hflag = BM_edge_flag_from_mflag(medge->flag & ~SELECT);
+    CustomData_bmesh_alloc_block(&bm->edata, &e->head.data);
+  }
+  settings.use_threading = (me->totedge >= BM_OMP_LIMIT);
+  BLI_task_parallel_range(0, me->totedge, &data, bm_edge_from_medge_cb, &settings);
 
+  for (i = 0, medge = me->medge; i < me->totedge; i++, medge++) {
     /* This is necessary for selection counts to work properly. */
     if (medge->flag & SELECT) {
-      BM_edge_select_set(bm, e, true);
-    }
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->edata, &bm->edata, i, &e->head.data, true);
-
-    if (cd_edge_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
-    }
-    if (cd_edge_crease_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_crease_offset, (float)medge->crease / 255.0f);
+      BM_edge_select_set(bm, etable[i], true);
     }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
   }
 
-  /* Only needed for selection. */
-  if (me->mselect && me->totselect != 0) {
-    ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
-  }
-
   mloop = me->mloop;
   mp = me->mpoly;
   for (i = 0, totloops = 0; i < me->totpoly; i++, mp++) {
     BMLoop *l_iter;
     BMLoop *l_first;
 
-    f = bm_face_create_from_mpoly(mp, mloop + mp->loopstart, bm, vtable, etable);
-    if (ftable != NULL) {
-      ftable[i] = f;
-    }
+    f = ftable[i] = bm_face_create_from_mpoly(mp, mloop + mp->loopstart, bm, vtable, etable);
 
     if (UNLIKELY(f == NULL)) {
       printf(
@@ -401,36 +498,32 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
 
     /* Don't use 'i' since we may have skipped the face. */
     BM_elem_index_set(f, bm->totface - 1); /* set_ok */
+    CustomData_bmesh_alloc_block(&bm->pdata, &f->head.data);
 
-    /* Transfer flag. */
-    f->head.hflag = BM_face_flag_from_mflag(mp->flag & ~ME_FACE_SEL);
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      /* Don't use 'j' since we may have skipped some faces, hence some loops. */
+      BM_elem_index_set(l_iter, totloops++); /* set_ok */
+      CustomData_bmesh_alloc_block(&bm->ldata, &l_iter->head.data);
+    } while ((l_iter = l_iter->next) != l_first);
+  }
+  settings.use_threading = (me->totpoly >= BM_OMP_LIMIT);
+  BLI_task_parallel_range(0, me->totpoly, &data, bm_face_from_mpoly_cb, &settings);
+
+  for (i = 0, mp = me->mpoly; i < me->totpoly; i++, mp++) {
+    f = ftable[i];
+    if (f == NULL) {
+      continue;
+    }
 
     /* This is necessary for selection counts to work properly. */
     if (mp->flag & ME_FACE_SEL) {
       BM_face_select_set(bm, f, true);
     }
 
-    f->mat_nr = mp->mat_nr;
     if (i == me->act_face) {
       bm->act_face = f;
     }
-
-    int j = mp->loopstart;
-    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-    do {
-      /* Don't use 'j' since we may have skipped some faces, hence some loops. */
-      BM_elem_index_set(l_iter, totloops++); /* set_ok */
-
-      /* Save index of corresponding #MLoop. */
-      CustomData_to_bmesh_block(&me->ldata, &bm->ldata, j++, &l_iter->head.data, true);
-    } while ((l_iter = l_iter->next) != l_first);
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->pdata, &bm->pdata, i, &f->head.data, true);
-
-    if (params->calc_face_normal) {
-      BM_face_normal_update(f);
-    }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
@@ -472,9 +565,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
 
   MEM_freeN(vtable);
   MEM_freeN(etable);
-  if (ftable) {
-    MEM_freeN(ftable);
-  }
+  MEM_freeN(ftable);
 }
 
 /**
@@ -555,22 +646,210 @@ BLI_INLINE void bmesh_quick_edgedraw_flag(MEdge *med, BMEdge *e)
   }
 }
 
+typedef struct BMeshToMeshData {
+  BMesh *bm;
+  Mesh *me;
+  /* Use the simpler edge draw flag of #BM_mesh_bm_to_me_for_eval. */
+  bool for_eval;
+
+  /* Elements by index, see #bm_to_mesh_elements. */
+  BMVert **vtable;
+  BMEdge **etable;
+  BMFace **ftable;
+
+  /* Optional #CD_ORIGINDEX layers to fill. */
+  int *vert_origindex;
+  int *edge_origindex;
+  int *poly_origindex;
+
+  int cd_vert_bweight_offset;
+  int cd_edge_bweight_offset;
+  int cd_edge_crease_offset;
+} BMeshToMeshData;
+
+static void bm_vert_to_mvert_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMeshToMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  BMVert *v = data->vtable[i];
+  MVert *mv = &data->me->mvert[i];
+
+  copy_v3_v3(mv->co, v->co);
+  normal_float_to_short_v3(mv->no, v->no);
+
+  mv->flag = BM_vert_flag_to_mflag(v);
+
+  if (data->cd_vert_bweight_offset != -1) {
+    mv->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, data->cd_vert_bweight_offset);
+  }
+
+  if (data->vert_origindex) {
+    data->vert_origindex[i] = i;
+  }
+
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_block(&bm->vdata, &data->me->vdata, v->head.data, i);
+
+  BM_CHECK_ELEMENT(v);
+}
+
+static void bm_edge_to_medge_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMeshToMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  BMEdge *e = data->etable[i];
+  MEdge *med = &data->me->medge[i];
+
+  med->v1 = BM_elem_index_get(e->v1);
+  med->v2 = BM_elem_index_get(e->v2);
+
+  med->flag = BM_edge_flag_to_mflag(e);
+
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_block(&bm->edata, &data->me->edata, e->head.data, i);
+
+  if (data->for_eval) {
+    /* Handle this differently to editmode switching,
+     * only enable draw for single user edges rather then calculating angle. */
+    if ((med->flag & ME_EDGEDRAW) == 0) {
+      if (e->l && e->l == e->l->radial_next) {
+        med->flag |= ME_EDGEDRAW;
+      }
+    }
+  }
+  else {
+    bmesh_quick_edgedraw_flag(med, e);
+  }
+
+  if (data->cd_edge_crease_offset != -1) {
+    med->crease = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, data->cd_edge_crease_offset);
+  }
+  if (data->cd_edge_bweight_offset != -1) {
+    med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, data->cd_edge_bweight_offset);
+  }
+
+  if (data->edge_origindex) {
+    data->edge_origindex[i] = i;
+  }
+
+  BM_CHECK_ELEMENT(e);
+}
+
+static void bm_face_to_mpoly_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMeshToMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  BMFace *f = data->ftable[i];
+  MPoly *mp = &data->me->mpoly[i];
+  BMLoop *l_iter, *l_first;
+
+  l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+
+  /* Loop indices are valid, they follow the face order. */
+  int j = BM_elem_index_get(l_first);
+  mp->loopstart = j;
+  mp->totloop = f->len;
+  mp->mat_nr = f->mat_nr;
+  mp->flag = BM_face_flag_to_mflag(f);
+
+  do {
+    MLoop *ml = &data->me->mloop[j];
+    ml->e = BM_elem_index_get(l_iter->e);
+    ml->v = BM_elem_index_get(l_iter->v);
+
+    /* Copy over custom-data. */
+    CustomData_from_bmesh_block(&bm->ldata, &data->me->ldata, l_iter->head.data, j);
+
+    j++;
+    BM_CHECK_ELEMENT(l_iter);
+    BM_CHECK_ELEMENT(l_iter->e);
+    BM_CHECK_ELEMENT(l_iter->v);
+  } while ((l_iter = l_iter->next) != l_first);
+
+  if (!data->for_eval && f == bm->act_face) {
+    data->me->act_face = i;
+  }
+
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_block(&bm->pdata, &data->me->pdata, f->head.data, i);
+
+  if (data->poly_origindex) {
+    data->poly_origindex[i] = i;
+  }
+
+  BM_CHECK_ELEMENT(f);
+}
+
+/**
+ * Fill the arrays of \a me from \a bm, the custom-data layers must already be allocated.
+ *
+ * Element indices are ensured serially, the elements are then copied in parallel since each one
+ * writes to its own index.
+ *
+ * \note This updates the element indices of \a bm, as the serial conversion always did. The
+ * element tables of \a bm are only used when they are valid, otherwise local tables are built,
+ * so converting an edit-mesh does not re-allocate tables that its other users may be reading.
+ */
+static void bm_to_mesh_elements(BMeshToMeshData *data)
+{
+  BMesh *bm = data->bm;
+  int len;
+
+  BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE | BM_FACE | BM_LOOP);
+
+  data->vtable = (bm->vtable && !(bm->elem_table_dirty & BM_VERT)) ?
+                     bm->vtable :
+                     BM_iter_as_arrayN(bm, BM_VERTS_OF_MESH, NULL, &len, NULL, 0);
+  data->etable = (bm->etable && !(bm->elem_table_dirty & BM_EDGE)) ?
+                     bm->etable :
+                     BM_iter_as_arrayN(bm, BM_EDGES_OF_MESH, NULL, &len, NULL, 0);
+  data->ftable = (bm->ftable && !(bm->elem_table_dirty & BM_FACE)) ?
+                     bm->ftable :
+                     BM_iter_as_arrayN(bm, BM_FACES_OF_MESH, NULL, &len, NULL, 0);
+
+  data->cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
+  data->cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
+  data->cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+
+  settings.use_threading = (bm->totvert >= BM_OMP_LIMIT);
+  BLI_task_parallel_range(0, bm->totvert, data, bm_vert_to_mvert_cb, &settings);
+
+  settings.use_threading = (bm->totedge >= BM_OMP_LIMIT);
+  BLI_task_parallel_range(0, bm->totedge, data, bm_edge_to_medge_cb, &settings);
+
+  settings.use_threading = (bm->totface >= BM_OMP_LIMIT);
+  BLI_task_parallel_range(0, bm->totface, data, bm_face_to_mpoly_cb, &settings);
+
+  if (data->vtable != bm->vtable) {
+    MEM_SAFE_FREE(data->vtable);
+  }
+  if (data->etable != bm->etable) {
+    MEM_SAFE_FREE(data->etable);
+  }
+  if (data->ftable != bm->ftable) {
+    MEM_SAFE_FREE(data->ftable);
+  }
+}
+
 /**
  *
  * \param bmain: May be NULL in case \a calc_object_remap parameter option is not set.
  */
 void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMeshParams *params)
 {
-  MEdge *med;
-  BMVert *v, *eve;
-  BMEdge *e;
-  BMFace *f;
+  BMVert *eve;
   BMIter iter;
   int i, j;
 
-  const int cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
-  const int cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
-  const int cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
   const int cd_shape_keyindex_offset = CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX);
 
   MVert *oldverts = NULL;
@@ -583,7 +862,8 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 #if 0
   oldverts = MEM_dupallocN(me->mvert);
 #else
-    oldverts = me->mvert;
+    /* Make sure the array is not shared with copies of the mesh before freeing it below. */
+    oldverts = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
     me->mvert = NULL;
     CustomData_update_typemap(&me->vdata);
     CustomData_set_layer(&me->vdata, CD_MVERT, NULL);
@@ -631,92 +911,12 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   /* This is called again, 'dotess' arg is used there. */
   BKE_mesh_update_customdata_pointers(me, 0);
 
-  i = 0;
-  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-    copy_v3_v3(mvert->co, v->co);
-    normal_float_to_short_v3(mvert->no, v->no);
-
-    mvert->flag = BM_vert_flag_to_mflag(v);
-
-    BM_elem_index_set(v, i); /* set_inline */
-
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, v->head.data, i);
-
-    if (cd_vert_bweight_offset != -1) {
-      mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, cd_vert_bweight_offset);
-    }
-
-    i++;
-    mvert++;
-
-    BM_CHECK_ELEMENT(v);
-  }
-  bm->elem_index_dirty &= ~BM_VERT;
-
-  med = medge;
-  i = 0;
-  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-    med->v1 = BM_elem_index_get(e->v1);
-    med->v2 = BM_elem_index_get(e->v2);
-
-    med->flag = BM_edge_flag_to_mflag(e);
-
-    BM_elem_index_set(e, i); /* set_inline */
-
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, e->head.data, i);
-
-    bmesh_quick_edgedraw_flag(med, e);
-
-    if (cd_edge_crease_offset != -1) {
-      med->crease = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_crease_offset);
-    }
-    if (cd_edge_bweight_offset != -1) {
-      med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_bweight_offset);
-    }
-
-    i++;
-    med++;
-    BM_CHECK_ELEMENT(e);
-  }
-  bm->elem_index_dirty &= ~BM_EDGE;
-
-  i = 0;
-  j = 0;
-  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
-    BMLoop *l_iter, *l_first;
-    mpoly->loopstart = j;
-    mpoly->totloop = f->len;
-    mpoly->mat_nr = f->mat_nr;
-    mpoly->flag = BM_face_flag_to_mflag(f);
-
-    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-    do {
-      mloop->e = BM_elem_index_get(l_iter->e);
-      mloop->v = BM_elem_index_get(l_iter->v);
-
-      /* Copy over custom-data. */
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
-
-      j++;
-      mloop++;
-      BM_CHECK_ELEMENT(l_iter);
-      BM_CHECK_ELEMENT(l_iter->e);
-      BM_CHECK_ELEMENT(l_iter->v);
-    } while ((l_iter = l_iter->next) != l_first);
-
-    if (f == bm->act_face) {
-      me->act_face = i;
-    }
-
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, f->head.data, i);
-
-    i++;
-    mpoly++;
-    BM_CHECK_ELEMENT(f);
-  }
+  BMeshToMeshData data = {
+      .bm = bm,
+      .me = me,
+      .for_eval = false,
+  };
+  bm_to_mesh_elements(&data);
 
   /* Patch hook indices and vertex parents. */
   if (params->calc_object_remap && (ototvert > 0)) {
@@ -995,6 +1195,8 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
  * - Uses #CD_MASK_DERIVEDMESH instead of #CD_MASK_MESH.
  *
  * \note Was `cddm_from_bmesh_ex` in 2.7x, removed `MFace` support.
+ * \note Updates the element indices of \a bm, which is usually an edit-mesh,
+ * see #bm_to_mesh_elements.
  */
 void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *cd_mask_extra)
 {
@@ -1031,117 +1233,20 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
 
   BKE_mesh_update_customdata_pointers(me, false);
 
-  BMIter iter;
-  BMVert *eve;
-  BMEdge *eed;
-  BMFace *efa;
-  MVert *mvert = me->mvert;
-  MEdge *medge = me->medge;
-  MLoop *mloop = me->mloop;
-  MPoly *mpoly = me->mpoly;
-  int *index, add_orig;
-  unsigned int i, j;
-
-  const int cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
-  const int cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
-  const int cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
-
   me->runtime.deformed_only = true;
 
   /* Don't add origindex layer if one already exists. */
-  add_orig = !CustomData_has_layer(&bm->pdata, CD_ORIGINDEX);
-
-  index = CustomData_get_layer(&me->vdata, CD_ORIGINDEX);
-
-  BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, i) {
-    MVert *mv = &mvert[i];
-
-    copy_v3_v3(mv->co, eve->co);
-
-    BM_elem_index_set(eve, i); /* set_inline */
-
-    normal_float_to_short_v3(mv->no, eve->no);
-
-    mv->flag = BM_vert_flag_to_mflag(eve);
-
-    if (cd_vert_bweight_offset != -1) {
-      mv->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(eve, cd_vert_bweight_offset);
-    }
-
-    if (add_orig) {
-      *index++ = i;
-    }
-
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, eve->head.data, i);
-  }
-  bm->elem_index_dirty &= ~BM_VERT;
-
-  index = CustomData_get_layer(&me->edata, CD_ORIGINDEX);
-  BM_ITER_MESH_INDEX (eed, &iter, bm, BM_EDGES_OF_MESH, i) {
-    MEdge *med = &medge[i];
-
-    BM_elem_index_set(eed, i); /* set_inline */
-
-    med->v1 = BM_elem_index_get(eed->v1);
-    med->v2 = BM_elem_index_get(eed->v2);
-
-    med->flag = BM_edge_flag_to_mflag(eed);
-
-    /* Handle this differently to editmode switching,
-     * only enable draw for single user edges rather then calculating angle. */
-    if ((med->flag & ME_EDGEDRAW) == 0) {
-      if (eed->l && eed->l == eed->l->radial_next) {
-        med->flag |= ME_EDGEDRAW;
-      }
-    }
-
-    if (cd_edge_crease_offset != -1) {
-      med->crease = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(eed, cd_edge_crease_offset);
-    }
-    if (cd_edge_bweight_offset != -1) {
-      med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(eed, cd_edge_bweight_offset);
-    }
-
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, eed->head.data, i);
-    if (add_orig) {
-      *index++ = i;
-    }
-  }
-  bm->elem_index_dirty &= ~BM_EDGE;
-
-  index = CustomData_get_layer(&me->pdata, CD_ORIGINDEX);
-  j = 0;
-  BM_ITER_MESH_INDEX (efa, &iter, bm, BM_FACES_OF_MESH, i) {
-    BMLoop *l_iter;
-    BMLoop *l_first;
-    MPoly *mp = &mpoly[i];
-
-    BM_elem_index_set(efa, i); /* set_inline */
-
-    mp->totloop = efa->len;
-    mp->flag = BM_face_flag_to_mflag(efa);
-    mp->loopstart = j;
-    mp->mat_nr = efa->mat_nr;
-
-    l_iter = l_first = BM_FACE_FIRST_LOOP(efa);
-    do {
-      mloop->v = BM_elem_index_get(l_iter->v);
-      mloop->e = BM_elem_index_get(l_iter->e);
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
-
-      BM_elem_index_set(l_iter, j); /* set_inline */
-
-      j++;
-      mloop++;
-    } while ((l_iter = l_iter->next) != l_first);
-
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, efa->head.data, i);
-
-    if (add_orig) {
-      *index++ = i;
-    }
-  }
-  bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP);
+  const bool add_orig = !CustomData_has_layer(&bm->pdata, CD_ORIGINDEX);
+
+  BMeshToMeshData data = {
+      .bm = bm,
+      .me = me,
+      .for_eval = true,
+      .vert_origindex = add_orig ? CustomData_get_layer(&me->vdata, CD_ORIGINDEX) : NULL,
+      .edge_origindex = add_orig ? CustomData_get_layer(&me->edata, CD_ORIGINDEX) : NULL,
+      .poly_origindex = add_orig ? CustomData_get_layer(&me->pdata, CD_ORIGINDEX) : NULL,
+  };
+  bm_to_mesh_elements(&data);
 
   me->cd_flag = BM_mesh_cd_flag_from_bmesh(bm);
 }
@@ -360,7 +360,28 @@ void COM_deinitialize(void);
  * \brief Clear all compositor caches. (Compositor system will still remain available).
  * To deinitialize the compositor use the COM_deinitialize method.
  */
-// void COM_clearCaches(void); // NOT YET WRITTEN
+void COM_clearCaches(void);
+
+/**
+ * \brief Clear the cached results that depend on a data-block, after its contents changed.
+ */
+void COM_clearCachesForID(const struct ID *id);
+
+/**
+ * \brief Forget a data-block before it is freed, so a new data-block allocated at the same
+ * address does not use results cached for the freed one.
+ * \param id: the data-block, or NULL when all data-blocks are freed (loading a file, undo)
+ */
+void COM_freeID(const struct ID *id);
+
+/**
+ * \brief Get statistics of the results cached between executions while editing.
+ * \param r_hits: number of cached results used by the last execution
+ * \param r_misses: number of results the last execution had to calculate
+ * \param r_num_buffers: number of cached results
+ * \param r_memory: memory used by the cached results, in bytes
+ */
+void COM_getCacheStats(int *r_hits, int *r_misses, int *r_num_buffers, size_t *r_memory);
 
 #ifdef __cplusplus
 }
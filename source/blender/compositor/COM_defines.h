@@ -107,6 +107,13 @@ typedef enum OrderOfChunks {
 #define COM_NUM_CHANNELS_VECTOR 3
 #define COM_NUM_CHANNELS_COLOR 4
 
+/**
+ * \brief Maximum number of pixels calculated at once when executing rows of pixels.
+ * Rows always hold COM_NUM_CHANNELS_COLOR floats per pixel, small enough to fit on the stack.
+ * \see SocketReader.executeRow
+ */
+#define COM_ROW_SIZE 64
+
 #define COM_BLUR_BOKEH_PIXELS 512
 
 #endif /* __COM_DEFINES_H__ */
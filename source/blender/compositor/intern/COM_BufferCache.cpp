@@ -0,0 +1,448 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#include <map>
+#include <string.h>
+#include <typeinfo>
+
+#include "COM_BufferCache.h"
+#include "COM_ExecutionGroup.h"
+#include "COM_ExecutionSystem.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "DNA_color_types.h"
+#include "DNA_ID.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_node.h"
+}
+
+#define HASH_OFFSET_BASIS 14695981039346656037ULL
+#define HASH_PRIME 1099511628211ULL
+
+typedef struct CacheEntry {
+  MemoryBuffer *buffer;
+  size_t memory;
+  /** Number of the last execution that used this entry. */
+  unsigned int last_used;
+} CacheEntry;
+
+typedef std::map<uint64_t, CacheEntry> CacheEntries;
+typedef std::map<const ID *, unsigned int> IDGenerations;
+/** Hash of the result of an operation and whether it can be cached. */
+typedef std::map<NodeOperation *, std::pair<uint64_t, bool>> OperationHashes;
+
+static ThreadMutex s_cacheMutex = BLI_MUTEX_INITIALIZER;
+static CacheEntries s_entries;
+static IDGenerations s_idGenerations;
+/** Last generation given to a data-block, generations are never reused. */
+static unsigned int s_lastIDGeneration = 0;
+static size_t s_memory = 0;
+static unsigned int s_execution = 0;
+static int s_hits = 0;
+static int s_misses = 0;
+
+uint64_t BufferCache::hash(uint64_t hash, const void *data, size_t size)
+{
+  /* FNV-1a */
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= HASH_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * A data-block seen for the first time gets a new generation, so a data-block allocated at the
+ * address of a freed one does not match results cached for the freed one.
+ */
+static unsigned int id_generation_get(const ID *id)
+{
+  BLI_mutex_lock(&s_cacheMutex);
+  IDGenerations::iterator it = s_idGenerations.find(id);
+  if (it == s_idGenerations.end()) {
+    it = s_idGenerations.insert(std::make_pair(id, ++s_lastIDGeneration)).first;
+  }
+  const unsigned int generation = it->second;
+  BLI_mutex_unlock(&s_cacheMutex);
+  return generation;
+}
+
+static uint64_t hash_string(uint64_t hash, const char *str)
+{
+  return (str) ? BufferCache::hash(hash, str, strlen(str) + 1) : hash;
+}
+
+static uint64_t hash_sockets(uint64_t hash, const ListBase *sockets)
+{
+  for (const bNodeSocket *sock = (const bNodeSocket *)sockets->first; sock; sock = sock->next) {
+    if (sock->default_value) {
+      hash = BufferCache::hash(hash, sock->default_value, MEM_allocN_len(sock->default_value));
+    }
+  }
+  return hash;
+}
+
+static uint64_t hash_curve_mapping(uint64_t hash, const CurveMapping *cumap)
+{
+  hash = BufferCache::hash(hash, &cumap->flag, sizeof(cumap->flag));
+  hash = BufferCache::hash(hash, &cumap->clipr, sizeof(cumap->clipr));
+  hash = BufferCache::hash(hash, cumap->black, sizeof(cumap->black));
+  hash = BufferCache::hash(hash, cumap->white, sizeof(cumap->white));
+  hash = BufferCache::hash(hash, &cumap->tone, sizeof(cumap->tone));
+  for (int i = 0; i < CM_TOT; i++) {
+    const CurveMap *cuma = &cumap->cm[i];
+    hash = BufferCache::hash(hash, cuma->ext_in, sizeof(cuma->ext_in));
+    hash = BufferCache::hash(hash, cuma->ext_out, sizeof(cuma->ext_out));
+    for (int a = 0; a < cuma->totpoint; a++) {
+      /* selecting points does not change the result */
+      const CurveMapPoint *cmp = &cuma->curve[a];
+      const short flag = cmp->flag & ~CUMA_SELECT;
+      hash = BufferCache::hash(hash, &cmp->x, sizeof(cmp->x));
+      hash = BufferCache::hash(hash, &cmp->y, sizeof(cmp->y));
+      hash = BufferCache::hash(hash, &flag, sizeof(flag));
+    }
+  }
+  return hash;
+}
+
+static uint64_t hash_storage(uint64_t hash, const bNode *bnode)
+{
+  switch (bnode->type) {
+    case CMP_NODE_CURVE_RGB:
+    case CMP_NODE_CURVE_VEC:
+    case CMP_NODE_HUECORRECT:
+    case CMP_NODE_TIME:
+      return hash_curve_mapping(hash, (const CurveMapping *)bnode->storage);
+    case CMP_NODE_CRYPTOMATTE: {
+      const NodeCryptomatte *data = (const NodeCryptomatte *)bnode->storage;
+      hash = BufferCache::hash(hash, data->add, sizeof(data->add));
+      hash = BufferCache::hash(hash, data->remove, sizeof(data->remove));
+      hash = BufferCache::hash(hash, &data->num_inputs, sizeof(data->num_inputs));
+      return hash_string(hash, data->matte_id);
+    }
+    case CMP_NODE_MOVIEDISTORTION:
+      /* storage is a runtime distortion cache */
+      return hash;
+    default:
+      return BufferCache::hash(hash, bnode->storage, MEM_allocN_len(bnode->storage));
+  }
+}
+
+uint64_t BufferCache::hashNode(const bNode *bnode, bool *r_cacheable)
+{
+  uint64_t result = HASH_OFFSET_BASIS;
+  *r_cacheable = true;
+
+  if (bnode == NULL) {
+    return result;
+  }
+
+  result = hash(result, &bnode->type, sizeof(bnode->type));
+  result = hash_string(result, bnode->idname);
+  result = hash(result, &bnode->custom1, sizeof(bnode->custom1));
+  result = hash(result, &bnode->custom2, sizeof(bnode->custom2));
+  result = hash(result, &bnode->custom3, sizeof(bnode->custom3));
+  result = hash(result, &bnode->custom4, sizeof(bnode->custom4));
+  result = hash_sockets(result, &bnode->inputs);
+  result = hash_sockets(result, &bnode->outputs);
+  if (bnode->storage) {
+    result = hash_storage(result, bnode);
+  }
+
+  const ID *id = bnode->id;
+  if (id) {
+    switch (GS(id->name)) {
+      case ID_MSK:
+      case ID_TE:
+        /* evaluated for the current frame or changed without notifying the compositor */
+        *r_cacheable = false;
+        break;
+      case ID_NT:
+        /* node groups are localized for every execution, their nodes are hashed instead */
+        break;
+      default: {
+        const unsigned int generation = id_generation_get(id);
+
+        result = hash(result, &id, sizeof(id));
+        result = hash_string(result, id->name);
+        result = hash(result, &generation, sizeof(generation));
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+static bool hash_operation(NodeOperation *operation, OperationHashes &hashes, uint64_t *r_hash)
+{
+  OperationHashes::const_iterator it = hashes.find(operation);
+  if (it != hashes.end()) {
+    *r_hash = it->second.first;
+    return it->second.second;
+  }
+
+  const char *type_name = typeid(*operation).name();
+  const unsigned int resolution[2] = {operation->getWidth(), operation->getHeight()};
+  bool cacheable = operation->isCacheable();
+  uint64_t result = operation->getSettingsHash();
+  result = BufferCache::hash(result, type_name, strlen(type_name));
+  result = BufferCache::hash(result, resolution, sizeof(resolution));
+
+  if (operation->isReadBufferOperation()) {
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    uint64_t input_hash;
+    if (!hash_operation(proxy->getWriteBufferOperation(), hashes, &input_hash)) {
+      cacheable = false;
+    }
+    result = BufferCache::hash(result, &input_hash, sizeof(input_hash));
+  }
+
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    uint64_t input_hash = 0;
+    if (input->isConnected() &&
+        !hash_operation(&input->getLink()->getOperation(), hashes, &input_hash)) {
+      cacheable = false;
+    }
+    result = BufferCache::hash(result, &input_hash, sizeof(input_hash));
+  }
+
+  hashes[operation] = std::make_pair(result, cacheable);
+  *r_hash = result;
+  return cacheable;
+}
+
+static uint64_t hash_context(const CompositorContext &context)
+{
+  const RenderData *rd = context.getRenderData();
+  const bNodeTree *ntree = context.getbNodeTree();
+  const int quality = context.getQuality();
+  const bool fast_calculation = context.isFastCalculation();
+  const bool use_opencl = context.getHasActiveOpenCLDevices();
+
+  uint64_t result = HASH_OFFSET_BASIS;
+  result = BufferCache::hash(result, &quality, sizeof(quality));
+  result = BufferCache::hash(result, &fast_calculation, sizeof(fast_calculation));
+  result = BufferCache::hash(result, &use_opencl, sizeof(use_opencl));
+  result = hash_string(result, context.getViewName());
+  result = BufferCache::hash(result, &rd->cfra, sizeof(rd->cfra));
+  result = BufferCache::hash(result, &rd->subframe, sizeof(rd->subframe));
+  result = BufferCache::hash(result, &rd->xsch, sizeof(rd->xsch));
+  result = BufferCache::hash(result, &rd->ysch, sizeof(rd->ysch));
+  result = BufferCache::hash(result, &rd->size, sizeof(rd->size));
+  if (ntree->flag & NTREE_VIEWER_BORDER) {
+    result = BufferCache::hash(result, &ntree->viewer_border, sizeof(ntree->viewer_border));
+  }
+  return result;
+}
+
+static size_t cache_limit(const CompositorContext &context)
+{
+  if (context.isRendering()) {
+    return 0;
+  }
+  return (size_t)max_ii(context.getbNodeTree()->cache_limit, 0) * 1024 * 1024;
+}
+
+/* Write buffer of a group whose result can be cached, or NULL. */
+static WriteBufferOperation *cacheable_output(ExecutionGroup *group)
+{
+  if (!group->isComplex() || group->isOutputExecutionGroup()) {
+    return NULL;
+  }
+  NodeOperation *operation = group->getOutputOperation();
+  if (!operation->isWriteBufferOperation()) {
+    return NULL;
+  }
+  WriteBufferOperation *write_operation = (WriteBufferOperation *)operation;
+  if (write_operation->isSingleValue() || write_operation->getMemoryProxy()->getBuffer() == NULL) {
+    return NULL;
+  }
+  return write_operation;
+}
+
+static void free_entry(CacheEntries::iterator it)
+{
+  s_memory -= it->second.memory;
+  delete it->second.buffer;
+  s_entries.erase(it);
+}
+
+/* Free the least recently used results until the cache fits in the given memory. */
+static void free_entries_until(size_t memory)
+{
+  while (s_memory > memory && !s_entries.empty()) {
+    CacheEntries::iterator oldest = s_entries.begin();
+    for (CacheEntries::iterator it = s_entries.begin(); it != s_entries.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
+    }
+    free_entry(oldest);
+  }
+}
+
+void BufferCache::restore(ExecutionSystem *system)
+{
+  const CompositorContext &context = system->getContext();
+
+  BLI_mutex_lock(&s_cacheMutex);
+  s_execution++;
+  s_hits = 0;
+  s_misses = 0;
+  BLI_mutex_unlock(&s_cacheMutex);
+
+  if (cache_limit(context) == 0) {
+    if (!context.isRendering()) {
+      clear();
+    }
+    return;
+  }
+
+  const uint64_t context_hash = hash_context(context);
+  OperationHashes hashes;
+
+  for (unsigned int index = 0; index < system->m_groups.size(); index++) {
+    ExecutionGroup *group = system->m_groups[index];
+    WriteBufferOperation *write_operation = cacheable_output(group);
+    uint64_t operation_hash;
+    if (write_operation == NULL || !hash_operation(write_operation, hashes, &operation_hash)) {
+      continue;
+    }
+
+    const uint64_t key = hash(context_hash, &operation_hash, sizeof(operation_hash));
+    group->setCacheKey(key);
+
+    BLI_mutex_lock(&s_cacheMutex);
+    CacheEntries::iterator it = s_entries.find(key);
+    MemoryBuffer *buffer = write_operation->getMemoryProxy()->getBuffer();
+    if (it != s_entries.end() && (it->second.buffer->getWidth() != buffer->getWidth() ||
+                                  it->second.buffer->getHeight() != buffer->getHeight() ||
+                                  it->second.buffer->get_num_channels() !=
+                                      buffer->get_num_channels())) {
+      free_entry(it);
+      it = s_entries.end();
+    }
+    if (it != s_entries.end()) {
+      buffer->copyContentFrom(it->second.buffer);
+      it->second.last_used = s_execution;
+      group->setChunksExecuted();
+      s_hits++;
+    }
+    else {
+      s_misses++;
+    }
+    BLI_mutex_unlock(&s_cacheMutex);
+  }
+}
+
+void BufferCache::store(ExecutionSystem *system)
+{
+  const CompositorContext &context = system->getContext();
+  const bNodeTree *ntree = context.getbNodeTree();
+  const size_t limit = cache_limit(context);
+
+  if (limit == 0 || ntree->test_break(ntree->tbh)) {
+    return;
+  }
+
+  BLI_mutex_lock(&s_cacheMutex);
+  /* the limit may have been lowered since the last execution */
+  free_entries_until(limit);
+
+  for (unsigned int index = 0; index < system->m_groups.size(); index++) {
+    ExecutionGroup *group = system->m_groups[index];
+    const uint64_t key = group->getCacheKey();
+    if (key == 0 || s_entries.find(key) != s_entries.end() || !group->isExecuted()) {
+      continue;
+    }
+
+    WriteBufferOperation *write_operation = (WriteBufferOperation *)group->getOutputOperation();
+    MemoryProxy *proxy = write_operation->getMemoryProxy();
+    MemoryBuffer *buffer = proxy->getBuffer();
+    const size_t memory = sizeof(float) * buffer->getWidth() * buffer->getHeight() *
+                          buffer->get_num_channels();
+    if (memory > limit) {
+      continue;
+    }
+
+    free_entries_until(limit - memory);
+
+    CacheEntry entry;
+    entry.buffer = new MemoryBuffer(proxy->getDataType(), buffer->getRect());
+    entry.buffer->copyContentFrom(buffer);
+    entry.memory = memory;
+    entry.last_used = s_execution;
+    s_entries[key] = entry;
+    s_memory += memory;
+  }
+  BLI_mutex_unlock(&s_cacheMutex);
+}
+
+void BufferCache::clear()
+{
+  BLI_mutex_lock(&s_cacheMutex);
+  while (!s_entries.empty()) {
+    free_entry(s_entries.begin());
+  }
+  BLI_mutex_unlock(&s_cacheMutex);
+}
+
+void BufferCache::tagID(const ID *id)
+{
+  BLI_mutex_lock(&s_cacheMutex);
+  s_idGenerations[id] = ++s_lastIDGeneration;
+  BLI_mutex_unlock(&s_cacheMutex);
+}
+
+void BufferCache::removeID(const ID *id)
+{
+  BLI_mutex_lock(&s_cacheMutex);
+  s_idGenerations.erase(id);
+  BLI_mutex_unlock(&s_cacheMutex);
+}
+
+void BufferCache::removeAllIDs()
+{
+  BLI_mutex_lock(&s_cacheMutex);
+  s_idGenerations.clear();
+  BLI_mutex_unlock(&s_cacheMutex);
+}
+
+void BufferCache::getStats(int *r_hits, int *r_misses, int *r_num_buffers, size_t *r_memory)
+{
+  BLI_mutex_lock(&s_cacheMutex);
+  *r_hits = s_hits;
+  *r_misses = s_misses;
+  *r_num_buffers = s_entries.size();
+  *r_memory = s_memory;
+  BLI_mutex_unlock(&s_cacheMutex);
+}
@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#ifndef __COM_BUFFERCACHE_H__
+#define __COM_BUFFERCACHE_H__
+
+#include "BLI_sys_types.h"
+
+struct bNode;
+struct ID;
+class ExecutionSystem;
+class NodeOperation;
+
+/**
+ * \brief Cache of the results of complex execution groups across executions.
+ *
+ * While editing, the result of every complex execution group is stored under a hash of the
+ * settings of all operations it depends on. When the tree is executed again, groups whose
+ * hash did not change are restored from the cache instead of being calculated, so only the part
+ * of the tree after a changed node is recalculated.
+ *
+ * Data-blocks used by nodes are hashed by pointer and a generation, changes to their contents
+ * are signaled with tagID(). Freed data-blocks have to be removed with removeID(), results
+ * cached for them are then never used again and freed when the cache runs out of memory.
+ * \ingroup Memory
+ */
+class BufferCache {
+ public:
+  /**
+   * \brief hash the settings of a node, sets r_cacheable to false when the result of the node
+   * depends on data that can change without the node being tagged.
+   */
+  static uint64_t hashNode(const bNode *bnode, bool *r_cacheable);
+
+  /**
+   * \brief combine data into a hash
+   */
+  static uint64_t hash(uint64_t hash, const void *data, size_t size);
+
+  /**
+   * \brief restore cached results of complex execution groups, before executing the system
+   */
+  static void restore(ExecutionSystem *system);
+
+  /**
+   * \brief store the results of complex execution groups, after executing the system
+   */
+  static void store(ExecutionSystem *system);
+
+  /**
+   * \brief free all cached results
+   */
+  static void clear();
+
+  /**
+   * \brief invalidate all cached results that depend on a data-block
+   */
+  static void tagID(const ID *id);
+
+  /**
+   * \brief forget a data-block that is freed, its address may be reused by another one
+   */
+  static void removeID(const ID *id);
+
+  /**
+   * \brief forget all data-blocks, when the whole main database is freed
+   */
+  static void removeAllIDs();
+
+  /**
+   * \brief get the number of restored and calculated groups of the last execution
+   * and the memory used by cached results.
+   */
+  static void getStats(int *r_hits, int *r_misses, int *r_num_buffers, size_t *r_memory);
+};
+
+#endif
@@ -0,0 +1,606 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "COM_Convolution.h"
+#include "COM_MemoryBuffer.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Recursive Gaussian
+ * \{ */
+
+typedef struct IIRCoefficients {
+  double cf[4];
+  /* Triggs/Sdika border corrections */
+  double tsM[9];
+} IIRCoefficients;
+
+static void iir_gauss_coefficients(IIRCoefficients *coefs, float sigma)
+{
+  double q, q2, sc;
+  double *cf = coefs->cf;
+  double *tsM = coefs->tsM;
+
+  // see "Recursive Gabor Filtering" by Young/VanVliet
+  // all factors here in double.prec.
+  // Required, because for single.prec it seems to blow up if sigma > ~200
+  if (sigma >= 3.556f) {
+    q = 0.9804f * (sigma - 3.556f) + 2.5091f;
+  }
+  else {  // sigma >= 0.5
+    q = (0.0561f * sigma + 0.5784f) * sigma - 0.2568f;
+  }
+  q2 = q * q;
+  sc = (1.1668 + q) * (3.203729649 + (2.21566 + q) * q);
+  // no gabor filtering here, so no complex multiplies, just the regular coefs.
+  // all negated here, so as not to have to recalc Triggs/Sdika matrix
+  cf[1] = q * (5.788961737 + (6.76492 + 3.0 * q) * q) / sc;
+  cf[2] = -q2 * (3.38246 + 3.0 * q) / sc;
+  // 0 & 3 unchanged
+  cf[3] = q2 * q / sc;
+  cf[0] = 1.0 - cf[1] - cf[2] - cf[3];
+
+  // Triggs/Sdika border corrections,
+  // it seems to work, not entirely sure if it is actually totally correct,
+  // Besides J.M.Geusebroek's anigauss.c (see http://www.science.uva.nl/~mark),
+  // found one other implementation by Cristoph Lampert,
+  // but neither seem to be quite the same, result seems to be ok so far anyway.
+  // Extra scale factor here to not have to do it in filter,
+  // though maybe this had something to with the precision errors
+  sc = cf[0] / ((1.0 + cf[1] - cf[2] + cf[3]) * (1.0 - cf[1] - cf[2] - cf[3]) *
+                (1.0 + cf[2] + (cf[1] - cf[3]) * cf[3]));
+  tsM[0] = sc * (-cf[3] * cf[1] + 1.0 - cf[3] * cf[3] - cf[2]);
+  tsM[1] = sc * ((cf[3] + cf[1]) * (cf[2] + cf[3] * cf[1]));
+  tsM[2] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+  tsM[3] = sc * (cf[1] + cf[3] * cf[2]);
+  tsM[4] = sc * (-(cf[2] - 1.0) * (cf[2] + cf[3] * cf[1]));
+  tsM[5] = sc * (-(cf[3] * cf[1] + cf[3] * cf[3] + cf[2] - 1.0) * cf[3]);
+  tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
+  tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
+                 cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
+  tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+}
+
+/* Filter a line of L >= 3 values forward into W and backward into Y. */
+static void iir_gauss_line(
+    const IIRCoefficients *coefs, const double *X, double *W, double *Y, unsigned int L)
+{
+  const double *cf = coefs->cf;
+  const double *tsM = coefs->tsM;
+  double tsu[3], tsv[3];
+  unsigned int i;
+
+  W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];
+  W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];
+  W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];
+  for (i = 3; i < L; i++) {
+    W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];
+  }
+  tsu[0] = W[L - 1] - X[L - 1];
+  tsu[1] = W[L - 2] - X[L - 1];
+  tsu[2] = W[L - 3] - X[L - 1];
+  tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];
+  tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];
+  tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];
+  Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];
+  Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];
+  Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0];
+  /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */
+  for (i = L - 4; i != UINT_MAX; i--) {
+    Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];
+  }
+}
+
+typedef struct IIRGaussData {
+  IIRCoefficients coefs;
+  float *buffer;
+  /* Number of values in a line, offset between lines and between values of a line. */
+  unsigned int length;
+  unsigned int line_stride;
+  unsigned int stride;
+} IIRGaussData;
+
+/* Intermediate buffers of a thread. */
+typedef struct IIRGaussTLS {
+  double *X, *W, *Y;
+} IIRGaussTLS;
+
+static void iir_gauss_line_cb(void *__restrict userdata,
+                              const int line,
+                              const TaskParallelTLS *__restrict tls)
+{
+  const IIRGaussData *data = (const IIRGaussData *)userdata;
+  IIRGaussTLS *buffers = (IIRGaussTLS *)tls->userdata_chunk;
+  const unsigned int L = data->length;
+
+  if (buffers->X == NULL) {
+    buffers->X = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss X buf");
+    buffers->W = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss W buf");
+    buffers->Y = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss Y buf");
+  }
+
+  float *values = data->buffer + line * data->line_stride;
+  for (unsigned int i = 0; i < L; i++) {
+    buffers->X[i] = values[i * data->stride];
+  }
+  iir_gauss_line(&data->coefs, buffers->X, buffers->W, buffers->Y, L);
+  for (unsigned int i = 0; i < L; i++) {
+    values[i * data->stride] = buffers->Y[i];
+  }
+}
+
+static void iir_gauss_finalize(void *__restrict /*userdata*/, void *__restrict userdata_chunk)
+{
+  IIRGaussTLS *buffers = (IIRGaussTLS *)userdata_chunk;
+  if (buffers->X) {
+    MEM_freeN(buffers->X);
+    MEM_freeN(buffers->W);
+    MEM_freeN(buffers->Y);
+  }
+}
+
+static void iir_gauss_lines(IIRGaussData *data, unsigned int num_lines)
+{
+  IIRGaussTLS buffers = {NULL, NULL, NULL};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.userdata_chunk = &buffers;
+  settings.userdata_chunk_size = sizeof(buffers);
+  settings.func_finalize = iir_gauss_finalize;
+  BLI_task_parallel_range(0, num_lines, data, iir_gauss_line_cb, &settings);
+}
+
+void Convolution::gaussIIR(MemoryBuffer *src, float sigma, unsigned int chan, unsigned int xy)
+{
+  const unsigned int src_width = src->getWidth();
+  const unsigned int src_height = src->getHeight();
+  const unsigned int num_channels = src->get_num_channels();
+
+  // <0.5 not valid, though can have a possibly useful sort of sharpening effect
+  if (sigma < 0.5f) {
+    return;
+  }
+
+  if ((xy < 1) || (xy > 3)) {
+    xy = 3;
+  }
+
+  // XXX The filter explicitly expects sources of at least 3x3 pixels,
+  //     so just skipping blur along faulty direction if src's def is below that limit!
+  if (src_width < 3) {
+    xy &= ~1;
+  }
+  if (src_height < 3) {
+    xy &= ~2;
+  }
+  if (xy < 1) {
+    return;
+  }
+
+  IIRGaussData data;
+  iir_gauss_coefficients(&data.coefs, sigma);
+  data.buffer = src->getBuffer() + chan;
+
+  if (xy & 1) {  // H
+    data.length = src_width;
+    data.line_stride = src_width * num_channels;
+    data.stride = num_channels;
+    iir_gauss_lines(&data, src_height);
+  }
+  if (xy & 2) {  // V
+    data.length = src_height;
+    data.line_stride = num_channels;
+    data.stride = src_width * num_channels;
+    iir_gauss_lines(&data, src_width);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name 2D Fast Hartley Transform, used for convolution
+ * \{ */
+
+typedef float fREAL;
+
+// returns next highest power of 2 of x, as well it's log2 in L2
+static unsigned int nextPow2(unsigned int x, unsigned int *L2)
+{
+  unsigned int pw, x_notpow2 = x & (x - 1);
+  *L2 = 0;
+  while (x >>= 1) {
+    ++(*L2);
+  }
+  pw = 1 << (*L2);
+  if (x_notpow2) {
+    (*L2)++;
+    pw <<= 1;
+  }
+  return pw;
+}
+
+//------------------------------------------------------------------------------
+
+// from FXT library by Joerg Arndt, faster in order bitreversal
+// use: r = revbin_upd(r, h) where h = N>>1
+static unsigned int revbin_upd(unsigned int r, unsigned int h)
+{
+  while (!((r ^= h) & h)) {
+    h >>= 1;
+  }
+  return r;
+}
+//------------------------------------------------------------------------------
+static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
+{
+  double tt, fc, dc, fs, ds, a = M_PI;
+  fREAL t1, t2;
+  int n2, bd, bl, istep, k, len = 1 << M, n = 1;
+
+  int i, j = 0;
+  unsigned int Nh = len >> 1;
+  for (i = 1; i < (len - 1); i++) {
+    j = revbin_upd(j, Nh);
+    if (j > i) {
+      t1 = data[i];
+      data[i] = data[j];
+      data[j] = t1;
+    }
+  }
+
+  do {
+    fREAL *data_n = &data[n];
+
+    istep = n << 1;
+    for (k = 0; k < len; k += istep) {
+      t1 = data_n[k];
+      data_n[k] = data[k] - t1;
+      data[k] += t1;
+    }
+
+    n2 = n >> 1;
+    if (n > 2) {
+      fc = dc = cos(a);
+      fs = ds = sqrt(1.0 - fc * fc);  // sin(a);
+      bd = n - 2;
+      for (bl = 1; bl < n2; bl++) {
+        fREAL *data_nbd = &data_n[bd];
+        fREAL *data_bd = &data[bd];
+        for (k = bl; k < len; k += istep) {
+          t1 = fc * (double)data_n[k] + fs * (double)data_nbd[k];
+          t2 = fs * (double)data_n[k] - fc * (double)data_nbd[k];
+          data_n[k] = data[k] - t1;
+          data_nbd[k] = data_bd[k] - t2;
+          data[k] += t1;
+          data_bd[k] += t2;
+        }
+        tt = fc * dc - fs * ds;
+        fs = fs * dc + fc * ds;
+        fc = tt;
+        bd -= 2;
+      }
+    }
+
+    if (n > 1) {
+      for (k = n2; k < len; k += istep) {
+        t1 = data_n[k];
+        data_n[k] = data[k] - t1;
+        data[k] += t1;
+      }
+    }
+
+    n = istep;
+    a *= 0.5;
+  } while (n < len);
+
+  if (inverse) {
+    fREAL sc = (fREAL)1 / (fREAL)len;
+    for (k = 0; k < len; k++) {
+      data[k] *= sc;
+    }
+  }
+}
+
+typedef struct FHTRowsData {
+  fREAL *data;
+  unsigned int M;
+  unsigned int inverse;
+} FHTRowsData;
+
+static void fht_row_cb(void *__restrict userdata,
+                       const int row,
+                       const TaskParallelTLS *__restrict /*tls*/)
+{
+  const FHTRowsData *rows = (const FHTRowsData *)userdata;
+  FHT(&rows->data[row << rows->M], rows->M, rows->inverse);
+}
+
+/* Transform rows of 2^M values in parallel, rows are independent. */
+static void FHT_rows(fREAL *data, unsigned int num_rows, unsigned int M, unsigned int inverse)
+{
+  FHTRowsData rows;
+  rows.data = data;
+  rows.M = M;
+  rows.inverse = inverse;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, num_rows, &rows, fht_row_cb, &settings);
+}
+
+//------------------------------------------------------------------------------
+/* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
+ * nzp -> the row where zero pad data starts,
+ * inverse -> see above */
+static void FHT2D(
+    fREAL *data, unsigned int Mx, unsigned int My, unsigned int nzp, unsigned int inverse)
+{
+  unsigned int i, j, Nx, Ny, maxy;
+
+  Nx = 1 << Mx;
+  Ny = 1 << My;
+
+  // rows (forward transform skips 0 pad data)
+  maxy = inverse ? Ny : nzp;
+  FHT_rows(data, maxy, Mx, inverse);
+
+  // transpose data
+  if (Nx == Ny) {  // square
+    for (j = 0; j < Ny; j++) {
+      for (i = j + 1; i < Nx; i++) {
+        unsigned int op = i + (j << Mx), np = j + (i << My);
+        SWAP(fREAL, data[op], data[np]);
+      }
+    }
+  }
+  else {  // rectangular
+    unsigned int k, Nym = Ny - 1, stm = 1 << (Mx + My);
+    for (i = 0; stm > 0; i++) {
+#define PRED(k) (((k & Nym) << Mx) + (k >> My))
+      for (j = PRED(i); j > i; j = PRED(j)) {
+        /* pass */
+      }
+      if (j < i) {
+        continue;
+      }
+      for (k = i, j = PRED(i); j != i; k = j, j = PRED(j), stm--) {
+        SWAP(fREAL, data[j], data[k]);
+      }
+#undef PRED
+      stm--;
+    }
+  }
+
+  SWAP(unsigned int, Nx, Ny);
+  SWAP(unsigned int, Mx, My);
+
+  // now columns == transposed rows
+  FHT_rows(data, Ny, Mx, inverse);
+
+  // finalize
+  for (j = 0; j <= (Ny >> 1); j++) {
+    unsigned int jm = (Ny - j) & (Ny - 1);
+    unsigned int ji = j << Mx;
+    unsigned int jmi = jm << Mx;
+    for (i = 0; i <= (Nx >> 1); i++) {
+      unsigned int im = (Nx - i) & (Nx - 1);
+      fREAL A = data[ji + i];
+      fREAL B = data[jmi + i];
+      fREAL C = data[ji + im];
+      fREAL D = data[jmi + im];
+      fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
+      data[ji + i] = A - E;
+      data[jmi + i] = B + E;
+      data[ji + im] = C + E;
+      data[jmi + im] = D - E;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/* 2D convolution calc, d1 *= d2, M/N - > log2 of width/height */
+static void fht_convolve(fREAL *d1, fREAL *d2, unsigned int M, unsigned int N)
+{
+  fREAL a, b;
+  unsigned int i, j, k, L, mj, mL;
+  unsigned int m = 1 << M, n = 1 << N;
+  unsigned int m2 = 1 << (M - 1), n2 = 1 << (N - 1);
+  unsigned int mn2 = m << (N - 1);
+
+  d1[0] *= d2[0];
+  d1[mn2] *= d2[mn2];
+  d1[m2] *= d2[m2];
+  d1[m2 + mn2] *= d2[m2 + mn2];
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    a = d1[i] * d2[i] - d1[k] * d2[k];
+    b = d1[k] * d2[i] + d1[i] * d2[k];
+    d1[i] = (b + a) * (fREAL)0.5;
+    d1[k] = (b - a) * (fREAL)0.5;
+    a = d1[i + mn2] * d2[i + mn2] - d1[k + mn2] * d2[k + mn2];
+    b = d1[k + mn2] * d2[i + mn2] + d1[i + mn2] * d2[k + mn2];
+    d1[i + mn2] = (b + a) * (fREAL)0.5;
+    d1[k + mn2] = (b - a) * (fREAL)0.5;
+  }
+  for (j = 1; j < n2; j++) {
+    L = n - j;
+    mj = j << M;
+    mL = L << M;
+    a = d1[mj] * d2[mj] - d1[mL] * d2[mL];
+    b = d1[mL] * d2[mj] + d1[mj] * d2[mL];
+    d1[mj] = (b + a) * (fREAL)0.5;
+    d1[mL] = (b - a) * (fREAL)0.5;
+    a = d1[m2 + mj] * d2[m2 + mj] - d1[m2 + mL] * d2[m2 + mL];
+    b = d1[m2 + mL] * d2[m2 + mj] + d1[m2 + mj] * d2[m2 + mL];
+    d1[m2 + mj] = (b + a) * (fREAL)0.5;
+    d1[m2 + mL] = (b - a) * (fREAL)0.5;
+  }
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    for (j = 1; j < n2; j++) {
+      L = n - j;
+      mj = j << M;
+      mL = L << M;
+      a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+      b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+      d1[i + mj] = (b + a) * (fREAL)0.5;
+      d1[k + mL] = (b - a) * (fREAL)0.5;
+      a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+      b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+      d1[i + mL] = (b + a) * (fREAL)0.5;
+      d1[k + mj] = (b - a) * (fREAL)0.5;
+    }
+  }
+}
+
+/** \} */
+
+void Convolution::convolveFFT(float *dst,
+                              MemoryBuffer *image,
+                              MemoryBuffer *kernel,
+                              unsigned int num_channels)
+{
+  fREAL *data1, *data2, *fp;
+  const float *colp;
+  unsigned int w2, h2, hw, hh, log2_w, log2_h;
+  int x, y;
+  unsigned int ch;
+  int xbl, ybl, nxb, nyb, xbsz, ybsz;
+  bool in2done = false;
+  const int kernelWidth = kernel->getWidth();
+  const int kernelHeight = kernel->getHeight();
+  const int imageWidth = image->getWidth();
+  const int imageHeight = image->getHeight();
+  const float *kernelBuffer = kernel->getBuffer();
+  const float *imageBuffer = image->getBuffer();
+
+  BLI_assert(image->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+  BLI_assert(kernel->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+  BLI_assert(num_channels <= COM_NUM_CHANNELS_COLOR);
+
+  memset(dst, 0, sizeof(float) * imageWidth * imageHeight * COM_NUM_CHANNELS_COLOR);
+
+  // convolution result width & height
+  w2 = 2 * kernelWidth - 1;
+  h2 = 2 * kernelHeight - 1;
+  // FFT pow2 required size & log2
+  w2 = nextPow2(w2, &log2_w);
+  h2 = nextPow2(h2, &log2_h);
+
+  // alloc space
+  data1 = (fREAL *)MEM_callocN(num_channels * w2 * h2 * sizeof(fREAL), "convolve_fast FHT data1");
+  data2 = (fREAL *)MEM_callocN(w2 * h2 * sizeof(fREAL), "convolve_fast FHT data2");
+
+  // block add-overlap
+  hw = kernelWidth >> 1;
+  hh = kernelHeight >> 1;
+  xbsz = (w2 + 1) - kernelWidth;
+  ybsz = (h2 + 1) - kernelHeight;
+  nxb = imageWidth / xbsz;
+  if (imageWidth % xbsz) {
+    nxb++;
+  }
+  nyb = imageHeight / ybsz;
+  if (imageHeight % ybsz) {
+    nyb++;
+  }
+  for (ybl = 0; ybl < nyb; ybl++) {
+    for (xbl = 0; xbl < nxb; xbl++) {
+
+      // each channel one by one
+      for (ch = 0; ch < num_channels; ch++) {
+        fREAL *data1ch = &data1[ch * w2 * h2];
+
+        // only need to calc fht data from kernel once, can re-use for every block
+        if (!in2done) {
+          // kernel, channel ch -> data1
+          for (y = 0; y < kernelHeight; y++) {
+            fp = &data1ch[y * w2];
+            colp = &kernelBuffer[y * kernelWidth * COM_NUM_CHANNELS_COLOR];
+            for (x = 0; x < kernelWidth; x++) {
+              fp[x] = colp[x * COM_NUM_CHANNELS_COLOR + ch];
+            }
+          }
+        }
+
+        // image, channel ch -> data2
+        memset(data2, 0, w2 * h2 * sizeof(fREAL));
+        for (y = 0; y < ybsz; y++) {
+          int yy = ybl * ybsz + y;
+          if (yy >= imageHeight) {
+            continue;
+          }
+          fp = &data2[y * w2];
+          colp = &imageBuffer[yy * imageWidth * COM_NUM_CHANNELS_COLOR];
+          for (x = 0; x < xbsz; x++) {
+            int xx = xbl * xbsz + x;
+            if (xx >= imageWidth) {
+              continue;
+            }
+            fp[x] = colp[xx * COM_NUM_CHANNELS_COLOR + ch];
+          }
+        }
+
+        // forward FHT
+        // zero pad data starts after the kernel and the image block
+        if (!in2done) {
+          FHT2D(data1ch, log2_w, log2_h, kernelHeight, 0);
+        }
+        FHT2D(data2, log2_w, log2_h, ybsz, 0);
+
+        // FHT2D transposed data, row/col now swapped
+        // convolve & inverse FHT
+        fht_convolve(data2, data1ch, log2_h, log2_w);
+        FHT2D(data2, log2_h, log2_w, 0, 1);
+        // data again transposed, so in order again
+
+        // overlap-add result
+        for (y = 0; y < (int)h2; y++) {
+          const int yy = ybl * ybsz + y - hh;
+          if ((yy < 0) || (yy >= imageHeight)) {
+            continue;
+          }
+          fp = &data2[y * w2];
+          float *dstp = &dst[yy * imageWidth * COM_NUM_CHANNELS_COLOR];
+          for (x = 0; x < (int)w2; x++) {
+            const int xx = xbl * xbsz + x - hw;
+            if ((xx < 0) || (xx >= imageWidth)) {
+              continue;
+            }
+            dstp[xx * COM_NUM_CHANNELS_COLOR + ch] += fp[x];
+          }
+        }
+      }
+      in2done = true;
+    }
+  }
+
+  MEM_freeN(data2);
+  MEM_freeN(data1);
+}
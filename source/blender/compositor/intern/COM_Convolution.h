@@ -0,0 +1,78 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#ifndef __COM_CONVOLUTION_H__
+#define __COM_CONVOLUTION_H__
+
+class MemoryBuffer;
+
+/**
+ * \brief Radius in pixels from which a gaussian blur is calculated with a recursive filter.
+ *
+ * The recursive filter approximates the gaussian with a cost per pixel that does not depend on
+ * the radius, for small radii the direct convolution is both faster and exact.
+ */
+#define COM_CONVOLUTION_IIR_MIN_RADIUS 32
+
+/**
+ * \brief Radius in pixels from which a 2D kernel is convolved with the FFT.
+ */
+#define COM_CONVOLUTION_FFT_MIN_RADIUS 16
+
+/**
+ * \brief Convolutions of whole images, for operations whose kernels are too large to be
+ * evaluated per pixel.
+ *
+ * The work is spread over all threads of the task scheduler, these functions are meant to be
+ * called once per operation, from initializeTileData or a SingleThreadedOperation.
+ * \ingroup Execution
+ */
+class Convolution {
+ public:
+  static bool useIIR(float radius)
+  {
+    return radius >= COM_CONVOLUTION_IIR_MIN_RADIUS;
+  }
+  static bool useFFT(int radius)
+  {
+    return radius >= COM_CONVOLUTION_FFT_MIN_RADIUS;
+  }
+
+  /**
+   * \brief gaussian blur of a channel of the buffer in place, using the recursive filter of
+   * Young and van Vliet.
+   * \param sigma: standard deviation of the gaussian, in pixels
+   * \param xy: 1 to blur horizontally, 2 to blur vertically, 3 for both
+   */
+  static void gaussIIR(MemoryBuffer *buffer, float sigma, unsigned int channel, unsigned int xy);
+
+  /**
+   * \brief convolve the first channels of a color image with a color kernel, using the Fast
+   * Hartley Transform.
+   *
+   * The kernel is centered on its middle pixel and is not normalized. Pixels outside of the
+   * image are zero. The remaining channels of the result are set to zero.
+   * \param dst: color buffer with the size of the image
+   */
+  static void convolveFFT(float *dst,
+                          MemoryBuffer *image,
+                          MemoryBuffer *kernel,
+                          unsigned int num_channels);
+};
+
+#endif
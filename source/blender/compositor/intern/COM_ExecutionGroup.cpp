@@ -46,6 +46,7 @@ ExecutionGroup::ExecutionGroup()
   this->m_isOutput = false;
   this->m_complex = false;
   this->m_chunkExecutionStates = NULL;
+  this->m_cacheKey = 0;
   this->m_bTree = NULL;
   this->m_height = 0;
   this->m_width = 0;
@@ -148,6 +149,24 @@ void ExecutionGroup::initExecution()
   }
   maxNumber++;
   this->m_cachedMaxReadBufferOffset = maxNumber;
+  this->m_cacheKey = 0;
+}
+
+void ExecutionGroup::setChunksExecuted()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
+bool ExecutionGroup::isExecuted() const
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void ExecutionGroup::deinitExecution()
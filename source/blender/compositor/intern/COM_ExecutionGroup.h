@@ -155,6 +155,11 @@ class ExecutionGroup {
    */
   ChunkExecutionState *m_chunkExecutionStates;
 
+  /**
+   * \brief key of the result of this group in the BufferCache, 0 when it is not cached
+   */
+  uint64_t m_cacheKey;
+
   /**
    * \brief indicator when this ExecutionGroup has valid Operations in its vector for Execution
    * \note When building the ExecutionGroup Operations are added via recursion.
@@ -341,6 +346,25 @@ class ExecutionGroup {
    */
   void initExecution();
 
+  void setCacheKey(uint64_t key)
+  {
+    this->m_cacheKey = key;
+  }
+  uint64_t getCacheKey() const
+  {
+    return this->m_cacheKey;
+  }
+
+  /**
+   * \brief mark all chunks as executed, used when the result was restored from the BufferCache
+   */
+  void setChunksExecuted();
+
+  /**
+   * \brief check if all chunks of this group have been executed
+   */
+  bool isExecuted() const;
+
   /**
    * \brief get all inputbuffers needed to calculate an chunk
    * \note all inputbuffers must be executed
@@ -26,6 +26,7 @@ extern "C" {
 
 #include "BLT_translation.h"
 
+#include "COM_BufferCache.h"
 #include "COM_Converter.h"
 #include "COM_NodeOperationBuilder.h"
 #include "COM_NodeOperation.h"
@@ -178,6 +179,8 @@ void ExecutionSystem::execute()
     executionGroup->initExecution();
   }
 
+  BufferCache::restore(this);
+
   WorkScheduler::start(this->m_context);
 
   executeGroups(COM_PRIORITY_HIGH);
@@ -189,6 +192,8 @@ void ExecutionSystem::execute()
   WorkScheduler::finish();
   WorkScheduler::stop();
 
+  BufferCache::store(this);
+
   editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -191,6 +191,8 @@ class ExecutionSystem {
 
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
+  /* allow the BufferCache to restore and store the results of groups */
+  friend class BufferCache;
 
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:ExecutionSystem")
@@ -126,6 +126,18 @@ class NodeOperation : public SocketReader {
    */
   bool m_isResolutionSet;
 
+  /**
+   * \brief hash of the settings of the node this operation was created for
+   * \see BufferCache
+   */
+  uint64_t m_nodeHash;
+
+  /**
+   * \brief can the result of this operation be kept between executions
+   * \see BufferCache
+   */
+  bool m_cacheable;
+
  public:
   virtual ~NodeOperation();
 
@@ -190,6 +202,28 @@ class NodeOperation : public SocketReader {
   {
     this->m_btree = tree;
   }
+
+  void setNodeHash(uint64_t hash, bool cacheable)
+  {
+    this->m_nodeHash = hash;
+    this->m_cacheable = cacheable;
+  }
+  bool isCacheable() const
+  {
+    return this->m_cacheable;
+  }
+
+  /**
+   * \brief hash of all settings that define the result of this operation, apart from its inputs
+   *
+   * Operations that are not created for a node, like constants, need to add their own settings.
+   * \see BufferCache
+   */
+  virtual uint64_t getSettingsHash() const
+  {
+    return this->m_nodeHash;
+  }
+
   virtual void initExecution();
 
   /**
@@ -20,6 +20,7 @@ extern "C" {
 #include "BLI_utildefines.h"
 }
 
+#include "COM_BufferCache.h"
 #include "COM_NodeConverter.h"
 #include "COM_Converter.h"
 #include "COM_Debug.h"
@@ -40,7 +41,12 @@ extern "C" {
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree)
-    : m_context(context), m_current_node(NULL), m_active_viewer(NULL)
+    : m_context(context),
+      m_current_node(NULL),
+      m_current_node_hash(0),
+      m_current_node_cacheable(true),
+      m_current_node_num_operations(0),
+      m_active_viewer(NULL)
 {
   m_graph.from_bNodeTree(*context, b_nodetree);
 }
@@ -58,6 +64,8 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
     Node *node = (Node *)m_graph.nodes()[index];
 
     m_current_node = node;
+    m_current_node_hash = BufferCache::hashNode(node->getbNode(), &m_current_node_cacheable);
+    m_current_node_num_operations = 0;
 
     DebugInfo::node_to_operations(node);
     node->convertToOperations(converter, *m_context);
@@ -127,6 +135,12 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
+  if (m_current_node) {
+    /* operations of the same node are told apart by the order in which they are added */
+    const unsigned int index = m_current_node_num_operations++;
+    operation->setNodeHash(BufferCache::hash(m_current_node_hash, &index, sizeof(index)),
+                           m_current_node_cacheable);
+  }
   m_operations.push_back(operation);
 }
 
@@ -89,6 +89,11 @@ class NodeOperationBuilder {
   OutputSocketMap m_output_map;
 
   Node *m_current_node;
+  /** Hash of the settings of the current node, given to the operations it adds */
+  uint64_t m_current_node_hash;
+  bool m_current_node_cacheable;
+  /** Number of operations the current node added so far */
+  unsigned int m_current_node_num_operations;
 
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
@@ -94,6 +94,23 @@ class SocketReader {
   {
   }
 
+  /**
+   * \brief calculate a row of pixels using nearest sampling
+   * \note this method is called for non-complex. Pointwise operations override it to
+   * avoid the overhead of calculating every pixel through a virtual call.
+   * \param output: array of num pixels of COM_NUM_CHANNELS_COLOR floats each,
+   * only the channels of the output data type are written.
+   * \param x: the x-coordinate of the first pixel to calculate in image space
+   * \param y: the y-coordinate of the row to calculate in image space
+   * \param num: the number of pixels to calculate, at most COM_ROW_SIZE
+   */
+  virtual void executeRow(float *output, int x, int y, int num)
+  {
+    for (int i = 0; i < num; i++) {
+      executePixelSampled(&output[i * COM_NUM_CHANNELS_COLOR], x + i, y, COM_PS_NEAREST);
+    }
+  }
+
  public:
   inline void readSampled(float result[4], float x, float y, PixelSampler sampler)
   {
@@ -107,6 +124,10 @@ class SocketReader {
   {
     executePixelFiltered(result, x, y, dx, dy);
   }
+  inline void readRow(float *result, int x, int y, int num)
+  {
+    executeRow(result, x, y, num);
+  }
 
   virtual void *initializeTileData(rcti * /*rect*/)
   {
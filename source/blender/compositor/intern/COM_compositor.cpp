@@ -26,6 +26,7 @@ extern "C" {
 #include "BKE_scene.h"
 
 #include "COM_compositor.h"
+#include "COM_BufferCache.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_WorkScheduler.h"
 #include "clew.h"
@@ -119,4 +120,30 @@ void COM_deinitialize()
     BLI_mutex_unlock(&s_compositorMutex);
     BLI_mutex_end(&s_compositorMutex);
   }
+  BufferCache::clear();
+}
+
+void COM_clearCaches()
+{
+  BufferCache::clear();
+}
+
+void COM_clearCachesForID(const ID *id)
+{
+  BufferCache::tagID(id);
+}
+
+void COM_freeID(const ID *id)
+{
+  if (id) {
+    BufferCache::removeID(id);
+  }
+  else {
+    BufferCache::removeAllIDs();
+  }
+}
+
+void COM_getCacheStats(int *r_hits, int *r_misses, int *r_num_buffers, size_t *r_memory)
+{
+  BufferCache::getStats(r_hits, r_misses, r_num_buffers, r_memory);
 }
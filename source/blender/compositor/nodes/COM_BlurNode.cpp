@@ -107,7 +107,9 @@ void BlurNode::convertToOperations(NodeConverter &converter,
     GaussianXBlurOperation *operationx = new GaussianXBlurOperation();
     operationx->setData(data);
     operationx->setQuality(quality);
-    operationx->checkOpenCL();
+    if (context.getHasActiveOpenCLDevices()) {
+      operationx->checkOpenCL();
+    }
     operationx->setExtendBounds(extend_bounds);
 
     converter.addOperation(operationx);
@@ -116,7 +118,9 @@ void BlurNode::convertToOperations(NodeConverter &converter,
     GaussianYBlurOperation *operationy = new GaussianYBlurOperation();
     operationy->setData(data);
     operationy->setQuality(quality);
-    operationy->checkOpenCL();
+    if (context.getHasActiveOpenCLDevices()) {
+      operationy->checkOpenCL();
+    }
     operationy->setExtendBounds(extend_bounds);
 
     converter.addOperation(operationy);
@@ -23,6 +23,28 @@ AlphaOverKeyOperation::AlphaOverKeyOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void alpha_over_key(float *output,
+                           const float *inputColor1,
+                           const float *inputOverColor,
+                           float value)
+{
+  if (inputOverColor[3] <= 0.0f) {
+    copy_v4_v4(output, inputColor1);
+  }
+  else if (value == 1.0f && inputOverColor[3] >= 1.0f) {
+    copy_v4_v4(output, inputOverColor);
+  }
+  else {
+    float premul = value * inputOverColor[3];
+    float mul = 1.0f - premul;
+
+    output[0] = (mul * inputColor1[0]) + premul * inputOverColor[0];
+    output[1] = (mul * inputColor1[1]) + premul * inputOverColor[1];
+    output[2] = (mul * inputColor1[2]) + premul * inputOverColor[2];
+    output[3] = (mul * inputColor1[3]) + value * inputOverColor[3];
+  }
+}
+
 void AlphaOverKeyOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -36,19 +58,18 @@ void AlphaOverKeyOperation::executePixelSampled(float output[4],
   this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
   this->m_inputColor2Operation->readSampled(inputOverColor, x, y, sampler);
 
-  if (inputOverColor[3] <= 0.0f) {
-    copy_v4_v4(output, inputColor1);
-  }
-  else if (value[0] == 1.0f && inputOverColor[3] >= 1.0f) {
-    copy_v4_v4(output, inputOverColor);
-  }
-  else {
-    float premul = value[0] * inputOverColor[3];
-    float mul = 1.0f - premul;
+  alpha_over_key(output, inputColor1, inputOverColor, value[0]);
+}
 
-    output[0] = (mul * inputColor1[0]) + premul * inputOverColor[0];
-    output[1] = (mul * inputColor1[1]) + premul * inputOverColor[1];
-    output[2] = (mul * inputColor1[2]) + premul * inputOverColor[2];
-    output[3] = (mul * inputColor1[3]) + value[0] * inputOverColor[3];
+void AlphaOverKeyOperation::executeRow(float *output, int x, int y, int num)
+{
+  float value[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  float inputOverColor[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  readInputRows(value, inputColor1, inputOverColor, x, y, num);
+
+  for (int i = 0; i < num; i++) {
+    const int offset = i * COM_NUM_CHANNELS_COLOR;
+    alpha_over_key(&output[offset], &inputColor1[offset], &inputOverColor[offset], value[offset]);
   }
 }
@@ -23,6 +23,30 @@ AlphaOverMixedOperation::AlphaOverMixedOperation() : MixBaseOperation()
   this->m_x = 0.0f;
 }
 
+static void alpha_over_mixed(float *output,
+                             const float *inputColor1,
+                             const float *inputOverColor,
+                             float value,
+                             float mix)
+{
+  if (inputOverColor[3] <= 0.0f) {
+    copy_v4_v4(output, inputColor1);
+  }
+  else if (value == 1.0f && inputOverColor[3] >= 1.0f) {
+    copy_v4_v4(output, inputOverColor);
+  }
+  else {
+    float addfac = 1.0f - mix + inputOverColor[3] * mix;
+    float premul = value * addfac;
+    float mul = 1.0f - value * inputOverColor[3];
+
+    output[0] = (mul * inputColor1[0]) + premul * inputOverColor[0];
+    output[1] = (mul * inputColor1[1]) + premul * inputOverColor[1];
+    output[2] = (mul * inputColor1[2]) + premul * inputOverColor[2];
+    output[3] = (mul * inputColor1[3]) + value * inputOverColor[3];
+  }
+}
+
 void AlphaOverMixedOperation::executePixelSampled(float output[4],
                                                   float x,
                                                   float y,
@@ -36,20 +60,22 @@ void AlphaOverMixedOperation::executePixelSampled(float output[4],
   this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
   this->m_inputColor2Operation->readSampled(inputOverColor, x, y, sampler);
 
-  if (inputOverColor[3] <= 0.0f) {
-    copy_v4_v4(output, inputColor1);
-  }
-  else if (value[0] == 1.0f && inputOverColor[3] >= 1.0f) {
-    copy_v4_v4(output, inputOverColor);
-  }
-  else {
-    float addfac = 1.0f - this->m_x + inputOverColor[3] * this->m_x;
-    float premul = value[0] * addfac;
-    float mul = 1.0f - value[0] * inputOverColor[3];
+  alpha_over_mixed(output, inputColor1, inputOverColor, value[0], this->m_x);
+}
 
-    output[0] = (mul * inputColor1[0]) + premul * inputOverColor[0];
-    output[1] = (mul * inputColor1[1]) + premul * inputOverColor[1];
-    output[2] = (mul * inputColor1[2]) + premul * inputOverColor[2];
-    output[3] = (mul * inputColor1[3]) + value[0] * inputOverColor[3];
+void AlphaOverMixedOperation::executeRow(float *output, int x, int y, int num)
+{
+  float value[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  float inputOverColor[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  readInputRows(value, inputColor1, inputOverColor, x, y, num);
+
+  for (int i = 0; i < num; i++) {
+    const int offset = i * COM_NUM_CHANNELS_COLOR;
+    alpha_over_mixed(&output[offset],
+                     &inputColor1[offset],
+                     &inputOverColor[offset],
+                     value[offset],
+                     this->m_x);
   }
 }
@@ -23,6 +23,28 @@ AlphaOverPremultiplyOperation::AlphaOverPremultiplyOperation() : MixBaseOperatio
   /* pass */
 }
 
+static void alpha_over_premultiply(float *output,
+                                   const float *inputColor1,
+                                   const float *inputOverColor,
+                                   float value)
+{
+  /* Zero alpha values should still permit an add of RGB data */
+  if (inputOverColor[3] < 0.0f) {
+    copy_v4_v4(output, inputColor1);
+  }
+  else if (value == 1.0f && inputOverColor[3] >= 1.0f) {
+    copy_v4_v4(output, inputOverColor);
+  }
+  else {
+    float mul = 1.0f - value * inputOverColor[3];
+
+    output[0] = (mul * inputColor1[0]) + value * inputOverColor[0];
+    output[1] = (mul * inputColor1[1]) + value * inputOverColor[1];
+    output[2] = (mul * inputColor1[2]) + value * inputOverColor[2];
+    output[3] = (mul * inputColor1[3]) + value * inputOverColor[3];
+  }
+}
+
 void AlphaOverPremultiplyOperation::executePixelSampled(float output[4],
                                                         float x,
                                                         float y,
@@ -37,18 +59,19 @@ void AlphaOverPremultiplyOperation::executePixelSampled(float output[4],
   this->m_inputColor2Operation->readSampled(inputOverColor, x, y, sampler);
 
   /* Zero alpha values should still permit an add of RGB data */
-  if (inputOverColor[3] < 0.0f) {
-    copy_v4_v4(output, inputColor1);
-  }
-  else if (value[0] == 1.0f && inputOverColor[3] >= 1.0f) {
-    copy_v4_v4(output, inputOverColor);
-  }
-  else {
-    float mul = 1.0f - value[0] * inputOverColor[3];
+  alpha_over_premultiply(output, inputColor1, inputOverColor, value[0]);
+}
+
+void AlphaOverPremultiplyOperation::executeRow(float *output, int x, int y, int num)
+{
+  float value[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  float inputOverColor[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+  readInputRows(value, inputColor1, inputOverColor, x, y, num);
 
-    output[0] = (mul * inputColor1[0]) + value[0] * inputOverColor[0];
-    output[1] = (mul * inputColor1[1]) + value[0] * inputOverColor[1];
-    output[2] = (mul * inputColor1[2]) + value[0] * inputOverColor[2];
-    output[3] = (mul * inputColor1[3]) + value[0] * inputOverColor[3];
+  for (int i = 0; i < num; i++) {
+    const int offset = i * COM_NUM_CHANNELS_COLOR;
+    alpha_over_premultiply(
+        &output[offset], &inputColor1[offset], &inputOverColor[offset], value[offset]);
   }
 }
@@ -35,5 +35,6 @@ class AlphaOverPremultiplyOperation : public MixBaseOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 #endif
@@ -18,7 +18,9 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_Convolution.h"
 #include "COM_OpenCLDevice.h"
+#include "MEM_guardedalloc.h"
 
 extern "C" {
 #include "RE_pipeline.h"
@@ -41,6 +43,8 @@ BokehBlurOperation::BokehBlurOperation() : NodeOperation()
   this->m_inputBoundingBoxReader = NULL;
 
   this->m_extend_bounds = false;
+  this->m_useFFT = false;
+  this->m_fftBuffer = NULL;
 }
 
 void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -50,10 +54,90 @@ void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
     updateSize();
   }
   void *buffer = getInputOperation(0)->initializeTileData(NULL);
+  if (this->m_useFFT) {
+    if (this->m_fftBuffer == NULL) {
+      this->m_fftBuffer = createFFTBuffer((MemoryBuffer *)buffer);
+    }
+    buffer = this->m_fftBuffer;
+  }
   unlockMutex();
   return buffer;
 }
 
+MemoryBuffer *BokehBlurOperation::createFFTBuffer(MemoryBuffer *inputBuffer)
+{
+  const float max_dim = max(this->getWidth(), this->getHeight());
+  const int radius = this->m_size * max_dim / 100.0f;
+  const int kernel_size = 2 * radius + 1;
+  const float m = this->m_bokehDimension / radius;
+  float bokeh[4];
+
+  /* The convolution kernel is flipped, entry k is the weight of the pixel at offset radius - k.
+   * Like executePixel, only offsets in [-radius, radius) are used. */
+  rcti kernelRect;
+  BLI_rcti_init(&kernelRect, 0, kernel_size, 0, kernel_size);
+  MemoryBuffer *kernel = new MemoryBuffer(COM_DT_COLOR, &kernelRect);
+  float *kernelBuffer = kernel->getBuffer();
+  for (int ky = 0; ky < kernel_size; ky++) {
+    for (int kx = 0; kx < kernel_size; kx++) {
+      zero_v4(bokeh);
+      if (kx > 0 && ky > 0) {
+        float u = this->m_bokehMidX - (radius - kx) * m;
+        float v = this->m_bokehMidY - (radius - ky) * m;
+        this->m_inputBokehProgram->readSampled(bokeh, u, v, COM_PS_NEAREST);
+      }
+      copy_v4_v4(&kernelBuffer[(ky * kernel_size + kx) * COM_NUM_CHANNELS_COLOR], bokeh);
+    }
+  }
+
+  /* Summed area table of the weights by offset, entry (i, j) is the sum of the weights of the
+   * offsets in [-radius, i - radius) x [-radius, j - radius). */
+  double *table = (double *)MEM_callocN(
+      sizeof(double) * kernel_size * kernel_size * COM_NUM_CHANNELS_COLOR, __func__);
+  for (int j = 1; j < kernel_size; j++) {
+    for (int i = 1; i < kernel_size; i++) {
+      const float *weight =
+          &kernelBuffer[((kernel_size - j) * kernel_size + kernel_size - i) *
+                        COM_NUM_CHANNELS_COLOR];
+      double *entry = &table[(j * kernel_size + i) * COM_NUM_CHANNELS_COLOR];
+      const double *left = entry - COM_NUM_CHANNELS_COLOR;
+      const double *below = entry - kernel_size * COM_NUM_CHANNELS_COLOR;
+      const double *corner = below - COM_NUM_CHANNELS_COLOR;
+      for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+        entry[c] = left[c] + below[c] - corner[c] + weight[c];
+      }
+    }
+  }
+
+  MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, inputBuffer->getRect());
+  float *buffer = result->getBuffer();
+  Convolution::convolveFFT(buffer, inputBuffer, kernel, COM_NUM_CHANNELS_COLOR);
+  delete kernel;
+
+  /* Normalize by the weights of the pixels inside of the input. */
+  const rcti &rect = *inputBuffer->getRect();
+  for (int y = rect.ymin; y < rect.ymax; y++) {
+    const int j0 = max(rect.ymin - y, -radius) + radius;
+    const int j1 = min(rect.ymax - y, radius) + radius;
+    for (int x = rect.xmin; x < rect.xmax; x++) {
+      const int i0 = max(rect.xmin - x, -radius) + radius;
+      const int i1 = min(rect.xmax - x, radius) + radius;
+      const double *t00 = &table[(j0 * kernel_size + i0) * COM_NUM_CHANNELS_COLOR];
+      const double *t01 = &table[(j0 * kernel_size + i1) * COM_NUM_CHANNELS_COLOR];
+      const double *t10 = &table[(j1 * kernel_size + i0) * COM_NUM_CHANNELS_COLOR];
+      const double *t11 = &table[(j1 * kernel_size + i1) * COM_NUM_CHANNELS_COLOR];
+      for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+        const double weight = t11[c] - t10[c] - t01[c] + t00[c];
+        *buffer = (weight > 0.0) ? *buffer / weight : 0.0f;
+        buffer++;
+      }
+    }
+  }
+  MEM_freeN(table);
+
+  return result;
+}
+
 void BokehBlurOperation::initExecution()
 {
   initMutex();
@@ -70,6 +154,12 @@ void BokehBlurOperation::initExecution()
   this->m_bokehMidY = height / 2.0f;
   this->m_bokehDimension = dimension / 2.0f;
   QualityStepHelper::initExecution(COM_QH_INCREASE);
+
+  if (this->m_sizeavailable) {
+    const float max_dim = max(this->getWidth(), this->getHeight());
+    const int pixelSize = this->m_size * max_dim / 100.0f;
+    this->m_useFFT = Convolution::useFFT(pixelSize);
+  }
 }
 
 void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -79,7 +169,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
   float bokeh[4];
 
   this->m_inputBoundingBoxReader->readSampled(tempBoundingBox, x, y, COM_PS_NEAREST);
-  if (tempBoundingBox[0] > 0.0f) {
+  if (tempBoundingBox[0] > 0.0f && this->m_useFFT) {
+    ((MemoryBuffer *)data)->read(output, x, y);
+  }
+  else if (tempBoundingBox[0] > 0.0f) {
     float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
     float *buffer = inputBuffer->getBuffer();
@@ -135,6 +228,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 void BokehBlurOperation::deinitExecution()
 {
   deinitMutex();
+  if (this->m_fftBuffer) {
+    delete this->m_fftBuffer;
+    this->m_fftBuffer = NULL;
+  }
   this->m_inputProgram = NULL;
   this->m_inputBokehProgram = NULL;
   this->m_inputBoundingBoxReader = NULL;
@@ -148,7 +245,14 @@ bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input,
   rcti bokehInput;
   const float max_dim = max(this->getWidth(), this->getHeight());
 
-  if (this->m_sizeavailable) {
+  if (this->m_useFFT) {
+    NodeOperation *operation = getInputOperation(0);
+    newInput.xmax = operation->getWidth();
+    newInput.xmin = 0;
+    newInput.ymax = operation->getHeight();
+    newInput.ymin = 0;
+  }
+  else if (this->m_sizeavailable) {
     newInput.xmax = input->xmax + (this->m_size * max_dim / 100.0f);
     newInput.xmin = input->xmin - (this->m_size * max_dim / 100.0f);
     newInput.ymax = input->ymax + (this->m_size * max_dim / 100.0f);
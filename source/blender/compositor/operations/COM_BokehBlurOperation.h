@@ -34,6 +34,10 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
   float m_bokehMidY;
   float m_bokehDimension;
   bool m_extend_bounds;
+  /** \brief convolve the whole input once with the FFT, for large radii */
+  bool m_useFFT;
+  MemoryBuffer *m_fftBuffer;
+  MemoryBuffer *createFFTBuffer(MemoryBuffer *inputBuffer);
 
  public:
   BokehBlurOperation();
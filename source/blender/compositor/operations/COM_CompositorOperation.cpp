@@ -134,7 +134,7 @@ void CompositorOperation::deinitExecution()
 
 void CompositorOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 {
-  float color[8];  // 7 is enough
+  float row[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
   float *buffer = this->m_outputBuffer;
   float *zbuffer = this->m_depthBuffer;
 
@@ -193,20 +193,24 @@ void CompositorOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 #endif
 
   for (y = y1; y < y2 && (!breaked); y++) {
-    for (x = x1; x < x2 && (!breaked); x++) {
+    for (x = x1; x < x2 && (!breaked); x += COM_ROW_SIZE) {
+      const int num = min(x2 - x, COM_ROW_SIZE);
       int input_x = x + dx, input_y = y + dy;
 
-      this->m_imageInput->readSampled(color, input_x, input_y, COM_PS_NEAREST);
+      this->m_imageInput->readRow(buffer + offset4, input_x, input_y, num);
       if (this->m_useAlphaInput) {
-        this->m_alphaInput->readSampled(&(color[3]), input_x, input_y, COM_PS_NEAREST);
+        this->m_alphaInput->readRow(row, input_x, input_y, num);
+        for (int i = 0; i < num; i++) {
+          buffer[offset4 + i * COM_NUM_CHANNELS_COLOR + 3] = row[i * COM_NUM_CHANNELS_COLOR];
+        }
       }
 
-      copy_v4_v4(buffer + offset4, color);
-
-      this->m_depthInput->readSampled(color, input_x, input_y, COM_PS_NEAREST);
-      zbuffer[offset] = color[0];
-      offset4 += COM_NUM_CHANNELS_COLOR;
-      offset++;
+      this->m_depthInput->readRow(row, input_x, input_y, num);
+      for (int i = 0; i < num; i++) {
+        zbuffer[offset + i] = row[i * COM_NUM_CHANNELS_COLOR];
+      }
+      offset4 += num * COM_NUM_CHANNELS_COLOR;
+      offset += num;
       if (isBraked()) {
         breaked = true;
       }
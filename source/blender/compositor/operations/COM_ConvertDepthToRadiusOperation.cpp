@@ -17,6 +17,7 @@
  */
 
 #include "COM_ConvertDepthToRadiusOperation.h"
+#include "COM_BufferCache.h"
 #include "BLI_math.h"
 #include "BKE_camera.h"
 #include "DNA_camera_types.h"
@@ -44,6 +45,25 @@ float ConvertDepthToRadiusOperation::determineFocalDistance()
   }
 }
 
+uint64_t ConvertDepthToRadiusOperation::getSettingsHash() const
+{
+  uint64_t hash = NodeOperation::getSettingsHash();
+  hash = BufferCache::hash(hash, &this->m_cameraObject, sizeof(this->m_cameraObject));
+
+  if (this->m_cameraObject && this->m_cameraObject->type == OB_CAMERA) {
+    const Camera *camera = (const Camera *)this->m_cameraObject->data;
+    /* Also covers the transform of the camera and the focus object. */
+    const float focal_distance = BKE_camera_object_dof_distance(this->m_cameraObject);
+    hash = BufferCache::hash(hash, &camera->lens, sizeof(camera->lens));
+    hash = BufferCache::hash(hash, &camera->sensor_x, sizeof(camera->sensor_x));
+    hash = BufferCache::hash(hash, &camera->sensor_y, sizeof(camera->sensor_y));
+    hash = BufferCache::hash(hash, &camera->sensor_fit, sizeof(camera->sensor_fit));
+    hash = BufferCache::hash(hash, &focal_distance, sizeof(focal_distance));
+  }
+
+  return hash;
+}
+
 void ConvertDepthToRadiusOperation::initExecution()
 {
   float cam_sensor = DEFAULT_SENSOR_WIDTH;
@@ -80,5 +80,10 @@ class ConvertDepthToRadiusOperation : public NodeOperation {
   {
     this->m_blurPostOperation = operation;
   }
+
+  /**
+   * The camera is read from the scene, add its lens, sensor and focus to the hash.
+   */
+  uint64_t getSettingsHash() const;
 };
 #endif
@@ -56,6 +56,17 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::executeRow(float *output, int x, int y, int num)
+{
+  /* Rows have room for colors, convert in place. */
+  this->m_inputOperation->readRow(output, x, y, num);
+  for (int i = 0; i < num; i++) {
+    float *color = &output[i * COM_NUM_CHANNELS_COLOR];
+    color[1] = color[2] = color[0];
+    color[3] = 1.0f;
+  }
+}
+
 /* ******** Color to Value ******** */
 
 ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperation()
@@ -74,6 +85,15 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4],
   output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::executeRow(float *output, int x, int y, int num)
+{
+  this->m_inputOperation->readRow(output, x, y, num);
+  for (int i = 0; i < num; i++) {
+    const float *color = &output[i * COM_NUM_CHANNELS_COLOR];
+    output[i * COM_NUM_CHANNELS_COLOR] = (color[0] + color[1] + color[2]) / 3.0f;
+  }
+}
+
 /* ******** Color to BW ******** */
 
 ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
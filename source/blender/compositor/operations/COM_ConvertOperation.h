@@ -37,6 +37,7 @@ class ConvertValueToColorOperation : public ConvertBaseOperation {
   ConvertValueToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class ConvertColorToValueOperation : public ConvertBaseOperation {
@@ -44,6 +45,7 @@ class ConvertColorToValueOperation : public ConvertBaseOperation {
   ConvertColorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class ConvertColorToBWOperation : public ConvertBaseOperation {
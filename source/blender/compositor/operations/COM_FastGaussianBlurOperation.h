@@ -35,7 +35,6 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
                                         rcti *output);
   void executePixel(float output[4], int x, int y, void *data);
 
-  static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int channel, unsigned int xy);
   void *initializeTileData(rcti *rect);
   void deinitExecution();
   void initExecution();
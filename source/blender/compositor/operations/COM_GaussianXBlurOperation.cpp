@@ -17,6 +17,7 @@
  */
 
 #include "COM_GaussianXBlurOperation.h"
+#include "COM_Convolution.h"
 #include "COM_OpenCLDevice.h"
 #include "BLI_math.h"
 #include "MEM_guardedalloc.h"
@@ -32,6 +33,8 @@ GaussianXBlurOperation::GaussianXBlurOperation() : BlurBaseOperation(COM_DT_COLO
   this->m_gausstab_sse = NULL;
 #endif
   this->m_filtersize = 0;
+  this->m_useIIR = false;
+  this->m_iirBuffer = NULL;
 }
 
 void *GaussianXBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -41,6 +44,17 @@ void *GaussianXBlurOperation::initializeTileData(rcti * /*rect*/)
     updateGauss();
   }
   void *buffer = getInputOperation(0)->initializeTileData(NULL);
+  if (this->m_useIIR) {
+    if (this->m_iirBuffer == NULL) {
+      MemoryBuffer *copy = ((MemoryBuffer *)buffer)->duplicate();
+      const float sigma = max_ff(m_size * m_data.sizex, 0.0f) / 3.0f;
+      for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+        Convolution::gaussIIR(copy, sigma, c, 1);
+      }
+      this->m_iirBuffer = copy;
+    }
+    buffer = this->m_iirBuffer;
+  }
   unlockMutex();
   return buffer;
 }
@@ -54,6 +68,9 @@ void GaussianXBlurOperation::initExecution()
   if (this->m_sizeavailable) {
     float rad = max_ff(m_size * m_data.sizex, 0.0f);
     m_filtersize = min_ii(ceil(rad), MAX_GAUSSTAB_RADIUS);
+    /* The recursive filter approximates the gaussian, other filter types keep the direct
+     * convolution. */
+    m_useIIR = m_data.filtertype == R_FILTER_GAUSS && Convolution::useIIR(rad) && !isOpenCL();
 
     /* TODO(sergey): De-duplicate with the case below and Y blur. */
     this->m_gausstab = BlurBaseOperation::make_gausstab(rad, m_filtersize);
@@ -79,6 +96,11 @@ void GaussianXBlurOperation::updateGauss()
 
 void GaussianXBlurOperation::executePixel(float output[4], int x, int y, void *data)
 {
+  if (this->m_useIIR) {
+    ((MemoryBuffer *)data)->read(output, x, y);
+    return;
+  }
+
   float ATTR_ALIGN(16) color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
   float multiplier_accum = 0.0f;
   MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
@@ -169,6 +191,10 @@ void GaussianXBlurOperation::deinitExecution()
     this->m_gausstab_sse = NULL;
   }
 #endif
+  if (this->m_iirBuffer) {
+    delete this->m_iirBuffer;
+    this->m_iirBuffer = NULL;
+  }
 
   deinitMutex();
 }
@@ -191,7 +217,7 @@ bool GaussianXBlurOperation::determineDependingAreaOfInterest(rcti *input,
     }
   }
   {
-    if (this->m_sizeavailable && this->m_gausstab != NULL) {
+    if (this->m_sizeavailable && this->m_gausstab != NULL && !this->m_useIIR) {
       newInput.xmax = input->xmax + this->m_filtersize + 1;
       newInput.xmin = input->xmin - this->m_filtersize - 1;
       newInput.ymax = input->ymax;
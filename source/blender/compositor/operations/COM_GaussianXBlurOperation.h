@@ -28,6 +28,9 @@ class GaussianXBlurOperation : public BlurBaseOperation {
   __m128 *m_gausstab_sse;
 #endif
   int m_filtersize;
+  /** \brief blur the whole input once with the recursive gaussian, for large radii */
+  bool m_useIIR;
+  MemoryBuffer *m_iirBuffer;
   void updateGauss();
 
  public:
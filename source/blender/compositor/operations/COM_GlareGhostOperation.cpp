@@ -18,7 +18,7 @@
 
 #include "COM_GlareGhostOperation.h"
 #include "BLI_math.h"
-#include "COM_FastGaussianBlurOperation.h"
+#include "COM_Convolution.h"
 
 static float smoothMask(float x, float y)
 {
@@ -47,15 +47,15 @@ void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, No
 
   bool breaked = false;
 
-  FastGaussianBlurOperation::IIR_gauss(tbuf1, s1, 0, 3);
+  Convolution::gaussIIR(tbuf1, s1, 0, 3);
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(tbuf1, s1, 1, 3);
+    Convolution::gaussIIR(tbuf1, s1, 1, 3);
   }
   if (isBraked()) {
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(tbuf1, s1, 2, 3);
+    Convolution::gaussIIR(tbuf1, s1, 2, 3);
   }
 
   MemoryBuffer *tbuf2 = tbuf1->duplicate();
@@ -64,19 +64,19 @@ void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, No
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(tbuf2, s2, 0, 3);
+    Convolution::gaussIIR(tbuf2, s2, 0, 3);
   }
   if (isBraked()) {
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(tbuf2, s2, 1, 3);
+    Convolution::gaussIIR(tbuf2, s2, 1, 3);
   }
   if (isBraked()) {
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(tbuf2, s2, 2, 3);
+    Convolution::gaussIIR(tbuf2, s2, 2, 3);
   }
 
   ofs = (settings->iter & 1) ? 0.5f : 0.0f;
@@ -72,6 +72,11 @@ void MathBaseOperation::clampIfNeeded(float *color)
   }
 }
 
+static float math_add(float value1, float value2)
+{
+  return value1 + value2;
+}
+
 void MathAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
   float inputValue1[4];
@@ -80,11 +85,21 @@ void MathAddOperation::executePixelSampled(float output[4], float x, float y, Pi
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = inputValue1[0] + inputValue2[0];
+  output[0] = math_add(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathAddOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMath<math_add>(output, x, y, num);
+}
+
+static float math_subtract(float value1, float value2)
+{
+  return value1 - value2;
+}
+
 void MathSubtractOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -96,11 +111,21 @@ void MathSubtractOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = inputValue1[0] - inputValue2[0];
+  output[0] = math_subtract(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathSubtractOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMath<math_subtract>(output, x, y, num);
+}
+
+static float math_multiply(float value1, float value2)
+{
+  return value1 * value2;
+}
+
 void MathMultiplyOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -112,11 +137,22 @@ void MathMultiplyOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = inputValue1[0] * inputValue2[0];
+  output[0] = math_multiply(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathMultiplyOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMath<math_multiply>(output, x, y, num);
+}
+
+static float math_divide(float value1, float value2)
+{
+  /* We don't want to divide by zero. */
+  return (value2 == 0.0f) ? 0.0f : value1 / value2;
+}
+
 void MathDivideOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -128,16 +164,16 @@ void MathDivideOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  if (inputValue2[0] == 0) { /* We don't want to divide by zero. */
-    output[0] = 0.0;
-  }
-  else {
-    output[0] = inputValue1[0] / inputValue2[0];
-  }
+  output[0] = math_divide(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathDivideOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMath<math_divide>(output, x, y, num);
+}
+
 void MathSineOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -341,6 +377,11 @@ void MathLogarithmOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+static float math_minimum(float value1, float value2)
+{
+  return min(value1, value2);
+}
+
 void MathMinimumOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -352,11 +393,21 @@ void MathMinimumOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = min(inputValue1[0], inputValue2[0]);
+  output[0] = math_minimum(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathMinimumOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMath<math_minimum>(output, x, y, num);
+}
+
+static float math_maximum(float value1, float value2)
+{
+  return max(value1, value2);
+}
+
 void MathMaximumOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -368,11 +419,16 @@ void MathMaximumOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = max(inputValue1[0], inputValue2[0]);
+  output[0] = math_maximum(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathMaximumOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMath<math_maximum>(output, x, y, num);
+}
+
 void MathRoundOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
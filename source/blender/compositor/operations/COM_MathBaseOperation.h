@@ -43,6 +43,27 @@ class MathBaseOperation : public NodeOperation {
 
   void clampIfNeeded(float color[4]);
 
+  /**
+   * Calculate a row with a pointwise function of the first two inputs.
+   */
+  template<float (*math_func)(float value1, float value2)>
+  void executeRowMath(float *output, int x, int y, int num)
+  {
+    float value2[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+    this->m_inputValue1Operation->readRow(output, x, y, num);
+    this->m_inputValue2Operation->readRow(value2, x, y, num);
+
+    for (int i = 0; i < num; i++) {
+      const int offset = i * COM_NUM_CHANNELS_COLOR;
+      output[offset] = math_func(output[offset], value2[offset]);
+    }
+    if (this->m_useClamp) {
+      for (int i = 0; i < num; i++) {
+        CLAMP(output[i * COM_NUM_CHANNELS_COLOR], 0.0f, 1.0f);
+      }
+    }
+  }
+
  public:
   /**
    * the inner loop of this program
@@ -76,6 +97,7 @@ class MathAddOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 class MathSubtractOperation : public MathBaseOperation {
  public:
@@ -83,6 +105,7 @@ class MathSubtractOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 class MathMultiplyOperation : public MathBaseOperation {
  public:
@@ -90,6 +113,7 @@ class MathMultiplyOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 class MathDivideOperation : public MathBaseOperation {
  public:
@@ -97,6 +121,7 @@ class MathDivideOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 class MathSineOperation : public MathBaseOperation {
  public:
@@ -183,6 +208,7 @@ class MathMinimumOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 class MathMaximumOperation : public MathBaseOperation {
  public:
@@ -190,6 +216,7 @@ class MathMaximumOperation : public MathBaseOperation {
   {
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 class MathRoundOperation : public MathBaseOperation {
  public:
@@ -65,6 +65,14 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
   output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::readInputRows(
+    float *value, float *color1, float *color2, int x, int y, int num)
+{
+  this->m_inputValueOperation->readRow(value, x, y, num);
+  this->m_inputColor1Operation->readRow(color1, x, y, num);
+  this->m_inputColor2Operation->readRow(color2, x, y, num);
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2],
                                            unsigned int preferredResolution[2])
 {
@@ -104,6 +112,14 @@ MixAddOperation::MixAddOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_add(float *output, const float *color1, const float *color2, float value)
+{
+  output[0] = color1[0] + value * color2[0];
+  output[1] = color1[1] + value * color2[1];
+  output[2] = color1[2] + value * color2[2];
+  output[3] = color1[3];
+}
+
 void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
   float inputColor1[4];
@@ -118,14 +134,16 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  output[0] = inputColor1[0] + value * inputColor2[0];
-  output[1] = inputColor1[1] + value * inputColor2[1];
-  output[2] = inputColor1[2] + value * inputColor2[2];
-  output[3] = inputColor1[3];
+  mix_add(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixAddOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_add>(output, x, y, num);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -133,6 +151,15 @@ MixBlendOperation::MixBlendOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_blend(float *output, const float *color1, const float *color2, float value)
+{
+  float valuem = 1.0f - value;
+  output[0] = valuem * (color1[0]) + value * (color2[0]);
+  output[1] = valuem * (color1[1]) + value * (color2[1]);
+  output[2] = valuem * (color1[2]) + value * (color2[2]);
+  output[3] = color1[3];
+}
+
 void MixBlendOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -141,25 +168,25 @@ void MixBlendOperation::executePixelSampled(float output[4],
   float inputColor1[4];
   float inputColor2[4];
   float inputValue[4];
-  float value;
 
   this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
   this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
   this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-  value = inputValue[0];
 
+  float value = inputValue[0];
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-  output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-  output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_blend(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_blend>(output, x, y, num);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixColorBurnOperation::MixColorBurnOperation() : MixBaseOperation()
@@ -295,6 +322,15 @@ MixDarkenOperation::MixDarkenOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_darken(float *output, const float *color1, const float *color2, float value)
+{
+  float valuem = 1.0f - value;
+  output[0] = min_ff(color1[0], color2[0]) * value + color1[0] * valuem;
+  output[1] = min_ff(color1[1], color2[1]) * value + color1[1] * valuem;
+  output[2] = min_ff(color1[2], color2[2]) * value + color1[2] * valuem;
+  output[3] = color1[3];
+}
+
 void MixDarkenOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -312,15 +348,16 @@ void MixDarkenOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = min_ff(inputColor1[0], inputColor2[0]) * value + inputColor1[0] * valuem;
-  output[1] = min_ff(inputColor1[1], inputColor2[1]) * value + inputColor1[1] * valuem;
-  output[2] = min_ff(inputColor1[2], inputColor2[2]) * value + inputColor1[2] * valuem;
-  output[3] = inputColor1[3];
+  mix_darken(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixDarkenOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_darken>(output, x, y, num);
+}
+
 /* ******** Mix Difference Operation ******** */
 
 MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
@@ -328,6 +365,15 @@ MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_difference(float *output, const float *color1, const float *color2, float value)
+{
+  float valuem = 1.0f - value;
+  output[0] = valuem * color1[0] + value * fabsf(color1[0] - color2[0]);
+  output[1] = valuem * color1[1] + value * fabsf(color1[1] - color2[1]);
+  output[2] = valuem * color1[2] + value * fabsf(color1[2] - color2[2]);
+  output[3] = color1[3];
+}
+
 void MixDifferenceOperation::executePixelSampled(float output[4],
                                                  float x,
                                                  float y,
@@ -345,15 +391,16 @@ void MixDifferenceOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * inputColor1[0] + value * fabsf(inputColor1[0] - inputColor2[0]);
-  output[1] = valuem * inputColor1[1] + value * fabsf(inputColor1[1] - inputColor2[1]);
-  output[2] = valuem * inputColor1[2] + value * fabsf(inputColor1[2] - inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_difference(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixDifferenceOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_difference>(output, x, y, num);
+}
+
 /* ******** Mix Difference Operation ******** */
 
 MixDivideOperation::MixDivideOperation() : MixBaseOperation()
@@ -582,6 +629,14 @@ MixLightenOperation::MixLightenOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_lighten(float *output, const float *color1, const float *color2, float value)
+{
+  output[0] = max_ff(value * color2[0], color1[0]);
+  output[1] = max_ff(value * color2[1], color1[1]);
+  output[2] = max_ff(value * color2[2], color1[2]);
+  output[3] = color1[3];
+}
+
 void MixLightenOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -599,33 +654,16 @@ void MixLightenOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float tmp;
-  tmp = value * inputColor2[0];
-  if (tmp > inputColor1[0]) {
-    output[0] = tmp;
-  }
-  else {
-    output[0] = inputColor1[0];
-  }
-  tmp = value * inputColor2[1];
-  if (tmp > inputColor1[1]) {
-    output[1] = tmp;
-  }
-  else {
-    output[1] = inputColor1[1];
-  }
-  tmp = value * inputColor2[2];
-  if (tmp > inputColor1[2]) {
-    output[2] = tmp;
-  }
-  else {
-    output[2] = inputColor1[2];
-  }
-  output[3] = inputColor1[3];
+  mix_lighten(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixLightenOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_lighten>(output, x, y, num);
+}
+
 /* ******** Mix Linear Light Operation ******** */
 
 MixLinearLightOperation::MixLinearLightOperation() : MixBaseOperation()
@@ -681,6 +719,15 @@ MixMultiplyOperation::MixMultiplyOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_multiply(float *output, const float *color1, const float *color2, float value)
+{
+  float valuem = 1.0f - value;
+  output[0] = color1[0] * (valuem + value * color2[0]);
+  output[1] = color1[1] * (valuem + value * color2[1]);
+  output[2] = color1[2] * (valuem + value * color2[2]);
+  output[3] = color1[3];
+}
+
 void MixMultiplyOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -698,15 +745,16 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = inputColor1[0] * (valuem + value * inputColor2[0]);
-  output[1] = inputColor1[1] * (valuem + value * inputColor2[1]);
-  output[2] = inputColor1[2] * (valuem + value * inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_multiply(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_multiply>(output, x, y, num);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -806,6 +854,15 @@ MixScreenOperation::MixScreenOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_screen(float *output, const float *color1, const float *color2, float value)
+{
+  float valuem = 1.0f - value;
+  output[0] = 1.0f - (valuem + value * (1.0f - color2[0])) * (1.0f - color1[0]);
+  output[1] = 1.0f - (valuem + value * (1.0f - color2[1])) * (1.0f - color1[1]);
+  output[2] = 1.0f - (valuem + value * (1.0f - color2[2])) * (1.0f - color1[2]);
+  output[3] = color1[3];
+}
+
 void MixScreenOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -823,16 +880,16 @@ void MixScreenOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-
-  output[0] = 1.0f - (valuem + value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
-  output[1] = 1.0f - (valuem + value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
-  output[2] = 1.0f - (valuem + value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
-  output[3] = inputColor1[3];
+  mix_screen(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixScreenOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_screen>(output, x, y, num);
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
@@ -886,6 +943,14 @@ MixSubtractOperation::MixSubtractOperation() : MixBaseOperation()
   /* pass */
 }
 
+static void mix_subtract(float *output, const float *color1, const float *color2, float value)
+{
+  output[0] = color1[0] - value * (color2[0]);
+  output[1] = color1[1] - value * (color2[1]);
+  output[2] = color1[2] - value * (color2[2]);
+  output[3] = color1[3];
+}
+
 void MixSubtractOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -903,14 +968,16 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  output[0] = inputColor1[0] - value * (inputColor2[0]);
-  output[1] = inputColor1[1] - value * (inputColor2[1]);
-  output[2] = inputColor1[2] - value * (inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_subtract(output, inputColor1, inputColor2, value);
 
   clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeRow(float *output, int x, int y, int num)
+{
+  executeRowMix<mix_subtract>(output, x, y, num);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
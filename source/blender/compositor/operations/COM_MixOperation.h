@@ -46,6 +46,35 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * Read rows of all inputs for executeRow.
+   */
+  void readInputRows(float *value, float *color1, float *color2, int x, int y, int num);
+
+  /**
+   * Calculate a row with a pointwise mix function, the factor passed to it is already multiplied
+   * by the alpha of the second color if needed.
+   */
+  template<void (*mix_func)(float *output, const float *color1, const float *color2, float value)>
+  void executeRowMix(float *output, int x, int y, int num)
+  {
+    float value[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+    float color1[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+    float color2[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
+    readInputRows(value, color1, color2, x, y, num);
+
+    const bool value_alpha_multiply = useValueAlphaMultiply();
+    for (int i = 0; i < num; i++) {
+      const int offset = i * COM_NUM_CHANNELS_COLOR;
+      float fac = value[offset];
+      if (value_alpha_multiply) {
+        fac *= color2[offset + 3];
+      }
+      mix_func(&output[offset], &color1[offset], &color2[offset], fac);
+      clampIfNeeded(&output[offset]);
+    }
+  }
+
  public:
   /**
    * Default constructor
@@ -87,12 +116,14 @@ class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
@@ -111,12 +142,14 @@ class MixDarkenOperation : public MixBaseOperation {
  public:
   MixDarkenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
  public:
   MixDifferenceOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixDivideOperation : public MixBaseOperation {
@@ -147,6 +180,7 @@ class MixLightenOperation : public MixBaseOperation {
  public:
   MixLightenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
@@ -159,6 +193,7 @@ class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -177,6 +212,7 @@ class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -189,6 +225,7 @@ class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 };
 
 class MixValueOperation : public MixBaseOperation {
@@ -74,6 +74,22 @@ void ReadBufferOperation::executePixelSampled(float output[4],
   }
 }
 
+void ReadBufferOperation::executeRow(float *output, int x, int y, int num)
+{
+  if (m_single_value) {
+    /* write buffer has a single value stored at (0,0) */
+    m_buffer->read(output, 0, 0);
+    for (int i = 1; i < num; i++) {
+      copy_v4_v4(&output[i * COM_NUM_CHANNELS_COLOR], output);
+    }
+  }
+  else {
+    for (int i = 0; i < num; i++) {
+      m_buffer->read(&output[i * COM_NUM_CHANNELS_COLOR], x + i, y);
+    }
+  }
+}
+
 void ReadBufferOperation::executePixelExtend(float output[4],
                                              float x,
                                              float y,
@@ -17,6 +17,7 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_BufferCache.h"
 
 SetColorOperation::SetColorOperation() : NodeOperation()
 {
@@ -31,9 +32,21 @@ void SetColorOperation::executePixelSampled(float output[4],
   copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeRow(float *output, int /*x*/, int /*y*/, int num)
+{
+  for (int i = 0; i < num; i++) {
+    copy_v4_v4(&output[i * COM_NUM_CHANNELS_COLOR], this->m_color);
+  }
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
   resolution[0] = preferredResolution[0];
   resolution[1] = preferredResolution[1];
 }
+
+uint64_t SetColorOperation::getSettingsHash() const
+{
+  return BufferCache::hash(NodeOperation::getSettingsHash(), this->m_color, sizeof(this->m_color));
+}
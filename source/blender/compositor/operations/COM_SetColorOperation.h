@@ -75,8 +75,10 @@ class SetColorOperation : public NodeOperation {
    * the inner loop of this program
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num);
 
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
+  uint64_t getSettingsHash() const;
   bool isSetOperation() const
   {
     return true;
@@ -17,6 +17,7 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_BufferCache.h"
 
 SetValueOperation::SetValueOperation() : NodeOperation()
 {
@@ -31,9 +32,22 @@ void SetValueOperation::executePixelSampled(float output[4],
   output[0] = this->m_value;
 }
 
+void SetValueOperation::executeRow(float *output, int /*x*/, int /*y*/, int num)
+{
+  for (int i = 0; i < num; i++) {
+    output[i * COM_NUM_CHANNELS_COLOR] = this->m_value;
+  }
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
   resolution[0] = preferredResolution[0];
   resolution[1] = preferredResolution[1];
 }
+
+uint64_t SetValueOperation::getSettingsHash() const
+{
+  return BufferCache::hash(
+      NodeOperation::getSettingsHash(), &this->m_value, sizeof(this->m_value));
+}
@@ -17,6 +17,7 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_BufferCache.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation() : NodeOperation()
@@ -40,3 +41,9 @@ void SetVectorOperation::determineResolution(unsigned int resolution[2],
   resolution[0] = preferredResolution[0];
   resolution[1] = preferredResolution[1];
 }
+
+uint64_t SetVectorOperation::getSettingsHash() const
+{
+  const float vector[4] = {this->m_x, this->m_y, this->m_z, this->m_w};
+  return BufferCache::hash(NodeOperation::getSettingsHash(), vector, sizeof(vector));
+}
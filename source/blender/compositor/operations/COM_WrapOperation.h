@@ -31,6 +31,11 @@ class WrapOperation : public ReadBufferOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int num)
+  {
+    /* Wrapped coordinates are not contiguous, read pixel by pixel. */
+    SocketReader::executeRow(output, x, y, num);
+  }
 
   void setWrapping(int wrapping_type);
   float getWrappedOriginalXPos(float x);
@@ -94,11 +94,24 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     int x;
     int y;
     bool breaked = false;
+    float row[COM_ROW_SIZE * COM_NUM_CHANNELS_COLOR];
     for (y = y1; y < y2 && (!breaked); y++) {
       int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-      for (x = x1; x < x2; x++) {
-        this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-        offset4 += num_channels;
+      for (x = x1; x < x2; x += COM_ROW_SIZE) {
+        const int num = min(x2 - x, COM_ROW_SIZE);
+        if (num_channels == COM_NUM_CHANNELS_COLOR) {
+          /* Rows have the same layout as color buffers. */
+          this->m_input->readRow(&(buffer[offset4]), x, y, num);
+        }
+        else {
+          this->m_input->readRow(row, x, y, num);
+          for (int i = 0; i < num; i++) {
+            memcpy(&(buffer[offset4 + i * num_channels]),
+                   &(row[i * COM_NUM_CHANNELS_COLOR]),
+                   sizeof(float) * num_channels);
+          }
+        }
+        offset4 += num * num_channels;
       }
       if (isBraked()) {
         breaked = true;
@@ -63,6 +63,10 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* Trace of operations evaluated by each thread during the last graph evaluation, in the trace
+ * event format of chrome://tracing. Only available with time debugging enabled. */
+void DEG_debug_eval_trace(const struct Depsgraph *graph, FILE *stream);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
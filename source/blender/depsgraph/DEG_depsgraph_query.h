@@ -79,6 +79,12 @@ void DEG_get_customdata_mask_for_object(const struct Depsgraph *graph,
                                         struct Object *object,
                                         struct CustomData_MeshMasks *r_mask);
 
+/* Check whether other IDs depend on the given component of the ID,
+ * for example modifiers or constraints of other objects reading its geometry. */
+bool DEG_id_component_has_other_users(const struct Depsgraph *graph,
+                                      struct ID *id,
+                                      eDepsObjectComponentType component_type);
+
 /* Get scene at its evaluated state.
  *
  * Technically, this is a copied-on-written and fully evaluated version of the input scene.
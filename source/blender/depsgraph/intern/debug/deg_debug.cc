@@ -35,7 +35,12 @@
 namespace DEG {
 
 DepsgraphDebug::DepsgraphDebug()
-    : flags(G.debug), is_ever_evaluated(false), graph_evaluation_start_time_(0)
+    : flags(G.debug),
+      is_ever_evaluated(false),
+      graph_evaluation_start_time_(0),
+      num_threads_(0),
+      busy_factor_(0.0),
+      critical_path_time_(0.0)
 {
 }
 
@@ -57,6 +62,7 @@ void DepsgraphDebug::begin_graph_evaluation()
   }
 
   graph_evaluation_start_time_ = current_time;
+  num_threads_ = 0;
 }
 
 void DepsgraphDebug::end_graph_evaluation()
@@ -67,11 +73,26 @@ void DepsgraphDebug::end_graph_evaluation()
 
   const double graph_eval_end_time = PIL_check_seconds_timer();
   printf("Depsgraph updated in %f seconds.\n", graph_eval_end_time - graph_evaluation_start_time_);
+  if (num_threads_ != 0) {
+    printf("Depsgraph threads %.1f%% busy on %d threads, estimated critical path %f seconds.\n",
+           100.0 * busy_factor_,
+           num_threads_,
+           critical_path_time_);
+  }
   printf("Depsgraph evaluation FPS: %f\n", 1.0f / fps_samples_.get_averaged());
 
   is_ever_evaluated = true;
 }
 
+void DepsgraphDebug::set_occupancy(int num_threads,
+                                   double busy_factor,
+                                   double critical_path_time)
+{
+  num_threads_ = num_threads;
+  busy_factor_ = busy_factor;
+  critical_path_time_ = critical_path_time;
+}
+
 bool terminal_do_color(void)
 {
   return (G.debug & G_DEBUG_DEPSGRAPH_PRETTY) != 0;
@@ -41,6 +41,9 @@ class DepsgraphDebug {
   void begin_graph_evaluation();
   void end_graph_evaluation();
 
+  /* Thread occupancy of the current evaluation, printed with its timing. */
+  void set_occupancy(int num_threads, double busy_factor, double critical_path_time);
+
   /* NOTE: Corresponds to G_DEBUG_DEPSGRAPH_* flags. */
   int flags;
 
@@ -62,6 +65,11 @@ class DepsgraphDebug {
   double graph_evaluation_start_time_;
 
   AveragedTimeSampler<MAX_FPS_COUNTERS> fps_samples_;
+
+  /* Occupancy of the current evaluation, num_threads_ is 0 when it is not known. */
+  int num_threads_;
+  double busy_factor_;
+  double critical_path_time_;
 };
 
 #define DEG_DEBUG_PRINTF(depsgraph, type, ...) \
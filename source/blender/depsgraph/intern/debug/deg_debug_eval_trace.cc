@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Trace of the last graph evaluation, in the trace event format which can be
+ * viewed in chrome://tracing, showing which operation each thread was busy with.
+ */
+
+#include "DEG_depsgraph_debug.h"
+
+#include "BLI_utildefines.h"
+
+#include "intern/depsgraph.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+extern "C" {
+#include "BLI_trace.h"
+
+#include "DNA_ID.h"
+} /* extern "C" */
+
+namespace DEG {
+namespace {
+
+void deg_debug_eval_trace(FILE *f, const Depsgraph *graph)
+{
+  double start_time = 0.0;
+  bool has_evaluated = false;
+  for (const OperationNode *op_node : graph->operations) {
+    if (!op_node->scheduled || op_node->is_noop()) {
+      continue;
+    }
+    if (!has_evaluated || op_node->trace_start_time < start_time) {
+      start_time = op_node->trace_start_time;
+      has_evaluated = true;
+    }
+  }
+
+  TraceWriter writer;
+  BLI_trace_writer_begin(&writer, f);
+  for (const OperationNode *op_node : graph->operations) {
+    if (!op_node->scheduled || op_node->is_noop()) {
+      continue;
+    }
+    const IDNode *id_node = op_node->owner->owner;
+    BLI_trace_writer_event(&writer,
+                           id_node->id_orig->name,
+                           op_node->full_identifier().c_str(),
+                           op_node->trace_thread_id,
+                           op_node->trace_start_time - start_time,
+                           op_node->stats.current_time,
+                           "critical_path",
+                           op_node->critical_path_time * 1e6);
+  }
+  BLI_trace_writer_end(&writer);
+}
+
+}  // namespace
+}  // namespace DEG
+
+void DEG_debug_eval_trace(const Depsgraph *depsgraph, FILE *f)
+{
+  if (depsgraph == nullptr) {
+    return;
+  }
+  DEG::deg_debug_eval_trace(f, (const DEG::Depsgraph *)depsgraph);
+}
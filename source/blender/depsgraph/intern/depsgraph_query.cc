@@ -48,8 +48,11 @@ extern "C" {
 #include "DEG_depsgraph_query.h"
 
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 #include "intern/eval/deg_eval_copy_on_write.h"
+#include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
 
 struct Scene *DEG_get_input_scene(const Depsgraph *graph)
 {
@@ -149,6 +152,37 @@ void DEG_get_customdata_mask_for_object(const Depsgraph *graph,
   r_mask->pmask |= id_node->customdata_masks.poly_mask;
 }
 
+bool DEG_id_component_has_other_users(const Depsgraph *graph,
+                                      ID *id,
+                                      eDepsObjectComponentType component_type)
+{
+  if (graph == nullptr) {
+    return false;
+  }
+
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+  const DEG::IDNode *id_node = deg_graph->find_id_node(DEG_get_original_id(id));
+  if (id_node == nullptr) {
+    return false;
+  }
+  const DEG::ComponentNode *comp_node = id_node->find_component(
+      DEG::nodeTypeFromObjectComponent(component_type));
+  if (comp_node == nullptr) {
+    return false;
+  }
+
+  /* Relations are only read here, so this is safe to call during evaluation. */
+  for (DEG::OperationNode *op_node : comp_node->operations) {
+    for (DEG::Relation *rel : op_node->outlinks) {
+      const DEG::OperationNode *to_node = reinterpret_cast<DEG::OperationNode *>(rel->to);
+      if (to_node->owner->owner != id_node) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 Scene *DEG_get_evaluated_scene(const Depsgraph *graph)
 {
   const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
@@ -25,6 +25,8 @@
 
 #include "intern/eval/deg_eval.h"
 
+#include <algorithm>
+
 #include "PIL_time.h"
 
 #include "BLI_compiler_attrs.h"
@@ -32,6 +34,8 @@
 #include "BLI_task.h"
 #include "BLI_ghash.h"
 #include "BLI_gsqueue.h"
+#include "BLI_math_base.h"
+#include "BLI_trace.h"
 
 #include "BKE_global.h"
 
@@ -75,6 +79,42 @@ void schedule_node_to_pool(OperationNode *node, const int thread_id, TaskPool *p
       pool, deg_task_run_func, node, false, TASK_PRIORITY_HIGH, thread_id);
 }
 
+void schedule_node_to_ready_list(OperationNode *node,
+                                 const int /*thread_id*/,
+                                 vector<OperationNode *> *ready_nodes)
+{
+  ready_nodes->push_back(node);
+}
+
+bool critical_path_comparator(const OperationNode *a, const OperationNode *b)
+{
+  return a->critical_path_time > b->critical_path_time;
+}
+
+/* Push operations which became ready to the pool, so that the ones with the longest chain of
+ * operations depending on them are picked up first.
+ *
+ * From a task, the first pushed operation is run next by the same thread, and all others go to
+ * the head of its queue in the reverse order of pushing. Pushes from outside of the pool go to
+ * the suspended queue, which is distributed over the threads in the reverse order of pushing. */
+void schedule_ready_nodes_to_pool(vector<OperationNode *> *ready_nodes,
+                                  const int thread_id,
+                                  TaskPool *pool)
+{
+  if (ready_nodes->empty()) {
+    return;
+  }
+  std::stable_sort(ready_nodes->begin(), ready_nodes->end(), critical_path_comparator);
+  int num_ready_nodes = ready_nodes->size();
+  if (thread_id != -1) {
+    schedule_node_to_pool((*ready_nodes)[0], thread_id, pool);
+  }
+  for (int i = num_ready_nodes - 1; i >= ((thread_id != -1) ? 1 : 0); i--) {
+    schedule_node_to_pool((*ready_nodes)[i], thread_id, pool);
+  }
+  ready_nodes->clear();
+}
+
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
   /* Stage 1: Only  Copy-on-Write operations are to be evaluated, prior to anything else.
@@ -97,22 +137,31 @@ struct DepsgraphEvalState {
   bool do_stats;
   EvaluationStage stage;
   bool need_single_thread_pass;
+  /* Operations which became ready for evaluation, per thread. */
+  vector<vector<OperationNode *>> thread_ready_nodes;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+void evaluate_node(const DepsgraphEvalState *state,
+                   OperationNode *operation_node,
+                   const int thread_id)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
-  if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+  /* Perform operation. Always timed, as the time is used to estimate the cost of the operation
+   * for scheduling. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double end_time = PIL_check_seconds_timer();
+  operation_node->stats.current_time += end_time - start_time;
+  if (BLI_trace_is_enabled()) {
+    BLI_trace_event(
+        "depsgraph", operation_node->full_identifier().c_str(), start_time, end_time);
   }
-  else {
-    operation_node->evaluate(depsgraph);
+  if (state->do_stats) {
+    operation_node->trace_start_time = start_time;
+    operation_node->trace_thread_id = thread_id;
   }
 }
 
@@ -123,11 +172,13 @@ void deg_task_run_func(TaskPool *pool, void *taskdata, int thread_id)
 
   /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  evaluate_node(state, operation_node, thread_id);
 
   /* Schedule children. */
+  vector<OperationNode *> *ready_nodes = &state->thread_ready_nodes[thread_id];
+  schedule_children(state, operation_node, thread_id, schedule_node_to_ready_list, ready_nodes);
   BLI_task_pool_delayed_push_begin(pool, thread_id);
-  schedule_children(state, operation_node, thread_id, schedule_node_to_pool, pool);
+  schedule_ready_nodes_to_pool(ready_nodes, thread_id, pool);
   BLI_task_pool_delayed_push_end(pool, thread_id);
 }
 
@@ -181,18 +232,90 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
-void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
+bool need_evaluate_operation(OperationNode *node)
+{
+  return check_operation_node_visible(node) && (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) != 0;
+}
+
+/* Estimated time of evaluating the operation, from the timings of previous evaluations. */
+double operation_cost_estimate(const OperationNode *node)
+{
+  if (node->is_noop()) {
+    return 0.0;
+  }
+  /* Operations which were not evaluated yet still count, so that longer chains of operations
+   * are preferred when there are no timings at all. */
+  const double min_cost = 1e-6;
+  return max_dd(node->stats.average_time, min_cost);
+}
+
+enum {
+  CRITICAL_PATH_UNKNOWN = 0,
+  CRITICAL_PATH_IN_PROGRESS = 1,
+  CRITICAL_PATH_DONE = 2,
+};
+
+/* Calculate critical path time of all operations which are to be evaluated, with an iterative
+ * depth first traversal, as chains of operations can be too long for recursion. */
+void calculate_critical_path(Depsgraph *graph)
 {
-  const bool do_stats = state->do_stats;
-  calculate_pending_parents(graph);
-  /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
-    if (do_stats) {
-      node->stats.reset_current();
+    node->custom_flags = CRITICAL_PATH_UNKNOWN;
+    node->critical_path_time = 0.0;
+  }
+  /* Operations on the current path, with the index of the next outgoing relation to visit. */
+  vector<std::pair<OperationNode *, int>> stack;
+  for (OperationNode *root : graph->operations) {
+    if (root->custom_flags != CRITICAL_PATH_UNKNOWN || !need_evaluate_operation(root)) {
+      continue;
+    }
+    root->custom_flags = CRITICAL_PATH_IN_PROGRESS;
+    stack.push_back(std::make_pair(root, 0));
+    while (!stack.empty()) {
+      OperationNode *node = stack.back().first;
+      const int num_outlinks = node->outlinks.size();
+      int &rel_index = stack.back().second;
+      OperationNode *next_node = nullptr;
+      for (; rel_index < num_outlinks; rel_index++) {
+        Relation *rel = node->outlinks[rel_index];
+        OperationNode *child = (OperationNode *)rel->to;
+        if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 &&
+            child->custom_flags == CRITICAL_PATH_UNKNOWN && need_evaluate_operation(child)) {
+          next_node = child;
+          break;
+        }
+      }
+      if (next_node != nullptr) {
+        next_node->custom_flags = CRITICAL_PATH_IN_PROGRESS;
+        stack.push_back(std::make_pair(next_node, 0));
+        continue;
+      }
+      /* All children are done, or are on the current path in case of a dependency cycle. */
+      double children_time = 0.0;
+      for (Relation *rel : node->outlinks) {
+        OperationNode *child = (OperationNode *)rel->to;
+        if (child->custom_flags == CRITICAL_PATH_DONE) {
+          children_time = max_dd(children_time, child->critical_path_time);
+        }
+      }
+      node->critical_path_time = operation_cost_estimate(node) + children_time;
+      node->custom_flags = CRITICAL_PATH_DONE;
+      stack.pop_back();
     }
   }
 }
 
+void initialize_execution(Depsgraph *graph)
+{
+  calculate_pending_parents(graph);
+  calculate_critical_path(graph);
+  /* Clear tags and other things which needs to be clear. Operations are always timed, for the
+   * cost estimates used by scheduling. */
+  for (OperationNode *node : graph->operations) {
+    node->stats.reset_current();
+  }
+}
+
 bool is_metaball_object_operation(const OperationNode *operation_node)
 {
   const ComponentNode *component_node = operation_node->owner;
@@ -290,6 +413,13 @@ void schedule_graph(DepsgraphEvalState *state,
   }
 }
 
+void schedule_graph_to_pool(DepsgraphEvalState *state, TaskPool *pool)
+{
+  vector<OperationNode *> ready_nodes;
+  schedule_graph(state, schedule_node_to_ready_list, &ready_nodes);
+  schedule_ready_nodes_to_pool(&ready_nodes, -1, pool);
+}
+
 template<typename ScheduleFunction, typename... ScheduleFunctionArgs>
 void schedule_children(DepsgraphEvalState *state,
                        OperationNode *node,
@@ -329,7 +459,7 @@ void evaluate_graph_single_threaded(DepsgraphEvalState *state)
     OperationNode *operation_node;
     BLI_gsqueue_pop(evaluation_queue, &operation_node);
 
-    evaluate_node(state, operation_node);
+    evaluate_node(state, operation_node, 0);
     schedule_children(state, operation_node, 0, schedule_node_to_queue, evaluation_queue);
   }
 
@@ -386,20 +516,22 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     task_scheduler = BLI_task_scheduler_get();
     need_free_scheduler = false;
   }
+  const int num_threads = BLI_task_scheduler_num_threads(task_scheduler);
+  state.thread_ready_nodes.resize(num_threads);
   TaskPool *task_pool = BLI_task_pool_create_suspended(task_scheduler, &state);
   /* Prepare all nodes for evaluation. */
-  initialize_execution(&state, graph);
+  initialize_execution(graph);
 
   /* Do actual evaluation now. */
 
   /* First, process all Copy-On-Write nodes. */
   state.stage = EvaluationStage::COPY_ON_WRITE;
-  schedule_graph(&state, schedule_node_to_pool, task_pool);
+  schedule_graph_to_pool(&state, task_pool);
   BLI_task_pool_work_wait_and_reset(task_pool);
 
   /* After that, process all other nodes. */
   state.stage = EvaluationStage::THREADED_EVALUATION;
-  schedule_graph(&state, schedule_node_to_pool, task_pool);
+  schedule_graph_to_pool(&state, task_pool);
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
 
@@ -411,8 +543,10 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
+  deg_eval_stats_update_average(graph);
   if (state.do_stats) {
     deg_eval_stats_aggregate(graph);
+    deg_eval_stats_occupancy(graph, num_threads);
   }
   /* Clear any uncleared tags - just in case. */
   deg_graph_clear_tags(graph);
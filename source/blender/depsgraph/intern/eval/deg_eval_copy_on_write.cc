@@ -39,6 +39,9 @@
 #include "BLI_listbase.h"
 #include "BLI_threads.h"
 #include "BLI_string.h"
+#include "BLI_trace.h"
+
+#include "PIL_time.h"
 
 #include "BKE_curve.h"
 #include "BKE_global.h"
@@ -286,8 +289,12 @@ bool id_copy_inplace_no_main(const ID *id, ID *newid)
   id_for_copy = nested_id_hack_get_discarded_pointers(&id_hack_storage, id);
 #endif
 
-  bool result = BKE_id_copy_ex(
-      nullptr, (ID *)id_for_copy, &newid, (LIB_ID_COPY_LOCALIZE | LIB_ID_CREATE_NO_ALLOCATE));
+  /* Geometry arrays are shared with the original until either side writes to them. */
+  bool result = BKE_id_copy_ex(nullptr,
+                               (ID *)id_for_copy,
+                               &newid,
+                               (LIB_ID_COPY_LOCALIZE | LIB_ID_CREATE_NO_ALLOCATE |
+                                LIB_ID_COPY_CD_SHARE));
 
 #ifdef NESTED_ID_NASTY_WORKAROUND
   if (result) {
@@ -938,11 +945,16 @@ ID *deg_update_copy_on_write_datablock(const Depsgraph *depsgraph, const IDNode
   if (!deg_copy_on_write_is_needed(id_orig)) {
     return id_cow;
   }
+  const bool do_trace = BLI_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
   RuntimeBackup backup(depsgraph);
   backup.init_from_id(id_cow);
   deg_free_copy_on_write_datablock(id_cow);
   deg_expand_copy_on_write_datablock(depsgraph, id_node);
   backup.restore_to_id(id_cow);
+  if (do_trace) {
+    BLI_trace_event("copy-on-write", id_orig->name, start_time, PIL_check_seconds_timer());
+  }
   return id_cow;
 }
 
@@ -35,7 +35,7 @@
 namespace DEG {
 
 ObjectRuntimeBackup::ObjectRuntimeBackup(const Depsgraph * /*depsgraph*/)
-    : base_flag(0), base_local_view_bits(0)
+    : base_flag(0), base_local_view_bits(0), transflag_runtime(0)
 {
   /* TODO(sergey): Use something like BKE_object_runtime_reset(). */
   memset(&runtime, 0, sizeof(runtime));
@@ -58,6 +58,8 @@ void ObjectRuntimeBackup::init_from_object(Object *object)
   /* Make a backup of base flags. */
   base_flag = object->base_flag;
   base_local_view_bits = object->base_local_view_bits;
+  /* Copy-on-write copies transflag from the original, which does not always have these. */
+  transflag_runtime = object->transflag & OB_DUPLIMESH;
   /* Backup tuntime data of all modifiers. */
   backup_modifier_runtime_data(object);
   /* Backup runtime data of all pose channels. */
@@ -129,6 +131,11 @@ void ObjectRuntimeBackup::restore_to_object(Object *object)
   }
   object->base_flag = base_flag;
   object->base_local_view_bits = base_local_view_bits;
+  /* The bits go together with the evaluated mesh, which is freed above when it is invalid. */
+  object->transflag &= ~OB_DUPLIMESH;
+  if (object->runtime.mesh_eval != nullptr) {
+    object->transflag |= transflag_runtime;
+  }
   /* Restore modifier's runtime data.
    * NOTE: Data of unused modifiers will be freed there. */
   restore_modifier_runtime_data(object);
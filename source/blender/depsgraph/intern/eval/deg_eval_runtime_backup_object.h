@@ -52,6 +52,8 @@ class ObjectRuntimeBackup {
   Object_Runtime runtime;
   short base_flag;
   unsigned short base_local_view_bits;
+  /* Runtime bits of transflag describing the evaluated data, like #OB_DUPLIMESH. */
+  short transflag_runtime;
   ModifierRuntimeDataBackup modifier_runtime_data;
   PoseChannelRuntimeDataBackup pose_channel_runtime_data;
 };
@@ -25,6 +25,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_math_base.h"
 
 #include "intern/depsgraph.h"
 
@@ -56,4 +57,50 @@ void deg_eval_stats_aggregate(Depsgraph *graph)
   }
 }
 
+void deg_eval_stats_update_average(Depsgraph *graph)
+{
+  /* Weight of the latest evaluation, small enough to smooth out spikes, but large enough to
+   * follow changes in the scene within a few frames. */
+  const double weight = 0.25;
+  for (OperationNode *op_node : graph->operations) {
+    if (!op_node->scheduled || op_node->is_noop()) {
+      continue;
+    }
+    Node::Stats &stats = op_node->stats;
+    if (stats.average_time == 0.0) {
+      stats.average_time = stats.current_time;
+    }
+    else {
+      stats.average_time += (stats.current_time - stats.average_time) * weight;
+    }
+  }
+}
+
+void deg_eval_stats_occupancy(Depsgraph *graph, int num_threads)
+{
+  double busy_time = 0.0;
+  double start_time = 0.0, end_time = 0.0, critical_path_time = 0.0;
+  bool has_evaluated = false;
+  for (const OperationNode *op_node : graph->operations) {
+    if (!op_node->scheduled || op_node->is_noop()) {
+      continue;
+    }
+    const double op_end_time = op_node->trace_start_time + op_node->stats.current_time;
+    if (!has_evaluated) {
+      start_time = op_node->trace_start_time;
+      end_time = op_end_time;
+      has_evaluated = true;
+    }
+    start_time = min_dd(start_time, op_node->trace_start_time);
+    end_time = max_dd(end_time, op_end_time);
+    critical_path_time = max_dd(critical_path_time, op_node->critical_path_time);
+    busy_time += op_node->stats.current_time;
+  }
+  if (!has_evaluated || end_time <= start_time) {
+    return;
+  }
+  const double wall_time = end_time - start_time;
+  graph->debug.set_occupancy(num_threads, busy_time / (wall_time * num_threads), critical_path_time);
+}
+
 }  // namespace DEG
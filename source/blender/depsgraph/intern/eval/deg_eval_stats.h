@@ -30,4 +30,12 @@ struct Depsgraph;
 /* Aggregate operation timings to overall component and ID nodes timing. */
 void deg_eval_stats_aggregate(Depsgraph *graph);
 
+/* Accumulate timings of evaluated operations into their average time, which is used as an
+ * estimate of their cost for scheduling. */
+void deg_eval_stats_update_average(Depsgraph *graph);
+
+/* Measure how busy the threads were during the last graph evaluation, for the timing report
+ * printed at the end of the evaluation. */
+void deg_eval_stats_occupancy(Depsgraph *graph, int num_threads);
+
 }  // namespace DEG
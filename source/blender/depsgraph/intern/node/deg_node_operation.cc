@@ -196,7 +196,8 @@ const char *operationCodeAsString(OperationCode opcode)
   return "UNKNOWN";
 }
 
-OperationNode::OperationNode() : name_tag(-1), flag(0)
+OperationNode::OperationNode()
+    : critical_path_time(0.0), trace_start_time(0.0), trace_thread_id(0), name_tag(-1), flag(0)
 {
 }
 
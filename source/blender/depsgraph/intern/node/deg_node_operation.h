@@ -252,6 +252,14 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Estimated time needed to evaluate this operation and the longest chain of operations
+   * depending on it. Operations with the longest remaining chain are scheduled first. */
+  double critical_path_time;
+
+  /* Start time and thread of the last evaluation, only filled in with time debugging. */
+  double trace_start_time;
+  int trace_thread_id;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
@@ -223,6 +223,9 @@ typedef struct MeshBatchCache {
   int vert_len;
   int mat_len;
   bool is_dirty; /* Instantly invalidates cache, skipping mesh check */
+  bool is_deform_dirty; /* Only positions changed, see #mesh_buffer_cache_update_deform. */
+  /* Faces to update while #is_deform_dirty is set. */
+  int deform_poly_range[2];
   bool is_editmode;
   bool is_uvsyncsel;
 
@@ -255,5 +258,15 @@ void mesh_buffer_cache_create_requested(MeshBatchCache *cache,
                                         const DRW_MeshCDMask *cd_layer_used,
                                         const ToolSettings *ts,
                                         const bool use_hide);
+void mesh_buffer_cache_update_deform(MeshBatchCache *cache,
+                                     MeshBufferCache mbc,
+                                     Mesh *me,
+                                     const bool is_editmode,
+                                     const float obmat[4][4],
+                                     const bool do_final,
+                                     const bool do_uvedit,
+                                     const bool use_subsurf_fdots,
+                                     const ToolSettings *ts,
+                                     const bool use_hide);
 
 #endif /* __DRAW_CACHE_EXTRACT_H__ */
@@ -125,6 +125,10 @@ typedef struct MeshRenderData {
   float (*loop_normals)[3];
   float (*poly_normals)[3];
   int *lverts, *ledges;
+  /** Elements whose positions changed, see #mesh_buffer_cache_update_deform. */
+  int update_poly_start, update_poly_end;
+  int update_ledge_start, update_ledge_end;
+  int update_lvert_start, update_lvert_end;
 } MeshRenderData;
 
 static MeshRenderData *mesh_render_data_create(Mesh *me,
@@ -421,6 +425,12 @@ typedef struct MeshExtract {
   const eMRDataType data_flag;
   /** Used to know if the element callbacks are threadsafe and can be parallelized. */
   const bool use_threading;
+  /**
+   * Executed on main thread instead of init when only the positions changed. Reuses the data of
+   * the buffer, the iter functions are only called for the elements in the update range of
+   * #MeshRenderData. NULL if the buffer does not depend on positions.
+   */
+  ExtractInitFn *init_update;
 } MeshExtract;
 
 BLI_INLINE eMRIterType mesh_extract_iter_type(const MeshExtract *ext)
@@ -1448,7 +1458,9 @@ static void *extract_pos_nor_init(const MeshRenderData *mr, void *buf)
     GPU_vertformat_alias_add(&format, "vnor");
   }
   GPUVertBuf *vbo = buf;
-  GPU_vertbuf_init_with_format(vbo, &format);
+  /* Keep the data in edit mode, for #extract_pos_nor_init_update. */
+  GPU_vertbuf_init_with_format_ex(
+      vbo, &format, (mr->edit_bmesh) ? GPU_USAGE_DYNAMIC : GPU_USAGE_STATIC);
   GPU_vertbuf_data_alloc(vbo, mr->loop_len + mr->loop_loose_len);
 
   /* Pack normals per vert, reduce amount of computation. */
@@ -1474,6 +1486,55 @@ static void *extract_pos_nor_init(const MeshRenderData *mr, void *buf)
   return data;
 }
 
+static void *extract_pos_nor_init_update(const MeshRenderData *mr, void *buf)
+{
+  GPUVertBuf *vbo = buf;
+  BLI_assert(vbo->vertex_len == mr->loop_len + mr->loop_loose_len);
+  vbo->dirty = true;
+
+  size_t packed_nor_len = sizeof(GPUPackedNormal) * mr->vert_len;
+  MeshExtract_PosNor_Data *data = MEM_mallocN(sizeof(*data) + packed_nor_len, __func__);
+  data->vbo_data = (PosNorLoop *)vbo->data;
+
+  /* Only pack the normals of the vertices in the update range. */
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    for (int f = mr->update_poly_start; f < mr->update_poly_end; f++) {
+      BMLoop *l_iter, *l_first;
+      l_iter = l_first = BM_FACE_FIRST_LOOP(BM_face_at_index(mr->bm, f));
+      do {
+        data->packed_nor[BM_elem_index_get(l_iter->v)] = GPU_normal_convert_i10_v3(l_iter->v->no);
+      } while ((l_iter = l_iter->next) != l_first);
+    }
+    for (int e = mr->update_ledge_start; e < mr->update_ledge_end; e++) {
+      BMEdge *eed = BM_edge_at_index(mr->bm, mr->ledges[e]);
+      data->packed_nor[BM_elem_index_get(eed->v1)] = GPU_normal_convert_i10_v3(eed->v1->no);
+      data->packed_nor[BM_elem_index_get(eed->v2)] = GPU_normal_convert_i10_v3(eed->v2->no);
+    }
+    for (int v = mr->update_lvert_start; v < mr->update_lvert_end; v++) {
+      BMVert *eve = BM_vert_at_index(mr->bm, mr->lverts[v]);
+      data->packed_nor[mr->lverts[v]] = GPU_normal_convert_i10_v3(eve->no);
+    }
+  }
+  else {
+    for (int p = mr->update_poly_start; p < mr->update_poly_end; p++) {
+      const MPoly *mpoly = &mr->mpoly[p];
+      const MLoop *mloop = &mr->mloop[mpoly->loopstart];
+      for (int i = 0; i < mpoly->totloop; i++, mloop++) {
+        data->packed_nor[mloop->v] = GPU_normal_convert_i10_s3(mr->mvert[mloop->v].no);
+      }
+    }
+    for (int e = mr->update_ledge_start; e < mr->update_ledge_end; e++) {
+      const MEdge *medge = &mr->medge[mr->ledges[e]];
+      data->packed_nor[medge->v1] = GPU_normal_convert_i10_s3(mr->mvert[medge->v1].no);
+      data->packed_nor[medge->v2] = GPU_normal_convert_i10_s3(mr->mvert[medge->v2].no);
+    }
+    for (int v = mr->update_lvert_start; v < mr->update_lvert_end; v++) {
+      data->packed_nor[mr->lverts[v]] = GPU_normal_convert_i10_s3(mr->mvert[mr->lverts[v]].no);
+    }
+  }
+  return data;
+}
+
 static void extract_pos_nor_loop_bmesh(const MeshRenderData *UNUSED(mr),
                                        int l,
                                        BMLoop *loop,
@@ -1574,6 +1635,7 @@ static const MeshExtract extract_pos_nor = {
     extract_pos_nor_finish,
     0,
     true,
+    extract_pos_nor_init_update,
 };
 /** \} */
 
@@ -1589,12 +1651,22 @@ static void *extract_lnor_init(const MeshRenderData *mr, void *buf)
     GPU_vertformat_alias_add(&format, "lnor");
   }
   GPUVertBuf *vbo = buf;
-  GPU_vertbuf_init_with_format(vbo, &format);
+  GPU_vertbuf_init_with_format_ex(
+      vbo, &format, (mr->edit_bmesh) ? GPU_USAGE_DYNAMIC : GPU_USAGE_STATIC);
   GPU_vertbuf_data_alloc(vbo, mr->loop_len);
 
   return vbo->data;
 }
 
+static void *extract_lnor_init_update(const MeshRenderData *mr, void *buf)
+{
+  GPUVertBuf *vbo = buf;
+  BLI_assert(vbo->vertex_len == mr->loop_len);
+  UNUSED_VARS_NDEBUG(mr);
+  vbo->dirty = true;
+  return vbo->data;
+}
+
 static void extract_lnor_loop_bmesh(const MeshRenderData *mr, int l, BMLoop *loop, void *data)
 {
   if (mr->loop_normals) {
@@ -1645,6 +1717,7 @@ static const MeshExtract extract_lnor = {
     NULL,
     MR_DATA_LOOP_NOR,
     true,
+    extract_lnor_init_update,
 };
 
 /** \} */
@@ -3652,7 +3725,8 @@ static void *extract_fdots_pos_init(const MeshRenderData *mr, void *buf)
     GPU_vertformat_attr_add(&format, "pos", GPU_COMP_F32, 3, GPU_FETCH_FLOAT);
   }
   GPUVertBuf *vbo = buf;
-  GPU_vertbuf_init_with_format(vbo, &format);
+  GPU_vertbuf_init_with_format_ex(
+      vbo, &format, (mr->edit_bmesh) ? GPU_USAGE_DYNAMIC : GPU_USAGE_STATIC);
   GPU_vertbuf_data_alloc(vbo, mr->poly_len);
   if (!mr->use_subsurf_fdots) {
     /* Clear so we can accumulate on it. */
@@ -3661,6 +3735,21 @@ static void *extract_fdots_pos_init(const MeshRenderData *mr, void *buf)
   return vbo->data;
 }
 
+static void *extract_fdots_pos_init_update(const MeshRenderData *mr, void *buf)
+{
+  GPUVertBuf *vbo = buf;
+  BLI_assert(vbo->vertex_len == mr->poly_len);
+  vbo->dirty = true;
+  if (!mr->use_subsurf_fdots) {
+    /* Clear so we can accumulate on it. */
+    float(*center)[3] = (float(*)[3])vbo->data;
+    memset(center + mr->update_poly_start,
+           0x0,
+           (mr->update_poly_end - mr->update_poly_start) * vbo->format.stride);
+  }
+  return vbo->data;
+}
+
 static void extract_fdots_pos_loop_bmesh(const MeshRenderData *UNUSED(mr),
                                          int UNUSED(l),
                                          BMLoop *loop,
@@ -3704,6 +3793,7 @@ static const MeshExtract extract_fdots_pos = {
     NULL,
     0,
     true,
+    extract_fdots_pos_init_update,
 };
 
 /** \} */
@@ -4555,3 +4645,190 @@ void mesh_buffer_cache_create_requested(MeshBatchCache *cache,
 }
 
 /** \} */
+
+/* ---------------------------------------------------------------------- */
+/** \name Update after Deformation
+ * \{ */
+
+static void mesh_render_data_update_range_full(MeshRenderData *mr)
+{
+  mr->update_poly_start = 0;
+  mr->update_poly_end = mr->poly_len;
+  mr->update_ledge_start = 0;
+  mr->update_ledge_end = mr->edge_loose_len;
+  mr->update_lvert_start = 0;
+  mr->update_lvert_end = mr->vert_loose_len;
+}
+
+/**
+ * Use the range of faces tagged by #BKE_MESH_BATCH_DIRTY_DEFORM. Loose geometry is usually
+ * small and is always updated.
+ */
+static void mesh_render_data_update_range_set(MeshRenderData *mr, const int poly_range[2])
+{
+  mr->update_poly_start = min_ii(poly_range[0], mr->poly_len);
+  mr->update_poly_end = min_ii(poly_range[1], mr->poly_len);
+  if (mr->update_poly_start >= mr->update_poly_end) {
+    mr->update_poly_start = mr->update_poly_end = 0;
+  }
+  mr->update_ledge_start = 0;
+  mr->update_ledge_end = mr->edge_loose_len;
+  mr->update_lvert_start = 0;
+  mr->update_lvert_end = mr->vert_loose_len;
+}
+
+static void extract_update_task_create(TaskPool *task_pool,
+                                       const MeshRenderData *mr,
+                                       const MeshExtract *extract,
+                                       void *buf,
+                                       int32_t *task_counter)
+{
+  ExtractTaskData *taskdata = MEM_mallocN(sizeof(*taskdata), "ExtractTaskData");
+  taskdata->mr = mr;
+  taskdata->extract = extract;
+  taskdata->buf = buf;
+  taskdata->user_data = extract->init_update(mr, buf);
+  taskdata->iter_type = mesh_extract_iter_type(extract);
+  taskdata->task_counter = task_counter;
+
+  const int poly_len = mr->update_poly_end - mr->update_poly_start;
+  const int ledge_len = mr->update_ledge_end - mr->update_ledge_start;
+  const int lvert_len = mr->update_lvert_end - mr->update_lvert_start;
+
+  /* Same heuristic as #extract_task_create, on the updated elements only. */
+  const int chunk_size = 8192;
+  if (extract->use_threading && poly_len > chunk_size) {
+    if (taskdata->iter_type & MR_ITER_LOOP) {
+      for (int i = mr->update_poly_start; i < mr->update_poly_end; i += chunk_size) {
+        extract_range_task_create(
+            task_pool, taskdata, MR_ITER_LOOP, i, min_ii(chunk_size, mr->update_poly_end - i));
+      }
+    }
+    if ((taskdata->iter_type & MR_ITER_LEDGE) && ledge_len > 0) {
+      extract_range_task_create(
+          task_pool, taskdata, MR_ITER_LEDGE, mr->update_ledge_start, ledge_len);
+    }
+    if ((taskdata->iter_type & MR_ITER_LVERT) && lvert_len > 0) {
+      extract_range_task_create(
+          task_pool, taskdata, MR_ITER_LVERT, mr->update_lvert_start, lvert_len);
+    }
+    MEM_freeN(taskdata);
+  }
+  else {
+    /* Single threaded update. */
+    void *user_data = taskdata->user_data;
+    if (taskdata->iter_type & MR_ITER_LOOP) {
+      mesh_extract_iter(
+          mr, MR_ITER_LOOP, mr->update_poly_start, mr->update_poly_end, extract, user_data);
+    }
+    if (taskdata->iter_type & MR_ITER_LEDGE) {
+      mesh_extract_iter(
+          mr, MR_ITER_LEDGE, mr->update_ledge_start, mr->update_ledge_end, extract, user_data);
+    }
+    if (taskdata->iter_type & MR_ITER_LVERT) {
+      mesh_extract_iter(
+          mr, MR_ITER_LVERT, mr->update_lvert_start, mr->update_lvert_end, extract, user_data);
+    }
+    if (extract->finish != NULL) {
+      extract->finish(mr, buf, user_data);
+    }
+    MEM_freeN(taskdata);
+  }
+}
+
+/**
+ * Update the already extracted buffers of \a mbc that depend on positions, after a
+ * #BKE_MESH_BATCH_DIRTY_DEFORM tag. The topology must be unchanged since the extraction.
+ *
+ * When the buffers still have their data (edit mode), only the faces in the range given with the
+ * tag are iterated, the other buffers need to be discarded by the caller.
+ */
+void mesh_buffer_cache_update_deform(MeshBatchCache *cache,
+                                     MeshBufferCache mbc,
+                                     Mesh *me,
+                                     const bool is_editmode,
+                                     const float obmat[4][4],
+                                     const bool do_final,
+                                     const bool do_uvedit,
+                                     const bool use_subsurf_fdots,
+                                     const ToolSettings *ts,
+                                     const bool use_hide)
+{
+  eMRDataType data_flag = 0;
+  bool use_full_range = false;
+
+  /* Buffers that are not extracted yet are left to #mesh_buffer_cache_create_requested. */
+#define TEST_ASSIGN_UPDATE(name) \
+  do { \
+    if (mbc.vbo.name != NULL && mbc.vbo.name->format.attr_len != 0) { \
+      data_flag |= extract_##name.data_flag; \
+      if (mbc.vbo.name->data == NULL) { \
+        /* Static buffers free their data once uploaded. */ \
+        GPU_vertbuf_data_alloc(mbc.vbo.name, mbc.vbo.name->vertex_len); \
+        use_full_range = true; \
+      } \
+    } \
+    else { \
+      mbc.vbo.name = NULL; \
+    } \
+  } while (0)
+
+  TEST_ASSIGN_UPDATE(pos_nor);
+  TEST_ASSIGN_UPDATE(lnor);
+  TEST_ASSIGN_UPDATE(fdots_pos);
+
+#undef TEST_ASSIGN_UPDATE
+
+  if (!mbc.vbo.pos_nor && !mbc.vbo.lnor && !mbc.vbo.fdots_pos) {
+    return;
+  }
+
+  MeshRenderData *mr = mesh_render_data_create(me,
+                                               is_editmode,
+                                               obmat,
+                                               do_final,
+                                               do_uvedit,
+                                               MR_ITER_LOOP | MR_ITER_LEDGE | MR_ITER_LVERT,
+                                               data_flag,
+                                               NULL,
+                                               ts);
+  mr->cache = cache; /* HACK */
+  mr->use_hide = use_hide;
+  mr->use_subsurf_fdots = use_subsurf_fdots;
+  mr->use_final_mesh = do_final;
+
+  /* The range refers to the faces of the mesh, not to the ones of a modifier result.
+   * Auto smooth normals depend on the neighbor faces, that are not in the range. */
+  if (use_full_range || mr->extract_type == MR_EXTRACT_MAPPED || mr->loop_normals != NULL) {
+    mesh_render_data_update_range_full(mr);
+  }
+  else {
+    mesh_render_data_update_range_set(mr, cache->deform_poly_range);
+  }
+
+  TaskScheduler *task_scheduler = BLI_task_scheduler_get();
+  TaskPool *task_pool = BLI_task_pool_create_suspended(task_scheduler, NULL);
+
+  int32_t task_counters[3] = {0};
+  int counter_used = 0;
+
+#define EXTRACT_UPDATE(name) \
+  if (mbc.vbo.name) { \
+    extract_update_task_create( \
+        task_pool, mr, &extract_##name, mbc.vbo.name, &task_counters[counter_used++]); \
+  } \
+  ((void)0)
+
+  EXTRACT_UPDATE(pos_nor);
+  EXTRACT_UPDATE(lnor);
+  EXTRACT_UPDATE(fdots_pos);
+
+#undef EXTRACT_UPDATE
+
+  BLI_task_pool_work_and_wait(task_pool);
+  BLI_task_pool_free(task_pool);
+
+  mesh_render_data_free(mr);
+}
+
+/** \} */
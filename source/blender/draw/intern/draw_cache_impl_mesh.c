@@ -494,6 +494,62 @@ static void mesh_batch_cache_discard_uvedit_select(MeshBatchCache *cache)
   cache->batch_ready &= ~MBC_EDITUV;
 }
 
+/* Discard the buffers that are not updated by #mesh_buffer_cache_update_deform but still depend
+ * on the positions, and the batches using them. */
+static void mesh_batch_cache_discard_deform(MeshBatchCache *cache)
+{
+  FOREACH_MESH_BUFFER_CACHE(cache, mbufcache)
+  {
+    /* Triangulation of quads and n-gons depends on the shape. */
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.tris);
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.edituv_tris);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edge_fac);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.mesh_analysis);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.tan);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.orco);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_area);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_angle);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.skin_roots);
+  }
+  GPU_BATCH_DISCARD_SAFE(cache->batch.surface);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.surface_weights);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_mesh_analysis);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_triangles);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_lnor);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_selection_faces);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_fdots);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_skin_roots);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.wire_edges);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces_stretch_area);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces_stretch_angle);
+  mesh_batch_cache_discard_shaded_batches(cache);
+
+  cache->tot_area = 0.0f;
+  cache->tot_uv_area = 0.0f;
+
+  cache->batch_ready &= ~(MBC_SURFACE | MBC_SURFACE_WEIGHTS | MBC_EDIT_MESH_ANALYSIS |
+                          MBC_EDIT_TRIANGLES | MBC_EDIT_LNOR | MBC_EDIT_SELECTION_FACES |
+                          MBC_EDIT_FACEDOTS | MBC_SKIN_ROOTS | MBC_WIRE_EDGES | MBC_EDITUV);
+}
+
+/* Extend the range of faces to update with the faces moved by transform in edit-mode,
+ * see #BMEditMesh.deform_face_range. Other deformations update all faces. */
+static void mesh_batch_cache_deform_range_add(MeshBatchCache *cache, const Mesh *me)
+{
+  const BMEditMesh *em = me->edit_mesh;
+  const int range[2] = {(em && em->is_deform_tagged) ? em->deform_face_range[0] : 0,
+                        (em && em->is_deform_tagged) ? em->deform_face_range[1] : INT_MAX};
+  if (cache->is_deform_dirty) {
+    cache->deform_poly_range[0] = min_ii(cache->deform_poly_range[0], range[0]);
+    cache->deform_poly_range[1] = max_ii(cache->deform_poly_range[1], range[1]);
+  }
+  else {
+    copy_v2_v2_int(cache->deform_poly_range, range);
+  }
+}
+
 void DRW_mesh_batch_cache_dirty_tag(Mesh *me, int mode)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -566,6 +622,14 @@ void DRW_mesh_batch_cache_dirty_tag(Mesh *me, int mode)
       GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_fdots);
       cache->batch_ready &= ~MBC_EDITUV;
       break;
+    case BKE_MESH_BATCH_DIRTY_DEFORM:
+      /* The buffers are updated in place on next request, batches using them stay valid. */
+      if (!cache->is_dirty) {
+        mesh_batch_cache_discard_deform(cache);
+        mesh_batch_cache_deform_range_add(cache, me);
+        cache->is_deform_dirty = true;
+      }
+      break;
     default:
       BLI_assert(0);
   }
@@ -971,6 +1035,51 @@ void DRW_mesh_batch_cache_free_old(Mesh *me, int ctime)
   mesh_cd_layers_type_clear(&cache->cd_used_over_time);
 }
 
+/* Update the buffers of all buffer caches after a #BKE_MESH_BATCH_DIRTY_DEFORM tag. */
+static void mesh_batch_cache_update_deform(Object *ob,
+                                           Mesh *me,
+                                           MeshBatchCache *cache,
+                                           const Scene *scene,
+                                           const ToolSettings *ts,
+                                           const bool is_editmode,
+                                           const bool use_hide)
+{
+  const bool do_cage = (is_editmode &&
+                        (me->edit_mesh->mesh_eval_final != me->edit_mesh->mesh_eval_cage));
+  const bool do_uvcage = is_editmode && !me->edit_mesh->mesh_eval_final->runtime.is_original;
+  /* Meh loose Scene const correctness here. */
+  const bool use_subsurf_fdots = scene ? modifiers_usesSubsurfFacedots((Scene *)scene, ob) : false;
+
+  if (do_uvcage) {
+    mesh_buffer_cache_update_deform(
+        cache, cache->uv_cage, me, is_editmode, ob->obmat, false, true, false, ts, true);
+  }
+  if (do_cage) {
+    mesh_buffer_cache_update_deform(cache,
+                                    cache->cage,
+                                    me,
+                                    is_editmode,
+                                    ob->obmat,
+                                    false,
+                                    false,
+                                    use_subsurf_fdots,
+                                    ts,
+                                    true);
+  }
+  mesh_buffer_cache_update_deform(cache,
+                                  cache->final,
+                                  me,
+                                  is_editmode,
+                                  ob->obmat,
+                                  true,
+                                  false,
+                                  use_subsurf_fdots,
+                                  ts,
+                                  use_hide);
+
+  cache->is_deform_dirty = false;
+}
+
 /* Can be called for any surface type. Mesh *me is the final mesh. */
 void DRW_mesh_batch_cache_create_requested(
     Object *ob, Mesh *me, const Scene *scene, const bool is_paint_mode, const bool use_hide)
@@ -1001,6 +1110,10 @@ void DRW_mesh_batch_cache_create_requested(
   DRWBatchFlag batch_requested = cache->batch_requested;
   cache->batch_requested = 0;
 
+  if (cache->is_deform_dirty) {
+    mesh_batch_cache_update_deform(ob, me, cache, scene, ts, is_editmode, use_hide);
+  }
+
   if (batch_requested & MBC_SURFACE_WEIGHTS) {
     /* Check vertex weights. */
     if ((cache->batch.surface_weights != NULL) && (ts != NULL)) {
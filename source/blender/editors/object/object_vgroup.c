@@ -98,6 +98,18 @@ static Lattice *vgroup_edit_lattice(Object *ob)
   return (lt->editlatt) ? lt->editlatt->latt : lt;
 }
 
+/* The original mesh may share its layers with the evaluated copy (see #CD_SHARE),
+ * take ownership of the weights or vertex flags before writing to them. */
+static void vgroup_mesh_dvert_ensure_owned(Mesh *me)
+{
+  me->dvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MDEFORMVERT, me->totvert);
+}
+
+static void vgroup_mesh_mvert_ensure_owned(Mesh *me)
+{
+  me->mvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
+}
+
 bool ED_vgroup_sync_from_pose(Object *ob)
 {
   Object *armobj = BKE_object_pose_armature_get(ob);
@@ -187,9 +199,12 @@ bool ED_vgroup_parray_alloc(ID *id,
         }
         else if (me->dvert) {
           MVert *mvert = me->mvert;
-          MDeformVert *dvert = me->dvert;
+          MDeformVert *dvert;
           int i;
 
+          vgroup_mesh_dvert_ensure_owned(me);
+          dvert = me->dvert;
+
           *dvert_tot = me->totvert;
           *dvert_arr = MEM_mallocN(sizeof(void *) * me->totvert, "vgroup parray from me");
 
@@ -547,8 +562,10 @@ static void ED_mesh_defvert_mirror_update_ob(Object *ob, int def_nr, int vidx)
   vidx_mirr = mesh_get_x_mirror_vert(ob, NULL, vidx, use_topology);
 
   if ((vidx_mirr) >= 0 && (vidx_mirr != vidx)) {
-    MDeformVert *dvert_src = &me->dvert[vidx];
-    MDeformVert *dvert_dst = &me->dvert[vidx_mirr];
+    MDeformVert *dvert_src, *dvert_dst;
+    vgroup_mesh_dvert_ensure_owned(me);
+    dvert_src = &me->dvert[vidx];
+    dvert_dst = &me->dvert[vidx_mirr];
     mesh_defvert_mirror_update_internal(ob, dvert_dst, dvert_src, def_nr);
   }
 }
@@ -662,6 +679,7 @@ static void vgroup_copy_active_to_sel(Object *ob, eVGroupSelect subset_type)
     MDeformVert *dv;
     int v_act;
 
+    vgroup_mesh_dvert_ensure_owned(me);
     dvert_act = ED_mesh_active_dvert_get_ob(ob, &v_act);
     if (dvert_act) {
       dv = me->dvert;
@@ -1019,6 +1037,7 @@ static void vgroup_select_verts(Object *ob, int select)
         MDeformVert *dv;
         int i;
 
+        vgroup_mesh_mvert_ensure_owned(me);
         mv = me->mvert;
         dv = me->dvert;
 
@@ -1509,6 +1528,7 @@ static void vgroup_fix(
   if (!(me->editflag & ME_EDIT_PAINT_VERT_SEL)) {
     return;
   }
+  vgroup_mesh_dvert_ensure_owned(me);
   for (i = 0; i < me->totvert && mvert; i++, mvert++) {
     if (mvert->flag & SELECT) {
       int count = 0;
@@ -2344,6 +2364,9 @@ void ED_vgroup_mirror(Object *ob,
         goto cleanup;
       }
 
+      vgroup_mesh_mvert_ensure_owned(me);
+      vgroup_mesh_dvert_ensure_owned(me);
+
       if (!use_vert_sel) {
         sel = sel_mirr = true;
       }
@@ -2505,6 +2528,9 @@ static void vgroup_assign_verts(Object *ob, const float weight)
       if (!me->dvert) {
         BKE_object_defgroup_data_create(&me->id);
       }
+      else {
+        vgroup_mesh_dvert_ensure_owned(me);
+      }
 
       mv = me->mvert;
       dv = me->dvert;
@@ -3976,6 +4002,7 @@ static void vgroup_copy_active_to_sel_single(Object *ob, const int def_nr)
     MDeformVert *dv;
     int v_act;
 
+    vgroup_mesh_dvert_ensure_owned(me);
     dvert_act = ED_mesh_active_dvert_get_ob(ob, &v_act);
     if (dvert_act == NULL) {
       return;
@@ -44,6 +44,7 @@
 
 #include "BKE_brush.h"
 #include "BKE_context.h"
+#include "BKE_customdata.h"
 #include "BKE_deform.h"
 #include "BKE_main.h"
 #include "BKE_mesh.h"
@@ -177,6 +178,18 @@ static MDeformVert *defweight_prev_init(MDeformVert *dvert_prev,
   return dv_prev;
 }
 
+/* The original mesh may share its layers with the evaluated copy (see #CD_SHARE),
+ * take ownership of the painted layer before writing to it. */
+static void wpaint_mesh_dvert_ensure_owned(Mesh *me)
+{
+  me->dvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MDEFORMVERT, me->totvert);
+}
+
+static void vpaint_mesh_mloopcol_ensure_owned(Mesh *me)
+{
+  me->mloopcol = CustomData_duplicate_referenced_layer(&me->ldata, CD_MLOOPCOL, me->totloop);
+}
+
 /* check if we can do partial updates and have them draw realtime
  * (without evaluating modifiers) */
 static bool vertex_paint_use_fast_update_check(Object *ob)
@@ -2324,6 +2337,9 @@ static void wpaint_stroke_update_step(bContext *C, struct PaintStroke *stroke, P
   wpi.brush_alpha_value = brush_alpha_value;
   /* *** done setting up WeightPaintInfo *** */
 
+  /* Weight arrays of deform vertices are re-allocated while painting. */
+  wpaint_mesh_dvert_ensure_owned(ob->data);
+
   if (wpd->precomputed_weight) {
     precompute_weight_values(C, ob, brush, wpd, &wpi, ob->data);
   }
@@ -2631,6 +2647,7 @@ static bool vpaint_stroke_test_start(bContext *C, struct wmOperator *op, const f
   if (me->mloopcol == NULL) {
     return false;
   }
+  vpaint_mesh_mloopcol_ensure_owned(me);
 
   /* make mode data storage */
   vpd = MEM_callocN(sizeof(*vpd), "VPaintData");
@@ -3298,6 +3315,9 @@ static void vpaint_stroke_update_step(bContext *C, struct PaintStroke *stroke, P
 
   swap_m4m4(vc->rv3d->persmat, mat);
 
+  /* Evaluation since the last step may have shared the colors again. */
+  vpaint_mesh_mloopcol_ensure_owned(ob->data);
+
   vpaint_do_symmetrical_brush_actions(C, sd, vp, vpd, ob);
 
   swap_m4m4(vc->rv3d->persmat, mat);
@@ -56,6 +56,7 @@
 #include "RNA_define.h"
 
 #include "ED_node.h"
+#include "ED_screen.h"
 #include "ED_space_api.h"
 
 #include "WM_api.h"
@@ -72,6 +73,10 @@
 #include "NOD_shader.h"
 #include "NOD_texture.h"
 
+#ifdef WITH_COMPOSITOR
+#  include "COM_compositor.h"
+#endif
+
 /* ****************** SOCKET BUTTON DRAW FUNCTIONS ***************** */
 
 static void node_socket_button_label(bContext *UNUSED(C),
@@ -3439,6 +3444,31 @@ void ED_init_node_socket_type_virtual(bNodeSocketType *stype)
 
 /* ************** Generic drawing ************** */
 
+#ifdef WITH_COMPOSITOR
+/* Show how many results of the last execution were restored from the compositor cache. */
+static void node_draw_cache_stats(ARegion *ar, const SpaceNode *snode)
+{
+  float fill_color[4] = {0.0f, 0.0f, 0.0f, 0.25f};
+  int hits, misses, num_buffers;
+  size_t memory;
+  char str[256];
+
+  if (snode->nodetree->cache_limit <= 0) {
+    return;
+  }
+
+  COM_getCacheStats(&hits, &misses, &num_buffers, &memory);
+  BLI_snprintf(str,
+               sizeof(str),
+               TIP_("Cache: %d/%d results reused | %d stored, %.1f MB"),
+               hits,
+               hits + misses,
+               num_buffers,
+               (double)memory / (1024.0 * 1024.0));
+  ED_region_info_draw(ar, str, fill_color, false);
+}
+#endif
+
 void draw_nodespace_back_pix(const bContext *C,
                              ARegion *ar,
                              SpaceNode *snode,
@@ -3573,6 +3603,10 @@ void draw_nodespace_back_pix(const bContext *C,
       }
     }
 
+#ifdef WITH_COMPOSITOR
+    node_draw_cache_stats(ar, snode);
+#endif
+
     GPU_matrix_pop_projection();
     GPU_matrix_pop();
   }
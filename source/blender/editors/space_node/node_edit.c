@@ -517,6 +517,7 @@ void ED_node_composit_default(const bContext *C, struct Scene *sce)
   sce->nodetree->chunksize = 256;
   sce->nodetree->edit_quality = NTREE_QUALITY_HIGH;
   sce->nodetree->render_quality = NTREE_QUALITY_HIGH;
+  sce->nodetree->cache_limit = 512;
 
   out = nodeAddStaticNode(C, sce->nodetree, CMP_NODE_COMPOSITE);
   out->locx = 300.0f;
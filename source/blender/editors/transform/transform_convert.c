@@ -1779,6 +1779,12 @@ static void special_aftertrans_update__node(bContext *C, TransInfo *t)
 
 static void special_aftertrans_update__mesh(bContext *UNUSED(C), TransInfo *t)
 {
+  /* Auto-merge and other updates after transform can change the topology. */
+  FOREACH_TRANS_DATA_CONTAINER (t, tc) {
+    BMEditMesh *em = BKE_editmesh_from_object(tc->obedit);
+    em->is_deform_tagged = false;
+  }
+
   /* so automerge supports mirror */
   if ((t->scene->toolsettings->automerge) && ((t->flag & T_EDIT) && t->obedit_type == OB_MESH)) {
     FOREACH_TRANS_DATA_CONTAINER (t, tc) {
@@ -76,6 +76,7 @@ void flushTransMasking(TransInfo *t);
 void flushTransUVs(TransInfo *t);
 void trans_mesh_customdata_correction_init(TransInfo *t);
 void trans_mesh_customdata_correction_apply(struct TransDataContainer *tc, bool is_final);
+void trans_mesh_deform_range_tag(TransInfo *t, struct TransDataContainer *tc);
 
 /* transform_convert_node.c */
 void flushTransNodes(TransInfo *t);
@@ -1281,6 +1281,73 @@ void trans_mesh_customdata_correction_apply(struct TransDataContainer *tc, bool
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Deform Range (for drawing)
+ *
+ * \{ */
+
+static void trans_mesh_deform_range_add_vert(BMVert *v, int range[2])
+{
+  BMIter iter;
+  BMFace *f;
+  BM_ITER_ELEM (f, &iter, v, BM_FACES_OF_VERT) {
+    const int index = BM_elem_index_get(f);
+    range[0] = min_ii(range[0], index);
+    range[1] = max_ii(range[1], index + 1);
+  }
+}
+
+static void trans_mesh_deform_range_add(BMVert *v, int range[2])
+{
+  BMIter iter;
+  BMFace *f;
+  BM_ITER_ELEM (f, &iter, v, BM_FACES_OF_VERT) {
+    /* Normals of the other vertices of the faces change too, so do their faces. */
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      trans_mesh_deform_range_add_vert(l_iter->v, range);
+    } while ((l_iter = l_iter->next) != l_first);
+  }
+}
+
+/**
+ * Tag the edit-mesh faces changed by moving the transformed vertices,
+ * so the next evaluation only updates their draw buffers, see #BMEditMesh.deform_face_range.
+ * Transformations that change more than vertex positions clear the tag instead.
+ */
+void trans_mesh_deform_range_tag(TransInfo *t, TransDataContainer *tc)
+{
+  BMEditMesh *em = BKE_editmesh_from_object(tc->obedit);
+
+  if ((t->options & CTX_EDGE) || ELEM(t->mode, TFM_SKIN_RESIZE, TFM_NORMAL_ROTATION) ||
+      (tc->custom.type.data != NULL)) {
+    em->is_deform_tagged = false;
+    return;
+  }
+
+  int range[2] = {INT_MAX, 0};
+  if (em->is_deform_tagged) {
+    copy_v2_v2_int(range, em->deform_face_range);
+  }
+
+  BM_mesh_elem_index_ensure(em->bm, BM_FACE);
+
+  TransData *td = tc->data;
+  for (int i = 0; i < tc->data_len; i++, td++) {
+    trans_mesh_deform_range_add(td->extra, range);
+  }
+  TransDataMirror *tdm = tc->mirror.data;
+  for (int i = 0; i < tc->mirror.data_len; i++, tdm++) {
+    trans_mesh_deform_range_add(tdm->extra, range);
+  }
+
+  copy_v2_v2_int(em->deform_face_range, range);
+  em->is_deform_tagged = true;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Edge (for crease) Transform Creation
  *
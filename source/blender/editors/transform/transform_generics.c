@@ -919,6 +919,7 @@ static void recalcData_objects(TransInfo *t)
         BMEditMesh *em = BKE_editmesh_from_object(tc->obedit);
         EDBM_mesh_normals_update(em);
         BKE_editmesh_looptri_calc(em);
+        trans_mesh_deform_range_tag(t, tc);
       }
     }
     else if (t->obedit_type == OB_ARMATURE) { /* no recalc flag, does pose */
@@ -283,7 +283,7 @@ static void iter_snap_objects(SnapObjectContext *sctx,
     }
 
     Object *obj_eval = DEG_get_evaluated_object(sctx->depsgraph, base->object);
-    if (obj_eval->transflag & OB_DUPLI) {
+    if (obj_eval->transflag & (OB_DUPLI | OB_DUPLIMESH)) {
       DupliObject *dupli_ob;
       ListBase *lb = object_duplilist(sctx->depsgraph, sctx->scene, obj_eval);
       for (dupli_ob = lb->first; dupli_ob; dupli_ob = dupli_ob->next) {
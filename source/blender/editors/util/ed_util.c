@@ -54,6 +54,8 @@
 #include "BKE_workspace.h"
 #include "BKE_material.h"
 
+#include "COM_compositor.h"
+
 #include "DEG_depsgraph.h"
 
 #include "ED_armature.h"
@@ -226,6 +228,11 @@ void ED_editors_exit(Main *bmain, bool do_undo_system)
   /* global in meshtools... */
   ED_mesh_mirror_spatial_table(NULL, NULL, NULL, NULL, 'e');
   ED_mesh_mirror_topo_table(NULL, NULL, 'e');
+
+#ifdef WITH_COMPOSITOR
+  /* the main database is freed or replaced by a loaded file or undo step */
+  COM_freeID(NULL);
+#endif
 }
 
 bool ED_editors_flush_edits_for_object_ex(Main *bmain,
@@ -99,7 +99,8 @@ NodeGroup *BlenderFileLoader::Load()
       continue;
     }
 
-    Mesh *mesh = BKE_object_to_mesh(NULL, ob, false);
+    /* Instances of the mesh are iterated as duplis. */
+    Mesh *mesh = BKE_object_to_mesh(NULL, ob, false, false);
 
     if (mesh) {
       insertShapeNode(ob, mesh, ++id);
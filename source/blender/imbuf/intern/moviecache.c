@@ -32,9 +32,12 @@
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_threads.h"
 
+#include "atomic_ops.h"
+
 #include "IMB_moviecache.h"
 
 #include "IMB_imbuf_types.h"
@@ -50,12 +53,35 @@
 #  define PRINT(format, ...)
 #endif
 
-static MEM_CacheLimiterC *limitor = NULL;
-static pthread_mutex_t limitor_lock = BLI_MUTEX_INITIALIZER;
+/**
+ * Memory used by all caches is limited by #MEM_CacheLimiter_get_maximum.
+ *
+ * Items are spread over a number of limiter shards by their key, each shard has its own lock,
+ * so lookups in different shards don't wait for each other. The memory in use by all shards is
+ * kept in an atomic total, once it exceeds the maximum all shards are locked and the lowest
+ * priority items of all caches are freed, the same as with a single limiter.
+ */
+#define MOVIECACHE_LIMITER_SHARDS 16
+
+typedef struct MovieCacheLimiterShard {
+  ThreadMutex mutex;
+  /** #MovieCacheItem which have a buffer, in order of insertion. */
+  ListBase items;
+  size_t memory_in_use;
+} MovieCacheLimiterShard;
+
+static MovieCacheLimiterShard *limiter_shards = NULL;
+static ThreadMutex limiter_init_lock = BLI_MUTEX_INITIALIZER;
+/** Sum of #MovieCacheLimiterShard.memory_in_use of all shards. */
+static size_t limiter_memory_in_use = 0;
+/** Incremented on every access, to find the least recently used items of all shards. */
+static uint64_t limiter_access_clock = 0;
 
 typedef struct MovieCache {
   char name[64];
 
+  /** Protects the hash and memory pools, lookups only need a read lock. */
+  ThreadRWMutex hash_lock;
   GHash *hash;
   GHashHashFP hashfp;
   GHashCmpFP cmpfp;
@@ -71,7 +97,14 @@ typedef struct MovieCache {
 
   int keysize;
 
+  /** Written by puts into this cache, read by the limiter while it frees items of any cache. */
+  ThreadMutex last_userkey_lock;
   void *last_userkey;
+  /** Copy of #MovieCache.last_userkey made by the limiter, which holds all shards meanwhile. */
+  void *priority_userkey;
+
+  /** Number of items which buffer was freed by the limiter, but still are in the hash. */
+  int unused_len;
 
   int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
   int pad;
@@ -83,10 +116,15 @@ typedef struct MovieCacheKey {
 } MovieCacheKey;
 
 typedef struct MovieCacheItem {
+  struct MovieCacheItem *next, *prev;
   MovieCache *cache_owner;
+  /** Set to NULL when freed by the limiter, only access with the shard locked. */
   ImBuf *ibuf;
-  MEM_CacheLimiterHandleC *c_handle;
   void *priority_data;
+  /** Limiter shard this item is accounted in. */
+  MovieCacheLimiterShard *shard;
+  size_t size;
+  uint64_t last_access;
 } MovieCacheItem;
 
 static unsigned int moviecache_hashhash(const void *keyv)
@@ -113,6 +151,20 @@ static void moviecache_keyfree(void *val)
   BLI_mempool_free(key->cache_owner->keys_pool, key);
 }
 
+/* Shard must be locked. */
+static void moviecache_limiter_memory_add(MovieCacheLimiterShard *shard, size_t size)
+{
+  shard->memory_in_use += size;
+  atomic_add_and_fetch_z(&limiter_memory_in_use, size);
+}
+
+/* Shard must be locked. */
+static void moviecache_limiter_memory_sub(MovieCacheLimiterShard *shard, size_t size)
+{
+  shard->memory_in_use -= size;
+  atomic_sub_and_fetch_z(&limiter_memory_in_use, size);
+}
+
 static void moviecache_valfree(void *val)
 {
   MovieCacheItem *item = (MovieCacheItem *)val;
@@ -120,9 +172,19 @@ static void moviecache_valfree(void *val)
 
   PRINT("%s: cache '%s' free item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
 
-  if (item->ibuf) {
-    MEM_CacheLimiter_unmanage(item->c_handle);
-    IMB_freeImBuf(item->ibuf);
+  if (item->shard) {
+    MovieCacheLimiterShard *shard = item->shard;
+    BLI_mutex_lock(&shard->mutex);
+    if (item->ibuf) {
+      BLI_remlink(&shard->items, item);
+      moviecache_limiter_memory_sub(shard, item->size);
+      IMB_freeImBuf(item->ibuf);
+      item->ibuf = NULL;
+    }
+    else {
+      atomic_sub_and_fetch_int32(&cache->unused_len, 1);
+    }
+    BLI_mutex_unlock(&shard->mutex);
   }
 
   if (item->priority_data && cache->prioritydeleterfp) {
@@ -132,10 +194,15 @@ static void moviecache_valfree(void *val)
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
 
+/* Cache must be locked for writing. */
 static void check_unused_keys(MovieCache *cache)
 {
   GHashIterator gh_iter;
 
+  if (atomic_add_and_fetch_int32(&cache->unused_len, 0) == 0) {
+    return;
+  }
+
   BLI_ghashIterator_init(&gh_iter, cache->hash);
 
   while (!BLI_ghashIterator_done(&gh_iter)) {
@@ -145,7 +212,9 @@ static void check_unused_keys(MovieCache *cache)
 
     BLI_ghashIterator_step(&gh_iter);
 
+    BLI_mutex_lock(&item->shard->mutex);
     remove = !item->ibuf;
+    BLI_mutex_unlock(&item->shard->mutex);
 
     if (remove) {
       PRINT("%s: cache '%s' remove item %p without buffer\n", __func__, cache->name, item);
@@ -164,26 +233,21 @@ static int compare_int(const void *av, const void *bv)
   return *a - *b;
 }
 
-static void IMB_moviecache_destructor(void *p)
+/* Free the buffer of an item, the key is removed later by #check_unused_keys.
+ * Shard must be locked. */
+static void moviecache_limiter_destroy_item(MovieCacheLimiterShard *shard, MovieCacheItem *item)
 {
-  MovieCacheItem *item = (MovieCacheItem *)p;
-
-  if (item && item->ibuf) {
-    MovieCache *cache = item->cache_owner;
+  MovieCache *cache = item->cache_owner;
 
-    PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
+  PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
 
-    IMB_freeImBuf(item->ibuf);
+  BLI_remlink(&shard->items, item);
+  moviecache_limiter_memory_sub(shard, item->size);
 
-    item->ibuf = NULL;
-    item->c_handle = NULL;
+  IMB_freeImBuf(item->ibuf);
+  item->ibuf = NULL;
 
-    /* force cached segments to be updated */
-    if (cache->points) {
-      MEM_freeN(cache->points);
-      cache->points = NULL;
-    }
-  }
+  atomic_add_and_fetch_int32(&cache->unused_len, 1);
 }
 
 static size_t get_size_in_memory(ImBuf *ibuf)
@@ -208,9 +272,8 @@ static size_t get_item_size(void *p)
   return size;
 }
 
-static int get_item_priority(void *item_v, int default_priority)
+static int get_item_priority(MovieCacheItem *item, int default_priority)
 {
-  MovieCacheItem *item = (MovieCacheItem *)item_v;
   MovieCache *cache = item->cache_owner;
   int priority;
 
@@ -224,16 +287,20 @@ static int get_item_priority(void *item_v, int default_priority)
     return default_priority;
   }
 
-  priority = cache->getitempriorityfp(cache->last_userkey, item->priority_data);
+  /* Puts into the cache of the item don't necessarily hold any of the locks held here. */
+  BLI_mutex_lock(&cache->last_userkey_lock);
+  memcpy(cache->priority_userkey, cache->last_userkey, cache->keysize);
+  BLI_mutex_unlock(&cache->last_userkey_lock);
+
+  priority = cache->getitempriorityfp(cache->priority_userkey, item->priority_data);
 
   PRINT("%s: cache '%s' item %p priority %d\n", __func__, cache->name, item, priority);
 
   return priority;
 }
 
-static bool get_item_destroyable(void *item_v)
+static bool get_item_destroyable(MovieCacheItem *item)
 {
-  MovieCacheItem *item = (MovieCacheItem *)item_v;
   /* IB_BITMAPDIRTY means image was modified from inside blender and
    * changes are not saved to disk.
    *
@@ -245,18 +312,124 @@ static bool get_item_destroyable(void *item_v)
   return true;
 }
 
+static MovieCacheLimiterShard *moviecache_limiter_shard_get(MovieCache *cache, void *userkey)
+{
+  const unsigned int hash = cache->hashfp(userkey);
+  /* Mix in higher bits, keys often only differ by frame number. */
+  return &limiter_shards[(hash ^ (hash >> 16)) % MOVIECACHE_LIMITER_SHARDS];
+}
+
+/* Buffers can grow after they were added (byte buffer created for display for example).
+ * Shard must be locked. */
+static void moviecache_limiter_item_update_size(MovieCacheLimiterShard *shard,
+                                                MovieCacheItem *item)
+{
+  const size_t size = get_item_size(item);
+
+  if (size > item->size) {
+    moviecache_limiter_memory_add(shard, size - item->size);
+  }
+  else {
+    moviecache_limiter_memory_sub(shard, item->size - size);
+  }
+  item->size = size;
+}
+
+/* Same as #moviecache_limiter_item_update_size for all items of the shard, only done before
+ * freeing items, since it's linear in the number of items. Shard must be locked. */
+static void moviecache_limiter_shard_update_sizes(MovieCacheLimiterShard *shard)
+{
+  size_t memory_in_use = 0;
+  LISTBASE_FOREACH (MovieCacheItem *, item, &shard->items) {
+    item->size = get_item_size(item);
+    memory_in_use += item->size;
+  }
+
+  if (memory_in_use > shard->memory_in_use) {
+    moviecache_limiter_memory_add(shard, memory_in_use - shard->memory_in_use);
+  }
+  else {
+    moviecache_limiter_memory_sub(shard, shard->memory_in_use - memory_in_use);
+  }
+}
+
+/**
+ * Free buffers of the lowest priority items of all caches while the memory in use by all shards
+ * exceeds the maximum. Must be called without any shard locked, since all of them are locked.
+ */
+static void moviecache_limiter_enforce(MovieCacheItem *item_keep)
+{
+  const size_t max = MEM_CacheLimiter_get_maximum();
+
+  if (MEM_CacheLimiter_is_disabled() || max == 0 ||
+      atomic_add_and_fetch_z(&limiter_memory_in_use, 0) <= max) {
+    return;
+  }
+
+  /* Always locked in the same order, so concurrent enforcing can't deadlock. */
+  for (int i = 0; i < MOVIECACHE_LIMITER_SHARDS; i++) {
+    BLI_mutex_lock(&limiter_shards[i].mutex);
+  }
+
+  for (int i = 0; i < MOVIECACHE_LIMITER_SHARDS; i++) {
+    moviecache_limiter_shard_update_sizes(&limiter_shards[i]);
+  }
+
+  const uint64_t access_clock = atomic_add_and_fetch_uint64(&limiter_access_clock, 0);
+
+  while (atomic_add_and_fetch_z(&limiter_memory_in_use, 0) > max) {
+    MovieCacheItem *best_match_item = NULL;
+    int best_match_priority = 0;
+
+    for (int i = 0; i < MOVIECACHE_LIMITER_SHARDS; i++) {
+      LISTBASE_FOREACH (MovieCacheItem *, item, &limiter_shards[i].items) {
+        if (item == item_keep || !get_item_destroyable(item)) {
+          continue;
+        }
+
+        /* by default 0 means highest priority element, the least recently used comes first */
+        const int default_priority = -(int)MIN2(access_clock - item->last_access, INT_MAX);
+        const int priority = get_item_priority(item, default_priority);
+
+        if (priority < best_match_priority || best_match_item == NULL) {
+          best_match_priority = priority;
+          best_match_item = item;
+        }
+      }
+    }
+
+    if (best_match_item == NULL) {
+      break;
+    }
+
+    moviecache_limiter_destroy_item(best_match_item->shard, best_match_item);
+  }
+
+  for (int i = MOVIECACHE_LIMITER_SHARDS - 1; i >= 0; i--) {
+    BLI_mutex_unlock(&limiter_shards[i].mutex);
+  }
+}
+
 void IMB_moviecache_init(void)
 {
-  limitor = new_MEM_CacheLimiter(IMB_moviecache_destructor, get_item_size);
+  MovieCacheLimiterShard *shards = MEM_callocN(sizeof(*shards) * MOVIECACHE_LIMITER_SHARDS,
+                                               "MovieCacheLimiterShard");
 
-  MEM_CacheLimiter_ItemPriority_Func_set(limitor, get_item_priority);
-  MEM_CacheLimiter_ItemDestroyable_Func_set(limitor, get_item_destroyable);
+  for (int i = 0; i < MOVIECACHE_LIMITER_SHARDS; i++) {
+    BLI_mutex_init(&shards[i].mutex);
+  }
+
+  limiter_shards = shards;
 }
 
 void IMB_moviecache_destruct(void)
 {
-  if (limitor) {
-    delete_MEM_CacheLimiter(limitor);
+  if (limiter_shards) {
+    for (int i = 0; i < MOVIECACHE_LIMITER_SHARDS; i++) {
+      BLI_mutex_end(&limiter_shards[i].mutex);
+    }
+    MEM_freeN(limiter_shards);
+    limiter_shards = NULL;
   }
 }
 
@@ -278,6 +451,8 @@ MovieCache *IMB_moviecache_create(const char *name,
   cache->userkeys_pool = BLI_mempool_create(keysize, 0, 64, BLI_MEMPOOL_NOP);
   cache->hash = BLI_ghash_new(
       moviecache_hashhash, moviecache_hashcmp, "MovieClip ImBuf cache hash");
+  BLI_rw_mutex_init(&cache->hash_lock);
+  BLI_mutex_init(&cache->last_userkey_lock);
 
   cache->keysize = keysize;
   cache->hashfp = hashfp;
@@ -298,23 +473,30 @@ void IMB_moviecache_set_priority_callback(struct MovieCache *cache,
                                           MovieCachePriorityDeleterFP prioritydeleterfp)
 {
   cache->last_userkey = MEM_mallocN(cache->keysize, "movie cache last user key");
+  cache->priority_userkey = MEM_mallocN(cache->keysize, "movie cache priority user key");
 
   cache->getprioritydatafp = getprioritydatafp;
   cache->getitempriorityfp = getitempriorityfp;
   cache->prioritydeleterfp = prioritydeleterfp;
 }
 
-static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, bool need_lock)
+void IMB_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
   MovieCacheKey *key;
   MovieCacheItem *item;
 
-  if (!limitor) {
-    IMB_moviecache_init();
+  if (!limiter_shards) {
+    BLI_mutex_lock(&limiter_init_lock);
+    if (!limiter_shards) {
+      IMB_moviecache_init();
+    }
+    BLI_mutex_unlock(&limiter_init_lock);
   }
 
   IMB_refImBuf(ibuf);
 
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_WRITE);
+
   key = BLI_mempool_alloc(cache->keys_pool);
   key->cache_owner = cache;
   key->userkey = BLI_mempool_alloc(cache->userkeys_pool);
@@ -326,8 +508,9 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
 
   item->ibuf = ibuf;
   item->cache_owner = cache;
-  item->c_handle = NULL;
   item->priority_data = NULL;
+  item->shard = NULL;
+  item->size = get_item_size(item);
 
   if (cache->getprioritydatafp) {
     item->priority_data = cache->getprioritydatafp(userkey);
@@ -336,22 +519,23 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
   BLI_ghash_reinsert(cache->hash, key, item, moviecache_keyfree, moviecache_valfree);
 
   if (cache->last_userkey) {
+    BLI_mutex_lock(&cache->last_userkey_lock);
     memcpy(cache->last_userkey, userkey, cache->keysize);
+    BLI_mutex_unlock(&cache->last_userkey_lock);
   }
 
-  if (need_lock) {
-    BLI_mutex_lock(&limitor_lock);
-  }
+  MovieCacheLimiterShard *shard = moviecache_limiter_shard_get(cache, userkey);
 
-  item->c_handle = MEM_CacheLimiter_insert(limitor, item);
+  BLI_mutex_lock(&shard->mutex);
 
-  MEM_CacheLimiter_ref(item->c_handle);
-  MEM_CacheLimiter_enforce_limits(limitor);
-  MEM_CacheLimiter_unref(item->c_handle);
+  item->shard = shard;
+  item->last_access = atomic_add_and_fetch_uint64(&limiter_access_clock, 1);
+  BLI_addtail(&shard->items, item);
+  moviecache_limiter_memory_add(shard, item->size);
 
-  if (need_lock) {
-    BLI_mutex_unlock(&limitor_lock);
-  }
+  BLI_mutex_unlock(&shard->mutex);
+
+  moviecache_limiter_enforce(item);
 
   /* cache limiter can't remove unused keys which points to destroyed values */
   check_unused_keys(cache);
@@ -360,32 +544,24 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
     MEM_freeN(cache->points);
     cache->points = NULL;
   }
-}
 
-void IMB_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf)
-{
-  do_moviecache_put(cache, userkey, ibuf, true);
+  BLI_rw_mutex_unlock(&cache->hash_lock);
 }
 
 bool IMB_moviecache_put_if_possible(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
   size_t mem_in_use, mem_limit, elem_size;
-  bool result = false;
 
   elem_size = get_size_in_memory(ibuf);
   mem_limit = MEM_CacheLimiter_get_maximum();
-
-  BLI_mutex_lock(&limitor_lock);
-  mem_in_use = MEM_CacheLimiter_get_memory_in_use(limitor);
+  mem_in_use = atomic_add_and_fetch_z(&limiter_memory_in_use, 0);
 
   if (mem_in_use + elem_size <= mem_limit) {
-    do_moviecache_put(cache, userkey, ibuf, false);
-    result = true;
+    IMB_moviecache_put(cache, userkey, ibuf);
+    return true;
   }
 
-  BLI_mutex_unlock(&limitor_lock);
-
-  return result;
+  return false;
 }
 
 void IMB_moviecache_remove(MovieCache *cache, void *userkey)
@@ -393,31 +569,41 @@ void IMB_moviecache_remove(MovieCache *cache, void *userkey)
   MovieCacheKey key;
   key.cache_owner = cache;
   key.userkey = userkey;
+
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_WRITE);
   BLI_ghash_remove(cache->hash, &key, moviecache_keyfree, moviecache_valfree);
+  BLI_rw_mutex_unlock(&cache->hash_lock);
 }
 
 ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey)
 {
   MovieCacheKey key;
   MovieCacheItem *item;
+  ImBuf *ibuf = NULL;
 
   key.cache_owner = cache;
   key.userkey = userkey;
+
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_READ);
   item = (MovieCacheItem *)BLI_ghash_lookup(cache->hash, &key);
 
   if (item) {
+    MovieCacheLimiterShard *shard = item->shard;
+
+    BLI_mutex_lock(&shard->mutex);
     if (item->ibuf) {
-      BLI_mutex_lock(&limitor_lock);
-      MEM_CacheLimiter_touch(item->c_handle);
-      BLI_mutex_unlock(&limitor_lock);
+      item->last_access = atomic_add_and_fetch_uint64(&limiter_access_clock, 1);
+      moviecache_limiter_item_update_size(shard, item);
 
       IMB_refImBuf(item->ibuf);
-
-      return item->ibuf;
+      ibuf = item->ibuf;
     }
+    BLI_mutex_unlock(&shard->mutex);
   }
 
-  return NULL;
+  BLI_rw_mutex_unlock(&cache->hash_lock);
+
+  return ibuf;
 }
 
 bool IMB_moviecache_has_frame(MovieCache *cache, void *userkey)
@@ -427,7 +613,10 @@ bool IMB_moviecache_has_frame(MovieCache *cache, void *userkey)
 
   key.cache_owner = cache;
   key.userkey = userkey;
+
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_READ);
   item = (MovieCacheItem *)BLI_ghash_lookup(cache->hash, &key);
+  BLI_rw_mutex_unlock(&cache->hash_lock);
 
   return item != NULL;
 }
@@ -437,6 +626,8 @@ void IMB_moviecache_free(MovieCache *cache)
   PRINT("%s: cache '%s' free\n", __func__, cache->name);
 
   BLI_ghash_free(cache->hash, moviecache_keyfree, moviecache_valfree);
+  BLI_rw_mutex_end(&cache->hash_lock);
+  BLI_mutex_end(&cache->last_userkey_lock);
 
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
@@ -448,6 +639,7 @@ void IMB_moviecache_free(MovieCache *cache)
 
   if (cache->last_userkey) {
     MEM_freeN(cache->last_userkey);
+    MEM_freeN(cache->priority_userkey);
   }
 
   MEM_freeN(cache);
@@ -459,6 +651,8 @@ void IMB_moviecache_cleanup(MovieCache *cache,
 {
   GHashIterator gh_iter;
 
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_WRITE);
+
   check_unused_keys(cache);
 
   BLI_ghashIterator_init(&gh_iter, cache->hash);
@@ -475,6 +669,8 @@ void IMB_moviecache_cleanup(MovieCache *cache,
       BLI_ghash_remove(cache->hash, key, moviecache_keyfree, moviecache_valfree);
     }
   }
+
+  BLI_rw_mutex_unlock(&cache->hash_lock);
 }
 
 /* get segments of cached frames. useful for debugging cache policies */
@@ -488,6 +684,17 @@ void IMB_moviecache_get_cache_segments(
     return;
   }
 
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_WRITE);
+
+  /* Segments need to be updated when the limiter freed buffers. */
+  if (atomic_add_and_fetch_int32(&cache->unused_len, 0) != 0) {
+    check_unused_keys(cache);
+    if (cache->points) {
+      MEM_freeN(cache->points);
+      cache->points = NULL;
+    }
+  }
+
   if (cache->proxy != proxy || cache->render_flags != render_flags) {
     if (cache->points) {
       MEM_freeN(cache->points);
@@ -566,13 +773,18 @@ void IMB_moviecache_get_cache_segments(
 
     MEM_freeN(frames);
   }
+
+  BLI_rw_mutex_unlock(&cache->hash_lock);
 }
 
 struct MovieCacheIter *IMB_moviecacheIter_new(MovieCache *cache)
 {
   GHashIterator *iter;
 
+  BLI_rw_mutex_lock(&cache->hash_lock, THREAD_LOCK_WRITE);
   check_unused_keys(cache);
+  BLI_rw_mutex_unlock(&cache->hash_lock);
+
   iter = BLI_ghashIterator_new(cache->hash);
 
   return (struct MovieCacheIter *)iter;
@@ -54,6 +54,11 @@ typedef struct CustomDataLayer {
   char name[64];
   /** Layer data. */
   void *data;
+  /**
+   * Runtime only: users of the layer data when it is shared with other layers,
+   * NULL when the data is owned by this layer alone.
+   */
+  struct CustomDataSharingInfo *sharing_info;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
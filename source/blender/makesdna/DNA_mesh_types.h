@@ -105,6 +105,15 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /**
+   * Transforms of copies of this mesh output by modifiers as instances instead of geometry,
+   * relative to the mesh itself which is not part of them (see #OB_DUPLIMESH). */
+  float (*instance_mats)[4][4];
+  /** Geometry of the mesh and all its instances, for readers outside of the object. */
+  struct Mesh *instances_realized;
+  int instance_mats_len;
+  char _pad3[4];
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
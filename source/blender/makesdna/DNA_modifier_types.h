@@ -307,6 +307,7 @@ typedef struct ArrayModifierData {
   int offset_type;
   /* general flags:
    * MOD_ARR_MERGE -> merge vertices in adjacent duplicates
+   * MOD_ARR_INSTANCE -> output the copies as instances when possible
    */
   int flags;
   /* the number of duplicates to generate for MOD_ARR_FIXEDCOUNT */
@@ -332,6 +333,7 @@ enum {
 enum {
   MOD_ARR_MERGE = (1 << 0),
   MOD_ARR_MERGEFINAL = (1 << 1),
+  MOD_ARR_INSTANCE = (1 << 2),
 };
 
 typedef struct MirrorModifierData {
@@ -828,8 +830,11 @@ typedef struct BooleanModifierData {
   ModifierData modifier;
 
   struct Object *object;
+  /** Operands used instead of #object when the operand type is a collection. */
+  struct Collection *collection;
   char operation;
-  char _pad[2];
+  char solver;
+  char operand_type;
   char bm_flag;
   float double_threshold;
 } BooleanModifierData;
@@ -840,6 +845,18 @@ typedef enum {
   eBooleanModifierOp_Difference = 2,
 } BooleanModifierOp;
 
+/* solver */
+typedef enum {
+  eBooleanModifierSolver_BMesh = 0,
+  eBooleanModifierSolver_Mesh = 1,
+} BooleanModifierSolver;
+
+/* operand_type */
+typedef enum {
+  eBooleanModifierOperandType_Object = 0,
+  eBooleanModifierOperandType_Collection = 1,
+} BooleanModifierOperandType;
+
 /* bm_flag (only used when G_DEBUG) */
 enum {
   eBooleanModifierBMeshFlag_BMesh_Separate = (1 << 0),
@@ -467,7 +467,8 @@ typedef struct bNodeTree {
    * in case multiple different editors are used and make context ambiguous.
    */
   bNodeInstanceKey active_viewer_key;
-  char _pad[4];
+  /** Compositor: memory in megabytes for results kept between executions while editing. */
+  int cache_limit;
 
   /** Execution data.
    *
@@ -508,7 +508,9 @@ enum {
   OB_DUPLIFACES = 1 << 9,
   OB_DUPLIFACES_SCALE = 1 << 10,
   OB_DUPLIPARTS = 1 << 11,
-  OB_TRANSFLAG_UNUSED_12 = 1 << 12, /* cleared */
+  /* runtime, evaluated mesh has instances, see #Mesh_Runtime.instance_mats,
+   * not part of #OB_DUPLI since they come in addition to the other dupli kinds */
+  OB_DUPLIMESH = 1 << 12,
   /* runtime constraints disable */
   OB_NO_CONSTRAINTS = 1 << 13,
   /* hack to work around particle issue */
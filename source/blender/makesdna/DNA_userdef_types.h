@@ -853,6 +853,15 @@ typedef struct UserDef {
   char filebrowser_display_type; /* eUserpref_TempSpaceDisplayType */
   char _pad5[4];
 
+  /** Directory of the sequencer disk cache, see #SEQ_CACHE_DISK_CACHE_ENABLE. */
+  char sequencer_disk_cache_dir[1024];
+  /** #eUserpref_DiskCacheCompression. */
+  int sequencer_disk_cache_compression;
+  /** Disk cache size limit in gigabytes. */
+  int sequencer_disk_cache_size_limit;
+  short sequencer_disk_cache_flag;
+  char _pad14[6];
+
   struct WalkNavigation walk_navigation;
 
   /** The UI for the user preferences. */
@@ -1282,6 +1291,13 @@ typedef enum eUserpref_EmulateMMBMod {
   USER_EMU_MMB_MOD_OSKEY = 1,
 } eUserpref_EmulateMMBMod;
 
+/** #UserDef.sequencer_disk_cache_compression */
+typedef enum eUserpref_DiskCacheCompression {
+  USER_SEQ_DISK_CACHE_COMPRESSION_NONE = 0,
+  USER_SEQ_DISK_CACHE_COMPRESSION_LOW = 1,
+  USER_SEQ_DISK_CACHE_COMPRESSION_HIGH = 2,
+} eUserpref_DiskCacheCompression;
+
 #ifdef __cplusplus
 }
 #endif
@@ -115,6 +115,20 @@ static CustomData *rna_mesh_fdata_helper(Mesh *me)
   return (me->edit_mesh) ? NULL : &me->fdata;
 }
 
+/**
+ * Items of the collections can be written to, so the layers they point into must not be shared
+ * with an evaluated copy of the mesh (see #CD_SHARE). Edit-mesh layers are never shared.
+ */
+static void rna_mesh_layer_ensure_owned(Mesh *me,
+                                        CustomData *cdata,
+                                        CustomDataLayer *layer,
+                                        const int totelem)
+{
+  if (me->edit_mesh == NULL) {
+    CustomData_duplicate_referenced_layer_named(cdata, layer->type, layer->name, totelem);
+  }
+}
+
 static CustomData *rna_mesh_vdata(PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
@@ -517,13 +531,45 @@ static void rna_Mesh_texspace_loc_get(PointerRNA *ptr, float values[3])
   copy_v3_v3(values, me->loc);
 }
 
+static void rna_Mesh_vertices_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  me->mvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
+  rna_iterator_array_begin(iter, me->mvert, sizeof(MVert), me->totvert, 0, NULL);
+}
+
+static void rna_Mesh_edges_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  me->medge = CustomData_duplicate_referenced_layer(&me->edata, CD_MEDGE, me->totedge);
+  rna_iterator_array_begin(iter, me->medge, sizeof(MEdge), me->totedge, 0, NULL);
+}
+
+static void rna_Mesh_loops_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  me->mloop = CustomData_duplicate_referenced_layer(&me->ldata, CD_MLOOP, me->totloop);
+  rna_iterator_array_begin(iter, me->mloop, sizeof(MLoop), me->totloop, 0, NULL);
+}
+
+static void rna_Mesh_polygons_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  me->mpoly = CustomData_duplicate_referenced_layer(&me->pdata, CD_MPOLY, me->totpoly);
+  rna_iterator_array_begin(iter, me->mpoly, sizeof(MPoly), me->totpoly, 0, NULL);
+}
+
 static void rna_MeshVertex_groups_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
 
   if (me->dvert) {
     MVert *mvert = (MVert *)ptr->data;
-    MDeformVert *dvert = me->dvert + (mvert - me->mvert);
+    MDeformVert *dvert;
+
+    /* Weights may be shared with an evaluated copy of the mesh, see #CD_SHARE. */
+    me->dvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MDEFORMVERT, me->totvert);
+    dvert = me->dvert + (mvert - me->mvert);
 
     rna_iterator_array_begin(
         iter, (void *)dvert->dw, sizeof(MDeformWeight), dvert->totweight, 0, NULL);
@@ -676,6 +722,7 @@ static void rna_MeshUVLoopLayer_data_begin(CollectionPropertyIterator *iter, Poi
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->ldata, layer, me->totloop);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MLoopUV), (me->edit_mesh) ? 0 : me->totloop, 0, NULL);
 }
@@ -728,6 +775,7 @@ static void rna_MeshLoopColorLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->ldata, layer, me->totloop);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MLoopCol), (me->edit_mesh) ? 0 : me->totloop, 0, NULL);
 }
@@ -887,6 +935,7 @@ static void rna_MeshSkinVertexLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->vdata, layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MVertSkin), me->totvert, 0, NULL);
 }
 
@@ -918,6 +967,7 @@ static void rna_MeshPaintMaskLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->vdata, layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totvert, 0, NULL);
 }
 
@@ -947,6 +997,7 @@ static void rna_MeshFaceMapLayer_data_begin(CollectionPropertyIterator *iter, Po
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->pdata, layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(int), me->totpoly, 0, NULL);
 }
 
@@ -1248,6 +1299,7 @@ static void rna_MeshVertexFloatPropertyLayer_data_begin(CollectionPropertyIterat
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->vdata, layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totvert, 0, NULL);
 }
 static void rna_MeshPolygonFloatPropertyLayer_data_begin(CollectionPropertyIterator *iter,
@@ -1255,6 +1307,7 @@ static void rna_MeshPolygonFloatPropertyLayer_data_begin(CollectionPropertyItera
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->pdata, layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totpoly, 0, NULL);
 }
 
@@ -1299,6 +1352,7 @@ static void rna_MeshVertexIntPropertyLayer_data_begin(CollectionPropertyIterator
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->vdata, layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MIntProperty), me->totvert, 0, NULL);
 }
 static void rna_MeshPolygonIntPropertyLayer_data_begin(CollectionPropertyIterator *iter,
@@ -1306,6 +1360,7 @@ static void rna_MeshPolygonIntPropertyLayer_data_begin(CollectionPropertyIterato
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->pdata, layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(MIntProperty), me->totpoly, 0, NULL);
 }
 
@@ -1350,6 +1405,7 @@ static void rna_MeshVertexStringPropertyLayer_data_begin(CollectionPropertyItera
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->vdata, layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MStringProperty), me->totvert, 0, NULL);
 }
 static void rna_MeshPolygonStringPropertyLayer_data_begin(CollectionPropertyIterator *iter,
@@ -1357,6 +1413,7 @@ static void rna_MeshPolygonStringPropertyLayer_data_begin(CollectionPropertyIter
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  rna_mesh_layer_ensure_owned(me, &me->pdata, layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(MStringProperty), me->totpoly, 0, NULL);
 }
 
@@ -2742,24 +2799,60 @@ static void rna_def_mesh(BlenderRNA *brna)
 
   prop = RNA_def_property(srna, "vertices", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "mvert", "totvert");
+  RNA_def_property_collection_funcs(prop,
+                                    "rna_Mesh_vertices_begin",
+                                    "rna_iterator_array_next",
+                                    "rna_iterator_array_end",
+                                    "rna_iterator_array_get",
+                                    NULL,
+                                    NULL,
+                                    NULL,
+                                    NULL);
   RNA_def_property_struct_type(prop, "MeshVertex");
   RNA_def_property_ui_text(prop, "Vertices", "Vertices of the mesh");
   rna_def_mesh_vertices(brna, prop);
 
   prop = RNA_def_property(srna, "edges", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "medge", "totedge");
+  RNA_def_property_collection_funcs(prop,
+                                    "rna_Mesh_edges_begin",
+                                    "rna_iterator_array_next",
+                                    "rna_iterator_array_end",
+                                    "rna_iterator_array_get",
+                                    NULL,
+                                    NULL,
+                                    NULL,
+                                    NULL);
   RNA_def_property_struct_type(prop, "MeshEdge");
   RNA_def_property_ui_text(prop, "Edges", "Edges of the mesh");
   rna_def_mesh_edges(brna, prop);
 
   prop = RNA_def_property(srna, "loops", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "mloop", "totloop");
+  RNA_def_property_collection_funcs(prop,
+                                    "rna_Mesh_loops_begin",
+                                    "rna_iterator_array_next",
+                                    "rna_iterator_array_end",
+                                    "rna_iterator_array_get",
+                                    NULL,
+                                    NULL,
+                                    NULL,
+                                    NULL);
   RNA_def_property_struct_type(prop, "MeshLoop");
   RNA_def_property_ui_text(prop, "Loops", "Loops of the mesh (polygon corners)");
   rna_def_mesh_loops(brna, prop);
 
   prop = RNA_def_property(srna, "polygons", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "mpoly", "totpoly");
+  RNA_def_property_collection_funcs(prop,
+                                    "rna_Mesh_polygons_begin",
+                                    "rna_iterator_array_next",
+                                    "rna_iterator_array_end",
+                                    "rna_iterator_array_get",
+                                    NULL,
+                                    NULL,
+                                    NULL,
+                                    NULL);
   RNA_def_property_struct_type(prop, "MeshPolygon");
   RNA_def_property_ui_text(prop, "Polygons", "Polygons of the mesh");
   rna_def_mesh_polygons(brna, prop);
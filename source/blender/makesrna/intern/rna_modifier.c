@@ -2595,6 +2595,35 @@ static void rna_def_modifier_boolean(BlenderRNA *brna)
       {0, NULL, 0, NULL, NULL},
   };
 
+  static const EnumPropertyItem prop_operand_items[] = {
+      {eBooleanModifierOperandType_Object,
+       "OBJECT",
+       0,
+       "Object",
+       "Use a mesh object as the operand for the Boolean operation"},
+      {eBooleanModifierOperandType_Collection,
+       "COLLECTION",
+       0,
+       "Collection",
+       "Use mesh objects in a collection as operands for the Boolean operation"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
+  static const EnumPropertyItem prop_solver_items[] = {
+      {eBooleanModifierSolver_BMesh,
+       "BMESH",
+       0,
+       "BMesh",
+       "Intersect through BMesh, one operand after the other"},
+      {eBooleanModifierSolver_Mesh,
+       "MESH",
+       0,
+       "Mesh",
+       "Faster multi-threaded solver, calculates all operands at once and only triangulates "
+       "the faces that are cut"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "BooleanModifier", "Modifier");
   RNA_def_struct_ui_text(srna, "Boolean Modifier", "Boolean operations modifier");
   RNA_def_struct_sdna(srna, "BooleanModifierData");
@@ -2608,12 +2637,32 @@ static void rna_def_modifier_boolean(BlenderRNA *brna)
   RNA_def_property_override_flag(prop, PROPOVERRIDE_OVERRIDABLE_LIBRARY);
   RNA_def_property_update(prop, 0, "rna_Modifier_dependency_update");
 
+  prop = RNA_def_property(srna, "collection", PROP_POINTER, PROP_NONE);
+  RNA_def_property_pointer_sdna(prop, NULL, "collection");
+  RNA_def_property_struct_type(prop, "Collection");
+  RNA_def_property_flag(prop, PROP_EDITABLE);
+  RNA_def_property_override_flag(prop, PROPOVERRIDE_OVERRIDABLE_LIBRARY);
+  RNA_def_property_ui_text(
+      prop, "Collection", "Use mesh objects in this collection for Boolean operation");
+  RNA_def_property_update(prop, 0, "rna_Modifier_dependency_update");
+
   prop = RNA_def_property(srna, "operation", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_items(prop, prop_operation_items);
   RNA_def_property_enum_default(prop, eBooleanModifierOp_Difference);
   RNA_def_property_ui_text(prop, "Operation", "");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "operand_type", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_items(prop, prop_operand_items);
+  RNA_def_property_ui_text(prop, "Operand Type", "");
+  RNA_def_property_update(prop, 0, "rna_Modifier_dependency_update");
+
+  prop = RNA_def_property(srna, "solver", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_items(prop, prop_solver_items);
+  RNA_def_property_enum_default(prop, eBooleanModifierSolver_BMesh);
+  RNA_def_property_ui_text(prop, "Solver", "Method for calculating the boolean");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   prop = RNA_def_property(srna, "double_threshold", PROP_FLOAT, PROP_DISTANCE);
   RNA_def_property_float_sdna(prop, NULL, "double_threshold");
   RNA_def_property_range(prop, 0, 1.0f);
@@ -2743,6 +2792,15 @@ static void rna_def_modifier_array(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Merge Distance", "Limit below which to merge vertices");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_instances", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flags", MOD_ARR_INSTANCE);
+  RNA_def_property_ui_text(prop,
+                           "Instances",
+                           "Output the duplicates as instances of the geometry, when they are "
+                           "not merged or capped, no other modifier follows and no other object "
+                           "uses the geometry");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   /* Offset object */
   prop = RNA_def_property(srna, "use_object_offset", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "offset_type", MOD_ARR_OFF_OBJ);
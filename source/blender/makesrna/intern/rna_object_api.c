@@ -73,6 +73,7 @@ static const EnumPropertyItem space_items[] = {
 #  include "BKE_layer.h"
 #  include "BKE_main.h"
 #  include "BKE_mesh.h"
+#  include "BKE_mesh_runtime.h"
 #  include "BKE_mball.h"
 #  include "BKE_modifier.h"
 #  include "BKE_object.h"
@@ -359,7 +360,8 @@ static void rna_Object_camera_fit_coords(
 static Mesh *rna_Object_to_mesh(Object *object,
                                 ReportList *reports,
                                 bool preserve_all_data_layers,
-                                Depsgraph *depsgraph)
+                                Depsgraph *depsgraph,
+                                bool realize_instances)
 {
   /* TODO(sergey): Make it more re-usable function, de-duplicate with
    * rna_Main_meshes_new_from_object. */
@@ -375,7 +377,7 @@ static Mesh *rna_Object_to_mesh(Object *object,
       return NULL;
   }
 
-  return BKE_object_to_mesh(depsgraph, object, preserve_all_data_layers);
+  return BKE_object_to_mesh(depsgraph, object, preserve_all_data_layers, realize_instances);
 }
 
 static void rna_Object_to_mesh_clear(Object *object)
@@ -535,10 +537,12 @@ static void rna_Object_ray_cast(Object *ob,
       (isect_ray_aabb_v3_simple(origin, direction, bb->vec[0], bb->vec[6], &distmin, NULL) &&
        distmin <= distance)) {
     BVHTreeFromMesh treeData = {NULL};
+    /* Hits on instances are reported like hits on the rest of the object. */
+    Mesh *mesh_eval = BKE_mesh_runtime_instances_realized_ensure(ob->runtime.mesh_eval);
 
     /* No need to managing allocation or freeing of the BVH data.
      * This is generated and freed as needed. */
-    BKE_bvhtree_from_mesh_get(&treeData, ob->runtime.mesh_eval, BVHTREE_FROM_LOOPTRI, 4);
+    BKE_bvhtree_from_mesh_get(&treeData, mesh_eval, BVHTREE_FROM_LOOPTRI, 4);
 
     /* may fail if the mesh has no faces, in that case the ray-cast misses */
     if (treeData.tree != NULL) {
@@ -559,8 +563,7 @@ static void rna_Object_ray_cast(Object *ob,
 
           copy_v3_v3(r_location, hit.co);
           copy_v3_v3(r_normal, hit.no);
-          *r_index = mesh_looptri_to_poly_index(ob->runtime.mesh_eval,
-                                                &treeData.looptri[hit.index]);
+          *r_index = mesh_looptri_to_poly_index(mesh_eval, &treeData.looptri[hit.index]);
         }
       }
 
@@ -594,9 +597,11 @@ static void rna_Object_closest_point_on_mesh(Object *ob,
     return;
   }
 
+  Mesh *mesh_eval = BKE_mesh_runtime_instances_realized_ensure(ob->runtime.mesh_eval);
+
   /* No need to managing allocation or freeing of the BVH data.
    * this is generated and freed as needed. */
-  BKE_bvhtree_from_mesh_get(&treeData, ob->runtime.mesh_eval, BVHTREE_FROM_LOOPTRI, 4);
+  BKE_bvhtree_from_mesh_get(&treeData, mesh_eval, BVHTREE_FROM_LOOPTRI, 4);
 
   if (treeData.tree == NULL) {
     BKE_reportf(reports,
@@ -617,8 +622,7 @@ static void rna_Object_closest_point_on_mesh(Object *ob,
 
       copy_v3_v3(r_location, nearest.co);
       copy_v3_v3(r_normal, nearest.no);
-      *r_index = mesh_looptri_to_poly_index(ob->runtime.mesh_eval,
-                                            &treeData.looptri[nearest.index]);
+      *r_index = mesh_looptri_to_poly_index(mesh_eval, &treeData.looptri[nearest.index]);
 
       goto finally;
     }
@@ -646,8 +650,6 @@ static bool rna_Object_is_deform_modified(Object *ob, Scene *scene, int settings
 
 #  ifndef NDEBUG
 
-#    include "BKE_mesh_runtime.h"
-
 void rna_Object_me_eval_info(
     struct Object *ob, bContext *C, int type, PointerRNA *rnaptr_depsgraph, char *result)
 {
@@ -939,6 +941,13 @@ void RNA_api_object(StructRNA *srna)
       "Depsgraph",
       "Dependency Graph",
       "Evaluated dependency graph which is required when preserve_all_data_layers is true");
+  RNA_def_boolean(func,
+                  "realize_instances",
+                  true,
+                  "",
+                  "Include the copies the modifiers output as instances of the mesh. "
+                  "Disable when the instances are read from the object instances of the "
+                  "dependency graph, so they are not exported twice");
   parm = RNA_def_pointer(func, "mesh", "Mesh", "", "Mesh created from object");
   RNA_def_function_return(func, parm);
 
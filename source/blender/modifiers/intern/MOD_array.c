@@ -267,6 +267,40 @@ static void dm_mvert_map_doubles(int *doubles_map,
   MEM_freeN(sorted_verts_target);
 }
 
+/* Copies can be output as instances of the input mesh when they are only transformed,
+ * and no modifier after this one nor other object needs their geometry. */
+static bool array_use_instances(const ArrayModifierData *amd, const ModifierEvalContext *ctx)
+{
+  if ((amd->flags & MOD_ARR_INSTANCE) == 0) {
+    return false;
+  }
+  /* Merged, capped or UV offset copies differ from the input. */
+  if ((amd->flags & MOD_ARR_MERGE) || amd->start_cap || amd->end_cap ||
+      !is_zero_v2(amd->uv_offset)) {
+    return false;
+  }
+  /* Edit-mode displays the geometry of the result. */
+  if (ctx->object->mode & OB_MODE_EDIT) {
+    return false;
+  }
+  /* Other objects reading the geometry, like Boolean operands or Shrinkwrap targets,
+   * need all the copies. */
+  if (DEG_id_component_has_other_users(ctx->depsgraph, &ctx->object->id, DEG_OB_COMP_GEOMETRY)) {
+    return false;
+  }
+
+  /* Without a depsgraph only the modes of the following modifiers are checked. */
+  const Scene *scene = (ctx->depsgraph != NULL) ? DEG_get_evaluated_scene(ctx->depsgraph) : NULL;
+  const int required_mode = (ctx->flag & MOD_APPLY_RENDER) ? eModifierMode_Render :
+                                                             eModifierMode_Realtime;
+  for (ModifierData *md = amd->modifier.next; md; md = md->next) {
+    if (modifier_isEnabled(scene, md, required_mode)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void mesh_merge_transform(Mesh *result,
                                  Mesh *cap_mesh,
                                  const float cap_offset[4][4],
@@ -493,6 +527,23 @@ static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
     count = 1;
   }
 
+  if (count > 1 && array_use_instances(amd, ctx)) {
+    /* Only the input is kept as geometry, the other copies are placed relative to it. */
+    float(*instance_mats)[4][4] = MEM_malloc_arrayN(
+        count - 1, sizeof(*instance_mats), "mod array instances");
+    unit_m4(current_offset);
+    for (c = 1; c < count; c++) {
+      mul_m4_m4m4(current_offset, current_offset, offset);
+      copy_m4_m4(instance_mats[c - 1], current_offset);
+    }
+
+    result = BKE_mesh_copy_for_eval(mesh, false);
+    BLI_assert(result->runtime.instance_mats == NULL);
+    result->runtime.instance_mats = instance_mats;
+    result->runtime.instance_mats_len = count - 1;
+    return result;
+  }
+
   /* The number of verts, edges, loops, polys, before eventually merging doubles */
   result_nverts = chunk_nverts * count + start_cap_nverts + end_cap_nverts;
   result_nedges = chunk_nedges * count + start_cap_nedges + end_cap_nedges;
@@ -31,15 +31,19 @@
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 
+#include "DNA_collection_types.h"
+#include "DNA_layer_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BKE_collection.h"
 #include "BKE_global.h" /* only to check G.debug */
 #include "BKE_library.h"
 #include "BKE_library_query.h"
 #include "BKE_material.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_boolean.h"
 #include "BKE_modifier.h"
 
 #include "MOD_util.h"
@@ -63,6 +67,8 @@ static void initData(ModifierData *md)
 
   bmd->double_threshold = 1e-6f;
   bmd->operation = eBooleanModifierOp_Difference;
+  bmd->solver = eBooleanModifierSolver_BMesh;
+  bmd->operand_type = eBooleanModifierOperandType_Object;
 }
 
 static bool isDisabled(const struct Scene *UNUSED(scene),
@@ -76,6 +82,9 @@ static bool isDisabled(const struct Scene *UNUSED(scene),
    *
    * In other cases it should be impossible to have a type mismatch.
    */
+  if (bmd->operand_type == eBooleanModifierOperandType_Collection) {
+    return !bmd->collection;
+  }
   return !bmd->object || bmd->object->type != OB_MESH;
 }
 
@@ -86,10 +95,31 @@ static void foreachObjectLink(ModifierData *md, Object *ob, ObjectWalkFunc walk,
   walk(userData, ob, &bmd->object, IDWALK_CB_NOP);
 }
 
+static void foreachIDLink(ModifierData *md, Object *ob, IDWalkFunc walk, void *userData)
+{
+  BooleanModifierData *bmd = (BooleanModifierData *)md;
+
+  walk(userData, ob, (ID **)&bmd->collection, IDWALK_CB_NOP);
+
+  foreachObjectLink(md, ob, (ObjectWalkFunc)walk, userData);
+}
+
 static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphContext *ctx)
 {
   BooleanModifierData *bmd = (BooleanModifierData *)md;
-  if (bmd->object != NULL) {
+  if (bmd->operand_type == eBooleanModifierOperandType_Collection) {
+    if (bmd->collection != NULL) {
+      FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (bmd->collection, operand_ob) {
+        if (operand_ob->type == OB_MESH && operand_ob != ctx->object) {
+          DEG_add_object_relation(
+              ctx->node, operand_ob, DEG_OB_COMP_TRANSFORM, "Boolean Modifier");
+          DEG_add_object_relation(ctx->node, operand_ob, DEG_OB_COMP_GEOMETRY, "Boolean Modifier");
+        }
+      }
+      FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+    }
+  }
+  else if (bmd->object != NULL) {
     DEG_add_object_relation(ctx->node, bmd->object, DEG_OB_COMP_TRANSFORM, "Boolean Modifier");
     DEG_add_object_relation(ctx->node, bmd->object, DEG_OB_COMP_GEOMETRY, "Boolean Modifier");
   }
@@ -153,18 +183,19 @@ static int bm_face_isect_pair(BMFace *f, void *UNUSED(user_data))
   return BM_elem_flag_test(f, BM_FACE_TAG) ? 1 : 0;
 }
 
-static Mesh *applyModifier(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
+/**
+ * Apply the boolean with a single operand through BMesh.
+ * \return \a mesh when the operand has no geometry, NULL on failure.
+ */
+static Mesh *boolean_operand_apply_bmesh(BooleanModifierData *bmd,
+                                         const ModifierEvalContext *ctx,
+                                         Mesh *mesh,
+                                         Object *other)
 {
-  BooleanModifierData *bmd = (BooleanModifierData *)md;
   Mesh *result = mesh;
 
   Mesh *mesh_other;
 
-  if (bmd->object == NULL) {
-    return result;
-  }
-
-  Object *other = bmd->object;
   mesh_other = BKE_modifier_get_evaluated_mesh_from_evaluated_object(other, false);
   if (mesh_other) {
     Object *object = ctx->object;
@@ -326,14 +357,143 @@ static Mesh *applyModifier(ModifierData *md, const ModifierEvalContext *ctx, Mes
       TIMEIT_END(boolean_bmesh);
 #endif
     }
+  }
 
-    /* if new mesh returned, return it; otherwise there was
-     * an error, so delete the modifier object */
-    if (result == NULL) {
-      modifier_setError(md, "Cannot execute boolean operation");
+  return result;
+}
+
+/**
+ * Apply the boolean with all operands in a single pass, without converting to BMesh.
+ */
+static Mesh *boolean_operands_apply_mesh(BooleanModifierData *bmd,
+                                         const ModifierEvalContext *ctx,
+                                         Mesh *mesh,
+                                         Object **operand_obs,
+                                         const int operand_obs_len)
+{
+  Object *object = ctx->object;
+  MeshBooleanOperand *operands = MEM_calloc_arrayN(
+      operand_obs_len + 1, sizeof(*operands), __func__);
+  int operands_len = 0;
+
+  operands[operands_len].mesh = mesh;
+  unit_m4(operands[operands_len].obmat);
+  operands_len++;
+
+  float imat[4][4];
+  invert_m4_m4(imat, object->obmat);
+
+  for (int i = 0; i < operand_obs_len; i++) {
+    Object *other = operand_obs[i];
+    Mesh *mesh_other = BKE_modifier_get_evaluated_mesh_from_evaluated_object(other, false);
+    if (mesh_other == NULL) {
+      continue;
+    }
+
+    MeshBooleanOperand *operand = &operands[operands_len++];
+    operand->mesh = mesh_other;
+    mul_m4_m4m4(operand->obmat, imat, other->obmat);
+
+    short *material_remap = MEM_malloc_arrayN(
+        other->totcol ? other->totcol : 1, sizeof(*material_remap), __func__);
+    BKE_material_remap_object_calc(object, other, material_remap);
+    operand->material_remap = material_remap;
+    operand->material_remap_len = other->totcol;
+  }
+
+#ifdef DEBUG_TIME
+  TIMEIT_START(boolean_mesh);
+#endif
+
+  Mesh *result = BKE_mesh_boolean(operands, operands_len, bmd->operation, bmd->double_threshold);
+
+#ifdef DEBUG_TIME
+  TIMEIT_END(boolean_mesh);
+#endif
+
+  for (int i = 1; i < operands_len; i++) {
+    MEM_freeN((void *)operands[i].material_remap);
+  }
+  MEM_freeN(operands);
+
+  return result;
+}
+
+/**
+ * Mesh objects used as operands, the object of the modifier is never one of them.
+ * \return An array which must be freed, NULL when there are no operands.
+ */
+static Object **boolean_operands_get(BooleanModifierData *bmd,
+                                     const ModifierEvalContext *ctx,
+                                     int *r_operands_len)
+{
+  Object **operand_obs = NULL;
+  *r_operands_len = 0;
+
+  if (bmd->operand_type == eBooleanModifierOperandType_Collection) {
+    if (bmd->collection == NULL) {
+      return NULL;
+    }
+    int operands_alloc = 0;
+    FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (bmd->collection, operand_ob) {
+      if (operand_ob->type == OB_MESH && operand_ob != ctx->object) {
+        operands_alloc++;
+      }
+    }
+    FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+    if (operands_alloc == 0) {
+      return NULL;
+    }
+
+    operand_obs = MEM_malloc_arrayN(operands_alloc, sizeof(*operand_obs), __func__);
+    FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (bmd->collection, operand_ob) {
+      if (operand_ob->type == OB_MESH && operand_ob != ctx->object) {
+        operand_obs[(*r_operands_len)++] = operand_ob;
+      }
+    }
+    FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+  }
+  else if (bmd->object != NULL) {
+    operand_obs = MEM_mallocN(sizeof(*operand_obs), __func__);
+    operand_obs[(*r_operands_len)++] = bmd->object;
+  }
+
+  return operand_obs;
+}
+
+static Mesh *applyModifier(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
+{
+  BooleanModifierData *bmd = (BooleanModifierData *)md;
+  Mesh *result = mesh;
+
+  int operand_obs_len;
+  Object **operand_obs = boolean_operands_get(bmd, ctx, &operand_obs_len);
+  if (operand_obs == NULL) {
+    return result;
+  }
+
+  if (bmd->solver == eBooleanModifierSolver_Mesh) {
+    result = boolean_operands_apply_mesh(bmd, ctx, mesh, operand_obs, operand_obs_len);
+  }
+  else {
+    /* Apply the operands one after the other. */
+    for (int i = 0; i < operand_obs_len && result != NULL; i++) {
+      Mesh *result_prev = result;
+      result = boolean_operand_apply_bmesh(bmd, ctx, result_prev, operand_obs[i]);
+      if (result_prev != mesh && result_prev != result) {
+        BKE_id_free(NULL, result_prev);
+      }
     }
   }
 
+  MEM_freeN(operand_obs);
+
+  /* if new mesh returned, return it; otherwise there was
+   * an error, so delete the modifier object */
+  if (result == NULL) {
+    modifier_setError(md, "Cannot execute boolean operation");
+  }
+
   return result;
 }
 
@@ -369,7 +529,7 @@ ModifierTypeInfo modifierType_Boolean = {
     /* dependsOnTime */ NULL,
     /* dependsOnNormals */ NULL,
     /* foreachObjectLink */ foreachObjectLink,
-    /* foreachIDLink */ NULL,
+    /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ NULL,
     /* freeRuntimeData */ NULL,
 };
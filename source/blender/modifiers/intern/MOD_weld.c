@@ -34,6 +34,7 @@
 #include "BLI_alloca.h"
 #include "BLI_kdopbvh.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -46,6 +47,8 @@
 
 #include "DEG_depsgraph.h"
 
+#include "atomic_ops.h"
+
 //#define USE_WELD_DEBUG
 //#define USE_WELD_NORMALS
 
@@ -56,6 +59,11 @@
 /* indicates whether an edge or vertex in groups_map will be merged. */
 #define ELEM_MERGED (uint)(-2)
 
+/* Minimum number of overlap pairs or vertices handled by each thread. */
+#define WELD_PARALLEL_GRAINSIZE 1024
+/* Number of elements per block when the result is written on many threads. */
+#define WELD_RESULT_BLOCK_LEN 1024
+
 /* Used to indicate a range in an array specifying a group. */
 struct WeldGroup {
   uint len;
@@ -368,6 +376,108 @@ static void weld_assert_poly_len(const WeldPoly *wp, const WeldLoop *wloop)
 /** \name Weld Vert API
  * \{ */
 
+/* Union-Find of the vertices in the overlap pairs, it runs on many threads so the root of a
+ * cluster is always the smaller index, which keeps the result independent of the thread order. */
+static uint weld_vert_find_root(uint *vert_parent, uint v)
+{
+  while (true) {
+    const uint v_parent = vert_parent[v];
+    if (v_parent == v) {
+      return v;
+    }
+    const uint v_grandparent = vert_parent[v_parent];
+    if (v_grandparent != v_parent) {
+      /* Path halving. */
+      atomic_cas_uint32(&vert_parent[v], v_parent, v_grandparent);
+    }
+    v = v_grandparent;
+  }
+}
+
+static void weld_vert_union(uint *vert_parent, uint va, uint vb)
+{
+  while (true) {
+    va = weld_vert_find_root(vert_parent, va);
+    vb = weld_vert_find_root(vert_parent, vb);
+    if (va == vb) {
+      return;
+    }
+    if (va > vb) {
+      SWAP(uint, va, vb);
+    }
+    /* Link the larger root to the smaller one, retry if `vb` stopped being a root. */
+    if (atomic_cas_uint32(&vert_parent[vb], vb, va) == vb) {
+      return;
+    }
+  }
+}
+
+static void weld_atomic_min_uint32(uint *p, const uint value)
+{
+  uint prev = *p;
+  while (value < prev) {
+    const uint orig = atomic_cas_uint32(p, prev, value);
+    if (orig == prev) {
+      break;
+    }
+    prev = orig;
+  }
+}
+
+struct WeldVertClusterData {
+  const BVHTreeOverlap *overlap;
+  uint *vert_parent;
+  /* Index of the first overlap pair in which each vertex appears. */
+  uint *vert_first_pair;
+  uint *vert_dest_map;
+};
+
+static void weld_vert_cluster_union_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  struct WeldVertClusterData *data = userdata;
+  const uint indexA = data->overlap[i].indexA;
+  const uint indexB = data->overlap[i].indexB;
+
+  BLI_assert(indexA < indexB);
+
+  weld_atomic_min_uint32(&data->vert_first_pair[indexA], (uint)i);
+  weld_atomic_min_uint32(&data->vert_first_pair[indexB], (uint)i);
+  weld_vert_union(data->vert_parent, indexA, indexB);
+}
+
+/* Processing the pairs in order, a pair whose vertices were not seen before starts a cluster
+ * with `indexA` as destination, and merging two clusters keeps the smaller destination.
+ * So the destination of a cluster is the smallest `indexA` of these starting pairs. */
+static void weld_vert_cluster_dest_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  struct WeldVertClusterData *data = userdata;
+  const uint indexA = data->overlap[i].indexA;
+  const uint indexB = data->overlap[i].indexB;
+  if ((data->vert_first_pair[indexA] == (uint)i) && (data->vert_first_pair[indexB] == (uint)i)) {
+    const uint root = weld_vert_find_root(data->vert_parent, indexA);
+    weld_atomic_min_uint32(&data->vert_dest_map[root], indexA);
+  }
+}
+
+static void weld_vert_cluster_map_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  struct WeldVertClusterData *data = userdata;
+  if (data->vert_first_pair[i] == OUT_OF_CONTEXT) {
+    return;
+  }
+  const uint root = weld_vert_find_root(data->vert_parent, (uint)i);
+  if (root != (uint)i) {
+    /* Only the roots are read here, and they are not written. */
+    data->vert_dest_map[i] = data->vert_dest_map[root];
+  }
+}
+
 static void weld_vert_ctx_alloc_and_setup(const uint mvert_len,
                                           const BVHTreeOverlap *overlap,
                                           const uint overlap_len,
@@ -376,62 +486,40 @@ static void weld_vert_ctx_alloc_and_setup(const uint mvert_len,
                                           uint *r_wvert_len,
                                           uint *r_vert_kill_len)
 {
-  uint *v_dest_iter = &r_vert_dest_map[0];
-  for (uint i = mvert_len; i--; v_dest_iter++) {
-    *v_dest_iter = OUT_OF_CONTEXT;
+  uint *vert_parent = MEM_mallocN(sizeof(*vert_parent) * mvert_len, __func__);
+  uint *vert_first_pair = MEM_mallocN(sizeof(*vert_first_pair) * mvert_len, __func__);
+  for (uint i = 0; i < mvert_len; i++) {
+    vert_parent[i] = i;
+    vert_first_pair[i] = OUT_OF_CONTEXT;
+    r_vert_dest_map[i] = OUT_OF_CONTEXT;
   }
 
-  uint vert_kill_len = 0;
-  const BVHTreeOverlap *overlap_iter = &overlap[0];
-  for (uint i = 0; i < overlap_len; i++, overlap_iter++) {
-    uint indexA = overlap_iter->indexA;
-    uint indexB = overlap_iter->indexB;
+  struct WeldVertClusterData data = {
+      .overlap = overlap,
+      .vert_parent = vert_parent,
+      .vert_first_pair = vert_first_pair,
+      .vert_dest_map = r_vert_dest_map,
+  };
 
-    BLI_assert(indexA < indexB);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = WELD_PARALLEL_GRAINSIZE;
 
-    uint va_dst = r_vert_dest_map[indexA];
-    uint vb_dst = r_vert_dest_map[indexB];
-    if (va_dst == OUT_OF_CONTEXT) {
-      if (vb_dst == OUT_OF_CONTEXT) {
-        vb_dst = indexA;
-        r_vert_dest_map[indexB] = vb_dst;
-      }
-      r_vert_dest_map[indexA] = vb_dst;
-      vert_kill_len++;
-    }
-    else if (vb_dst == OUT_OF_CONTEXT) {
-      r_vert_dest_map[indexB] = va_dst;
-      vert_kill_len++;
-    }
-    else if (va_dst != vb_dst) {
-      uint v_new, v_old;
-      if (va_dst < vb_dst) {
-        v_new = va_dst;
-        v_old = vb_dst;
-      }
-      else {
-        v_new = vb_dst;
-        v_old = va_dst;
-      }
-      BLI_assert(r_vert_dest_map[v_old] == v_old);
-      BLI_assert(r_vert_dest_map[v_new] == v_new);
-      vert_kill_len++;
+  BLI_task_parallel_range(0, (int)overlap_len, &data, weld_vert_cluster_union_cb, &settings);
+  BLI_task_parallel_range(0, (int)overlap_len, &data, weld_vert_cluster_dest_cb, &settings);
+  BLI_task_parallel_range(0, (int)mvert_len, &data, weld_vert_cluster_map_cb, &settings);
 
-      const BVHTreeOverlap *overlap_iter_b = &overlap[0];
-      for (uint j = i + 1; j--; overlap_iter_b++) {
-        indexA = overlap_iter_b->indexA;
-        indexB = overlap_iter_b->indexB;
-        va_dst = r_vert_dest_map[indexA];
-        vb_dst = r_vert_dest_map[indexB];
-        if (ELEM(v_old, vb_dst, va_dst)) {
-          r_vert_dest_map[indexA] = v_new;
-          r_vert_dest_map[indexB] = v_new;
-        }
-      }
-      BLI_assert(r_vert_dest_map[v_old] == v_new);
+  /* Each cluster keeps one vertex. */
+  uint vert_kill_len = 0;
+  for (uint i = 0; i < mvert_len; i++) {
+    if ((vert_first_pair[i] != OUT_OF_CONTEXT) && (vert_parent[i] != i)) {
+      vert_kill_len++;
     }
   }
 
+  MEM_freeN(vert_parent);
+  MEM_freeN(vert_first_pair);
+
   /* Vert Context. */
   uint wvert_len = 0;
 
@@ -439,7 +527,7 @@ static void weld_vert_ctx_alloc_and_setup(const uint mvert_len,
   wvert = MEM_mallocN(sizeof(*wvert) * mvert_len, __func__);
   wv = &wvert[0];
 
-  v_dest_iter = &r_vert_dest_map[0];
+  const uint *v_dest_iter = &r_vert_dest_map[0];
   for (uint i = 0; i < mvert_len; i++, v_dest_iter++) {
     if (*v_dest_iter != OUT_OF_CONTEXT) {
       wv->vert_dest = *v_dest_iter;
@@ -1588,6 +1676,297 @@ static void customdata_weld(
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Weld Result
+ *
+ * The result is written on many threads, by blocks of elements. The elements kept by each block
+ * are counted first and accumulated into the offset of the block, so the order of the elements
+ * is the same as when writing them one after the other.
+ * \{ */
+
+struct WeldResultData {
+  const Mesh *mesh;
+  Mesh *result;
+  const WeldMesh *weld_mesh;
+  /* Final indexes, written over the groups map of the #WeldMesh. */
+  uint *vert_final;
+  uint *edge_final;
+
+  /* Elements of the current pass. */
+  const uint *groups_map;
+  uint elem_len;
+  /* Index of the first element (and loop) of each block in the result. */
+  uint *block_ofs;
+  uint *block_loop_ofs;
+};
+
+static uint weld_result_blocks_len(const uint elem_len)
+{
+  return (elem_len + WELD_RESULT_BLOCK_LEN - 1) / WELD_RESULT_BLOCK_LEN;
+}
+
+static void weld_result_block_range(const struct WeldResultData *data,
+                                    const int block,
+                                    uint *r_start,
+                                    uint *r_end)
+{
+  *r_start = (uint)block * WELD_RESULT_BLOCK_LEN;
+  *r_end = MIN2(*r_start + WELD_RESULT_BLOCK_LEN, data->elem_len);
+}
+
+/* Turn the number of elements kept by each block into the index of its first element. */
+static uint weld_result_block_ofs_accumulate(uint *block_ofs, const uint blocks_len)
+{
+  uint ofs = 0;
+  for (uint i = 0; i < blocks_len; i++) {
+    const uint len = block_ofs[i];
+    block_ofs[i] = ofs;
+    ofs += len;
+  }
+  return ofs;
+}
+
+static void weld_result_block_count_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct WeldResultData *data = userdata;
+  uint start, end;
+  weld_result_block_range(data, i, &start, &end);
+
+  uint len = 0;
+  for (uint j = start; j < end; j++) {
+    if (data->groups_map[j] != ELEM_MERGED) {
+      len++;
+    }
+  }
+  data->block_ofs[i] = len;
+}
+
+static void weld_result_verts_cb(void *__restrict userdata,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct WeldResultData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const WeldMesh *weld_mesh = data->weld_mesh;
+  uint *vert_final = data->vert_final;
+  uint start, end;
+  weld_result_block_range(data, i, &start, &end);
+
+  uint dest_index = data->block_ofs[i];
+  for (uint j = start; j < end; j++) {
+    const uint source_index = j;
+    uint count = 0;
+    while (j < end && vert_final[j] == OUT_OF_CONTEXT) {
+      vert_final[j] = dest_index + count;
+      count++;
+      j++;
+    }
+    if (count) {
+      CustomData_copy_data(
+          &mesh->vdata, &result->vdata, (int)source_index, (int)dest_index, (int)count);
+      dest_index += count;
+    }
+    if (j == end) {
+      break;
+    }
+    if (vert_final[j] != ELEM_MERGED) {
+      const struct WeldGroup *wgroup = &weld_mesh->vert_groups[vert_final[j]];
+      customdata_weld(&mesh->vdata,
+                      &result->vdata,
+                      &weld_mesh->vert_groups_buffer[wgroup->ofs],
+                      (int)wgroup->len,
+                      (int)dest_index);
+      vert_final[j] = dest_index;
+      dest_index++;
+    }
+  }
+}
+
+static void weld_result_edges_cb(void *__restrict userdata,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct WeldResultData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const WeldMesh *weld_mesh = data->weld_mesh;
+  const uint *vert_final = data->vert_final;
+  uint *edge_final = data->edge_final;
+  uint start, end;
+  weld_result_block_range(data, i, &start, &end);
+
+  uint dest_index = data->block_ofs[i];
+  for (uint j = start; j < end; j++) {
+    const uint source_index = j;
+    uint count = 0;
+    while (j < end && edge_final[j] == OUT_OF_CONTEXT) {
+      edge_final[j] = dest_index + count;
+      count++;
+      j++;
+    }
+    if (count) {
+      CustomData_copy_data(
+          &mesh->edata, &result->edata, (int)source_index, (int)dest_index, (int)count);
+      MEdge *me = &result->medge[dest_index];
+      dest_index += count;
+      for (; count--; me++) {
+        me->v1 = vert_final[me->v1];
+        me->v2 = vert_final[me->v2];
+      }
+    }
+    if (j == end) {
+      break;
+    }
+    if (edge_final[j] != ELEM_MERGED) {
+      const struct WeldGroupEdge *wegrp = &weld_mesh->edge_groups[edge_final[j]];
+      customdata_weld(&mesh->edata,
+                      &result->edata,
+                      &weld_mesh->edge_groups_buffer[wegrp->group.ofs],
+                      (int)wegrp->group.len,
+                      (int)dest_index);
+      MEdge *me = &result->medge[dest_index];
+      me->v1 = vert_final[wegrp->v1];
+      me->v2 = vert_final[wegrp->v2];
+      me->flag |= ME_LOOSEEDGE;
+
+      edge_final[j] = dest_index;
+      dest_index++;
+    }
+  }
+}
+
+/* The polygons of the result are the original ones followed by the new ones.
+ * Return NULL for original polygons that are not affected. */
+static const WeldPoly *weld_result_poly_get(const struct WeldResultData *data, const uint index)
+{
+  const WeldMesh *weld_mesh = data->weld_mesh;
+  const uint totpoly = (uint)data->mesh->totpoly;
+  if (index < totpoly) {
+    const uint poly_ctx = weld_mesh->poly_map[index];
+    return (poly_ctx != OUT_OF_CONTEXT) ? &weld_mesh->wpoly[poly_ctx] : NULL;
+  }
+  return &weld_mesh->wpoly_new[index - totpoly];
+}
+
+/* Collapsed polygons and polygons merged into others are not part of the result. */
+static bool weld_result_poly_is_removed(const WeldPoly *wp)
+{
+  return (wp->flag == ELEM_COLLAPSED) || (wp->poly_dst != OUT_OF_CONTEXT);
+}
+
+static void weld_result_polys_count_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct WeldResultData *data = userdata;
+  uint start, end;
+  weld_result_block_range(data, i, &start, &end);
+
+  uint poly_len = 0, loop_len = 0;
+  for (uint j = start; j < end; j++) {
+    const WeldPoly *wp = weld_result_poly_get(data, j);
+    if (wp == NULL) {
+      loop_len += (uint)data->mesh->mpoly[j].totloop;
+    }
+    else if (!weld_result_poly_is_removed(wp)) {
+      loop_len += wp->len;
+    }
+    else {
+      continue;
+    }
+    poly_len++;
+  }
+  data->block_ofs[i] = poly_len;
+  data->block_loop_ofs[i] = loop_len;
+}
+
+static void weld_result_polys_cb(void *__restrict userdata,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct WeldResultData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const WeldMesh *weld_mesh = data->weld_mesh;
+  const uint *vert_final = data->vert_final;
+  const uint *edge_final = data->edge_final;
+  uint start, end;
+  weld_result_block_range(data, i, &start, &end);
+
+  uint *group_buffer = BLI_array_alloca(group_buffer, weld_mesh->max_poly_len);
+  uint r_i = data->block_ofs[i];
+  uint loop_cur = data->block_loop_ofs[i];
+  for (uint j = start; j < end; j++) {
+    const uint loop_start = loop_cur;
+    const WeldPoly *wp = weld_result_poly_get(data, j);
+    if (wp == NULL) {
+      const MPoly *mp = &mesh->mpoly[j];
+      uint mp_loop_len = (uint)mp->totloop;
+      CustomData_copy_data(
+          &mesh->ldata, &result->ldata, mp->loopstart, (int)loop_cur, (int)mp_loop_len);
+      MLoop *r_ml = &result->mloop[loop_cur];
+      loop_cur += mp_loop_len;
+      for (; mp_loop_len--; r_ml++) {
+        r_ml->v = vert_final[r_ml->v];
+        r_ml->e = edge_final[r_ml->e];
+      }
+    }
+    else {
+      if (weld_result_poly_is_removed(wp)) {
+        continue;
+      }
+      WeldLoopOfPolyIter iter;
+      weld_iter_loop_of_poly_begin(
+          &iter, wp, weld_mesh->wloop, mesh->mloop, weld_mesh->loop_map, group_buffer);
+      MLoop *r_ml = &result->mloop[loop_cur];
+      while (weld_iter_loop_of_poly_next(&iter)) {
+        customdata_weld(
+            &mesh->ldata, &result->ldata, group_buffer, (int)iter.group_len, (int)loop_cur);
+        r_ml->v = vert_final[iter.v];
+        r_ml->e = edge_final[iter.e];
+        r_ml++;
+        loop_cur++;
+      }
+      BLI_assert(loop_cur - loop_start == wp->len);
+    }
+
+    if (j < (uint)mesh->totpoly) {
+      CustomData_copy_data(&mesh->pdata, &result->pdata, (int)j, (int)r_i, 1);
+    }
+    MPoly *r_mp = &result->mpoly[r_i];
+    r_mp->loopstart = (int)loop_start;
+    r_mp->totloop = (int)(loop_cur - loop_start);
+    r_i++;
+  }
+}
+
+/* Edges merged by the welded loops are not loose. */
+static void weld_result_poly_edges_flag_update(const Mesh *mesh,
+                                               Mesh *result,
+                                               const WeldMesh *weld_mesh,
+                                               const WeldPoly *wp)
+{
+  if (weld_result_poly_is_removed(wp)) {
+    return;
+  }
+  const uint *edge_final = weld_mesh->edge_groups_map;
+  WeldLoopOfPolyIter iter;
+  weld_iter_loop_of_poly_begin(
+      &iter, wp, weld_mesh->wloop, mesh->mloop, weld_mesh->loop_map, NULL);
+  while (weld_iter_loop_of_poly_next(&iter)) {
+    const uint e = edge_final[iter.e];
+    if (iter.type) {
+      result->medge[e].flag &= ~ME_LOOSEEDGE;
+    }
+    BLI_assert((result->medge[e].flag & ME_LOOSEEDGE) == 0);
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Weld Modifier Main
  * \{ */
@@ -1617,8 +1996,6 @@ static Mesh *weldModifier_doWeld(WeldModifierData *wmd, const ModifierEvalContex
   int v_mask_act = 0;
 
   const MVert *mvert;
-  const MLoop *mloop;
-  const MPoly *mpoly, *mp;
   uint totvert, totedge, totloop, totpoly;
   uint i;
 
@@ -1676,9 +2053,6 @@ static Mesh *weldModifier_doWeld(WeldModifierData *wmd, const ModifierEvalContex
     WeldMesh weld_mesh;
     weld_mesh_context_create(mesh, overlap, overlap_len, &weld_mesh);
 
-    mloop = mesh->mloop;
-    mpoly = mesh->mpoly;
-
     totedge = mesh->totedge;
     totloop = mesh->totloop;
     totpoly = mesh->totpoly;
@@ -1691,175 +2065,74 @@ static Mesh *weldModifier_doWeld(WeldModifierData *wmd, const ModifierEvalContex
     result = BKE_mesh_new_nomain_from_template(
         mesh, result_nverts, result_nedges, 0, result_nloops, result_npolys);
 
-    /* Vertices */
+    struct WeldResultData result_data = {
+        .mesh = mesh,
+        .result = result,
+        .weld_mesh = &weld_mesh,
+        .vert_final = weld_mesh.vert_groups_map,
+        .edge_final = weld_mesh.edge_groups_map,
+    };
 
-    uint *vert_final = weld_mesh.vert_groups_map;
-    uint *index_iter = &vert_final[0];
-    int dest_index = 0;
-    for (i = 0; i < totvert; i++, index_iter++) {
-      int source_index = i;
-      int count = 0;
-      while (i < totvert && *index_iter == OUT_OF_CONTEXT) {
-        *index_iter = dest_index + count;
-        index_iter++;
-        count++;
-        i++;
-      }
-      if (count) {
-        CustomData_copy_data(&mesh->vdata, &result->vdata, source_index, dest_index, count);
-        dest_index += count;
-      }
-      if (i == totvert) {
-        break;
-      }
-      if (*index_iter != ELEM_MERGED) {
-        struct WeldGroup *wgroup = &weld_mesh.vert_groups[*index_iter];
-        customdata_weld(&mesh->vdata,
-                        &result->vdata,
-                        &weld_mesh.vert_groups_buffer[wgroup->ofs],
-                        wgroup->len,
-                        dest_index);
-        *index_iter = dest_index;
-        dest_index++;
-      }
-    }
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
 
-    BLI_assert(dest_index == result_nverts);
+    /* Vertices */
 
-    /* Edges */
+    uint blocks_len = weld_result_blocks_len(totvert);
+    uint *block_ofs = MEM_mallocN(sizeof(*block_ofs) * blocks_len, __func__);
+    result_data.groups_map = weld_mesh.vert_groups_map;
+    result_data.elem_len = totvert;
+    result_data.block_ofs = block_ofs;
+    BLI_task_parallel_range(
+        0, (int)blocks_len, &result_data, weld_result_block_count_cb, &settings);
+    uint dest_len = weld_result_block_ofs_accumulate(block_ofs, blocks_len);
+    BLI_assert(dest_len == (uint)result_nverts);
+    BLI_task_parallel_range(0, (int)blocks_len, &result_data, weld_result_verts_cb, &settings);
+    MEM_freeN(block_ofs);
 
-    uint *edge_final = weld_mesh.edge_groups_map;
-    index_iter = &edge_final[0];
-    dest_index = 0;
-    for (i = 0; i < totedge; i++, index_iter++) {
-      int source_index = i;
-      int count = 0;
-      while (i < totedge && *index_iter == OUT_OF_CONTEXT) {
-        *index_iter = dest_index + count;
-        index_iter++;
-        count++;
-        i++;
-      }
-      if (count) {
-        CustomData_copy_data(&mesh->edata, &result->edata, source_index, dest_index, count);
-        MEdge *me = &result->medge[dest_index];
-        dest_index += count;
-        for (; count--; me++) {
-          me->v1 = vert_final[me->v1];
-          me->v2 = vert_final[me->v2];
-        }
-      }
-      if (i == totedge) {
-        break;
-      }
-      if (*index_iter != ELEM_MERGED) {
-        struct WeldGroupEdge *wegrp = &weld_mesh.edge_groups[*index_iter];
-        customdata_weld(&mesh->edata,
-                        &result->edata,
-                        &weld_mesh.edge_groups_buffer[wegrp->group.ofs],
-                        wegrp->group.len,
-                        dest_index);
-        MEdge *me = &result->medge[dest_index];
-        me->v1 = vert_final[wegrp->v1];
-        me->v2 = vert_final[wegrp->v2];
-        me->flag |= ME_LOOSEEDGE;
-
-        *index_iter = dest_index;
-        dest_index++;
-      }
-    }
+    /* Edges */
 
-    BLI_assert(dest_index == result_nedges);
+    blocks_len = weld_result_blocks_len(totedge);
+    block_ofs = MEM_mallocN(sizeof(*block_ofs) * blocks_len, __func__);
+    result_data.groups_map = weld_mesh.edge_groups_map;
+    result_data.elem_len = totedge;
+    result_data.block_ofs = block_ofs;
+    BLI_task_parallel_range(
+        0, (int)blocks_len, &result_data, weld_result_block_count_cb, &settings);
+    dest_len = weld_result_block_ofs_accumulate(block_ofs, blocks_len);
+    BLI_assert(dest_len == (uint)result_nedges);
+    BLI_task_parallel_range(0, (int)blocks_len, &result_data, weld_result_edges_cb, &settings);
+    MEM_freeN(block_ofs);
 
     /* Polys/Loops */
 
-    mp = &mpoly[0];
-    MPoly *r_mp = &result->mpoly[0];
-    MLoop *r_ml = &result->mloop[0];
-    uint r_i = 0;
-    int loop_cur = 0;
-    uint *group_buffer = BLI_array_alloca(group_buffer, weld_mesh.max_poly_len);
-    for (i = 0; i < totpoly; i++, mp++) {
-      int loop_start = loop_cur;
-      uint poly_ctx = weld_mesh.poly_map[i];
-      if (poly_ctx == OUT_OF_CONTEXT) {
-        uint mp_loop_len = mp->totloop;
-        CustomData_copy_data(&mesh->ldata, &result->ldata, mp->loopstart, loop_cur, mp_loop_len);
-        loop_cur += mp_loop_len;
-        for (; mp_loop_len--; r_ml++) {
-          r_ml->v = vert_final[r_ml->v];
-          r_ml->e = edge_final[r_ml->e];
-        }
-      }
-      else {
-        WeldPoly *wp = &weld_mesh.wpoly[poly_ctx];
-        WeldLoopOfPolyIter iter;
-        if (!weld_iter_loop_of_poly_begin(
-                &iter, wp, weld_mesh.wloop, mloop, weld_mesh.loop_map, group_buffer)) {
-          continue;
-        }
-        else {
-          if (wp->poly_dst != OUT_OF_CONTEXT) {
-            continue;
-          }
-          while (weld_iter_loop_of_poly_next(&iter)) {
-            customdata_weld(&mesh->ldata, &result->ldata, group_buffer, iter.group_len, loop_cur);
-            uint v = vert_final[iter.v];
-            uint e = edge_final[iter.e];
-            r_ml->v = v;
-            r_ml->e = e;
-            r_ml++;
-            loop_cur++;
-            if (iter.type) {
-              result->medge[e].flag &= ~ME_LOOSEEDGE;
-            }
-            BLI_assert((result->medge[e].flag & ME_LOOSEEDGE) == 0);
-          }
-        }
-      }
-
-      CustomData_copy_data(&mesh->pdata, &result->pdata, i, r_i, 1);
-      r_mp->loopstart = loop_start;
-      r_mp->totloop = loop_cur - loop_start;
-      r_mp++;
-      r_i++;
+    /* The new polygons come after the original ones. */
+    blocks_len = weld_result_blocks_len(totpoly + weld_mesh.wpoly_new_len);
+    block_ofs = MEM_mallocN(sizeof(*block_ofs) * blocks_len, __func__);
+    uint *block_loop_ofs = MEM_mallocN(sizeof(*block_loop_ofs) * blocks_len, __func__);
+    result_data.elem_len = totpoly + weld_mesh.wpoly_new_len;
+    result_data.block_ofs = block_ofs;
+    result_data.block_loop_ofs = block_loop_ofs;
+    BLI_task_parallel_range(
+        0, (int)blocks_len, &result_data, weld_result_polys_count_cb, &settings);
+    dest_len = weld_result_block_ofs_accumulate(block_ofs, blocks_len);
+    const uint loop_len = weld_result_block_ofs_accumulate(block_loop_ofs, blocks_len);
+    BLI_assert(dest_len == (uint)result_npolys);
+    BLI_assert(loop_len == (uint)result_nloops);
+    BLI_task_parallel_range(0, (int)blocks_len, &result_data, weld_result_polys_cb, &settings);
+    MEM_freeN(block_ofs);
+    MEM_freeN(block_loop_ofs);
+    UNUSED_VARS_NDEBUG(dest_len, loop_len);
+
+    /* Polygons share edges, so their flags are updated on a single thread. */
+    for (i = 0; i < weld_mesh.wpoly_len; i++) {
+      weld_result_poly_edges_flag_update(mesh, result, &weld_mesh, &weld_mesh.wpoly[i]);
     }
-
-    WeldPoly *wp = &weld_mesh.wpoly_new[0];
-    for (i = 0; i < weld_mesh.wpoly_new_len; i++, wp++) {
-      int loop_start = loop_cur;
-      WeldLoopOfPolyIter iter;
-      if (!weld_iter_loop_of_poly_begin(
-              &iter, wp, weld_mesh.wloop, mloop, weld_mesh.loop_map, group_buffer)) {
-        continue;
-      }
-      else {
-        if (wp->poly_dst != OUT_OF_CONTEXT) {
-          continue;
-        }
-        while (weld_iter_loop_of_poly_next(&iter)) {
-          customdata_weld(&mesh->ldata, &result->ldata, group_buffer, iter.group_len, loop_cur);
-          uint v = vert_final[iter.v];
-          uint e = edge_final[iter.e];
-          r_ml->v = v;
-          r_ml->e = e;
-          r_ml++;
-          loop_cur++;
-          if (iter.type) {
-            result->medge[e].flag &= ~ME_LOOSEEDGE;
-          }
-          BLI_assert((result->medge[e].flag & ME_LOOSEEDGE) == 0);
-        }
-      }
-      r_mp->loopstart = loop_start;
-      r_mp->totloop = loop_cur - loop_start;
-      r_mp++;
-      r_i++;
+    for (i = 0; i < weld_mesh.wpoly_new_len; i++) {
+      weld_result_poly_edges_flag_update(mesh, result, &weld_mesh, &weld_mesh.wpoly_new[i]);
     }
 
-    BLI_assert((int)r_i == result_npolys);
-    BLI_assert(loop_cur == result_nloops);
-
     /* is this needed? */
     /* recalculate normals */
     result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
@@ -75,7 +75,7 @@ static void foreach_nodeclass(Scene *UNUSED(scene), void *calldata, bNodeClassCa
   func(calldata, NODE_CLASS_LAYOUT, N_("Layout"));
 }
 
-static void free_node_cache(bNodeTree *UNUSED(ntree), bNode *node)
+static void free_node_cache(bNodeTree *ntree, bNode *node)
 {
   bNodeSocket *sock;
 
@@ -84,6 +84,15 @@ static void free_node_cache(bNodeTree *UNUSED(ntree), bNode *node)
       sock->cache = NULL;
     }
   }
+
+#ifdef WITH_COMPOSITOR
+  /* localized trees are freed after every execution, without changing data-blocks */
+  if (node->id && !(ntree->id.tag & LIB_TAG_LOCALIZED)) {
+    COM_clearCachesForID(node->id);
+  }
+#else
+  UNUSED_VARS(ntree);
+#endif
 }
 
 static void free_cache(bNodeTree *ntree)
@@ -92,6 +101,10 @@ static void free_cache(bNodeTree *ntree)
   for (node = ntree->nodes.first; node; node = node->next) {
     free_node_cache(ntree, node);
   }
+
+#ifdef WITH_COMPOSITOR
+  COM_clearCaches();
+#endif
 }
 
 /* local tree then owns all compbufs */
@@ -46,6 +46,8 @@ extern "C" {
 #include "DEG_depsgraph.h"
 #include "DEG_depsgraph_query.h"
 
+#include "PIL_time.h"
+
 static float I3[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
 
 /* Number of off-diagonal non-zero matrix blocks.
@@ -1088,6 +1090,7 @@ static void cloth_clear_result(ClothModifierData *clmd)
   sres->max_error = sres->min_error = sres->avg_error = 0.0f;
   sres->max_iterations = sres->min_iterations = 0;
   sres->avg_iterations = 0.0f;
+  sres->max_time = sres->avg_time = 0.0f;
 }
 
 static void cloth_record_result(ClothModifierData *clmd, ImplicitSolverResult *result, float dt)
@@ -1105,6 +1108,8 @@ static void cloth_record_result(ClothModifierData *clmd, ImplicitSolverResult *r
     sres->min_iterations = min_ii(sres->min_iterations, result->iterations);
     sres->max_iterations = max_ii(sres->max_iterations, result->iterations);
     sres->avg_iterations += (float)result->iterations * dt;
+    sres->max_time = max_ff(sres->max_time, result->time);
+    sres->avg_time += result->time * dt;
   }
   else {
     /* error only makes sense for successful iterations */
@@ -1115,6 +1120,8 @@ static void cloth_record_result(ClothModifierData *clmd, ImplicitSolverResult *r
 
     sres->min_iterations = sres->max_iterations = result->iterations;
     sres->avg_iterations += (float)result->iterations * dt;
+    sres->max_time = result->time;
+    sres->avg_time += result->time * dt;
   }
 
   sres->status |= result->status;
@@ -1173,7 +1180,9 @@ int BPH_cloth_solve(
     cloth_calc_force(scene, clmd, frame, effectors, step);
 
     // calculate new velocity and position
+    const double solve_start = PIL_check_seconds_timer();
     BPH_mass_spring_solve_velocities(id, dt, &result);
+    result.time = (float)(PIL_check_seconds_timer() - solve_start);
     cloth_record_result(clmd, &result, dt);
 
     /* Calculate collision impulses. */
@@ -58,6 +58,8 @@ typedef struct ImplicitSolverResult {
 
   int iterations;
   float error;
+  /* Time spent in the solver, in seconds. */
+  float time;
 } ImplicitSolverResult;
 
 BLI_INLINE void implicit_print_matrix_elem(float v)
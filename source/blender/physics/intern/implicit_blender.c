@@ -34,6 +34,7 @@
 #  include "DNA_texture_types.h"
 
 #  include "BLI_math.h"
+#  include "BLI_task.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_cloth.h"
@@ -652,6 +653,347 @@ DO_INLINE void subadd_bfmatrixS_bfmatrixS(
   }
 }
 
+///////////////////////////////////////////////////////////////////
+// block compressed sparse row matrix
+///////////////////////////////////////////////////////////////////
+
+/* Number of rows processed by a task. Dot products are summed per chunk of rows and the partial
+ * sums are added up in order, so results don't depend on the number of threads. */
+#  define CLOTH_SOLVER_CHUNK_SIZE 1024
+#  define CLOTH_SOLVER_NUM_CHUNKS(num_rows) \
+    (((num_rows) + CLOTH_SOLVER_CHUNK_SIZE - 1) / CLOTH_SOLVER_CHUNK_SIZE)
+
+/* System matrix of the solver, computed from the big matrices. Both triangles of the symmetric
+ * matrix are stored and the blocks of a row are contiguous, so rows can be multiplied in
+ * parallel. */
+typedef struct BCSRMatrix {
+  unsigned int num_rows;
+  unsigned int num_entries;
+  /* First entry of each row, and one past the last entry. */
+  unsigned int *row_start;
+  /* Column of the entry and index of the big matrix block it is computed from. */
+  unsigned int *col;
+  unsigned int *block;
+  /* Entries above the diagonal are transposed springs blocks. */
+  bool *transposed;
+  float (*m)[3][3];
+
+  /* Vertices of the springs blocks the pattern was built for, and their two entries. */
+  unsigned int num_springs, springs_alloc;
+  unsigned int (*springs)[2];
+  unsigned int (*spring_entries)[2];
+
+  /* Partial sums of dot products, one for each chunk of rows. */
+  double *chunk_sums;
+} BCSRMatrix;
+
+static void bcsr_matrix_free(BCSRMatrix *mat)
+{
+  MEM_SAFE_FREE(mat->row_start);
+  MEM_SAFE_FREE(mat->col);
+  MEM_SAFE_FREE(mat->block);
+  MEM_SAFE_FREE(mat->transposed);
+  MEM_SAFE_FREE(mat->m);
+  MEM_SAFE_FREE(mat->springs);
+  MEM_SAFE_FREE(mat->spring_entries);
+  MEM_SAFE_FREE(mat->chunk_sums);
+}
+
+static bool bcsr_matrix_pattern_is_valid(BCSRMatrix *mat,
+                                         fmatrix3x3 *from,
+                                         unsigned int num_blocks)
+{
+  const unsigned int vcount = from[0].vcount;
+
+  if (mat->row_start == NULL || mat->num_springs != num_blocks) {
+    return false;
+  }
+  for (unsigned int i = 0; i < num_blocks; i++) {
+    if (mat->springs[i][0] != from[vcount + i].r || mat->springs[i][1] != from[vcount + i].c) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Build the sparsity pattern of the big matrices with num_blocks springs blocks in use. The
+ * blocks are added again by the forces of every step, usually in the same order, in which case
+ * the previous pattern is kept. */
+static void bcsr_matrix_build_pattern(BCSRMatrix *mat, fmatrix3x3 *from, unsigned int num_blocks)
+{
+  const unsigned int vcount = from[0].vcount;
+  const unsigned int num_entries = vcount + 2 * num_blocks;
+  unsigned int i;
+
+  if (bcsr_matrix_pattern_is_valid(mat, from, num_blocks)) {
+    return;
+  }
+
+  if (mat->row_start == NULL) {
+    mat->num_rows = vcount;
+    mat->row_start = MEM_mallocN(sizeof(*mat->row_start) * (vcount + 1), "cloth BCSR rows");
+    mat->chunk_sums = MEM_mallocN(sizeof(*mat->chunk_sums) * CLOTH_SOLVER_NUM_CHUNKS(vcount),
+                                  "cloth BCSR chunk sums");
+  }
+  if (num_blocks > mat->springs_alloc || mat->col == NULL) {
+    MEM_SAFE_FREE(mat->col);
+    MEM_SAFE_FREE(mat->block);
+    MEM_SAFE_FREE(mat->transposed);
+    MEM_SAFE_FREE(mat->m);
+    MEM_SAFE_FREE(mat->springs);
+    MEM_SAFE_FREE(mat->spring_entries);
+    mat->springs_alloc = num_blocks;
+    mat->col = MEM_mallocN(sizeof(*mat->col) * num_entries, "cloth BCSR columns");
+    mat->block = MEM_mallocN(sizeof(*mat->block) * num_entries, "cloth BCSR blocks");
+    mat->transposed = MEM_mallocN(sizeof(*mat->transposed) * num_entries, "cloth BCSR transp");
+    mat->m = MEM_mallocN(sizeof(*mat->m) * num_entries, "cloth BCSR matrices");
+    mat->springs = MEM_mallocN(sizeof(*mat->springs) * max_ii(num_blocks, 1),
+                               "cloth BCSR springs");
+    mat->spring_entries = MEM_mallocN(sizeof(*mat->spring_entries) * max_ii(num_blocks, 1),
+                                      "cloth BCSR spring entries");
+  }
+  mat->num_entries = num_entries;
+  mat->num_springs = num_blocks;
+
+  /* Count the entries of each row, the diagonal block comes first. */
+  unsigned int *row_start = mat->row_start;
+  for (i = 0; i <= vcount; i++) {
+    row_start[i] = (i < vcount) ? 1 : 0;
+  }
+  for (i = vcount; i < vcount + num_blocks; i++) {
+    row_start[from[i].r]++;
+    row_start[from[i].c]++;
+  }
+  unsigned int total = 0;
+  for (i = 0; i <= vcount; i++) {
+    const unsigned int count = row_start[i];
+    row_start[i] = total;
+    total += count;
+  }
+
+  /* Fill the rows, row_start is used as insertion cursor and restored afterwards. */
+  for (i = 0; i < vcount; i++) {
+    const unsigned int e = row_start[i]++;
+    mat->col[e] = i;
+    mat->block[e] = i;
+    mat->transposed[e] = false;
+  }
+  for (i = vcount; i < vcount + num_blocks; i++) {
+    const unsigned int r = from[i].r, c = from[i].c;
+    unsigned int *spring = mat->springs[i - vcount];
+    unsigned int *entries = mat->spring_entries[i - vcount];
+
+    spring[0] = r;
+    spring[1] = c;
+
+    entries[0] = row_start[r]++;
+    mat->col[entries[0]] = c;
+    mat->block[entries[0]] = i;
+    mat->transposed[entries[0]] = false;
+
+    /* This is the lower triangle of the sparse matrix,
+     * the upper triangle uses the transposed submatrices. */
+    entries[1] = row_start[c]++;
+    mat->col[entries[1]] = r;
+    mat->block[entries[1]] = i;
+    mat->transposed[entries[1]] = true;
+  }
+  for (i = vcount; i > 0; i--) {
+    row_start[i] = row_start[i - 1];
+  }
+  row_start[0] = 0;
+}
+
+/* Preconditioner block for a diagonal block of the system matrix: the inverse of its symmetric
+ * part, or identity when that is not positive definite and would break the conjugate gradient. */
+static void cloth_preconditioner_block(float r_pinv[3][3], float a[3][3])
+{
+  float p[3][3];
+  int j, k;
+
+  for (j = 0; j < 3; j++) {
+    for (k = 0; k < 3; k++) {
+      p[j][k] = 0.5f * (a[j][k] + a[k][j]);
+    }
+  }
+
+  if (p[0][0] > 0.0f && p[0][0] * p[1][1] - p[0][1] * p[1][0] > 0.0f &&
+      determinant_m3_array(p) > 0.0f && invert_m3_m3(r_pinv, p)) {
+    return;
+  }
+  unit_m3(r_pinv);
+}
+
+typedef struct ClothSolverTaskData {
+  BCSRMatrix *A;
+
+  /* Big matrices combined by #bcsr_matrix_fill, and the preconditioner blocks to update. */
+  fmatrix3x3 *M, *dFdV, *dFdX;
+  float dt;
+  fmatrix3x3 *Pinv;
+
+  /* Big matrix multiplied through the pattern of A by #mul_bfmatrix_pattern_lfvector. */
+  fmatrix3x3 *from;
+
+  /* Filtering matrix for constraints, optional for #mul_bcsrmatrix_lfvector. */
+  fmatrix3x3 *S;
+
+  lfVector *x, *to;
+  /* Conjugate gradient state. */
+  lfVector *dV, *r, *c, *q, *s;
+  float alpha, beta;
+} ClothSolverTaskData;
+
+BLI_INLINE void cloth_solver_chunk_range(const ClothSolverTaskData *data,
+                                         const int chunk,
+                                         unsigned int *r_start,
+                                         unsigned int *r_end)
+{
+  *r_start = (unsigned int)chunk * CLOTH_SOLVER_CHUNK_SIZE;
+  *r_end = MIN2(*r_start + CLOTH_SOLVER_CHUNK_SIZE, data->A->num_rows);
+}
+
+/* Run func on all chunks of rows, and return the sum of the partial sums of the chunks. */
+static double cloth_solver_parallel_chunks(ClothSolverTaskData *data, TaskParallelRangeFunc func)
+{
+  const int num_chunks = (int)CLOTH_SOLVER_NUM_CHUNKS(data->A->num_rows);
+  double sum = 0.0;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (num_chunks > 1);
+  BLI_task_parallel_range(0, num_chunks, data, func, &settings);
+
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    sum += data->A->chunk_sums[chunk];
+  }
+  return sum;
+}
+
+/* A = M - dFdV * dt - dFdX * dt^2 */
+BLI_INLINE void cloth_system_block(const ClothSolverTaskData *data,
+                                   const unsigned int b,
+                                   float r_m[3][3])
+{
+  copy_m3_m3(r_m, data->M[b].m);
+  subadd_fmatrixS_fmatrixS(r_m, data->dFdV[b].m, data->dt, data->dFdX[b].m, data->dt * data->dt);
+}
+
+static void bcsr_matrix_fill_diagonal_cb(void *__restrict userdata,
+                                         const int chunk,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothSolverTaskData *data = userdata;
+  BCSRMatrix *A = data->A;
+  unsigned int i, i_end;
+
+  cloth_solver_chunk_range(data, chunk, &i, &i_end);
+  for (; i < i_end; i++) {
+    float(*m)[3] = A->m[A->row_start[i]];
+    cloth_system_block(data, i, m);
+    cloth_preconditioner_block(data->Pinv[i].m, m);
+  }
+  A->chunk_sums[chunk] = 0.0;
+}
+
+static void bcsr_matrix_fill_springs_cb(void *__restrict userdata,
+                                        const int spring,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothSolverTaskData *data = userdata;
+  BCSRMatrix *A = data->A;
+  const unsigned int *entries = A->spring_entries[spring];
+
+  cloth_system_block(data, A->num_rows + (unsigned int)spring, A->m[entries[0]]);
+  transpose_m3_m3(A->m[entries[1]], A->m[entries[0]]);
+}
+
+/* Compute the blocks of the system matrix with the pattern built by #bcsr_matrix_build_pattern,
+ * and the block diagonal preconditioner. */
+static void bcsr_matrix_fill(BCSRMatrix *mat,
+                             fmatrix3x3 *M,
+                             fmatrix3x3 *dFdV,
+                             fmatrix3x3 *dFdX,
+                             float dt,
+                             fmatrix3x3 *Pinv)
+{
+  ClothSolverTaskData data = {
+      .A = mat, .M = M, .dFdV = dFdV, .dFdX = dFdX, .dt = dt, .Pinv = Pinv};
+  cloth_solver_parallel_chunks(&data, bcsr_matrix_fill_diagonal_cb);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (mat->num_springs > CLOTH_SOLVER_CHUNK_SIZE);
+  settings.min_iter_per_thread = CLOTH_SOLVER_CHUNK_SIZE;
+  BLI_task_parallel_range(0, (int)mat->num_springs, &data, bcsr_matrix_fill_springs_cb, &settings);
+}
+
+static void mul_bcsrmatrix_lfvector_cb(void *__restrict userdata,
+                                       const int chunk,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothSolverTaskData *data = userdata;
+  const BCSRMatrix *A = data->A;
+  lfVector *x = data->x, *to = data->to;
+  double dot = 0.0;
+  unsigned int i, i_end;
+
+  cloth_solver_chunk_range(data, chunk, &i, &i_end);
+  for (; i < i_end; i++) {
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    for (unsigned int e = A->row_start[i]; e < A->row_start[i + 1]; e++) {
+      muladd_fmatrix_fvector(sum, A->m[e], x[A->col[e]]);
+    }
+    if (data->S) {
+      mul_m3_v3(data->S[i].m, sum);
+    }
+    copy_v3_v3(to[i], sum);
+    dot += dot_v3v3(x[i], sum);
+  }
+  A->chunk_sums[chunk] = dot;
+}
+
+/* to = filter(A * x), filtering is skipped when S is NULL. Returns x^T * to. */
+static float mul_bcsrmatrix_lfvector(lfVector *to, BCSRMatrix *A, lfVector *x, fmatrix3x3 *S)
+{
+  ClothSolverTaskData data = {.A = A, .S = S, .x = x, .to = to};
+  return (float)cloth_solver_parallel_chunks(&data, mul_bcsrmatrix_lfvector_cb);
+}
+
+static void mul_bfmatrix_pattern_lfvector_cb(void *__restrict userdata,
+                                             const int chunk,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothSolverTaskData *data = userdata;
+  const BCSRMatrix *A = data->A;
+  unsigned int i, i_end;
+
+  cloth_solver_chunk_range(data, chunk, &i, &i_end);
+  for (; i < i_end; i++) {
+    zero_v3(data->to[i]);
+    for (unsigned int e = A->row_start[i]; e < A->row_start[i + 1]; e++) {
+      if (A->transposed[e]) {
+        muladd_fmatrixT_fvector(data->to[i], data->from[A->block[e]].m, data->x[A->col[e]]);
+      }
+      else {
+        muladd_fmatrix_fvector(data->to[i], data->from[A->block[e]].m, data->x[A->col[e]]);
+      }
+    }
+  }
+  A->chunk_sums[chunk] = 0.0;
+}
+
+/* to = from * x for a big matrix with the same blocks as A, reading the blocks in place.
+ * Cheaper than copying them when the matrix is only multiplied once. */
+static void mul_bfmatrix_pattern_lfvector(lfVector *to,
+                                          BCSRMatrix *A,
+                                          fmatrix3x3 *from,
+                                          lfVector *x)
+{
+  ClothSolverTaskData data = {.A = A, .from = from, .x = x, .to = to};
+  cloth_solver_parallel_chunks(&data, mul_bfmatrix_pattern_lfvector_cb);
+}
+
 ///////////////////////////////////////////////////////////////////
 // simulator start
 ///////////////////////////////////////////////////////////////////
@@ -670,8 +1012,8 @@ typedef struct Implicit_Data {
   lfVector *V, *Vnew; /* velocities */
 
   /* internal solver data */
-  lfVector *B;   /* B for A*dV = B */
-  fmatrix3x3 *A; /* A for A*dV = B */
+  lfVector *B;  /* B for A*dV = B */
+  BCSRMatrix A; /* A for A*dV = B */
 
   lfVector *dV;         /* velocity change (solution of A*dV = B) */
   lfVector *z;          /* target velocity in constrained directions */
@@ -685,7 +1027,6 @@ Implicit_Data *BPH_mass_spring_solver_create(int numverts, int numsprings)
 
   /* process diagonal elements */
   id->tfm = create_bfmatrix(numverts, 0);
-  id->A = create_bfmatrix(numverts, numsprings);
   id->dFdV = create_bfmatrix(numverts, numsprings);
   id->dFdX = create_bfmatrix(numverts, numsprings);
   id->S = create_bfmatrix(numverts, 0);
@@ -710,7 +1051,7 @@ Implicit_Data *BPH_mass_spring_solver_create(int numverts, int numsprings)
 void BPH_mass_spring_solver_free(Implicit_Data *id)
 {
   del_bfmatrix(id->tfm);
-  del_bfmatrix(id->A);
+  bcsr_matrix_free(&id->A);
   del_bfmatrix(id->dFdV);
   del_bfmatrix(id->dFdX);
   del_bfmatrix(id->S);
@@ -838,74 +1179,110 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 }
 #  endif
 
+static void cg_filtered_update_cb(void *__restrict userdata,
+                                  const int chunk,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothSolverTaskData *data = userdata;
+  double dot = 0.0;
+  unsigned int i, i_end;
+
+  cloth_solver_chunk_range(data, chunk, &i, &i_end);
+  for (; i < i_end; i++) {
+    if (data->c) {
+      VECADDS(data->dV[i], data->dV[i], data->c[i], data->alpha);
+      VECADDS(data->r[i], data->r[i], data->q[i], -data->alpha);
+    }
+
+    /* s = filter(P^-1 * r) */
+    mul_v3_m3v3(data->s[i], data->Pinv[i].m, data->r[i]);
+    mul_m3_v3(data->S[i].m, data->s[i]);
+
+    dot += dot_v3v3(data->r[i], data->s[i]);
+  }
+  data->A->chunk_sums[chunk] = dot;
+}
+
+static void cg_filtered_direction_cb(void *__restrict userdata,
+                                     const int chunk,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothSolverTaskData *data = userdata;
+  unsigned int i, i_end;
+
+  cloth_solver_chunk_range(data, chunk, &i, &i_end);
+  for (; i < i_end; i++) {
+    /* c = filter(s + c * beta) */
+    VECADDS(data->c[i], data->s[i], data->c[i], data->beta);
+    mul_m3_v3(data->S[i].m, data->c[i]);
+  }
+  data->A->chunk_sums[chunk] = 0.0;
+}
+
+/* Preconditioned conjugate gradient, with the modified filtering of constrained vertices from
+ * "Large Steps in Cloth Simulation" (Baraff, Witkin 1998) and a block diagonal preconditioner.
+ * All vector operations of an iteration are done in three parallel passes over the rows. */
 static int cg_filtered(lfVector *ldV,
-                       fmatrix3x3 *lA,
+                       BCSRMatrix *lA,
                        lfVector *lB,
                        lfVector *z,
                        fmatrix3x3 *S,
+                       fmatrix3x3 *Pinv,
                        ImplicitSolverResult *result)
 {
   // Solves for unknown X in equation AX=B
   unsigned int conjgrad_loopcount = 0, conjgrad_looplimit = 100;
   float conjgrad_epsilon = 0.01f;
 
-  unsigned int numverts = lA[0].vcount;
+  unsigned int numverts = lA->num_rows;
   lfVector *fB = create_lfvector(numverts);
   lfVector *AdV = create_lfvector(numverts);
   lfVector *r = create_lfvector(numverts);
   lfVector *c = create_lfvector(numverts);
   lfVector *q = create_lfvector(numverts);
   lfVector *s = create_lfvector(numverts);
-  float bnorm2, delta_new, delta_old, delta_target, alpha;
+  float bnorm2, delta_new, delta_old, delta_target;
+
+  ClothSolverTaskData data = {
+      .A = lA, .Pinv = Pinv, .S = S, .dV = ldV, .r = r, .c = NULL, .q = q, .s = s};
 
   cp_lfvector(ldV, z, numverts);
 
-  /* d0 = filter(B)^T * P * filter(B) */
+  /* d0 = filter(B)^T * P^-1 * filter(B) */
   cp_lfvector(fB, lB, numverts);
   filter(fB, S);
-  bnorm2 = dot_lfvector(fB, fB, numverts);
+  data.r = fB;
+  bnorm2 = (float)cloth_solver_parallel_chunks(&data, cg_filtered_update_cb);
+  data.r = r;
   delta_target = conjgrad_epsilon * conjgrad_epsilon * bnorm2;
 
   /* r = filter(B - A * dV) */
-  mul_bfmatrix_lfvector(AdV, lA, ldV);
+  mul_bcsrmatrix_lfvector(AdV, lA, ldV, NULL);
   sub_lfvector_lfvector(r, lB, AdV, numverts);
   filter(r, S);
 
-  /* c = filter(P^-1 * r) */
-  cp_lfvector(c, r, numverts);
-  filter(c, S);
-
-  /* delta = r^T * c */
-  delta_new = dot_lfvector(r, c, numverts);
+  /* c = filter(P^-1 * r), delta = r^T * c */
+  delta_new = (float)cloth_solver_parallel_chunks(&data, cg_filtered_update_cb);
+  cp_lfvector(c, s, numverts);
+  data.c = c;
 
 #  ifdef IMPLICIT_PRINT_SOLVER_INPUT_OUTPUT
-  printf("==== A ====\n");
-  print_bfmatrix(lA);
   printf("==== z ====\n");
   print_lvector(z, numverts);
   printf("==== B ====\n");
   print_lvector(lB, numverts);
-  printf("==== S ====\n");
-  print_bfmatrix(S);
 #  endif
 
   while (delta_new > delta_target && conjgrad_loopcount < conjgrad_looplimit) {
-    mul_bfmatrix_lfvector(q, lA, c);
-    filter(q, S);
-
-    alpha = delta_new / dot_lfvector(c, q, numverts);
-
-    add_lfvector_lfvectorS(ldV, ldV, c, alpha, numverts);
+    /* q = filter(A * c) */
+    data.alpha = delta_new / mul_bcsrmatrix_lfvector(q, lA, c, S);
 
-    add_lfvector_lfvectorS(r, r, q, -alpha, numverts);
-
-    /* s = P^-1 * r */
-    cp_lfvector(s, r, numverts);
+    /* dV += c * alpha, r -= q * alpha, s = filter(P^-1 * r) */
     delta_old = delta_new;
-    delta_new = dot_lfvector(r, s, numverts);
+    delta_new = (float)cloth_solver_parallel_chunks(&data, cg_filtered_update_cb);
 
-    add_lfvector_lfvectorS(c, s, c, delta_new / delta_old, numverts);
-    filter(c, S);
+    data.beta = delta_new / delta_old;
+    cloth_solver_parallel_chunks(&data, cg_filtered_direction_cb);
 
     conjgrad_loopcount++;
   }
@@ -933,212 +1310,6 @@ static int cg_filtered(lfVector *ldV,
          conjgrad_looplimit;  // true means we reached desired accuracy in given time - ie stable
 }
 
-#  if 0
-// block diagonalizer
-DO_INLINE void BuildPPinv(fmatrix3x3 *lA, fmatrix3x3 *P, fmatrix3x3 *Pinv)
-{
-  unsigned int i = 0;
-
-  // Take only the diagonal blocks of A
-  // #pragma omp parallel for private(i) if (lA[0].vcount > CLOTH_OPENMP_LIMIT)
-  for (i = 0; i < lA[0].vcount; i++) {
-    // block diagonalizer
-    cp_fmatrix(P[i].m, lA[i].m);
-    inverse_fmatrix(Pinv[i].m, P[i].m);
-  }
-}
-
-#    if 0
-// version 1.3
-static int cg_filtered_pre(lfVector *dv,
-                           fmatrix3x3 *lA,
-                           lfVector *lB,
-                           lfVector *z,
-                           fmatrix3x3 *S,
-                           fmatrix3x3 *P,
-                           fmatrix3x3 *Pinv)
-{
-  unsigned int numverts = lA[0].vcount, iterations = 0, conjgrad_looplimit = 100;
-  float delta0 = 0, deltaNew = 0, deltaOld = 0, alpha = 0;
-  float conjgrad_epsilon = 0.0001;  // 0.2 is dt for steps=5
-  lfVector *r = create_lfvector(numverts);
-  lfVector *p = create_lfvector(numverts);
-  lfVector *s = create_lfvector(numverts);
-  lfVector *h = create_lfvector(numverts);
-
-  BuildPPinv(lA, P, Pinv);
-
-  filter(dv, S);
-  add_lfvector_lfvector(dv, dv, z, numverts);
-
-  mul_bfmatrix_lfvector(r, lA, dv);
-  sub_lfvector_lfvector(r, lB, r, numverts);
-  filter(r, S);
-
-  mul_prevfmatrix_lfvector(p, Pinv, r);
-  filter(p, S);
-
-  deltaNew = dot_lfvector(r, p, numverts);
-
-  delta0 = deltaNew * sqrt(conjgrad_epsilon);
-
-#      ifdef DEBUG_TIME
-  double start = PIL_check_seconds_timer();
-#      endif
-
-  while ((deltaNew > delta0) && (iterations < conjgrad_looplimit)) {
-    iterations++;
-
-    mul_bfmatrix_lfvector(s, lA, p);
-    filter(s, S);
-
-    alpha = deltaNew / dot_lfvector(p, s, numverts);
-
-    add_lfvector_lfvectorS(dv, dv, p, alpha, numverts);
-
-    add_lfvector_lfvectorS(r, r, s, -alpha, numverts);
-
-    mul_prevfmatrix_lfvector(h, Pinv, r);
-    filter(h, S);
-
-    deltaOld = deltaNew;
-
-    deltaNew = dot_lfvector(r, h, numverts);
-
-    add_lfvector_lfvectorS(p, h, p, deltaNew / deltaOld, numverts);
-
-    filter(p, S);
-  }
-
-#      ifdef DEBUG_TIME
-  double end = PIL_check_seconds_timer();
-  printf("cg_filtered_pre time: %f\n", (float)(end - start));
-#      endif
-
-  del_lfvector(h);
-  del_lfvector(s);
-  del_lfvector(p);
-  del_lfvector(r);
-
-  printf("iterations: %d\n", iterations);
-
-  return iterations < conjgrad_looplimit;
-}
-#    endif
-
-// version 1.4
-static int cg_filtered_pre(lfVector *dv,
-                           fmatrix3x3 *lA,
-                           lfVector *lB,
-                           lfVector *z,
-                           fmatrix3x3 *S,
-                           fmatrix3x3 *P,
-                           fmatrix3x3 *Pinv,
-                           fmatrix3x3 *bigI)
-{
-  unsigned int numverts = lA[0].vcount, iterations = 0, conjgrad_looplimit = 100;
-  float delta0 = 0, deltaNew = 0, deltaOld = 0, alpha = 0, tol = 0;
-  lfVector *r = create_lfvector(numverts);
-  lfVector *p = create_lfvector(numverts);
-  lfVector *s = create_lfvector(numverts);
-  lfVector *h = create_lfvector(numverts);
-  lfVector *bhat = create_lfvector(numverts);
-  lfVector *btemp = create_lfvector(numverts);
-
-  BuildPPinv(lA, P, Pinv);
-
-  initdiag_bfmatrix(bigI, I);
-  sub_bfmatrix_Smatrix(bigI, bigI, S);
-
-  // x = Sx_0+(I-S)z
-  filter(dv, S);
-  add_lfvector_lfvector(dv, dv, z, numverts);
-
-  // b_hat = S(b-A(I-S)z)
-  mul_bfmatrix_lfvector(r, lA, z);
-  mul_bfmatrix_lfvector(bhat, bigI, r);
-  sub_lfvector_lfvector(bhat, lB, bhat, numverts);
-
-  // r = S(b-Ax)
-  mul_bfmatrix_lfvector(r, lA, dv);
-  sub_lfvector_lfvector(r, lB, r, numverts);
-  filter(r, S);
-
-  // p = SP^-1r
-  mul_prevfmatrix_lfvector(p, Pinv, r);
-  filter(p, S);
-
-  // delta0 = bhat^TP^-1bhat
-  mul_prevfmatrix_lfvector(btemp, Pinv, bhat);
-  delta0 = dot_lfvector(bhat, btemp, numverts);
-
-  // deltaNew = r^TP
-  deltaNew = dot_lfvector(r, p, numverts);
-
-#    if 0
-  filter(dv, S);
-  add_lfvector_lfvector(dv, dv, z, numverts);
-
-  mul_bfmatrix_lfvector(r, lA, dv);
-  sub_lfvector_lfvector(r, lB, r, numverts);
-  filter(r, S);
-
-  mul_prevfmatrix_lfvector(p, Pinv, r);
-  filter(p, S);
-
-  deltaNew = dot_lfvector(r, p, numverts);
-
-  delta0 = deltaNew * sqrt(conjgrad_epsilon);
-#    endif
-
-#    ifdef DEBUG_TIME
-  double start = PIL_check_seconds_timer();
-#    endif
-
-  tol = (0.01 * 0.2);
-
-  while ((deltaNew > delta0 * tol * tol) && (iterations < conjgrad_looplimit)) {
-    iterations++;
-
-    mul_bfmatrix_lfvector(s, lA, p);
-    filter(s, S);
-
-    alpha = deltaNew / dot_lfvector(p, s, numverts);
-
-    add_lfvector_lfvectorS(dv, dv, p, alpha, numverts);
-
-    add_lfvector_lfvectorS(r, r, s, -alpha, numverts);
-
-    mul_prevfmatrix_lfvector(h, Pinv, r);
-    filter(h, S);
-
-    deltaOld = deltaNew;
-
-    deltaNew = dot_lfvector(r, h, numverts);
-
-    add_lfvector_lfvectorS(p, h, p, deltaNew / deltaOld, numverts);
-
-    filter(p, S);
-  }
-
-#    ifdef DEBUG_TIME
-  double end = PIL_check_seconds_timer();
-  printf("cg_filtered_pre time: %f\n", (float)(end - start));
-#    endif
-
-  del_lfvector(btemp);
-  del_lfvector(bhat);
-  del_lfvector(h);
-  del_lfvector(s);
-  del_lfvector(p);
-  del_lfvector(r);
-
-  // printf("iterations: %d\n", iterations);
-
-  return iterations < conjgrad_looplimit;
-}
-#  endif
-
 bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSolverResult *result)
 {
   unsigned int numverts = data->dFdV[0].vcount;
@@ -1146,11 +1317,10 @@ bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
   lfVector *dFdXmV = create_lfvector(numverts);
   zero_lfvector(data->dV, numverts);
 
-  cp_bfmatrix(data->A, data->M);
+  /* All big matrices use the blocks added by the forces of this step. */
+  bcsr_matrix_build_pattern(&data->A, data->dFdX, data->num_blocks);
 
-  subadd_bfmatrixS_bfmatrixS(data->A, data->dFdV, dt, data->dFdX, (dt * dt));
-
-  mul_bfmatrix_lfvector(dFdXmV, data->dFdX, data->V);
+  mul_bfmatrix_pattern_lfvector(dFdXmV, &data->A, data->dFdX, data->V);
 
   add_lfvectorS_lfvectorS(data->B, data->F, dt, dFdXmV, (dt * dt), numverts);
 
@@ -1159,9 +1329,8 @@ bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 #  endif
 
   /* Conjugate gradient algorithm to solve Ax=b. */
-  cg_filtered(data->dV, data->A, data->B, data->z, data->S, result);
-
-  // cg_filtered_pre(id->dV, id->A, id->B, id->z, id->S, id->P, id->Pinv, id->bigI);
+  bcsr_matrix_fill(&data->A, data->M, data->dFdV, data->dFdX, dt, data->Pinv);
+  cg_filtered(data->dV, &data->A, data->B, data->z, data->S, data->Pinv, result);
 
 #  ifdef DEBUG_TIME
   double end = PIL_check_seconds_timer();
@@ -1279,7 +1448,6 @@ static int BPH_mass_spring_add_block(Implicit_Data *data, int v1, int v2)
   init_fmatrix(data->M + s, v1, v2);
   init_fmatrix(data->dFdX + s, v1, v2);
   init_fmatrix(data->dFdV + s, v1, v2);
-  init_fmatrix(data->A + s, v1, v2);
   init_fmatrix(data->P + s, v1, v2);
   init_fmatrix(data->Pinv + s, v1, v2);
 
@@ -1569,6 +1569,7 @@ PyDoc_STRVAR(
     "according to output type. "
     "The returned verts may be in a different order from input verts, may be moved "
     "slightly, and may be merged with other nearby verts. "
+    "The returned edges and faces are indices in the returned verts. "
     "The three returned orig lists give, for each of verts, edges, and faces, the list of "
     "input element indices corresponding to the positionally same output element. "
     "For edges, the orig indices start with the input edges and then continue "
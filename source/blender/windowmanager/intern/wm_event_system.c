@@ -58,6 +58,8 @@
 
 #include "BKE_sound.h"
 
+#include "COM_compositor.h"
+
 #include "BLT_translation.h"
 
 #include "ED_fileselect.h"
@@ -309,6 +311,13 @@ void WM_main_remap_editor_id_reference(ID *old_id, ID *new_id)
       WM_msg_id_remove(mbus, old_id);
     }
   }
+
+#ifdef WITH_COMPOSITOR
+  /* cached results refer to the data-block by its address */
+  if (new_id == NULL) {
+    COM_freeID(old_id);
+  }
+#endif
 }
 
 static void wm_notifier_clear(wmNotifier *note)
@@ -47,6 +47,7 @@
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 #include "BLI_timer.h"
+#include "BLI_trace.h"
 
 #include "BLO_writefile.h"
 #include "BLO_undofile.h"
@@ -647,6 +648,9 @@ void WM_exit_ex(bContext *C, const bool do_python)
 
   DNA_sdna_current_free();
 
+  /* Write the trace requested with `--debug-trace`, all evaluation is done by now. */
+  BLI_trace_end();
+
   BLI_threadapi_exit();
 
   /* No need to call this early, rather do it late so that other
@@ -42,6 +42,7 @@
 #  include "BLI_fileops.h"
 #  include "BLI_mempool.h"
 #  include "BLI_system.h"
+#  include "BLI_trace.h"
 
 #  include "BLO_readfile.h" /* only for BLO_has_bfile_extension */
 
@@ -598,6 +599,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-no-threads");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-time");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-pretty");
+  BLI_argsPrintArgDoc(ba, "--debug-trace");
   BLI_argsPrintArgDoc(ba, "--debug-gpu");
   BLI_argsPrintArgDoc(ba, "--debug-gpumem");
   BLI_argsPrintArgDoc(ba, "--debug-gpu-shaders");
@@ -1069,6 +1071,25 @@ static int arg_handle_debug_value_set(int argc, const char **argv, void *UNUSED(
   }
 }
 
+static const char arg_handle_debug_trace_set_doc[] =
+    "<filepath>\n"
+    "\tRecord timings of dependency graph operations, modifiers and copy-on-write on all threads,\n"
+    "\twritten on exit as a trace file which can be viewed in chrome://tracing or Perfetto.";
+static int arg_handle_debug_trace_set(int argc, const char **argv, void *UNUSED(data))
+{
+  if (argc > 1) {
+    char filepath[FILE_MAX];
+    BLI_strncpy(filepath, argv[1], sizeof(filepath));
+    BLI_path_cwd(filepath, sizeof(filepath));
+    BLI_trace_begin(filepath);
+    return 1;
+  }
+  else {
+    printf("\nError: you must specify a file path to write the trace to.\n");
+    return 0;
+  }
+}
+
 static const char arg_handle_debug_fpe_set_doc[] =
     "\n\t"
     "Enable floating point exceptions.";
@@ -2166,6 +2187,7 @@ void main_args_setup(bContext *C, bArgs *ba)
               "--debug-depsgraph-pretty",
               CB_EX(arg_handle_debug_mode_generic_set, depsgraph_pretty),
               (void *)G_DEBUG_DEPSGRAPH_PRETTY);
+  BLI_argsAdd(ba, 1, NULL, "--debug-trace", CB(arg_handle_debug_trace_set), NULL);
   BLI_argsAdd(ba,
               1,
               NULL,
@@ -0,0 +1,225 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_threads.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_boolean.h"
+
+#include "bmesh.h"
+#include "tools/bmesh_intersect.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 3
+
+/* Closed UV sphere, with triangle fans at the poles. */
+static Mesh *boolean_test_sphere_create(const int resolution,
+                                        const float radius,
+                                        const float center[3])
+{
+  const int rings = resolution, segments = resolution * 2;
+  const int totvert = 2 + (rings - 1) * segments;
+  const int totquad = (rings - 2) * segments, tottri = 2 * segments;
+  Mesh *mesh = BKE_mesh_new_nomain(
+      totvert, 0, 0, totquad * 4 + tottri * 3, totquad + tottri);
+
+#define RING_VERT(r, s) (1 + ((r)-1) * segments + ((s) % segments))
+
+  const int bottom = totvert - 1;
+  copy_v3_fl3(mesh->mvert[0].co, 0.0f, 0.0f, radius);
+  copy_v3_fl3(mesh->mvert[bottom].co, 0.0f, 0.0f, -radius);
+  for (int r = 1; r < rings; r++) {
+    const float theta = (float)M_PI * r / rings;
+    for (int s = 0; s < segments; s++) {
+      const float phi = 2.0f * (float)M_PI * s / segments;
+      copy_v3_fl3(mesh->mvert[RING_VERT(r, s)].co,
+                  radius * sinf(theta) * cosf(phi),
+                  radius * sinf(theta) * sinf(phi),
+                  radius * cosf(theta));
+    }
+  }
+  for (int v = 0; v < totvert; v++) {
+    add_v3_v3(mesh->mvert[v].co, center);
+  }
+
+  MPoly *mp = mesh->mpoly;
+  MLoop *ml = mesh->mloop;
+  int loop = 0;
+  for (int s = 0; s < segments; s++) {
+    const int verts[3] = {0, RING_VERT(1, s), RING_VERT(1, s + 1)};
+    mp->loopstart = loop;
+    mp->totloop = 3;
+    for (int k = 0; k < 3; k++) {
+      ml[loop++].v = verts[k];
+    }
+    mp++;
+  }
+  for (int r = 1; r < rings - 1; r++) {
+    for (int s = 0; s < segments; s++) {
+      const int verts[4] = {
+          RING_VERT(r, s), RING_VERT(r + 1, s), RING_VERT(r + 1, s + 1), RING_VERT(r, s + 1)};
+      mp->loopstart = loop;
+      mp->totloop = 4;
+      for (int k = 0; k < 4; k++) {
+        ml[loop++].v = verts[k];
+      }
+      mp++;
+    }
+  }
+  for (int s = 0; s < segments; s++) {
+    const int verts[3] = {RING_VERT(rings - 1, s), bottom, RING_VERT(rings - 1, s + 1)};
+    mp->loopstart = loop;
+    mp->totloop = 3;
+    for (int k = 0; k < 3; k++) {
+      ml[loop++].v = verts[k];
+    }
+    mp++;
+  }
+
+#undef RING_VERT
+
+  BKE_mesh_calc_edges(mesh, false, false);
+  BKE_mesh_calc_normals(mesh);
+  return mesh;
+}
+
+/* The faces of the operand are tagged to tell them apart, like the Boolean modifier does. */
+static int boolean_test_face_isect_pair(BMFace *f, void *UNUSED(user_data))
+{
+  return BM_elem_flag_test(f, BM_ELEM_DRAW) ? 1 : 0;
+}
+
+/* Same steps as the BMesh solver of the Boolean modifier. */
+static Mesh *boolean_test_bmesh(const Mesh *mesh, const Mesh *mesh_other, const int operation)
+{
+  const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh, mesh_other);
+  BMeshCreateParams create_params = {0};
+  BMeshFromMeshParams convert_params = {0};
+  convert_params.calc_face_normal = true;
+
+  BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+  BM_mesh_bm_from_me(bm, mesh_other, &convert_params);
+  BMIter iter;
+  BMFace *efa;
+  BM_ITER_MESH (efa, &iter, bm, BM_FACES_OF_MESH) {
+    BM_elem_flag_enable(efa, BM_ELEM_DRAW);
+  }
+  BM_mesh_bm_from_me(bm, mesh, &convert_params);
+
+  const int looptris_tot = poly_to_tri_count(bm->totface, bm->totloop);
+  int tottri;
+  BMLoop *(*looptris)[3] = (BMLoop * (*)[3]) MEM_malloc_arrayN(
+      looptris_tot, sizeof(*looptris), __func__);
+  BM_mesh_calc_tessellation_beauty(bm, looptris, &tottri);
+  BM_mesh_intersect(bm,
+                    looptris,
+                    tottri,
+                    boolean_test_face_isect_pair,
+                    NULL,
+                    false,
+                    false,
+                    true,
+                    true,
+                    false,
+                    false,
+                    operation,
+                    1e-6f);
+  MEM_freeN(looptris);
+
+  Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, NULL, mesh);
+  BM_mesh_free(bm);
+  return result;
+}
+
+/* Subtract spheres placed around the surface of a large sphere, all at once and one by one. */
+static void boolean_test_do(const char *id, const int resolution, const int cutters_len)
+{
+  const float center[3] = {0.0f, 0.0f, 0.0f};
+  Mesh *mesh = boolean_test_sphere_create(resolution, 1.0f, center);
+  Mesh **cutters = (Mesh **)MEM_malloc_arrayN(cutters_len, sizeof(*cutters), __func__);
+  MeshBooleanOperand *operands = (MeshBooleanOperand *)MEM_calloc_arrayN(
+      cutters_len + 1, sizeof(*operands), __func__);
+
+  operands[0].mesh = mesh;
+  unit_m4(operands[0].obmat);
+  for (int i = 0; i < cutters_len; i++) {
+    const float angle = 2.0f * (float)M_PI * i / cutters_len;
+    const float cutter_center[3] = {cosf(angle), sinf(angle), 0.1f * (i % 3)};
+    cutters[i] = boolean_test_sphere_create(resolution / 2, 0.3f, cutter_center);
+    operands[i + 1].mesh = cutters[i];
+    unit_m4(operands[i + 1].obmat);
+  }
+
+  BLI_threadapi_init();
+
+  double mesh_timing = 0.0, bmesh_timing = 0.0;
+  for (int run = 0; run < NUM_RUN_AVERAGED; run++) {
+    double init_time = PIL_check_seconds_timer();
+    Mesh *result = BKE_mesh_boolean(operands, cutters_len + 1, MESH_BOOLEAN_DIFFERENCE, 1e-6f);
+    mesh_timing += PIL_check_seconds_timer() - init_time;
+
+    EXPECT_GT(result->totpoly, 0);
+    /* Uncut polygons are kept as they are. */
+    EXPECT_LT(result->totpoly, mesh->totpoly + cutters_len * cutters[0]->totpoly * 4);
+    BKE_id_free(NULL, result);
+
+    init_time = PIL_check_seconds_timer();
+    result = mesh;
+    for (int i = 0; i < cutters_len; i++) {
+      Mesh *result_next = boolean_test_bmesh(result, cutters[i], MESH_BOOLEAN_DIFFERENCE);
+      if (result != mesh) {
+        BKE_id_free(NULL, result);
+      }
+      result = result_next;
+    }
+    bmesh_timing += PIL_check_seconds_timer() - init_time;
+
+    EXPECT_GT(result->totpoly, 0);
+    BKE_id_free(NULL, result);
+  }
+
+  printf("\t%s: %d faces and %d cutters, Mesh solver in %fs, BMesh solver in %fs "
+         "on average over %d runs\n",
+         id,
+         mesh->totpoly,
+         cutters_len,
+         mesh_timing / NUM_RUN_AVERAGED,
+         bmesh_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  for (int i = 0; i < cutters_len; i++) {
+    BKE_id_free(NULL, cutters[i]);
+  }
+  MEM_freeN(cutters);
+  MEM_freeN(operands);
+  BKE_id_free(NULL, mesh);
+  BLI_threadapi_exit();
+}
+
+TEST(mesh_boolean, DifferenceSingle)
+{
+  boolean_test_do("Boolean - single cutter", 256, 1);
+}
+
+TEST(mesh_boolean, DifferenceMany)
+{
+  boolean_test_do("Boolean - many cutters", 256, 32);
+}
+
+TEST(mesh_boolean, DifferenceManyDense)
+{
+  boolean_test_do("Boolean - many cutters, dense", 1024, 32);
+}
@@ -0,0 +1,233 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_threads.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_boolean.h"
+}
+
+#define VOLUME_EPSILON 1e-4f
+
+/* Offsets of the operands, chosen so no faces are coplanar and no edges go through corners. */
+static const float cube_b[3] = {0.5f, 0.3f, 0.2f};
+static const float cube_c[3] = {-0.6f, 0.2f, 0.35f};
+static const float cube_d[3] = {0.3f, 0.45f, 0.35f};
+
+struct BooleanTestCube {
+  float offset[3];
+  /** Mirrored on the X axis, so the operand has a negative scale. */
+  bool is_mirror;
+};
+
+/* Unit cube with outward facing quads, vertex index bits are the X, Y and Z coordinates. */
+static Mesh *boolean_test_cube_create(void)
+{
+  static const int faces[6][4] = {
+      {0, 4, 6, 2},
+      {1, 3, 7, 5},
+      {0, 1, 5, 4},
+      {2, 6, 7, 3},
+      {0, 2, 3, 1},
+      {4, 5, 7, 6},
+  };
+  Mesh *mesh = BKE_mesh_new_nomain(8, 0, 0, 24, 6);
+  for (int v = 0; v < 8; v++) {
+    copy_v3_fl3(mesh->mvert[v].co, v & 1, (v >> 1) & 1, (v >> 2) & 1);
+  }
+  for (int p = 0; p < 6; p++) {
+    mesh->mpoly[p].loopstart = p * 4;
+    mesh->mpoly[p].totloop = 4;
+    for (int k = 0; k < 4; k++) {
+      mesh->mloop[p * 4 + k].v = faces[p][k];
+    }
+  }
+  BKE_mesh_calc_edges(mesh, false, false);
+  BKE_mesh_calc_normals(mesh);
+  return mesh;
+}
+
+static Mesh *boolean_test_cubes(const BooleanTestCube *cubes,
+                                const int cubes_len,
+                                const int operation)
+{
+  Mesh *cube = boolean_test_cube_create();
+  MeshBooleanOperand *operands = (MeshBooleanOperand *)MEM_calloc_arrayN(
+      cubes_len, sizeof(*operands), __func__);
+
+  for (int i = 0; i < cubes_len; i++) {
+    operands[i].mesh = cube;
+    unit_m4(operands[i].obmat);
+    copy_v3_v3(operands[i].obmat[3], cubes[i].offset);
+    if (cubes[i].is_mirror) {
+      /* Still covers the same space. */
+      operands[i].obmat[0][0] = -1.0f;
+      operands[i].obmat[3][0] += 1.0f;
+    }
+  }
+
+  BLI_threadapi_init();
+  Mesh *result = BKE_mesh_boolean(operands, cubes_len, operation, 1e-6f);
+  BLI_threadapi_exit();
+
+  MEM_freeN(operands);
+  BKE_id_free(NULL, cube);
+  return result;
+}
+
+/* Signed volume, positive when the faces point outwards. */
+static float boolean_test_volume(const Mesh *mesh)
+{
+  float volume = 0.0f;
+  for (int p = 0; p < mesh->totpoly; p++) {
+    const MPoly *mp = &mesh->mpoly[p];
+    const MLoop *ml = &mesh->mloop[mp->loopstart];
+    const float *v0 = mesh->mvert[ml[0].v].co;
+    for (int k = 2; k < mp->totloop; k++) {
+      volume += volume_tri_tetrahedron_signed_v3(
+          v0, mesh->mvert[ml[k - 1].v].co, mesh->mvert[ml[k].v].co);
+    }
+  }
+  return volume;
+}
+
+/* Every edge is used by two faces going along it in opposite directions. */
+static void boolean_test_expect_manifold(const Mesh *mesh)
+{
+  int *edge_users = (int *)MEM_calloc_arrayN(mesh->totedge, sizeof(int), __func__);
+  int *edge_winding = (int *)MEM_calloc_arrayN(mesh->totedge, sizeof(int), __func__);
+  for (int p = 0; p < mesh->totpoly; p++) {
+    const MPoly *mp = &mesh->mpoly[p];
+    for (int k = 0; k < mp->totloop; k++) {
+      const MLoop *ml = &mesh->mloop[mp->loopstart + k];
+      edge_users[ml->e]++;
+      edge_winding[ml->e] += (mesh->medge[ml->e].v1 == ml->v) ? 1 : -1;
+    }
+  }
+
+  int edges_non_manifold = 0, edges_flipped = 0;
+  for (int e = 0; e < mesh->totedge; e++) {
+    edges_non_manifold += (edge_users[e] != 2);
+    edges_flipped += (edge_winding[e] != 0);
+  }
+  EXPECT_EQ(edges_non_manifold, 0);
+  EXPECT_EQ(edges_flipped, 0);
+
+  MEM_freeN(edge_users);
+  MEM_freeN(edge_winding);
+}
+
+static void boolean_test_expect(const BooleanTestCube *cubes,
+                                const int cubes_len,
+                                const int operation,
+                                const float volume)
+{
+  Mesh *result = boolean_test_cubes(cubes, cubes_len, operation);
+  EXPECT_GT(result->totpoly, 0);
+  EXPECT_NEAR(boolean_test_volume(result), volume, VOLUME_EPSILON);
+  boolean_test_expect_manifold(result);
+  BKE_id_free(NULL, result);
+}
+
+TEST(mesh_boolean, Union)
+{
+  const BooleanTestCube cubes[] = {{{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}}};
+  boolean_test_expect(cubes, 2, MESH_BOOLEAN_UNION, 2.0f - 0.28f);
+}
+
+TEST(mesh_boolean, Intersect)
+{
+  const BooleanTestCube cubes[] = {{{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}}};
+  boolean_test_expect(cubes, 2, MESH_BOOLEAN_INTERSECT, 0.28f);
+}
+
+TEST(mesh_boolean, Difference)
+{
+  const BooleanTestCube cubes[] = {{{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}}};
+  boolean_test_expect(cubes, 2, MESH_BOOLEAN_DIFFERENCE, 1.0f - 0.28f);
+}
+
+/* B and C both overlap the first cube, but not each other. */
+TEST(mesh_boolean, UnionMany)
+{
+  const BooleanTestCube cubes[] = {
+      {{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}}, {{UNPACK3(cube_c)}}};
+  boolean_test_expect(cubes, 3, MESH_BOOLEAN_UNION, 3.0f - 0.28f - 0.208f);
+}
+
+TEST(mesh_boolean, DifferenceMany)
+{
+  const BooleanTestCube cubes[] = {
+      {{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}}, {{UNPACK3(cube_c)}}};
+  boolean_test_expect(cubes, 3, MESH_BOOLEAN_DIFFERENCE, 1.0f - 0.28f - 0.208f);
+}
+
+/* D overlaps the intersection of the first cube and B. */
+TEST(mesh_boolean, IntersectMany)
+{
+  const BooleanTestCube cubes[] = {
+      {{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}}, {{UNPACK3(cube_d)}}};
+  boolean_test_expect(cubes, 3, MESH_BOOLEAN_INTERSECT, 0.5f * 0.55f * 0.65f);
+}
+
+TEST(mesh_boolean, NegativeScale)
+{
+  const BooleanTestCube cubes[] = {{{0.0f, 0.0f, 0.0f}}, {{UNPACK3(cube_b)}, true}};
+  boolean_test_expect(cubes, 2, MESH_BOOLEAN_UNION, 2.0f - 0.28f);
+  boolean_test_expect(cubes, 2, MESH_BOOLEAN_INTERSECT, 0.28f);
+  boolean_test_expect(cubes, 2, MESH_BOOLEAN_DIFFERENCE, 1.0f - 0.28f);
+
+  const BooleanTestCube cubes_first[] = {{{0.0f, 0.0f, 0.0f}, true}, {{UNPACK3(cube_b)}}};
+  boolean_test_expect(cubes_first, 2, MESH_BOOLEAN_DIFFERENCE, 1.0f - 0.28f);
+}
+
+/* Only one of the coinciding faces is kept. */
+TEST(mesh_boolean, CoplanarSame)
+{
+  const BooleanTestCube cubes[] = {{{0.0f, 0.0f, 0.0f}}, {{0.0f, 0.0f, 0.0f}}};
+
+  Mesh *result = boolean_test_cubes(cubes, 2, MESH_BOOLEAN_UNION);
+  EXPECT_EQ(result->totpoly, 6);
+  EXPECT_NEAR(boolean_test_volume(result), 1.0f, VOLUME_EPSILON);
+  BKE_id_free(NULL, result);
+
+  result = boolean_test_cubes(cubes, 2, MESH_BOOLEAN_INTERSECT);
+  EXPECT_EQ(result->totpoly, 6);
+  EXPECT_NEAR(boolean_test_volume(result), 1.0f, VOLUME_EPSILON);
+  BKE_id_free(NULL, result);
+
+  result = boolean_test_cubes(cubes, 2, MESH_BOOLEAN_DIFFERENCE);
+  EXPECT_EQ(result->totpoly, 0);
+  BKE_id_free(NULL, result);
+}
+
+/* Cubes touching by a face, the faces between them are removed. */
+TEST(mesh_boolean, CoplanarOpposite)
+{
+  const BooleanTestCube cubes[] = {{{0.0f, 0.0f, 0.0f}}, {{1.0f, 0.0f, 0.0f}}};
+
+  Mesh *result = boolean_test_cubes(cubes, 2, MESH_BOOLEAN_UNION);
+  EXPECT_EQ(result->totpoly, 10);
+  EXPECT_NEAR(boolean_test_volume(result), 2.0f, VOLUME_EPSILON);
+  BKE_id_free(NULL, result);
+
+  result = boolean_test_cubes(cubes, 2, MESH_BOOLEAN_INTERSECT);
+  EXPECT_EQ(result->totpoly, 0);
+  BKE_id_free(NULL, result);
+
+  result = boolean_test_cubes(cubes, 2, MESH_BOOLEAN_DIFFERENCE);
+  EXPECT_EQ(result->totpoly, 6);
+  EXPECT_NEAR(boolean_test_volume(result), 1.0f, VOLUME_EPSILON);
+  BKE_id_free(NULL, result);
+}
@@ -0,0 +1,97 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "testing/testing_mesh.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_runtime.h"
+}
+
+#define INSTANCES_LEN 2
+
+/* Each copy of the realized mesh is the input moved by its instance transform, with the indices
+ * of its edges and loops offset to the elements of the same copy. */
+TEST(mesh_runtime, InstancesRealize)
+{
+  Mesh *mesh = testing_mesh_grid_create(2, 0.0f);
+  float(*instance_mats)[4][4] = (float(*)[4][4])MEM_malloc_arrayN(
+      INSTANCES_LEN, sizeof(*instance_mats), __func__);
+  /* A translation, and a rotation of a quarter turn around X so the normals move too. */
+  unit_m4(instance_mats[0]);
+  copy_v3_fl3(instance_mats[0][3], 2.0f, 0.0f, 0.0f);
+  axis_angle_to_mat4_single(instance_mats[1], 'X', (float)M_PI_2);
+  copy_v3_fl3(instance_mats[1][3], 0.0f, 3.0f, 1.0f);
+  mesh->runtime.instance_mats = instance_mats;
+  mesh->runtime.instance_mats_len = INSTANCES_LEN;
+
+  Mesh *result = BKE_mesh_runtime_instances_realize(mesh);
+  const int copies_len = INSTANCES_LEN + 1;
+
+  ASSERT_EQ(result->totvert, mesh->totvert * copies_len);
+  ASSERT_EQ(result->totedge, mesh->totedge * copies_len);
+  ASSERT_EQ(result->totloop, mesh->totloop * copies_len);
+  ASSERT_EQ(result->totpoly, mesh->totpoly * copies_len);
+  EXPECT_EQ(result->runtime.instance_mats_len, 0);
+
+  int verts_mismatch = 0, normals_mismatch = 0, edges_mismatch = 0, loops_mismatch = 0,
+      polys_mismatch = 0;
+  for (int c = 0; c < copies_len; c++) {
+    float mat[4][4];
+    if (c == 0) {
+      unit_m4(mat);
+    }
+    else {
+      copy_m4_m4(mat, instance_mats[c - 1]);
+    }
+
+    for (int i = 0; i < mesh->totvert; i++) {
+      const MVert *mv_src = &mesh->mvert[i];
+      const MVert *mv = &result->mvert[c * mesh->totvert + i];
+      float co[3], no_src[3], no_expect[3], no[3];
+      mul_v3_m4v3(co, mat, mv_src->co);
+      verts_mismatch += !compare_v3v3(mv->co, co, 1e-6f);
+
+      normal_short_to_float_v3(no_src, mv_src->no);
+      mul_v3_mat3_m4v3(no_expect, mat, no_src);
+      normal_short_to_float_v3(no, mv->no);
+      normals_mismatch += !compare_v3v3(no, no_expect, 1e-3f);
+    }
+    for (int i = 0; i < mesh->totedge; i++) {
+      const MEdge *me_src = &mesh->medge[i];
+      const MEdge *me = &result->medge[c * mesh->totedge + i];
+      edges_mismatch += (me->v1 != me_src->v1 + c * mesh->totvert) ||
+                        (me->v2 != me_src->v2 + c * mesh->totvert);
+    }
+    for (int i = 0; i < mesh->totloop; i++) {
+      const MLoop *ml_src = &mesh->mloop[i];
+      const MLoop *ml = &result->mloop[c * mesh->totloop + i];
+      loops_mismatch += (ml->v != ml_src->v + c * mesh->totvert) ||
+                        (ml->e != ml_src->e + c * mesh->totedge);
+    }
+    for (int i = 0; i < mesh->totpoly; i++) {
+      const MPoly *mp_src = &mesh->mpoly[i];
+      const MPoly *mp = &result->mpoly[c * mesh->totpoly + i];
+      polys_mismatch += (mp->loopstart != mp_src->loopstart + c * mesh->totloop) ||
+                        (mp->totloop != mp_src->totloop);
+    }
+  }
+  EXPECT_EQ(verts_mismatch, 0);
+  EXPECT_EQ(normals_mismatch, 0);
+  EXPECT_EQ(edges_mismatch, 0);
+  EXPECT_EQ(loops_mismatch, 0);
+  EXPECT_EQ(polys_mismatch, 0);
+
+  BKE_id_free(NULL, result);
+  BKE_id_free(NULL, mesh);
+}
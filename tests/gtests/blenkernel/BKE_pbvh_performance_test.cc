@@ -0,0 +1,247 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "testing/testing_mesh.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_ghash.h"
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+#include "BKE_pbvh.h"
+
+#include "bmesh.h"
+#include "bmesh_tools.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 5
+
+/* Build the PBVH like entering sculpt mode does, including the triangulation. */
+static void pbvh_build_test_do(const char *id, const int resolution, const bool use_sah)
+{
+  Mesh *mesh = testing_mesh_grid_create(resolution, 0.1f);
+  const int looptri_num = poly_to_tri_count(mesh->totpoly, mesh->totloop);
+  int totnode = 0;
+
+  BLI_threadapi_init();
+
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = PIL_check_seconds_timer();
+
+    MLoopTri *looptri = (MLoopTri *)MEM_malloc_arrayN(looptri_num, sizeof(*looptri), __func__);
+    BKE_mesh_recalc_looptri(
+        mesh->mloop, mesh->mpoly, mesh->mvert, mesh->totloop, mesh->totpoly, looptri);
+
+    PBVH *pbvh = BKE_pbvh_new();
+    BKE_pbvh_build_sah_set(pbvh, use_sah);
+    BKE_pbvh_build_mesh(pbvh,
+                        mesh,
+                        mesh->mpoly,
+                        mesh->mloop,
+                        mesh->mvert,
+                        mesh->totvert,
+                        &mesh->vdata,
+                        &mesh->ldata,
+                        looptri,
+                        looptri_num);
+
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+
+    /* Every vertex is stored as unique vertex by exactly one leaf. */
+    PBVHNode **nodes;
+    int totuniq = 0;
+    BKE_pbvh_search_gather(pbvh, NULL, NULL, &nodes, &totnode);
+    for (int n = 0; n < totnode; n++) {
+      int uniq_verts, totvert;
+      BKE_pbvh_node_num_verts(pbvh, nodes[n], &uniq_verts, &totvert);
+      totuniq += uniq_verts;
+    }
+    EXPECT_EQ(totuniq, mesh->totvert);
+    MEM_SAFE_FREE(nodes);
+
+    BKE_pbvh_free(pbvh);
+  }
+
+  printf("\t%s: %d triangles, %d leaves built in %fs on average over %d runs\n",
+         id,
+         looptri_num,
+         totnode,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  BKE_id_free(NULL, mesh);
+  BLI_threadapi_exit();
+}
+
+/* Triangulated BMesh with the layers dynamic topology sculpting adds. */
+static BMesh *pbvh_test_bmesh_create(const Mesh *mesh)
+{
+  BMAllocTemplate allocsize = {mesh->totvert, mesh->totedge, mesh->totloop, mesh->totpoly};
+  BMeshCreateParams create_params = {0};
+  BMeshFromMeshParams convert_params = {0};
+  convert_params.calc_face_normal = true;
+
+  BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+  BM_mesh_bm_from_me(bm, mesh, &convert_params);
+  BM_mesh_triangulate(
+      bm, MOD_TRIANGULATE_QUAD_BEAUTY, MOD_TRIANGULATE_NGON_EARCLIP, 4, false, NULL, NULL, NULL);
+  BM_data_layer_add(bm, &bm->vdata, CD_PAINT_MASK);
+  BM_data_layer_add_named(bm, &bm->vdata, CD_PROP_INT, "_dyntopo_node_id");
+  BM_data_layer_add_named(bm, &bm->pdata, CD_PROP_INT, "_dyntopo_node_id");
+  BM_mesh_normals_update(bm);
+  return bm;
+}
+
+/* Offset the vertices of all leaves like a brush step does, through the vertex iterator. */
+static void pbvh_bmesh_test_brush_iter(PBVH *pbvh, PBVHNode **nodes, const int totnode)
+{
+  for (int n = 0; n < totnode; n++) {
+    PBVHVertexIter vd;
+    BKE_pbvh_vertex_iter_begin(pbvh, nodes[n], vd, PBVH_ITER_UNIQUE)
+    {
+      vd.co[2] += 1e-6f * (1.0f - *vd.mask);
+    }
+    BKE_pbvh_vertex_iter_end;
+  }
+}
+
+/* The same step walking the vertex sets of the leaves, as the iterator did before. */
+static void pbvh_bmesh_test_brush_gset(PBVH *pbvh, PBVHNode **nodes, const int totnode)
+{
+  const int cd_vert_mask_offset = CustomData_get_offset(&BKE_pbvh_get_bmesh(pbvh)->vdata,
+                                                        CD_PAINT_MASK);
+  for (int n = 0; n < totnode; n++) {
+    GSetIterator gs_iter;
+    GSET_ITER (gs_iter, BKE_pbvh_bmesh_node_unique_verts(nodes[n])) {
+      BMVert *v = (BMVert *)BLI_gsetIterator_getKey(&gs_iter);
+      if (BM_elem_flag_test(v, BM_ELEM_HIDDEN)) {
+        continue;
+      }
+      const float *mask = (const float *)BM_ELEM_CD_GET_VOID_P(v, cd_vert_mask_offset);
+      v->co[2] += 1e-6f * (1.0f - *mask);
+    }
+  }
+}
+
+/* Time a brush-like pass over all vertices of a dynamic topology PBVH, through the per-leaf
+ * vertex arrays and through the vertex sets, and a topology update which rebuilds the arrays
+ * of the changed leaves. */
+static void pbvh_bmesh_test_do(const char *id, const int resolution)
+{
+  Mesh *mesh = testing_mesh_grid_create(resolution, 0.1f);
+  BMesh *bm = pbvh_test_bmesh_create(mesh);
+  BMLog *bm_log = BM_log_create(bm);
+
+  BLI_threadapi_init();
+
+  PBVH *pbvh = BKE_pbvh_new();
+  BKE_pbvh_build_bmesh(pbvh,
+                       bm,
+                       false,
+                       bm_log,
+                       CustomData_get_offset(&bm->vdata, CD_PROP_INT),
+                       CustomData_get_offset(&bm->pdata, CD_PROP_INT));
+
+  PBVHNode **nodes;
+  int totnode;
+  BKE_pbvh_search_gather(pbvh, NULL, NULL, &nodes, &totnode);
+
+  double iter_timing = 0.0, gset_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    double init_time = PIL_check_seconds_timer();
+    pbvh_bmesh_test_brush_iter(pbvh, nodes, totnode);
+    iter_timing += PIL_check_seconds_timer() - init_time;
+
+    init_time = PIL_check_seconds_timer();
+    pbvh_bmesh_test_brush_gset(pbvh, nodes, totnode);
+    gset_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  /* Subdivide the edges around the center, like a stroke with a small detail size. */
+  const float center[3] = {0.5f, 0.5f, 0.0f};
+  for (int n = 0; n < totnode; n++) {
+    BKE_pbvh_node_mark_topology_update(nodes[n]);
+  }
+  BKE_pbvh_bmesh_detail_size_set(pbvh, 0.5f / resolution);
+  const double init_time = PIL_check_seconds_timer();
+  BKE_pbvh_bmesh_update_topology(pbvh, PBVH_Subdivide, center, NULL, 0.1f, false, false);
+  const double topology_timing = PIL_check_seconds_timer() - init_time;
+  MEM_SAFE_FREE(nodes);
+
+  /* The arrays of the changed leaves were rebuilt: every vertex is unique to one leaf. */
+  int totuniq = 0;
+  BKE_pbvh_search_gather(pbvh, NULL, NULL, &nodes, &totnode);
+  for (int n = 0; n < totnode; n++) {
+    PBVHVertexIter vd;
+    BKE_pbvh_vertex_iter_begin(pbvh, nodes[n], vd, PBVH_ITER_UNIQUE)
+    {
+      totuniq++;
+    }
+    BKE_pbvh_vertex_iter_end;
+  }
+  EXPECT_EQ(totuniq, bm->totvert);
+  MEM_SAFE_FREE(nodes);
+
+  printf("\t%s: %d triangles, %d leaves\n", id, bm->totface, totnode);
+  printf("\t\tbrush step through arrays: %fs, through sets: %fs on average over %d runs\n",
+         iter_timing / NUM_RUN_AVERAGED,
+         gset_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+  printf("\t\ttopology update: %fs\n", topology_timing);
+
+  BKE_pbvh_free(pbvh);
+  BM_log_free(bm_log);
+  BM_mesh_free(bm);
+  BKE_id_free(NULL, mesh);
+  BLI_threadapi_exit();
+}
+
+TEST(pbvh, BuildSmall)
+{
+  pbvh_build_test_do("PBVH build - 130k triangles", 256, false);
+}
+
+TEST(pbvh, BuildMedium)
+{
+  pbvh_build_test_do("PBVH build - 2M triangles", 1024, false);
+}
+
+TEST(pbvh, BuildLarge)
+{
+  pbvh_build_test_do("PBVH build - 8M triangles", 2048, false);
+}
+
+TEST(pbvh, BuildSAHMedium)
+{
+  pbvh_build_test_do("PBVH build SAH - 2M triangles", 1024, true);
+}
+
+TEST(pbvh, BuildSAHLarge)
+{
+  pbvh_build_test_do("PBVH build SAH - 8M triangles", 2048, true);
+}
+
+TEST(pbvh, DyntopoMedium)
+{
+  pbvh_bmesh_test_do("PBVH dyntopo - 2M triangles", 1024);
+}
+
+TEST(pbvh, DyntopoLarge)
+{
+  pbvh_bmesh_test_do("PBVH dyntopo - 5M triangles", 1600);
+}
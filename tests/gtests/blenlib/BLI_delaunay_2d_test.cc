@@ -445,6 +445,52 @@ TEST(delaunay, ThreePtsMerge)
   BLI_delaunay_2d_cdt_free(out);
 }
 
+/* Faces using a merged input vertex must refer to the output vertex it merged into. */
+TEST(delaunay, MergedVertInFace)
+{
+  CDT_input in;
+  CDT_result *out;
+  int v_out[5];
+  int i, j, f, v;
+  const char *spec = R"(5 0 1
+  0.0 0.0
+  0.0 0.0
+  1.0 0.0
+  1.0 1.0
+  0.0 1.0
+  1 2 3 4
+  )";
+
+  fill_input_from_string(&in, spec);
+  out = BLI_delaunay_2d_cdt_calc(&in, CDT_FULL);
+  EXPECT_EQ(out->verts_len, 4);
+  EXPECT_EQ(out->edges_len, 5);
+  EXPECT_EQ(out->faces_len, 2);
+  for (i = 0; i < 5; i++) {
+    v_out[i] = get_output_vert_index(out, i);
+    EXPECT_NE(v_out[i], -1);
+  }
+  EXPECT_EQ(v_out[0], v_out[1]);
+  for (f = 0; f < out->faces_len; f++) {
+    EXPECT_EQ(out->faces_len_table[f], 3);
+    EXPECT_TRUE(out_face_has_input_id(out, f, 0));
+    for (j = 0; j < out->faces_len_table[f]; j++) {
+      v = out->faces[out->faces_start_table[f] + j];
+      EXPECT_GE(v, 0);
+      EXPECT_LT(v, out->verts_len);
+      EXPECT_TRUE(v == v_out[1] || v == v_out[2] || v == v_out[3] || v == v_out[4]);
+    }
+  }
+  if (out->faces_len == 2) {
+    EXPECT_TRUE((get_face_tri(out, v_out[1], v_out[2], v_out[3]) != -1 &&
+                 get_face_tri(out, v_out[1], v_out[3], v_out[4]) != -1) ||
+                (get_face_tri(out, v_out[1], v_out[2], v_out[4]) != -1 &&
+                 get_face_tri(out, v_out[2], v_out[3], v_out[4]) != -1));
+  }
+  free_spec_arrays(&in);
+  BLI_delaunay_2d_cdt_free(out);
+}
+
 TEST(delaunay, MixedPts)
 {
   CDT_input in;
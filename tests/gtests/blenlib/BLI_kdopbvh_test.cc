@@ -136,3 +136,51 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+/**
+ * Move all points after building the tree and refit it, every point must still be found at its
+ * new location. Use enough points for the branches of a level to be updated in parallel.
+ */
+static void update_tree_points_test(int points_len, float scale, int round, int random_seed)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+  void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  float(*points)[3] = (float(*)[3])mem;
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, round, scale);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    float offset[3];
+    rng_v3_round(offset, 3, rng, round, scale * 0.1f);
+    add_v3_v3(points[i], offset);
+    EXPECT_TRUE(BLI_bvhtree_update_node(tree, i, points[i], NULL, 1));
+  }
+  BLI_bvhtree_update_tree(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    const int j = BLI_bvhtree_find_nearest(tree, points[i], NULL, NULL, NULL);
+    if (j != i) {
+      EXPECT_GE(j, 0);
+      EXPECT_LT(j, points_len);
+      EXPECT_EQ_ARRAY(points[i], points[j], 3);
+    }
+  }
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+}
+
+TEST(kdopbvh, UpdateTree_500)
+{
+  update_tree_points_test(500, 1.0, 1000, 12);
+}
+TEST(kdopbvh, UpdateTree_20000)
+{
+  update_tree_points_test(20000, 1.0, 100000, 12);
+}
@@ -13,6 +13,7 @@ extern "C" {
 #include "BLI_utildefines.h"
 
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
 
@@ -296,3 +297,120 @@ TEST(task, ListBaseIter100k)
 {
   task_listbase_test("ListBase parallel iteration - Threaded - 100000 items", 100000, true);
 }
+
+/* *** Task pools contention, tiny tasks pushed from many threads. *** */
+
+static void task_pool_tiny_func(TaskPool *__restrict UNUSED(pool),
+                                void *taskdata,
+                                int UNUSED(threadid))
+{
+  const uint index = (uint)POINTER_AS_INT(taskdata);
+  const uint limit = gen_pseudo_random_number(index) >> 4;
+  for (uint i = index; i < limit;) {
+    i += gen_pseudo_random_number(i) >> 4;
+  }
+}
+
+/* Each task spawns a sub-tree of tiny tasks from within the worker thread, which is the pattern
+ * used by depsgraph evaluation when scheduling children of an evaluated node. */
+static void task_pool_spawn_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+  const int depth = POINTER_AS_INT(taskdata);
+  task_pool_tiny_func(pool, POINTER_FROM_INT(depth), threadid);
+  if (depth == 0) {
+    return;
+  }
+  for (int i = 0; i < 2; i++) {
+    BLI_task_pool_push_from_thread(pool,
+                                   task_pool_spawn_func,
+                                   POINTER_FROM_INT(depth - 1),
+                                   false,
+                                   TASK_PRIORITY_HIGH,
+                                   threadid);
+  }
+}
+
+/* Each task pushes tiny tasks to a nested pool and waits for them, like modifiers doing threaded
+ * work from within a threaded depsgraph evaluation. */
+static void task_pool_nested_pool_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+  TaskScheduler *scheduler = (TaskScheduler *)BLI_task_pool_userdata(pool);
+  TaskPool *nested_pool = BLI_task_pool_create(scheduler, NULL);
+  for (int i = 0; i < POINTER_AS_INT(taskdata); i++) {
+    BLI_task_pool_push_from_thread(nested_pool,
+                                   task_pool_tiny_func,
+                                   POINTER_FROM_INT(i),
+                                   false,
+                                   TASK_PRIORITY_HIGH,
+                                   threadid);
+  }
+  BLI_task_pool_work_and_wait(nested_pool);
+  BLI_task_pool_free(nested_pool);
+}
+
+static void task_pool_contention_test_do(const char *id,
+                                         const int num_threads,
+                                         const int num_tasks,
+                                         TaskRunFunction func,
+                                         const int taskdata)
+{
+  TaskScheduler *scheduler = BLI_task_scheduler_create(num_threads);
+
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = PIL_check_seconds_timer();
+    TaskPool *pool = BLI_task_pool_create(scheduler, scheduler);
+    for (int j = 0; j < num_tasks; j++) {
+      BLI_task_pool_push(pool, func, POINTER_FROM_INT(taskdata), false, TASK_PRIORITY_LOW);
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  printf("\t%s - %d threads: done in %fs on average over %d runs\n",
+         id,
+         BLI_task_scheduler_num_threads(scheduler),
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  BLI_task_scheduler_free(scheduler);
+}
+
+static void task_pool_contention_test(const char *id,
+                                      const int num_tasks,
+                                      TaskRunFunction func,
+                                      const int taskdata)
+{
+  printf("\n========== STARTING %s ==========\n", id);
+
+  BLI_threadapi_init();
+
+  const int max_threads = max_ii(BLI_system_thread_count(), 2);
+  for (int num_threads = 2; num_threads < max_threads; num_threads *= 2) {
+    task_pool_contention_test_do(id, num_threads, num_tasks, func, taskdata);
+  }
+  task_pool_contention_test_do(id, max_threads, num_tasks, func, taskdata);
+
+  BLI_threadapi_exit();
+
+  printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(task, PoolContentionTinyTasks10k)
+{
+  task_pool_contention_test("Task pool - 10000 tiny tasks", 10000, task_pool_tiny_func, 1024);
+}
+
+TEST(task, PoolContentionSpawnFromThreads)
+{
+  /* 64 roots spawning 2^10 tasks each. */
+  task_pool_contention_test(
+      "Task pool - tasks spawned from worker threads", 64, task_pool_spawn_func, 9);
+}
+
+TEST(task, PoolContentionNestedPools)
+{
+  /* 256 tasks waiting for 64 nested tasks each. */
+  task_pool_contention_test("Task pool - nested pools", 256, task_pool_nested_pool_func, 64);
+}
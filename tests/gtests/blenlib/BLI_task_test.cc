@@ -253,3 +253,93 @@ TEST(task, ListBaseIter)
   MEM_freeN(items_buffer);
   BLI_threadapi_exit();
 }
+
+/* *** Task pools with explicit scheduler, tasks spawning other tasks. *** */
+
+#define TREE_DEPTH 10
+#define NUM_SCHEDULER_THREADS 8
+
+typedef struct TaskTreeNode {
+  int depth;
+  int *counter;
+} TaskTreeNode;
+
+static void task_tree_node_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+  TaskTreeNode *node = (TaskTreeNode *)taskdata;
+  atomic_add_and_fetch_uint32((uint32_t *)node->counter, 1);
+  if (node->depth == 0) {
+    return;
+  }
+  for (int i = 0; i < 2; i++) {
+    TaskTreeNode *child = (TaskTreeNode *)MEM_mallocN(sizeof(*child), __func__);
+    child->depth = node->depth - 1;
+    child->counter = node->counter;
+    BLI_task_pool_push_from_thread(
+        pool, task_tree_node_func, child, true, TASK_PRIORITY_HIGH, threadid);
+  }
+}
+
+static void task_tree_test_do(TaskPool *pool, int *counter)
+{
+  TaskTreeNode *root = (TaskTreeNode *)MEM_mallocN(sizeof(*root), __func__);
+  root->depth = TREE_DEPTH;
+  root->counter = counter;
+  BLI_task_pool_push(pool, task_tree_node_func, root, true, TASK_PRIORITY_HIGH);
+  BLI_task_pool_work_and_wait(pool);
+}
+
+TEST(task, PoolTaskTree)
+{
+  BLI_threadapi_init();
+  TaskScheduler *scheduler = BLI_task_scheduler_create(NUM_SCHEDULER_THREADS);
+
+  int counter = 0;
+  TaskPool *pool = BLI_task_pool_create(scheduler, NULL);
+  task_tree_test_do(pool, &counter);
+  BLI_task_pool_free(pool);
+
+  EXPECT_EQ(counter, (1 << (TREE_DEPTH + 1)) - 1);
+
+  BLI_task_scheduler_free(scheduler);
+  BLI_threadapi_exit();
+}
+
+typedef struct TaskNestedPoolData {
+  TaskScheduler *scheduler;
+  int num_outer_tasks;
+  int num_nested_tasks;
+} TaskNestedPoolData;
+
+static void task_nested_pool_func(TaskPool *__restrict pool,
+                                  void *UNUSED(taskdata),
+                                  int UNUSED(threadid))
+{
+  TaskNestedPoolData *data = (TaskNestedPoolData *)BLI_task_pool_userdata(pool);
+  TaskPool *nested_pool = BLI_task_pool_create(data->scheduler, NULL);
+  task_tree_test_do(nested_pool, &data->num_nested_tasks);
+  BLI_task_pool_free(nested_pool);
+  atomic_add_and_fetch_uint32((uint32_t *)&data->num_outer_tasks, 1);
+}
+
+TEST(task, PoolNestedSuspended)
+{
+  BLI_threadapi_init();
+  TaskScheduler *scheduler = BLI_task_scheduler_create(NUM_SCHEDULER_THREADS);
+
+  TaskNestedPoolData data = {scheduler, 0, 0};
+  const int num_outer_tasks = 16;
+
+  TaskPool *pool = BLI_task_pool_create_suspended(scheduler, &data);
+  for (int i = 0; i < num_outer_tasks; i++) {
+    BLI_task_pool_push(pool, task_nested_pool_func, NULL, false, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  EXPECT_EQ(data.num_outer_tasks, num_outer_tasks);
+  EXPECT_EQ(data.num_nested_tasks, num_outer_tasks * ((1 << (TREE_DEPTH + 1)) - 1));
+
+  BLI_task_scheduler_free(scheduler);
+  BLI_threadapi_exit();
+}
@@ -0,0 +1,131 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "testing/testing_mesh.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_threads.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+
+#include "bmesh.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 5
+
+/* Grid of quads with a UV layer and materials, so loops and faces have data to convert too. */
+static Mesh *mesh_conv_test_mesh_create(const int resolution)
+{
+  Mesh *mesh = testing_mesh_grid_create(resolution, 0.0f);
+  MLoopUV *mloopuv = (MLoopUV *)CustomData_add_layer(
+      &mesh->ldata, CD_MLOOPUV, CD_CALLOC, NULL, mesh->totloop);
+
+  for (int i = 0; i < mesh->totpoly; i++) {
+    mesh->mpoly[i].mat_nr = i % 3;
+  }
+  for (int i = 0; i < mesh->totloop; i++) {
+    copy_v2_v2(mloopuv[i].uv, mesh->mvert[mesh->mloop[i].v].co);
+  }
+
+  return mesh;
+}
+
+static BMesh *mesh_conv_test_bmesh_create(const Mesh *mesh)
+{
+  BMAllocTemplate allocsize = {mesh->totvert, mesh->totedge, mesh->totloop, mesh->totpoly};
+  BMeshCreateParams create_params = {0};
+  BMeshFromMeshParams convert_params = {0};
+  convert_params.calc_face_normal = true;
+
+  BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+  BM_mesh_bm_from_me(bm, mesh, &convert_params);
+  return bm;
+}
+
+/* Convert a mesh to a BMesh and back, like entering and leaving edit-mode. */
+static void mesh_conv_test_do(const char *id, const int resolution)
+{
+  Mesh *mesh = mesh_conv_test_mesh_create(resolution);
+  BMeshToMeshParams to_mesh_params = {0};
+
+  BLI_threadapi_init();
+
+  double from_mesh_timing = 0.0, to_mesh_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    double init_time = PIL_check_seconds_timer();
+    BMesh *bm = mesh_conv_test_bmesh_create(mesh);
+    from_mesh_timing += PIL_check_seconds_timer() - init_time;
+
+    EXPECT_EQ(bm->totvert, mesh->totvert);
+    EXPECT_EQ(bm->totedge, mesh->totedge);
+    EXPECT_EQ(bm->totloop, mesh->totloop);
+    EXPECT_EQ(bm->totface, mesh->totpoly);
+
+    Mesh *result = BKE_mesh_new_nomain(0, 0, 0, 0, 0);
+    init_time = PIL_check_seconds_timer();
+    BM_mesh_bm_to_me(NULL, bm, result, &to_mesh_params);
+    to_mesh_timing += PIL_check_seconds_timer() - init_time;
+
+    /* Elements are converted in order, the round trip gives back the same mesh. */
+    ASSERT_EQ(result->totvert, mesh->totvert);
+    ASSERT_EQ(result->totedge, mesh->totedge);
+    ASSERT_EQ(result->totloop, mesh->totloop);
+    ASSERT_EQ(result->totpoly, mesh->totpoly);
+    for (int v = 0; v < mesh->totvert; v++) {
+      EXPECT_V3_NEAR(result->mvert[v].co, mesh->mvert[v].co, 0.0f);
+    }
+    for (int e = 0; e < mesh->totedge; e++) {
+      EXPECT_EQ(result->medge[e].v1, mesh->medge[e].v1);
+      EXPECT_EQ(result->medge[e].v2, mesh->medge[e].v2);
+    }
+    for (int p = 0; p < mesh->totpoly; p++) {
+      EXPECT_EQ(result->mpoly[p].loopstart, mesh->mpoly[p].loopstart);
+      EXPECT_EQ(result->mpoly[p].mat_nr, mesh->mpoly[p].mat_nr);
+    }
+    const MLoopUV *mloopuv = (const MLoopUV *)CustomData_get_layer(&mesh->ldata, CD_MLOOPUV);
+    const MLoopUV *result_mloopuv = (const MLoopUV *)CustomData_get_layer(&result->ldata,
+                                                                          CD_MLOOPUV);
+    ASSERT_TRUE(result_mloopuv != NULL);
+    for (int l = 0; l < mesh->totloop; l++) {
+      EXPECT_EQ(result->mloop[l].v, mesh->mloop[l].v);
+      EXPECT_EQ(result->mloop[l].e, mesh->mloop[l].e);
+      EXPECT_V2_NEAR(result_mloopuv[l].uv, mloopuv[l].uv, 0.0f);
+    }
+
+    BKE_id_free(NULL, result);
+    BM_mesh_free(bm);
+  }
+
+  printf("\t%s: %d faces, converted to BMesh in %fs and back in %fs "
+         "on average over %d runs\n",
+         id,
+         mesh->totpoly,
+         from_mesh_timing / NUM_RUN_AVERAGED,
+         to_mesh_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  BKE_id_free(NULL, mesh);
+  BLI_threadapi_exit();
+}
+
+TEST(bmesh_mesh_conv, ConvertSmall)
+{
+  mesh_conv_test_do("Mesh conversion - 65k faces", 256);
+}
+
+TEST(bmesh_mesh_conv, ConvertMedium)
+{
+  mesh_conv_test_do("Mesh conversion - 1M faces", 1024);
+}
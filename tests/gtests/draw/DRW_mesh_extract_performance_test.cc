@@ -0,0 +1,174 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "testing/testing_mesh.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+
+#include "GPU_batch.h"
+
+#include "draw_cache_extract.h"
+#include "draw_cache_impl.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 5
+
+/* Size of the square of vertices moved between two updates. */
+#define DEFORM_PATCH_SIZE 32
+
+/* Buffers used by the solid shading and the wireframe overlay, as in object mode. */
+static void extract_test_buffers_request(MeshBufferCache *mbc)
+{
+  GPUVertBuf **vbos[] = {
+      &mbc->vbo.pos_nor,
+      &mbc->vbo.lnor,
+      &mbc->vbo.edge_fac,
+      &mbc->vbo.fdots_pos,
+  };
+  GPUIndexBuf **ibos[] = {
+      &mbc->ibo.tris,
+      &mbc->ibo.lines,
+      &mbc->ibo.points,
+  };
+  for (int i = 0; i < ARRAY_SIZE(vbos); i++) {
+    if (*vbos[i] == NULL) {
+      *vbos[i] = GPU_vertbuf_create(GPU_USAGE_STATIC);
+    }
+  }
+  for (int i = 0; i < ARRAY_SIZE(ibos); i++) {
+    if (*ibos[i] == NULL) {
+      *ibos[i] = (GPUIndexBuf *)MEM_callocN(sizeof(GPUIndexBuf), __func__);
+    }
+  }
+}
+
+static void extract_test_buffers_free(MeshBufferCache *mbc)
+{
+  GPUVertBuf **vbos = (GPUVertBuf **)&mbc->vbo;
+  GPUIndexBuf **ibos = (GPUIndexBuf **)&mbc->ibo;
+  for (int i = 0; i < sizeof(mbc->vbo) / sizeof(void *); i++) {
+    GPU_VERTBUF_DISCARD_SAFE(vbos[i]);
+  }
+  for (int i = 0; i < sizeof(mbc->ibo) / sizeof(void *); i++) {
+    GPU_INDEXBUF_DISCARD_SAFE(ibos[i]);
+  }
+}
+
+static void extract_test_buffers_create(MeshBatchCache *cache, Mesh *mesh)
+{
+  float obmat[4][4];
+  DRW_MeshCDMask cd_used;
+  unit_m4(obmat);
+  memset(&cd_used, 0, sizeof(cd_used));
+  mesh_buffer_cache_create_requested(
+      cache, cache->final, mesh, false, obmat, true, false, false, &cd_used, NULL, false);
+}
+
+static void extract_test_vbo_compare(GPUVertBuf *vbo, GPUVertBuf *vbo_ref)
+{
+  ASSERT_EQ(vbo->vertex_len, vbo_ref->vertex_len);
+  ASSERT_EQ(vbo->format.stride, vbo_ref->format.stride);
+  EXPECT_EQ(memcmp(vbo->data, vbo_ref->data, vbo->vertex_len * vbo->format.stride), 0);
+}
+
+/* Extract all buffers, then move a small patch of vertices and only update the buffers that
+ * depend on the positions, in the range of faces around the patch, like after a
+ * #BKE_MESH_BATCH_DIRTY_DEFORM tag from edit-mode transform. */
+static void extract_test_do(const char *id, const int resolution)
+{
+  Mesh *mesh = testing_mesh_grid_create(resolution, 0.0f);
+  MeshBatchCache *cache = (MeshBatchCache *)MEM_callocN(sizeof(*cache), __func__);
+  mesh->runtime.batch_cache = cache;
+  float obmat[4][4];
+  unit_m4(obmat);
+
+  BLI_threadapi_init();
+
+  double full_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    extract_test_buffers_free(&cache->final);
+    extract_test_buffers_request(&cache->final);
+
+    const double init_time = PIL_check_seconds_timer();
+    extract_test_buffers_create(cache, mesh);
+    full_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  double update_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    for (int y = 0; y < DEFORM_PATCH_SIZE; y++) {
+      for (int x = 0; x < DEFORM_PATCH_SIZE; x++) {
+        MVert *mv = &mesh->mvert[(resolution / 2 + y) * (resolution + 1) + resolution / 2 + x];
+        mv->co[2] += 0.01f * (x + y + i);
+      }
+    }
+    BKE_mesh_calc_normals(mesh);
+
+    const double init_time = PIL_check_seconds_timer();
+    DRW_mesh_batch_cache_dirty_tag(mesh, BKE_MESH_BATCH_DIRTY_DEFORM);
+    EXPECT_TRUE(cache->is_deform_dirty);
+    /* Rows of faces using the moved vertices and their neighbors, like transform tags them. */
+    cache->deform_poly_range[0] = (resolution / 2 - 2) * resolution;
+    cache->deform_poly_range[1] = (resolution / 2 + DEFORM_PATCH_SIZE + 1) * resolution;
+    mesh_buffer_cache_update_deform(
+        cache, cache->final, mesh, false, obmat, true, false, false, NULL, false);
+    cache->is_deform_dirty = false;
+    /* Discarded buffers are extracted again. */
+    extract_test_buffers_request(&cache->final);
+    extract_test_buffers_create(cache, mesh);
+    update_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  /* The updated buffers must match a full extraction. */
+  MeshBatchCache *cache_ref = (MeshBatchCache *)MEM_callocN(sizeof(*cache_ref), __func__);
+  extract_test_buffers_request(&cache_ref->final);
+  extract_test_buffers_create(cache_ref, mesh);
+  extract_test_vbo_compare(cache->final.vbo.pos_nor, cache_ref->final.vbo.pos_nor);
+  extract_test_vbo_compare(cache->final.vbo.lnor, cache_ref->final.vbo.lnor);
+  extract_test_vbo_compare(cache->final.vbo.fdots_pos, cache_ref->final.vbo.fdots_pos);
+  extract_test_buffers_free(&cache_ref->final);
+  MEM_freeN(cache_ref);
+
+  printf("\t%s: %d faces, full extraction in %fs, update after deformation in %fs "
+         "on average over %d runs\n",
+         id,
+         mesh->totpoly,
+         full_timing / NUM_RUN_AVERAGED,
+         update_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  DRW_mesh_batch_cache_free(mesh);
+  BKE_id_free(NULL, mesh);
+  BLI_threadapi_exit();
+}
+
+TEST(draw_mesh_extract, DeformSmall)
+{
+  extract_test_do("Mesh extraction - 65k faces", 256);
+}
+
+TEST(draw_mesh_extract, DeformMedium)
+{
+  extract_test_do("Mesh extraction - 1M faces", 1024);
+}
+
+TEST(draw_mesh_extract, DeformLarge)
+{
+  extract_test_do("Mesh extraction - 4M faces", 2048);
+}
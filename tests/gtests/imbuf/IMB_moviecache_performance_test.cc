@@ -0,0 +1,169 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_ghash.h"
+#include "BLI_task.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+#include "IMB_moviecache.h"
+
+#include "MEM_CacheLimiterC-Api.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 10
+#define NUM_FRAMES 256
+#define NUM_LOOKUPS 1000000
+
+class MovieCacheTest : public testing::Test {
+ protected:
+  static void SetUpTestCase()
+  {
+    IMB_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    IMB_moviecache_destruct();
+    IMB_exit();
+  }
+};
+
+typedef struct MovieCacheTestKey {
+  int frame;
+} MovieCacheTestKey;
+
+static unsigned int moviecache_test_hashhash(const void *key_v)
+{
+  const MovieCacheTestKey *key = (const MovieCacheTestKey *)key_v;
+  return BLI_ghashutil_uinthash((uint)key->frame);
+}
+
+static bool moviecache_test_hashcmp(const void *a_v, const void *b_v)
+{
+  const MovieCacheTestKey *a = (const MovieCacheTestKey *)a_v;
+  const MovieCacheTestKey *b = (const MovieCacheTestKey *)b_v;
+  return a->frame != b->frame;
+}
+
+static MovieCache *moviecache_test_create(const int num_frames)
+{
+  MovieCache *cache = IMB_moviecache_create("moviecache performance test",
+                                            sizeof(MovieCacheTestKey),
+                                            moviecache_test_hashhash,
+                                            moviecache_test_hashcmp);
+
+  for (int i = 0; i < num_frames; i++) {
+    MovieCacheTestKey key = {i};
+    ImBuf *ibuf = IMB_allocImBuf(64, 64, 32, IB_rect);
+    IMB_moviecache_put(cache, &key, ibuf);
+    IMB_freeImBuf(ibuf);
+  }
+
+  return cache;
+}
+
+static void moviecache_lookup_func(void *userdata,
+                                   int index,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MovieCache *cache = (MovieCache *)userdata;
+  /* Spread lookups over all frames, like scrubbing in several editors at once. */
+  MovieCacheTestKey key = {(int)(BLI_ghashutil_uinthash((uint)index) % NUM_FRAMES)};
+  ImBuf *ibuf = IMB_moviecache_get(cache, &key);
+
+  if (ibuf) {
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+static void moviecache_lookup_test_do(const char *id, const bool use_threads)
+{
+  MovieCache *cache = moviecache_test_create(NUM_FRAMES);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = use_threads;
+  settings.min_iter_per_thread = 1024;
+
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = PIL_check_seconds_timer();
+    BLI_task_parallel_range(0, NUM_LOOKUPS, cache, moviecache_lookup_func, &settings);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  printf("\t%s: %d lookups done in %fs on average over %d runs\n",
+         id,
+         NUM_LOOKUPS,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  IMB_moviecache_free(cache);
+}
+
+TEST_F(MovieCacheTest, LookupNoThread)
+{
+  moviecache_lookup_test_do("MovieCache lookup - Single thread", false);
+}
+
+TEST_F(MovieCacheTest, Lookup)
+{
+  moviecache_lookup_test_do("MovieCache lookup - Threaded", true);
+}
+
+typedef struct MovieCachePutData {
+  MovieCache *cache;
+  int num_frames;
+} MovieCachePutData;
+
+static void moviecache_lookup_put_func(void *userdata,
+                                       int index,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MovieCachePutData *data = (MovieCachePutData *)userdata;
+  MovieCacheTestKey key = {(int)(BLI_ghashutil_uinthash((uint)index) % data->num_frames)};
+  ImBuf *ibuf = IMB_moviecache_get(data->cache, &key);
+
+  if (ibuf == NULL) {
+    ibuf = IMB_allocImBuf(64, 64, 32, IB_rect);
+    IMB_moviecache_put(data->cache, &key, ibuf);
+  }
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST_F(MovieCacheTest, LookupPutLimited)
+{
+  const size_t maximum = MEM_CacheLimiter_get_maximum();
+
+  /* Room for about half of the frames, so lookups and evictions are mixed. */
+  MEM_CacheLimiter_set_maximum((size_t)NUM_FRAMES * 64 * 64 * 4 / 2);
+
+  MovieCachePutData data;
+  data.cache = moviecache_test_create(0);
+  data.num_frames = NUM_FRAMES;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  const double init_time = PIL_check_seconds_timer();
+  BLI_task_parallel_range(0, NUM_LOOKUPS / 10, &data, moviecache_lookup_put_func, &settings);
+
+  printf("\tMovieCache lookup and put - Threaded, limited: %d lookups done in %fs\n",
+         NUM_LOOKUPS / 10,
+         PIL_check_seconds_timer() - init_time);
+
+  IMB_moviecache_free(data.cache);
+
+  MEM_CacheLimiter_set_maximum(maximum);
+}
@@ -0,0 +1,159 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "testing/testing_mesh.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_runtime.h"
+#include "BKE_modifier.h"
+
+#include "MOD_modifiertypes.h"
+}
+
+#define COUNT 4
+
+static Object *array_test_object_create(Mesh *mesh_eval)
+{
+  Object *ob = (Object *)MEM_callocN(sizeof(*ob), __func__);
+  ob->type = OB_MESH;
+  unit_m4(ob->obmat);
+  ob->runtime.mesh_eval = mesh_eval;
+  return ob;
+}
+
+static void array_test_object_free(Object *ob)
+{
+  if (ob->runtime.mesh_eval != NULL) {
+    BKE_id_free(NULL, ob->runtime.mesh_eval);
+  }
+  MEM_freeN(ob);
+}
+
+/* Array of copies along X, output as instances when possible. */
+static ArrayModifierData *array_test_modifier_create(void)
+{
+  ArrayModifierData *amd = (ArrayModifierData *)MEM_callocN(sizeof(*amd), __func__);
+  amd->modifier.type = eModifierType_Array;
+  amd->modifier.mode = eModifierMode_Realtime | eModifierMode_Render;
+  modifierType_Array.initData((ModifierData *)amd);
+  amd->count = COUNT;
+  amd->flags |= MOD_ARR_INSTANCE;
+  return amd;
+}
+
+static Mesh *array_test_apply(ArrayModifierData *amd, Object *ob, Mesh *mesh)
+{
+  const ModifierEvalContext ctx = {NULL, ob, (ModifierApplyFlag)0};
+  return modifierType_Array.applyModifier((ModifierData *)amd, &ctx, mesh);
+}
+
+/* Copies output as instances are the same as the copies output as geometry, once realized. */
+TEST(array, Instances)
+{
+  Mesh *mesh = testing_mesh_grid_create(4, 0.0f);
+  Object *ob = array_test_object_create(NULL);
+  ArrayModifierData *amd = array_test_modifier_create();
+
+  Mesh *result = array_test_apply(amd, ob, mesh);
+  ASSERT_EQ(result->runtime.instance_mats_len, COUNT - 1);
+  EXPECT_EQ(result->totvert, mesh->totvert);
+  EXPECT_EQ(result->totpoly, mesh->totpoly);
+  /* The grid is one unit wide, relative offsets move each copy by that much. */
+  for (int i = 0; i < COUNT - 1; i++) {
+    float offset[3] = {(float)(i + 1), 0.0f, 0.0f};
+    EXPECT_TRUE(compare_v3v3(result->runtime.instance_mats[i][3], offset, 1e-6f));
+  }
+
+  amd->flags &= ~MOD_ARR_INSTANCE;
+  Mesh *result_geometry = array_test_apply(amd, ob, mesh);
+  EXPECT_EQ(result_geometry->runtime.instance_mats_len, 0);
+
+  Mesh *result_realized = BKE_mesh_runtime_instances_realize(result);
+  ASSERT_EQ(result_realized->totvert, result_geometry->totvert);
+  ASSERT_EQ(result_realized->totedge, result_geometry->totedge);
+  ASSERT_EQ(result_realized->totloop, result_geometry->totloop);
+  ASSERT_EQ(result_realized->totpoly, result_geometry->totpoly);
+
+  int verts_mismatch = 0, edges_mismatch = 0, loops_mismatch = 0;
+  for (int i = 0; i < result_geometry->totvert; i++) {
+    verts_mismatch += !compare_v3v3(
+        result_realized->mvert[i].co, result_geometry->mvert[i].co, 1e-6f);
+  }
+  for (int i = 0; i < result_geometry->totedge; i++) {
+    edges_mismatch += (result_realized->medge[i].v1 != result_geometry->medge[i].v1) ||
+                      (result_realized->medge[i].v2 != result_geometry->medge[i].v2);
+  }
+  for (int i = 0; i < result_geometry->totloop; i++) {
+    loops_mismatch += (result_realized->mloop[i].v != result_geometry->mloop[i].v) ||
+                      (result_realized->mloop[i].e != result_geometry->mloop[i].e);
+  }
+  EXPECT_EQ(verts_mismatch, 0);
+  EXPECT_EQ(edges_mismatch, 0);
+  EXPECT_EQ(loops_mismatch, 0);
+
+  BKE_id_free(NULL, result_realized);
+  BKE_id_free(NULL, result_geometry);
+  BKE_id_free(NULL, result);
+  MEM_freeN(amd);
+  array_test_object_free(ob);
+  BKE_id_free(NULL, mesh);
+}
+
+/* Copies which differ from the input, or are read by a following modifier, are geometry. */
+TEST(array, InstancesFallback)
+{
+  Mesh *mesh = testing_mesh_grid_create(4, 0.0f);
+  Object *ob = array_test_object_create(NULL);
+  Object *ob_cap = array_test_object_create(testing_mesh_grid_create(1, 0.0f));
+  ArrayModifierData *amd = array_test_modifier_create();
+  Mesh *result;
+
+  /* Merged copies share the vertices on their borders. */
+  amd->flags |= MOD_ARR_MERGE;
+  result = array_test_apply(amd, ob, mesh);
+  EXPECT_EQ(result->runtime.instance_mats_len, 0);
+  EXPECT_EQ(result->totvert, mesh->totvert * COUNT - 5 * (COUNT - 1));
+  BKE_id_free(NULL, result);
+  amd->flags &= ~MOD_ARR_MERGE;
+
+  amd->start_cap = ob_cap;
+  result = array_test_apply(amd, ob, mesh);
+  EXPECT_EQ(result->runtime.instance_mats_len, 0);
+  EXPECT_EQ(result->totvert, mesh->totvert * COUNT + ob_cap->runtime.mesh_eval->totvert);
+  BKE_id_free(NULL, result);
+  amd->start_cap = NULL;
+
+  /* Only enabled modifiers read the copies. */
+  ModifierData *md_next = (ModifierData *)MEM_callocN(sizeof(SmoothModifierData), __func__);
+  md_next->type = eModifierType_Smooth;
+  amd->modifier.next = md_next;
+  result = array_test_apply(amd, ob, mesh);
+  EXPECT_EQ(result->runtime.instance_mats_len, COUNT - 1);
+  BKE_id_free(NULL, result);
+
+  md_next->mode = eModifierMode_Realtime;
+  result = array_test_apply(amd, ob, mesh);
+  EXPECT_EQ(result->runtime.instance_mats_len, 0);
+  EXPECT_EQ(result->totvert, mesh->totvert * COUNT);
+  BKE_id_free(NULL, result);
+  amd->modifier.next = NULL;
+
+  MEM_freeN(md_next);
+  MEM_freeN(amd);
+  array_test_object_free(ob_cap);
+  array_test_object_free(ob);
+  BKE_id_free(NULL, mesh);
+}
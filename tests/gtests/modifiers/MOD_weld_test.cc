@@ -0,0 +1,136 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_rand.h"
+#include "BLI_threads.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+
+#include "MOD_modifiertypes.h"
+}
+
+#define MERGE_DIST 0.001f
+/* Quads on each side of the grid, every quad has its own vertices. */
+#define GRID_LEN 64
+/* Loose vertices only touching their neighbors, so each chain is merged into one. */
+#define CHAINS_LEN 256
+#define CHAIN_LEN 6
+
+/* Clusters of 2 to 4 duplicates at the corners of the quads, and chains of loose vertices
+ * added out of order, so clusters are joined in the order of the overlap pairs. */
+static Mesh *weld_test_mesh_create(void)
+{
+  static const int chain_order[CHAIN_LEN] = {2, 0, 4, 1, 5, 3};
+  const int quads_len = GRID_LEN * GRID_LEN;
+  Mesh *mesh = BKE_mesh_new_nomain(
+      quads_len * 4 + CHAINS_LEN * CHAIN_LEN, 0, 0, quads_len * 4, quads_len);
+  RNG *rng = BLI_rng_new(0);
+
+  MVert *mv = mesh->mvert;
+  for (int y = 0; y < GRID_LEN; y++) {
+    for (int x = 0; x < GRID_LEN; x++) {
+      const int p = y * GRID_LEN + x;
+      const int corners[4][2] = {{x, y}, {x + 1, y}, {x + 1, y + 1}, {x, y + 1}};
+      for (int k = 0; k < 4; k++, mv++) {
+        /* Duplicates are always closer than the merge distance to each other. */
+        for (int j = 0; j < 3; j++) {
+          mv->co[j] = (BLI_rng_get_float(rng) - 0.5f) * MERGE_DIST * 0.5f;
+        }
+        mv->co[0] += (float)corners[k][0] / GRID_LEN;
+        mv->co[1] += (float)corners[k][1] / GRID_LEN;
+        mesh->mloop[p * 4 + k].v = (uint)(p * 4 + k);
+      }
+      mesh->mpoly[p].loopstart = p * 4;
+      mesh->mpoly[p].totloop = 4;
+    }
+  }
+
+  for (int c = 0; c < CHAINS_LEN; c++) {
+    for (int k = 0; k < CHAIN_LEN; k++, mv++) {
+      copy_v3_fl3(mv->co, (float)c / CHAINS_LEN, 0.0f, 1.0f);
+      mv->co[2] += (float)chain_order[k] * MERGE_DIST * 0.6f;
+    }
+  }
+
+  BLI_rng_free(rng);
+  BKE_mesh_calc_edges(mesh, false, false);
+  return mesh;
+}
+
+static Mesh *weld_test_apply(Mesh *mesh, const int threads_len)
+{
+  WeldModifierData *wmd = (WeldModifierData *)MEM_callocN(sizeof(*wmd), __func__);
+  modifierType_Weld.initData((ModifierData *)wmd);
+  wmd->merge_dist = MERGE_DIST;
+  /* Find all duplicates, not only the first one of each vertex. */
+  wmd->max_interactions = 0;
+
+  BLI_system_num_threads_override_set(threads_len);
+  BLI_threadapi_init();
+  const ModifierEvalContext ctx = {NULL, NULL, (ModifierApplyFlag)0};
+  Mesh *result = modifierType_Weld.applyModifier((ModifierData *)wmd, &ctx, mesh);
+  BLI_threadapi_exit();
+  BLI_system_num_threads_override_set(0);
+
+  MEM_freeN(wmd);
+  return result;
+}
+
+static void weld_test_expect_equal(const Mesh *a, const Mesh *b)
+{
+  ASSERT_EQ(a->totvert, b->totvert);
+  ASSERT_EQ(a->totedge, b->totedge);
+  ASSERT_EQ(a->totloop, b->totloop);
+  ASSERT_EQ(a->totpoly, b->totpoly);
+
+  int verts_mismatch = 0, edges_mismatch = 0, loops_mismatch = 0, polys_mismatch = 0;
+  for (int i = 0; i < a->totvert; i++) {
+    verts_mismatch += !equals_v3v3(a->mvert[i].co, b->mvert[i].co);
+  }
+  for (int i = 0; i < a->totedge; i++) {
+    edges_mismatch += (a->medge[i].v1 != b->medge[i].v1) || (a->medge[i].v2 != b->medge[i].v2);
+  }
+  for (int i = 0; i < a->totloop; i++) {
+    loops_mismatch += (a->mloop[i].v != b->mloop[i].v) || (a->mloop[i].e != b->mloop[i].e);
+  }
+  for (int i = 0; i < a->totpoly; i++) {
+    polys_mismatch += (a->mpoly[i].loopstart != b->mpoly[i].loopstart) ||
+                      (a->mpoly[i].totloop != b->mpoly[i].totloop);
+  }
+  EXPECT_EQ(verts_mismatch, 0);
+  EXPECT_EQ(edges_mismatch, 0);
+  EXPECT_EQ(loops_mismatch, 0);
+  EXPECT_EQ(polys_mismatch, 0);
+}
+
+/* Welding on many threads maps the vertices exactly like on a single thread. */
+TEST(weld, ClusteredDuplicates)
+{
+  Mesh *mesh = weld_test_mesh_create();
+  Mesh *result_serial = weld_test_apply(mesh, 1);
+  Mesh *result = weld_test_apply(mesh, 8);
+
+  /* The quads share the corners of the grid, each chain keeps one vertex. */
+  EXPECT_EQ(result_serial->totvert, (GRID_LEN + 1) * (GRID_LEN + 1) + CHAINS_LEN);
+  EXPECT_EQ(result_serial->totedge, GRID_LEN * (GRID_LEN + 1) * 2);
+  EXPECT_EQ(result_serial->totloop, GRID_LEN * GRID_LEN * 4);
+  EXPECT_EQ(result_serial->totpoly, GRID_LEN * GRID_LEN);
+
+  weld_test_expect_equal(result, result_serial);
+
+  BKE_id_free(NULL, result);
+  BKE_id_free(NULL, result_serial);
+  BKE_id_free(NULL, mesh);
+}
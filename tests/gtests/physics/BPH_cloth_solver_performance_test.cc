@@ -0,0 +1,132 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_threads.h"
+
+#include "BPH_mass_spring.h"
+#include "implicit.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 5
+
+/* Square sheet of cloth stretched by 5% and pinned along one side, with structural and shear
+ * springs like the cloth modifier creates them. */
+static void cloth_solver_test_forces(Implicit_Data *id, const int resolution)
+{
+  const float spacing = 1.0f / resolution;
+  const float gravity[3] = {0.0f, 0.0f, -9.81f};
+  const float mass = 0.3f;
+  const int row = resolution + 1;
+  /* Stiffness is scaled by the average spring length, as in #cloth_calc_spring_force. */
+  const float k_tension = 40.0f / spacing, k_shear = 5.0f / spacing;
+  const float shear_len = spacing * (float)M_SQRT2;
+
+  BPH_mass_spring_clear_forces(id);
+
+  for (int i = 0; i < row * row; i++) {
+    BPH_mass_spring_force_gravity(id, i, mass, gravity);
+  }
+
+  for (int y = 0; y <= resolution; y++) {
+    for (int x = 0; x <= resolution; x++) {
+      const int v = y * row + x;
+      if (x < resolution) {
+        BPH_mass_spring_force_spring_linear(
+            id, v, v + 1, spacing, k_tension, 5.0f, k_tension, 5.0f, false, true, 0.0f);
+      }
+      if (y < resolution) {
+        BPH_mass_spring_force_spring_linear(
+            id, v, v + row, spacing, k_tension, 5.0f, k_tension, 5.0f, false, true, 0.0f);
+      }
+      if (x < resolution && y < resolution) {
+        BPH_mass_spring_force_spring_linear(
+            id, v, v + row + 1, shear_len, k_shear, 5.0f, k_shear, 5.0f, false, true, 0.0f);
+        BPH_mass_spring_force_spring_linear(
+            id, v + 1, v + row, shear_len, k_shear, 5.0f, k_shear, 5.0f, false, true, 0.0f);
+      }
+    }
+  }
+}
+
+static void cloth_solver_test_do(const char *id_name, const int resolution)
+{
+  const int row = resolution + 1;
+  const int numverts = row * row;
+  const int numsprings = 2 * resolution * row + 2 * resolution * resolution;
+  const float dt = 1.0f / (25.0f * 5.0f);
+  const float zero[3] = {0.0f, 0.0f, 0.0f};
+  float rest_transform[3][3];
+  unit_m3(rest_transform);
+
+  Implicit_Data *id = BPH_mass_spring_solver_create(numverts, numsprings);
+  for (int y = 0; y <= resolution; y++) {
+    for (int x = 0; x <= resolution; x++) {
+      const int v = y * row + x;
+      float co[3] = {1.05f * x / resolution, 1.05f * y / resolution, 0.0f};
+      float vel[3] = {0.0f, 0.0f, 0.1f * sinf(x * 0.3f) * cosf(y * 0.2f)};
+      BPH_mass_spring_set_vertex_mass(id, v, 0.3f);
+      BPH_mass_spring_set_rest_transform(id, v, rest_transform);
+      BPH_mass_spring_set_motion_state(id, v, co, vel);
+    }
+  }
+
+  BPH_mass_spring_clear_constraints(id);
+  for (int x = 0; x <= resolution; x++) {
+    BPH_mass_spring_add_constraint_ndof0(id, x, zero);
+  }
+
+  BLI_threadapi_init();
+
+  ImplicitSolverResult result;
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    cloth_solver_test_forces(id, resolution);
+
+    const double init_time = PIL_check_seconds_timer();
+    BPH_mass_spring_solve_velocities(id, dt, &result);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+
+    EXPECT_EQ(result.status, BPH_SOLVER_SUCCESS);
+  }
+
+  /* Pinned vertices keep their velocity. */
+  float vel[3];
+  BPH_mass_spring_get_new_velocity(id, 0, vel);
+  EXPECT_V3_NEAR(vel, zero, 1e-6f);
+
+  printf("\t%s: %d vertices, solved in %fs on average over %d runs, "
+         "%d iterations, error %g\n",
+         id_name,
+         numverts,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED,
+         result.iterations,
+         result.error);
+
+  BPH_mass_spring_solver_free(id);
+  BLI_threadapi_exit();
+}
+
+TEST(cloth_solver, SolveSmall)
+{
+  cloth_solver_test_do("Cloth solver - 10k vertices", 100);
+}
+
+TEST(cloth_solver, SolveMedium)
+{
+  cloth_solver_test_do("Cloth solver - 100k vertices", 316);
+}
+
+TEST(cloth_solver, SolveLarge)
+{
+  cloth_solver_test_do("Cloth solver - 250k vertices", 500);
+}
@@ -0,0 +1,59 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_MESH_H__
+#define __BLENDER_TESTING_MESH_H__
+
+/* Meshes shared by tests and benchmarks, the includer links against blenkernel. */
+
+extern "C" {
+#include "BLI_math.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_mesh.h"
+}
+
+/**
+ * Grid of quads over the unit square in the XY plane, with \a resolution quads on each side.
+ * Edges and normals are calculated.
+ *
+ * \param wave_height: height of a wave along Z, so the faces are not evenly spread in space.
+ */
+static inline Mesh *testing_mesh_grid_create(const int resolution, const float wave_height)
+{
+  const int totvert = (resolution + 1) * (resolution + 1);
+  const int totpoly = resolution * resolution;
+  Mesh *mesh = BKE_mesh_new_nomain(totvert, 0, 0, totpoly * 4, totpoly);
+
+  for (int y = 0; y <= resolution; y++) {
+    for (int x = 0; x <= resolution; x++) {
+      MVert *mv = &mesh->mvert[y * (resolution + 1) + x];
+      const float u = (float)x / resolution, v = (float)y / resolution;
+      mv->co[0] = u;
+      mv->co[1] = v;
+      mv->co[2] = wave_height * sinf(u * 20.0f) * cosf(v * 5.0f);
+    }
+  }
+
+  for (int y = 0; y < resolution; y++) {
+    for (int x = 0; x < resolution; x++) {
+      const int poly = y * resolution + x;
+      const int vert = y * (resolution + 1) + x;
+      MPoly *mp = &mesh->mpoly[poly];
+      MLoop *ml = &mesh->mloop[poly * 4];
+      mp->loopstart = poly * 4;
+      mp->totloop = 4;
+      ml[0].v = vert;
+      ml[1].v = vert + 1;
+      ml[2].v = vert + resolution + 2;
+      ml[3].v = vert + resolution + 1;
+    }
+  }
+
+  BKE_mesh_calc_edges(mesh, false, false);
+  BKE_mesh_calc_normals(mesh);
+  return mesh;
+}
+
+#endif /* __BLENDER_TESTING_MESH_H__ */
@@ -0,0 +1,189 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Compare convergence of light tree sampling against the light distribution,
+on a generated city block lit by many emissive windows and street lights.
+
+Example Usage:
+
+./blender.bin --background --factory-startup \
+    --python tests/python/cycles_light_tree_benchmark.py -- \
+    --blocks=40 --lights=2000 --samples=4,16,64 --reference-samples=1024 \
+    --outdir=/tmp/light_tree
+
+Prints render time and RMSE against a reference render for each sample
+count, with and without the light tree.
+"""
+
+import argparse
+import math
+import os
+import random
+import sys
+import time
+
+import bpy
+
+
+def create_material(name, color, strength):
+    material = bpy.data.materials.new(name)
+    material.use_nodes = True
+    nodes = material.node_tree.nodes
+    nodes.clear()
+
+    emission = nodes.new('ShaderNodeEmission')
+    emission.inputs["Color"].default_value = color + (1.0,)
+    emission.inputs["Strength"].default_value = strength
+
+    output = nodes.new('ShaderNodeOutputMaterial')
+    material.node_tree.links.new(emission.outputs["Emission"], output.inputs["Surface"])
+    return material
+
+
+def create_scene(num_blocks, num_lights, seed):
+    random.seed(seed)
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    collection = scene.collection
+
+    # Ground.
+    bpy.ops.mesh.primitive_plane_add(size=num_blocks * 4.0)
+
+    # Buildings with emissive windows, each window its own small mesh light.
+    window_materials = [
+        create_material("Window%d" % i, (1.0, 0.8 - 0.1 * i, 0.5 + 0.1 * i), 2.0 + i)
+        for i in range(4)
+    ]
+    window_mesh = bpy.data.meshes.new("Window")
+    window_mesh.from_pydata(
+        [(-0.1, 0.0, -0.1), (0.1, 0.0, -0.1), (0.1, 0.0, 0.1), (-0.1, 0.0, 0.1)],
+        [], [(0, 1, 2, 3)])
+
+    half = num_blocks * 2.0
+    for bx in range(num_blocks):
+        for by in range(num_blocks):
+            x = bx * 4.0 - half + 2.0
+            y = by * 4.0 - half + 2.0
+            height = random.uniform(1.0, 6.0)
+
+            bpy.ops.mesh.primitive_cube_add(size=1.0, location=(x, y, height * 0.5))
+            bpy.context.object.scale = (2.0, 2.0, height)
+
+            for _ in range(8):
+                mesh = window_mesh.copy()
+                mesh.materials.append(random.choice(window_materials))
+                window = bpy.data.objects.new("Window", mesh)
+                window.location = (x + random.uniform(-0.8, 0.8), y - 1.01,
+                                   random.uniform(0.3, height - 0.2))
+                collection.objects.link(window)
+
+    # Street lights.
+    for i in range(num_lights):
+        light = bpy.data.lights.new("Street%d" % i, 'POINT')
+        light.energy = random.uniform(5.0, 50.0)
+        light.shadow_soft_size = 0.05
+        light.color = (1.0, random.uniform(0.6, 0.9), random.uniform(0.3, 0.6))
+        ob = bpy.data.objects.new("Street%d" % i, light)
+        ob.location = (random.uniform(-half, half), random.uniform(-half, half), 0.5)
+        collection.objects.link(ob)
+
+    # Camera looking down the street.
+    camera = bpy.data.cameras.new("Camera")
+    camera_ob = bpy.data.objects.new("Camera", camera)
+    camera_ob.location = (0.0, -half - 4.0, 6.0)
+    camera_ob.rotation_euler = (math.radians(70.0), 0.0, 0.0)
+    collection.objects.link(camera_ob)
+    scene.camera = camera_ob
+
+    scene.world = bpy.data.worlds.new("World")
+    scene.world.color = (0.0, 0.0, 0.0)
+
+    scene.render.engine = 'CYCLES'
+    scene.render.resolution_x = 480
+    scene.render.resolution_y = 270
+    scene.render.resolution_percentage = 100
+    scene.render.image_settings.file_format = 'OPEN_EXR'
+    scene.render.image_settings.color_depth = '32'
+    scene.cycles.device = 'CPU'
+    scene.cycles.progressive = 'PATH'
+    scene.cycles.max_bounces = 2
+    scene.cycles.use_denoising = False
+    scene.cycles.light_sampling_threshold = 0.0
+
+    return scene
+
+
+def render(scene, samples, use_light_tree, filepath):
+    scene.cycles.samples = samples
+    scene.cycles.use_light_tree = use_light_tree
+    scene.render.filepath = filepath
+
+    start = time.time()
+    bpy.ops.render.render(write_still=True)
+    elapsed = time.time() - start
+
+    image = bpy.data.images.load(filepath)
+    pixels = list(image.pixels)
+    bpy.data.images.remove(image)
+    return pixels, elapsed
+
+
+def rmse(pixels, reference):
+    total = 0.0
+    num = 0
+    for i in range(0, len(pixels), 4):
+        for c in range(3):
+            diff = pixels[i + c] - reference[i + c]
+            total += diff * diff
+        num += 3
+    return math.sqrt(total / num)
+
+
+def main():
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--blocks", type=int, default=20)
+    parser.add_argument("--lights", type=int, default=1000)
+    parser.add_argument("--samples", default="4,16,64")
+    parser.add_argument("--reference-samples", type=int, default=1024)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--outdir", default="/tmp/cycles_light_tree")
+    args = parser.parse_args(argv)
+
+    os.makedirs(args.outdir, exist_ok=True)
+    scene = create_scene(args.blocks, args.lights, args.seed)
+
+    reference, _ = render(scene, args.reference_samples, True,
+                          os.path.join(args.outdir, "reference.exr"))
+
+    print("%8s %12s %10s %12s" % ("samples", "method", "time (s)", "rmse"))
+    for samples in [int(s) for s in args.samples.split(",")]:
+        for use_light_tree in (False, True):
+            method = "tree" if use_light_tree else "distribution"
+            filepath = os.path.join(args.outdir, "%s_%d.exr" % (method, samples))
+            pixels, elapsed = render(scene, samples, use_light_tree, filepath)
+            print("%8d %12s %10.2f %12.6f" % (samples, method, elapsed, rmse(pixels, reference)))
+
+
+if __name__ == "__main__":
+    main()